@@ -0,0 +1,8311 @@
+/**
+ * @file
+ * @brief   lfg-ctest -- C99 unit test + mock framework (amalgamated).
+ *
+ * This file is auto-generated. Do not edit.
+ * Define LFG_CTEST_IMPLEMENTATION in exactly one translation unit
+ * before including this header:
+ *
+ *     #define LFG_CTEST_IMPLEMENTATION
+ *     #include "lfg-ctest.h"
+ *
+ * Optional build-time defines:
+ *   LFG_CTEST_HAS_FLOAT    -- enable 32-bit float asserts (needs libm).
+ *   LFG_CTEST_HAS_DOUBLE   -- enable 64-bit double asserts (needs libm).
+ *   LFG_CTEST_NO_FUNC      -- disable __func__ reporting.
+ *   LFG_CTEST_SELF_TEST    -- enable expect-failures self-test mode.
+ */
+
+#ifndef LFG_CTEST_SINGLE_H_
+#define LFG_CTEST_SINGLE_H_
+
+/* --- lfg-ctest-version.h --- */
+#define LFG_CTEST_VERSION_MAJOR 0
+#define LFG_CTEST_VERSION_MINOR 0
+#define LFG_CTEST_VERSION_PATCH 0
+#define LFG_CTEST_VERSION      "0.0.0"
+#define LFG_CTEST_VERSION_FULL "0.0.0"
+
+/* --- lfg-ctest.h --- */
+/**
+ * @file
+ * @brief       lfg-ctest unit testing helpers.
+ */
+
+
+/*============================================================================
+ *  Includes
+ *==========================================================================*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Generated at configure/build time by tools/mkversion.c -- contains
+ * LFG_CTEST_VERSION, LFG_CTEST_VERSION_FULL, and LFG_CTEST_VERSION_{MAJOR,MINOR,PATCH}. */
+
+/*============================================================================
+ *  Defines/Typedefs
+ *==========================================================================*/
+
+#ifndef _STR
+#define _STR(_x) #_x
+#endif
+#ifndef STR
+#define STR(_x) _STR(_x)
+#endif
+
+/**
+ * LFG_CT_FUNCTION - portable function name identifier
+ *
+ * Auto-detects the best available option:
+ *   1. __func__     (C99 standard)
+ *   2. __FUNCTION__ (GCC/Clang/MSVC extension for C89)
+ *   3. "(unknown)"  (fallback)
+ *
+ * Define LFG_CTEST_NO_FUNC before including this header to disable
+ * function name reporting entirely.
+ */
+#ifdef LFG_CTEST_NO_FUNC
+#define LFG_CT_FUNCTION "(unknown)"
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define LFG_CT_FUNCTION __func__
+#elif defined(__GNUC__) || defined(_MSC_VER)
+#define LFG_CT_FUNCTION __FUNCTION__
+#else
+#define LFG_CT_FUNCTION "(unknown)"
+#endif
+
+/** Selects the assertion entry point. With LFG_CTEST_INLINE_ASSERTS the scalar
+ *  assertions go through the header-inline lfg_ct_fast_* helpers below, which
+ *  only call the out-of-line implementation when the check fails.
+ */
+#ifdef LFG_CTEST_INLINE_ASSERTS
+#define _LFG_CT_ASSERT(_name) lfg_ct_fast_##_name
+#else
+#define _LFG_CT_ASSERT(_name) lfg_ct_assert_##_name
+#endif
+
+/** Execute a test or suite of tests.
+ */
+#define ASSERT_FALSE(_cond) _LFG_CT_ASSERT(false_impl)((_cond), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_cond))
+
+#define ASSERT_TRUE(_cond) _LFG_CT_ASSERT(true_impl)((_cond), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_cond))
+
+#define ASSERT_INT_EQUAL(_e, _a)                                                                                       \
+    _LFG_CT_ASSERT(int_equal_impl)((int)(_e), (int)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT_NOT_EQUAL(_e, _a)                                                                                   \
+    _LFG_CT_ASSERT(int_not_equal_impl)((int)(_e), (int)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT_EQUAL(_e, _a)                                                                                      \
+    _LFG_CT_ASSERT(uint_equal_impl)((unsigned)(_e), (unsigned)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT_NOT_EQUAL(_e, _a)                                                                                  \
+    _LFG_CT_ASSERT(uint_not_equal_impl)((unsigned)(_e), (unsigned)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT8_EQUAL(_e, _a)                                                                                     \
+    _LFG_CT_ASSERT(uint8_equal_impl)((uint8_t)(_e), (uint8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT8_NOT_EQUAL(_e, _a)                                                                                 \
+    _LFG_CT_ASSERT(uint8_not_equal_impl)((uint8_t)(_e), (uint8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT16_EQUAL(_e, _a)                                                                                    \
+    _LFG_CT_ASSERT(uint16_equal_impl)((uint16_t)(_e), (uint16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT16_NOT_EQUAL(_e, _a)                                                                                \
+    _LFG_CT_ASSERT(uint16_not_equal_impl)((uint16_t)(_e), (uint16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT32_EQUAL(_e, _a)                                                                                    \
+    _LFG_CT_ASSERT(uint32_equal_impl)((uint32_t)(_e), (uint32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT32_NOT_EQUAL(_e, _a)                                                                                \
+    _LFG_CT_ASSERT(uint32_not_equal_impl)((uint32_t)(_e), (uint32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_PTR_EQUAL(_e, _a)                                                                                       \
+    _LFG_CT_ASSERT(ptr_equal_impl)((void *)(_e), (void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_PTR_NOT_EQUAL(_e, _a)                                                                                   \
+    _LFG_CT_ASSERT(ptr_not_equal_impl)((void *)(_e), (void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_PTR_NOT_NULL(_a) _LFG_CT_ASSERT(ptr_not_null)((void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_PTR_NULL(_a) _LFG_CT_ASSERT(ptr_null)((void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT8_EQUAL(_e, _a)                                                                                      \
+    _LFG_CT_ASSERT(int8_equal_impl)((int8_t)(_e), (int8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT8_NOT_EQUAL(_e, _a)                                                                                  \
+    _LFG_CT_ASSERT(int8_not_equal_impl)((int8_t)(_e), (int8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT16_EQUAL(_e, _a)                                                                                     \
+    _LFG_CT_ASSERT(int16_equal_impl)((int16_t)(_e), (int16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT16_NOT_EQUAL(_e, _a)                                                                                 \
+    _LFG_CT_ASSERT(int16_not_equal_impl)((int16_t)(_e), (int16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT32_EQUAL(_e, _a)                                                                                     \
+    _LFG_CT_ASSERT(int32_equal_impl)((int32_t)(_e), (int32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT32_NOT_EQUAL(_e, _a)                                                                                 \
+    _LFG_CT_ASSERT(int32_not_equal_impl)((int32_t)(_e), (int32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT64_EQUAL(_e, _a)                                                                                     \
+    _LFG_CT_ASSERT(int64_equal_impl)((int64_t)(_e), (int64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT64_NOT_EQUAL(_e, _a)                                                                                 \
+    _LFG_CT_ASSERT(int64_not_equal_impl)((int64_t)(_e), (int64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT64_EQUAL(_e, _a)                                                                                    \
+    _LFG_CT_ASSERT(uint64_equal_impl)((uint64_t)(_e), (uint64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT64_NOT_EQUAL(_e, _a)                                                                                \
+    _LFG_CT_ASSERT(uint64_not_equal_impl)((uint64_t)(_e), (uint64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_STR_EQUAL(_e, _a) lfg_ct_assert_str_equal_impl((_e), (_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_STR_NOT_EQUAL(_e, _a)                                                                                   \
+    lfg_ct_assert_str_not_equal_impl((_e), (_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_STRN_EQUAL(_e, _a, _n)                                                                                  \
+    lfg_ct_assert_strn_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_MEM_EQUAL(_e, _a, _n)                                                                                   \
+    lfg_ct_assert_mem_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_MEM_NOT_EQUAL(_e, _a, _n)                                                                               \
+    lfg_ct_assert_mem_not_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/** Assert @p _n elements of two fixed-width integer arrays are equal. Counts as one assertion;
+ *  a failure lists the first LFG_CT_ARRAY_DIFF_MAX mismatching indices. */
+#define ASSERT_INT8_ARRAY_EQUAL(_e, _a, _n)                                                                            \
+    lfg_ct_assert_int8_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT16_ARRAY_EQUAL(_e, _a, _n)                                                                           \
+    lfg_ct_assert_int16_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT32_ARRAY_EQUAL(_e, _a, _n)                                                                           \
+    lfg_ct_assert_int32_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT64_ARRAY_EQUAL(_e, _a, _n)                                                                           \
+    lfg_ct_assert_int64_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT8_ARRAY_EQUAL(_e, _a, _n)                                                                           \
+    lfg_ct_assert_uint8_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT16_ARRAY_EQUAL(_e, _a, _n)                                                                          \
+    lfg_ct_assert_uint16_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT32_ARRAY_EQUAL(_e, _a, _n)                                                                          \
+    lfg_ct_assert_uint32_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT64_ARRAY_EQUAL(_e, _a, _n)                                                                          \
+    lfg_ct_assert_uint64_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_GREATER_THAN(_a, _b)                                                                                    \
+    _LFG_CT_ASSERT(greater_than_impl)((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+
+#define ASSERT_LESS_THAN(_a, _b)                                                                                       \
+    _LFG_CT_ASSERT(less_than_impl)((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+
+#define ASSERT_GREATER_OR_EQUAL(_a, _b)                                                                                \
+    _LFG_CT_ASSERT(greater_or_equal_impl)((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+
+#define ASSERT_LESS_OR_EQUAL(_a, _b)                                                                                   \
+    _LFG_CT_ASSERT(less_or_equal_impl)((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+
+#define ASSERT_IN_RANGE(_val, _min, _max)                                                                              \
+    _LFG_CT_ASSERT(in_range_impl)((int)(_val), (int)(_min), (int)(_max), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val))
+
+#define ASSERT_BIT_SET(_val, _bit)                                                                                     \
+    _LFG_CT_ASSERT(bit_set_impl)((unsigned)(_val), (_bit), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_bit))
+
+#define ASSERT_BIT_CLEAR(_val, _bit)                                                                                   \
+    _LFG_CT_ASSERT(bit_clear_impl)((unsigned)(_val), (_bit), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_bit))
+
+#define ASSERT_BITS_SET(_val, _mask)                                                                                   \
+    _LFG_CT_ASSERT(bits_set_impl)((unsigned)(_val), (_mask), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_mask))
+
+#define ASSERT_BITS_CLEAR(_val, _mask)                                                                                 \
+    _LFG_CT_ASSERT(bits_clear_impl)((unsigned)(_val), (_mask), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_mask))
+
+#define ASSERT_FAIL(_msg) lfg_ct_assert_fail_impl(__FILE__, __LINE__, LFG_CT_FUNCTION, (_msg))
+
+/*============================================================================
+ *  32-bit Float Assertions (optional - requires LFG_CTEST_HAS_FLOAT)
+ *
+ *  These assertions require fabsf from math library.
+ *  On embedded platforms without FPU, disable with:
+ *    cmake -DLFG_CTEST_ENABLE_FLOAT=OFF
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_HAS_FLOAT
+
+/** Assert float values are equal within epsilon tolerance */
+#define ASSERT_FLOAT_EQUAL(_e, _a, _eps)                                                                               \
+    lfg_ct_assert_float_equal_impl(                                                                                    \
+            (float)(_e), (float)(_a), (float)(_eps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/** Assert float values are not equal (differ by more than epsilon) */
+#define ASSERT_FLOAT_NOT_EQUAL(_e, _a, _eps)                                                                           \
+    lfg_ct_assert_float_not_equal_impl(                                                                                \
+            (float)(_e), (float)(_a), (float)(_eps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/** Assert float a > b */
+#define ASSERT_FLOAT_GREATER_THAN(_a, _b)                                                                              \
+    lfg_ct_assert_float_greater_impl((float)(_a), (float)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+
+/** Assert float a < b */
+#define ASSERT_FLOAT_LESS_THAN(_a, _b)                                                                                 \
+    lfg_ct_assert_float_less_impl((float)(_a), (float)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+
+/** Assert float a >= b */
+#define ASSERT_FLOAT_GREATER_OR_EQUAL(_a, _b)                                                                          \
+    lfg_ct_assert_float_ge_impl((float)(_a), (float)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+
+/** Assert float a <= b */
+#define ASSERT_FLOAT_LESS_OR_EQUAL(_a, _b)                                                                             \
+    lfg_ct_assert_float_le_impl((float)(_a), (float)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+
+/** Assert float value is within range [min, max] */
+#define ASSERT_FLOAT_IN_RANGE(_val, _min, _max)                                                                        \
+    lfg_ct_assert_float_in_range_impl(                                                                                 \
+            (float)(_val), (float)(_min), (float)(_max), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val))
+
+/** Assert @p _n float elements are each equal within absolute epsilon (one assertion) */
+#define ASSERT_FLOAT_ARRAY_EQUAL(_e, _a, _n, _eps)                                                                     \
+    lfg_ct_assert_float_array_equal_impl((_e), (_a), (_n), (float)(_eps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/** Assert @p _n float elements are each at most @p _ulps representable values apart (one assertion) */
+#define ASSERT_FLOAT_ARRAY_EQUAL_ULP(_e, _a, _n, _ulps)                                                                \
+    lfg_ct_assert_float_array_equal_ulp_impl(                                                                          \
+            (_e), (_a), (_n), (uint64_t)(_ulps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/* Shorthand aliases for float assertions */
+#define ASSERT_FLT_EQ(_e, _a, _eps) ASSERT_FLOAT_EQUAL(_e, _a, _eps)
+#define ASSERT_FLT_NE(_e, _a, _eps) ASSERT_FLOAT_NOT_EQUAL(_e, _a, _eps)
+#define ASSERT_FLT_GT(_a, _b) ASSERT_FLOAT_GREATER_THAN(_a, _b)
+#define ASSERT_FLT_LT(_a, _b) ASSERT_FLOAT_LESS_THAN(_a, _b)
+#define ASSERT_FLT_GE(_a, _b) ASSERT_FLOAT_GREATER_OR_EQUAL(_a, _b)
+#define ASSERT_FLT_LE(_a, _b) ASSERT_FLOAT_LESS_OR_EQUAL(_a, _b)
+
+#endif /* LFG_CTEST_HAS_FLOAT */
+
+/*============================================================================
+ *  64-bit Double Assertions (optional - requires LFG_CTEST_HAS_DOUBLE)
+ *
+ *  These assertions require fabs from math library.
+ *  Some embedded platforms have hardware float but software-emulated double.
+ *  Disable double separately with:
+ *    cmake -DLFG_CTEST_ENABLE_DOUBLE=OFF
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_HAS_DOUBLE
+
+/** Assert double values are equal within epsilon tolerance */
+#define ASSERT_DOUBLE_EQUAL(_e, _a, _eps)                                                                              \
+    lfg_ct_assert_double_equal_impl(                                                                                   \
+            (double)(_e), (double)(_a), (double)(_eps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/** Assert double values are not equal (differ by more than epsilon) */
+#define ASSERT_DOUBLE_NOT_EQUAL(_e, _a, _eps)                                                                          \
+    lfg_ct_assert_double_not_equal_impl(                                                                               \
+            (double)(_e), (double)(_a), (double)(_eps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/** Assert @p _n double elements are each equal within absolute epsilon (one assertion) */
+#define ASSERT_DOUBLE_ARRAY_EQUAL(_e, _a, _n, _eps)                                                                    \
+    lfg_ct_assert_double_array_equal_impl(                                                                             \
+            (_e), (_a), (_n), (double)(_eps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/** Assert @p _n double elements are each at most @p _ulps representable values apart (one assertion) */
+#define ASSERT_DOUBLE_ARRAY_EQUAL_ULP(_e, _a, _n, _ulps)                                                               \
+    lfg_ct_assert_double_array_equal_ulp_impl(                                                                         \
+            (_e), (_a), (_n), (uint64_t)(_ulps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/* Shorthand aliases for double assertions */
+#define ASSERT_DBL_EQ(_e, _a, _eps) ASSERT_DOUBLE_EQUAL(_e, _a, _eps)
+#define ASSERT_DBL_NE(_e, _a, _eps) ASSERT_DOUBLE_NOT_EQUAL(_e, _a, _eps)
+
+#endif /* LFG_CTEST_HAS_DOUBLE */
+
+/* Less verbose aliases */
+#define ASSERT_EQ(_e, _a) ASSERT_INT_EQUAL(_e, _a)
+#define ASSERT_NE(_e, _a) ASSERT_INT_NOT_EQUAL(_e, _a)
+#define ASSERT_GT(_a, _b) ASSERT_GREATER_THAN(_a, _b)
+#define ASSERT_LT(_a, _b) ASSERT_LESS_THAN(_a, _b)
+#define ASSERT_GE(_a, _b) ASSERT_GREATER_OR_EQUAL(_a, _b)
+#define ASSERT_LE(_a, _b) ASSERT_LESS_OR_EQUAL(_a, _b)
+#define ASSERT_NULL(_a) ASSERT_PTR_NULL(_a)
+#define ASSERT_NOT_NULL(_a) ASSERT_PTR_NOT_NULL(_a)
+
+#define lfg_ct_suite(_suite) lfg_ct_suite_impl(_suite, #_suite)
+
+#define lfg_ctest(_test) lfg_ct_impl(_test, #_test)
+
+#define lfg_ct_bench(_fn) lfg_ct_bench_impl(_fn, #_fn)
+
+/* Run a test or suite with its own time budget in milliseconds */
+#define lfg_ctest_timeout(_test, _ms)                                                                                  \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        lfg_ct_timeout_next(_ms);                                                                                      \
+        lfg_ct_impl(_test, #_test);                                                                                    \
+    } while (0)
+
+#define lfg_ct_suite_timeout(_suite, _ms)                                                                              \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        lfg_ct_timeout_next(_ms);                                                                                      \
+        lfg_ct_suite_impl(_suite, #_suite);                                                                            \
+    } while (0)
+
+/*============================================================================
+ *  Test Registration
+ *
+ *  LFG_CT_TEST(name) defines a test function and adds it to a static registry
+ *  before main() runs, so lfg_ct_main() can list, filter and order tests
+ *  without hand-written suites:
+ *
+ *      LFG_CT_TEST(test_parse_empty)
+ *      {
+ *          ASSERT_INT_EQUAL(0, parse(""));
+ *      }
+ *
+ *      int main(int argc, char *argv[])
+ *      {
+ *          return lfg_ct_main(argc, argv);
+ *      }
+ *
+ *  GCC/Clang use a constructor function and MSVC a .CRT$XCU initializer; both
+ *  define LFG_CT_HAS_AUTO_REGISTER. Other compilers must list each test with
+ *  LFG_CT_REGISTER(name) before calling lfg_ct_main(). LFG_CT_REGISTER is
+ *  harmless where registration is automatic.
+ *==========================================================================*/
+
+/** Registry entry created by LFG_CT_TEST(). */
+typedef struct lfg_ct_test_node
+{
+    const char *name;
+    void (*fn)(void);
+    const char *file;
+    int line;
+    struct lfg_ct_test_node *next;
+    bool registered;
+} lfg_ct_test_node_t;
+
+#define _LFG_CT_TEST_NODE(_name)                                                                                       \
+    static void _name(void);                                                                                           \
+    static lfg_ct_test_node_t _name##__lfg_ct_node = {#_name, _name, __FILE__, __LINE__, NULL, false}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LFG_CT_HAS_AUTO_REGISTER 1
+#define LFG_CT_TEST(_name)                                                                                             \
+    _LFG_CT_TEST_NODE(_name);                                                                                          \
+    __attribute__((constructor)) static void _name##__lfg_ct_register(void)                                            \
+    {                                                                                                                  \
+        lfg_ct_register(&_name##__lfg_ct_node);                                                                        \
+    }                                                                                                                  \
+    static void _name(void)
+#elif defined(_MSC_VER)
+#define LFG_CT_HAS_AUTO_REGISTER 1
+#define LFG_CT_TEST(_name)                                                                                             \
+    _LFG_CT_TEST_NODE(_name);                                                                                          \
+    static void __cdecl _name##__lfg_ct_register(void)                                                                 \
+    {                                                                                                                  \
+        lfg_ct_register(&_name##__lfg_ct_node);                                                                        \
+    }                                                                                                                  \
+    __pragma(section(".CRT$XCU", read)) __declspec(allocate(".CRT$XCU")) void(__cdecl * _name##__lfg_ct_ctor)(void) =  \
+            _name##__lfg_ct_register;                                                                                  \
+    static void _name(void)
+#else
+#define LFG_CT_TEST(_name)                                                                                             \
+    _LFG_CT_TEST_NODE(_name);                                                                                          \
+    static void _name(void)
+#endif
+
+#define LFG_CT_REGISTER(_name) lfg_ct_register(&_name##__lfg_ct_node)
+
+/*============================================================================
+ *  Reporter Types
+ *==========================================================================*/
+
+/** Kinds of event delivered to reporters. */
+typedef enum
+{
+    LFG_CT_EVENT_START,     /* lfg_ct_start(); seed is valid */
+    LFG_CT_EVENT_FAILURE,   /* an assertion failed; file/line/function/message are valid */
+    LFG_CT_EVENT_TEST_END,  /* a test finished; name/failures/wall_ns/cpu_ns, message on crash */
+    LFG_CT_EVENT_SUITE_END, /* a suite finished; name/failures (failed tests)/wall_ns/cpu_ns */
+    LFG_CT_EVENT_SUMMARY,   /* lfg_ct_print_summary(); run totals, slowest and benchmark tables */
+    LFG_CT_EVENT_BENCH,     /* a benchmark finished; name/bench are valid */
+    LFG_CT_EVENT_TIMEOUT,   /* a time budget ran out; name, message ("test" or "suite"), wall_ns = budget */
+} lfg_ct_event_type_t;
+
+/** One entry of a slowest-tests or slowest-suites table. */
+typedef struct
+{
+    const char *name;
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+} lfg_ct_timing_t;
+
+/** Result of one lfg_ct_bench() run. Per-op figures are in picoseconds
+ *  (divide by 1000 for ns) so operations faster than 1 ns keep precision.
+ */
+typedef struct
+{
+    const char *name;
+    unsigned long iterations; /* calls per sample, found by calibration */
+    unsigned samples;         /* timed samples taken */
+    uint64_t min_ps;
+    uint64_t median_ps;
+    uint64_t mean_ps;
+    uint64_t p99_ps;
+    uint64_t median_mcycles; /* median CPU cycles per op x1000; 0 without a cycle counter */
+} lfg_ct_bench_result_t;
+
+/** Event passed to reporters. Fields not listed for an event type are zero.
+ *  Strings are only valid for the duration of the callback.
+ */
+typedef struct
+{
+    lfg_ct_event_type_t type;
+    const char *name;        /* test or suite name */
+    const char *file;        /* failing assertion's source file */
+    int line;                /* failing assertion's source line */
+    const char *function;    /* function containing the failing assertion */
+    const char *message;     /* failure text, or why a test failed without one */
+    int failures;            /* failed assertions (test), failed tests (suite, summary) */
+    unsigned seed;           /* random seed */
+    int assertions_executed; /* summary only */
+    int tests_executed;      /* summary only */
+    uint64_t wall_ns;        /* test/suite wall time; summed test wall time for the summary */
+    uint64_t cpu_ns;         /* test/suite CPU time; summed test CPU time for the summary */
+    uint64_t elapsed_ns;     /* summary only: wall time since lfg_ct_start() */
+    const lfg_ct_timing_t *slowest_tests;
+    unsigned slowest_tests_count;
+    const lfg_ct_timing_t *slowest_suites;
+    unsigned slowest_suites_count;
+    const lfg_ct_bench_result_t *bench; /* the finished benchmark, or the results table (summary) */
+    unsigned bench_count;               /* summary only: entries in bench */
+    int tests_skipped;                  /* summary only: tests left to other shards */
+    unsigned shard_index;               /* start and summary */
+    unsigned shard_count;               /* start and summary; 1 when not sharded */
+} lfg_ct_event_t;
+
+/** Reporter callback. @p ctx is the pointer given to lfg_ct_reporter_add(). */
+typedef void (*lfg_ct_reporter_fn)(const lfg_ct_event_t *event, void *ctx);
+
+/*============================================================================
+ *  Public API
+ *==========================================================================*/
+
+/** Return the framework version string as "M.m.p[+<sha>]".
+ *  The underlying macro is LFG_CTEST_VERSION_FULL; use this function when
+ *  you need the version at runtime (e.g. logging a test harness banner).
+ */
+const char *lfg_ct_version(void);
+
+/** Mark the beginning of unit testing.
+ */
+void lfg_ct_start(void);
+
+/** Mark the end of unit testing.
+ */
+void lfg_ct_end(void);
+
+/** Run subsequent tests in up to @p jobs forked worker processes.
+ *  Each lfg_ctest() call becomes one worker; its assertion counters are sent
+ *  back to the parent over a pipe and a worker that crashes counts as a failed
+ *  test. Output from concurrent workers may interleave. Outstanding workers
+ *  are always drained at the end of each suite, and before printing the
+ *  summary or returning. A value of 0 or 1 restores in-process execution.
+ *  No-op unless built with LFG_CTEST_HAS_FORK.
+ *  @param jobs Maximum number of concurrent workers (clamped to LFG_CT_JOBS_MAX).
+ */
+void lfg_ct_parallel(unsigned jobs);
+
+/** Run each subsequent test in its own forked child, one at a time, so a
+ *  crash, abort or _exit() in one test is reported as that test's failure
+ *  (naming the signal) and the run carries on. Counters come back to the
+ *  parent the same way as with lfg_ct_parallel(), which takes precedence
+ *  when it asks for more than one job. No-op unless built with
+ *  LFG_CTEST_HAS_FORK.
+ *  @param enable true to isolate tests, false to run them in-process again.
+ */
+void lfg_ct_isolate(bool enable);
+
+/** Set the default time budgets. When a test or suite runs past its budget
+ *  the runner reports it as timed out and prints a backtrace of where it is
+ *  stuck (with LFG_CTEST_HAS_BACKTRACE). A test isolated in a worker (see
+ *  lfg_ct_isolate() and lfg_ct_parallel()) fails and the run continues.
+ *  Otherwise the running test fails, a summary line is printed and the
+ *  process exits with status 1. A test's budget is measured inside its
+ *  suite's, and whichever ends first fires. The previous SIGALRM action is
+ *  restored once no budget is active.
+ *  No-op unless built with LFG_CTEST_HAS_WATCHDOG.
+ *  @param test_ms  Budget for each test in milliseconds, 0 for none (default).
+ *  @param suite_ms Budget for each suite in milliseconds, 0 for none (default).
+ */
+void lfg_ct_set_timeout_ms(unsigned test_ms, unsigned suite_ms);
+
+/** Override the budget of the next test or suite started (used by
+ *  lfg_ctest_timeout() and lfg_ct_suite_timeout()).
+ *  @param ms Budget in milliseconds, 0 for none.
+ */
+void lfg_ct_timeout_next(unsigned ms);
+
+/** Set how many of the slowest tests and suites lfg_ct_print_summary() lists.
+ *  Every test and suite is timed (monotonic wall time and process CPU time);
+ *  this only controls the report. Defaults to 5; 0 disables the listing.
+ *  @param n Number of entries to print (clamped to LFG_CT_SLOWEST_MAX).
+ */
+void lfg_ct_set_report_slowest(unsigned n);
+
+/** Register a reporter that receives every event after the console reporter.
+ *  Registering the same fn/ctx pair twice has no effect. Reporters registered
+ *  before lfg_ct_parallel() workers are forked are also called inside them.
+ *  @param fn  Callback.
+ *  @param ctx Passed through to @p fn.
+ *  @return 0 on success, -1 if @p fn is NULL or LFG_CT_REPORTERS_MAX is reached.
+ */
+int lfg_ct_reporter_add(lfg_ct_reporter_fn fn, void *ctx);
+
+/** Unregister a reporter added with lfg_ct_reporter_add().
+ */
+void lfg_ct_reporter_remove(lfg_ct_reporter_fn fn, void *ctx);
+
+/** Enable or disable the built-in console reporter (enabled by default).
+ */
+void lfg_ct_reporter_console(bool enable);
+
+/** Write out any console output still held in the batch buffer. The buffer is
+ *  flushed automatically at the end of every test and suite and by the summary.
+ */
+void lfg_ct_report_flush(void);
+
+/** Execute a suite of tests.
+ */
+void lfg_ct_suite_impl(void (*fn)(void), const char *name);
+
+/** Benchmark a function. Calibrates the number of calls per sample until one
+ *  sample takes about LFG_CT_BENCH_SAMPLE_NS, runs a warmup sample, then takes
+ *  LFG_CT_BENCH_SAMPLES timed samples with CLOCK_MONOTONIC (and the CPU cycle
+ *  counter on x86). min/median/mean/p99 ns per call are listed by
+ *  lfg_ct_print_summary(). Always runs in-process, after draining any
+ *  lfg_ct_parallel() workers.
+ *  @param fn   Function performing one operation.
+ *  @param name Name shown in the report.
+ */
+void lfg_ct_bench_impl(void (*fn)(void), const char *name);
+
+/** Execute a single unit test.
+ */
+void lfg_ct_impl(void (*fn)(void), const char *name);
+
+/** Print test summary.
+ */
+void lfg_ct_print_summary(void);
+
+/** Retrieve the return code for the main unittest function. This is intended
+ * to be called by the main() function such as:
+ *      int main(int argc, char *argv[]) {
+ *          // ... <execute suites or tests> ...
+ *          return lfg_ct_return();
+ *      }
+ */
+int lfg_ct_return(void);
+
+/** Run only every @p count-th top-level test, starting at @p index. Tests are
+ *  assigned round-robin in the order lfg_ctest() is called (declaration order
+ *  under lfg_ct_main()), so shards of the same binary never overlap and
+ *  together cover every test. Overrides the LFG_CT_SHARD_INDEX and
+ *  LFG_CT_SHARD_COUNT environment variables, which lfg_ct_start() reads.
+ *  @return 0, or -1 if @p count is 0 or @p index >= @p count.
+ */
+int lfg_ct_set_shard(unsigned index, unsigned count);
+
+/** Write the run totals as key=value lines to @p path when the summary is
+ *  printed (NULL disables). Defaults to the LFG_CT_RESULT_FILE environment
+ *  variable. @p path must stay valid until then.
+ */
+void lfg_ct_set_result_file(const char *path);
+
+/** Add a test to the registry. Called by LFG_CT_TEST() / LFG_CT_REGISTER();
+ *  a node that is already registered is ignored. Tests keep registration
+ *  order, which is the default run order.
+ */
+void lfg_ct_register(lfg_ct_test_node_t *node);
+
+/** Run the registered tests, driven by command-line options:
+ *      --list              print the selected test names and exit
+ *      --filter=GLOB       run only tests whose name matches GLOB ('*' and
+ *                          '?' wildcards); may be repeated, matches are OR'ed
+ *      --order=ORDER       declaration (default), name, or random (seeded by
+ *                          lfg_ct_start())
+ *      -j N, --jobs=N      run tests in N worker processes (lfg_ct_parallel)
+ *      --isolate           run each test in its own child process (lfg_ct_isolate)
+ *      --shard-index=I     with --shard-count=N, run only shard I of N
+ *      --shard-count=N     (see lfg_ct_set_shard; overrides the environment)
+ *      --result-file=PATH  see lfg_ct_set_result_file
+ *      --timeout=MS        per-test budget (see lfg_ct_set_timeout_ms)
+ *  Calls lfg_ct_start(), runs the tests, prints the summary and calls
+ *  lfg_ct_end().
+ *  @return lfg_ct_return(), or -1 on a usage error.
+ */
+int lfg_ct_main(int argc, char *argv[]);
+
+int lfg_ct_assert_false_impl(
+        bool condition, char *filename, int line_no, const char *function, const char *condition_str);
+
+int lfg_ct_assert_true_impl(
+        bool condition, char *filename, int line_no, const char *function, const char *condition_str);
+
+int lfg_ct_assert_int_equal_impl(
+        int expected, int actual, char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int_not_equal_impl(
+        int expected, int actual, char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint_equal_impl(unsigned expected, unsigned actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str);
+
+int lfg_ct_assert_uint_not_equal_impl(unsigned expected, unsigned actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint8_equal_impl(uint8_t expected, uint8_t actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str);
+
+int lfg_ct_assert_uint8_not_equal_impl(uint8_t expected, uint8_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint16_equal_impl(uint16_t expected, uint16_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint16_not_equal_impl(uint16_t expected, uint16_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint32_equal_impl(uint32_t expected, uint32_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint32_not_equal_impl(uint32_t expected, uint32_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_ptr_equal_impl(void *expected, void *actual, const char *filename, int line_no, const char *function,
+        const char *actual_expr_str);
+
+int lfg_ct_assert_ptr_not_equal_impl(void *expected, void *actual, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_ptr_not_null(
+        void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_ptr_null(
+        void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int8_equal_impl(
+        int8_t expected, int8_t actual, char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int8_not_equal_impl(
+        int8_t expected, int8_t actual, char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int16_equal_impl(int16_t expected, int16_t actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str);
+
+int lfg_ct_assert_int16_not_equal_impl(int16_t expected, int16_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int32_equal_impl(int32_t expected, int32_t actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str);
+
+int lfg_ct_assert_int32_not_equal_impl(int32_t expected, int32_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int64_equal_impl(int64_t expected, int64_t actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str);
+
+int lfg_ct_assert_int64_not_equal_impl(int64_t expected, int64_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint64_equal_impl(uint64_t expected, uint64_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint64_not_equal_impl(uint64_t expected, uint64_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_str_equal_impl(const char *expected, const char *actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_str_not_equal_impl(const char *expected, const char *actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_strn_equal_impl(const char *expected, const char *actual, size_t n, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_mem_equal_impl(const void *expected, const void *actual, size_t n, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_mem_not_equal_impl(const void *expected, const void *actual, size_t n, char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int8_array_equal_impl(const int8_t *expected, const int8_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int16_array_equal_impl(const int16_t *expected, const int16_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int32_array_equal_impl(const int32_t *expected, const int32_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int64_array_equal_impl(const int64_t *expected, const int64_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint8_array_equal_impl(const uint8_t *expected, const uint8_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint16_array_equal_impl(const uint16_t *expected, const uint16_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint32_array_equal_impl(const uint32_t *expected, const uint32_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint64_array_equal_impl(const uint64_t *expected, const uint64_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_greater_than_impl(int a, int b, char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str);
+
+int lfg_ct_assert_less_than_impl(int a, int b, char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str);
+
+int lfg_ct_assert_greater_or_equal_impl(int a, int b, char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str);
+
+int lfg_ct_assert_less_or_equal_impl(int a, int b, char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str);
+
+int lfg_ct_assert_in_range_impl(
+        int val, int min, int max, char *filename, int line_no, const char *function, const char *val_expr_str);
+
+int lfg_ct_assert_bit_set_impl(unsigned val, unsigned bit, char *filename, int line_no, const char *function,
+        const char *val_expr_str, unsigned bit_num);
+
+int lfg_ct_assert_bit_clear_impl(unsigned val, unsigned bit, char *filename, int line_no, const char *function,
+        const char *val_expr_str, unsigned bit_num);
+
+int lfg_ct_assert_bits_set_impl(unsigned val, unsigned mask, char *filename, int line_no, const char *function,
+        const char *val_expr_str, unsigned mask_val);
+
+int lfg_ct_assert_bits_clear_impl(unsigned val, unsigned mask, char *filename, int line_no, const char *function,
+        const char *val_expr_str, unsigned mask_val);
+
+int lfg_ct_assert_fail_impl(char *filename, int line_no, const char *function, const char *message);
+
+/*============================================================================
+ *  32-bit Float Assertion Implementations (optional)
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_HAS_FLOAT
+
+int lfg_ct_assert_float_equal_impl(float expected, float actual, float epsilon, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_float_not_equal_impl(float expected, float actual, float epsilon, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_float_greater_impl(float a, float b, const char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str);
+
+int lfg_ct_assert_float_less_impl(float a, float b, const char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str);
+
+int lfg_ct_assert_float_ge_impl(float a, float b, const char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str);
+
+int lfg_ct_assert_float_le_impl(float a, float b, const char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str);
+
+int lfg_ct_assert_float_in_range_impl(float val, float min, float max, const char *filename, int line_no,
+        const char *function, const char *val_expr_str);
+
+int lfg_ct_assert_float_array_equal_impl(const float *expected, const float *actual, size_t n, float tolerance,
+        const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_float_array_equal_ulp_impl(const float *expected, const float *actual, size_t n, uint64_t tolerance,
+        const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+#endif /* LFG_CTEST_HAS_FLOAT */
+
+/*============================================================================
+ *  64-bit Double Assertion Implementations (optional)
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_HAS_DOUBLE
+
+int lfg_ct_assert_double_equal_impl(double expected, double actual, double epsilon, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_double_not_equal_impl(double expected, double actual, double epsilon, const char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_double_array_equal_impl(const double *expected, const double *actual, size_t n, double tolerance,
+        const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_double_array_equal_ulp_impl(const double *expected, const double *actual, size_t n,
+        uint64_t tolerance, const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+#endif /* LFG_CTEST_HAS_DOUBLE */
+
+/*============================================================================
+ *  Inline Assertion Fast Path
+ *
+ *  Define LFG_CTEST_INLINE_ASSERTS before including this header to evaluate
+ *  the scalar assertions (bool, integer, pointer, comparison, range and bit)
+ *  inline. A passing check only bumps lfg_ct_counters; a failing one calls
+ *  the regular lfg_ct_assert_*_impl function, which counts the assertion and
+ *  reports it exactly as the out-of-line path does. String, memory and
+ *  floating-point assertions always take the out-of-line path.
+ *==========================================================================*/
+
+/** Assertion counters shared between lfg-ctest.c and the inline fast path.
+ *  Read them through the summary or a reporter, not directly.
+ */
+typedef struct
+{
+    int assertions_executed;
+    int assertions_passed;
+    int pass_weight; /* 0 while expect-failures mode is active, else 1 */
+} lfg_ct_counters_t;
+
+extern lfg_ct_counters_t lfg_ct_counters;
+
+/** Add to a framework counter. With LFG_CTEST_THREAD_SAFE this is a relaxed
+ *  atomic add, so assertions made from threads spawned by the code under test
+ *  are all counted. Those threads must be joined before the test returns.
+ */
+#ifdef LFG_CTEST_THREAD_SAFE
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "LFG_CTEST_THREAD_SAFE needs the GCC/Clang __atomic builtins"
+#endif
+#define _LFG_CT_COUNT(_var, _n) ((void)__atomic_fetch_add(&(_var), (_n), __ATOMIC_RELAXED))
+#else
+#define _LFG_CT_COUNT(_var, _n) ((void)((_var) += (_n)))
+#endif
+
+#ifdef LFG_CTEST_INLINE_ASSERTS
+
+#if defined(__GNUC__) || defined(__clang__)
+#define _LFG_CT_LIKELY(_x) __builtin_expect(!!(_x), 1)
+#else
+#define _LFG_CT_LIKELY(_x) (_x)
+#endif
+
+#define _LFG_CT_FAST_PASSED()                                                                                          \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);                                                         \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_passed, lfg_ct_counters.pass_weight);                                 \
+    } while (0)
+
+/* Scalar assertion taking (expected, actual) and the actual expression string. */
+#define _LFG_CT_FAST_PAIR(_name, _type, _pass)                                                                         \
+    static inline int lfg_ct_fast_##_name(_type expected, _type actual, const char *filename, int line_no,             \
+            const char *function, const char *actual_expr_str)                                                         \
+    {                                                                                                                  \
+        if (_LFG_CT_LIKELY(_pass))                                                                                     \
+        {                                                                                                              \
+            _LFG_CT_FAST_PASSED();                                                                                     \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        return lfg_ct_assert_##_name(expected, actual, (char *)filename, line_no, function, actual_expr_str);          \
+    }
+
+/* Ordering assertion taking (a, b) and both expression strings. */
+#define _LFG_CT_FAST_CMP(_name, _pass)                                                                                 \
+    static inline int lfg_ct_fast_##_name(int a, int b, const char *filename, int line_no, const char *function,       \
+            const char *a_str, const char *b_str)                                                                      \
+    {                                                                                                                  \
+        if (_LFG_CT_LIKELY(_pass))                                                                                     \
+        {                                                                                                              \
+            _LFG_CT_FAST_PASSED();                                                                                     \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        return lfg_ct_assert_##_name(a, b, (char *)filename, line_no, function, a_str, b_str);                         \
+    }
+
+/* Bit assertion taking (val, bit-or-mask) plus the literal echoed in the message. */
+#define _LFG_CT_FAST_BITS(_name, _pass)                                                                                \
+    static inline int lfg_ct_fast_##_name(unsigned val, unsigned bits, const char *filename, int line_no,              \
+            const char *function, const char *val_expr_str, unsigned bits_val)                                         \
+    {                                                                                                                  \
+        if (_LFG_CT_LIKELY(_pass))                                                                                     \
+        {                                                                                                              \
+            _LFG_CT_FAST_PASSED();                                                                                     \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        return lfg_ct_assert_##_name(val, bits, (char *)filename, line_no, function, val_expr_str, bits_val);          \
+    }
+
+static inline int lfg_ct_fast_false_impl(
+        bool condition, const char *filename, int line_no, const char *function, const char *condition_str)
+{
+    if (_LFG_CT_LIKELY(!condition))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_false_impl(condition, (char *)filename, line_no, function, condition_str);
+}
+
+static inline int lfg_ct_fast_true_impl(
+        bool condition, const char *filename, int line_no, const char *function, const char *condition_str)
+{
+    if (_LFG_CT_LIKELY(condition))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_true_impl(condition, (char *)filename, line_no, function, condition_str);
+}
+
+static inline int lfg_ct_fast_ptr_not_null(
+        void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    if (_LFG_CT_LIKELY(actual != NULL))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_ptr_not_null(actual, filename, line_no, function, actual_expr_str);
+}
+
+static inline int lfg_ct_fast_ptr_null(
+        void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    if (_LFG_CT_LIKELY(actual == NULL))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_ptr_null(actual, filename, line_no, function, actual_expr_str);
+}
+
+static inline int lfg_ct_fast_in_range_impl(
+        int val, int min, int max, const char *filename, int line_no, const char *function, const char *val_expr_str)
+{
+    if (_LFG_CT_LIKELY(val >= min && val <= max))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_in_range_impl(val, min, max, (char *)filename, line_no, function, val_expr_str);
+}
+
+_LFG_CT_FAST_PAIR(int_equal_impl, int, expected == actual)
+_LFG_CT_FAST_PAIR(int_not_equal_impl, int, expected != actual)
+_LFG_CT_FAST_PAIR(uint_equal_impl, unsigned, expected == actual)
+_LFG_CT_FAST_PAIR(uint_not_equal_impl, unsigned, expected != actual)
+_LFG_CT_FAST_PAIR(int8_equal_impl, int8_t, expected == actual)
+_LFG_CT_FAST_PAIR(int8_not_equal_impl, int8_t, expected != actual)
+_LFG_CT_FAST_PAIR(int16_equal_impl, int16_t, expected == actual)
+_LFG_CT_FAST_PAIR(int16_not_equal_impl, int16_t, expected != actual)
+_LFG_CT_FAST_PAIR(int32_equal_impl, int32_t, expected == actual)
+_LFG_CT_FAST_PAIR(int32_not_equal_impl, int32_t, expected != actual)
+_LFG_CT_FAST_PAIR(int64_equal_impl, int64_t, expected == actual)
+_LFG_CT_FAST_PAIR(int64_not_equal_impl, int64_t, expected != actual)
+_LFG_CT_FAST_PAIR(uint8_equal_impl, uint8_t, expected == actual)
+_LFG_CT_FAST_PAIR(uint8_not_equal_impl, uint8_t, expected != actual)
+_LFG_CT_FAST_PAIR(uint16_equal_impl, uint16_t, expected == actual)
+_LFG_CT_FAST_PAIR(uint16_not_equal_impl, uint16_t, expected != actual)
+_LFG_CT_FAST_PAIR(uint32_equal_impl, uint32_t, expected == actual)
+_LFG_CT_FAST_PAIR(uint32_not_equal_impl, uint32_t, expected != actual)
+_LFG_CT_FAST_PAIR(uint64_equal_impl, uint64_t, expected == actual)
+_LFG_CT_FAST_PAIR(uint64_not_equal_impl, uint64_t, expected != actual)
+_LFG_CT_FAST_PAIR(ptr_equal_impl, void *, expected == actual)
+_LFG_CT_FAST_PAIR(ptr_not_equal_impl, void *, expected != actual)
+
+_LFG_CT_FAST_CMP(greater_than_impl, a > b)
+_LFG_CT_FAST_CMP(less_than_impl, a < b)
+_LFG_CT_FAST_CMP(greater_or_equal_impl, a >= b)
+_LFG_CT_FAST_CMP(less_or_equal_impl, a <= b)
+
+_LFG_CT_FAST_BITS(bit_set_impl, val & (1u << bits))
+_LFG_CT_FAST_BITS(bit_clear_impl, !(val & (1u << bits)))
+_LFG_CT_FAST_BITS(bits_set_impl, (val & bits) == bits)
+_LFG_CT_FAST_BITS(bits_clear_impl, !(val & bits))
+
+#endif /* LFG_CTEST_INLINE_ASSERTS */
+
+/*============================================================================
+ *  Self-Test API (internal only - requires LFG_CTEST_SELF_TEST)
+ *
+ *  These functions enable "expect failures" mode for testing the framework
+ *  itself. Assertion failures during this mode are counted but don't affect
+ *  the final test result. This allows the framework's own tests to verify
+ *  that assertions correctly detect failures while still passing.
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_SELF_TEST
+
+/** Begin expect-failures mode. Assertion failures will be counted but won't
+ *  affect test results. Resets the expected failure counter.
+ */
+void lfg_ct_expect_failures_begin(void);
+
+/** End expect-failures mode and return the number of failures that occurred.
+ *  @return Number of assertion failures captured during expect-failures mode.
+ */
+int lfg_ct_expect_failures_end(void);
+
+/** Snapshot of the framework counters. */
+typedef struct
+{
+    int tests_executed;
+    int tests_failed;
+    int tests_passed;
+    int assertions_executed;
+    int assertions_failed;
+    int assertions_passed;
+    uint64_t tests_wall_ns; /* sum of per-test wall time */
+    uint64_t tests_cpu_ns;  /* sum of per-test CPU time */
+} lfg_ct_counts_t;
+
+/** Copy the current counters into @p counts, waiting for any parallel
+ *  workers first.
+ *  @param counts Destination for the counters.
+ */
+void lfg_ct_self_test_counts(lfg_ct_counts_t *counts);
+
+#endif /* LFG_CTEST_SELF_TEST */
+
+
+/* --- lfg-ctest-mock.h --- */
+/**
+ * @file
+ * @brief       lfg-ctest mocking helpers.
+ *
+ * Macro naming convention: {R|V}_{V|N}[_S]
+ *   First letter:  R = returns a value, V = void return
+ *   Second letter: V = void (no params), N = number of parameters (1-9)
+ *   _S suffix:     use ONLY when a parameter is a struct-by-value. Struct
+ *                  return types do NOT require _S -- the plain R_N variants
+ *                  handle struct returns and keep __param_actions available.
+ *                  _S drops __param_actions (mem/str read/write) because the
+ *                  parameter switch cannot cast struct-by-value through
+ *                  (void*)(size_t). For struct-by-value params, mock_param_mem_*
+ *                  would not help anyway (the mock receives a copy); read
+ *                  __param_history[i].pX.field directly instead.
+ * Examples:
+ *   DECLARE_MOCK_R_2 = returns value, 2 params (return may be a struct)
+ *   DECLARE_MOCK_V_V = void return, no params
+ *   DECLARE_MOCK_R_1_S = returns value, 1 struct-by-value param
+ */
+
+
+/*============================================================================
+ *  Includes
+ *==========================================================================*/
+
+#include <assert.h>
+
+
+/*============================================================================
+ *  Defines/Typedefs
+ *==========================================================================*/
+
+typedef void *mock_param_action_t;
+
+enum _mock_param_action_dir
+{
+    eMOCK_PARAM_ACTION_DIR_READ,
+    eMOCK_PARAM_ACTION_DIR_WRITE,
+    eMOCK_PARAM_ACTION_DIR_READ_STR,
+    eMOCK_PARAM_ACTION_DIR_WRITE_STR,
+    eMOCK_PARAM_ACTION_DIR_DIGEST,
+};
+
+struct _mock_param_action
+{
+    struct _mock_param_action *next; /* linked list member must be first */
+    enum _mock_param_action_dir dir;
+    unsigned call_index;
+    unsigned parameter_index;
+    void *buffer;
+    size_t buf_size;
+    struct _mock_param_action *next_for_call; /* next action with the same call_index (built by the index) */
+    struct _mock_param_action *last_for_call; /* first action of a call only: end of its next_for_call list */
+    struct _mock_param_chain *chain;          /* head node only: tail and call index */
+};
+
+struct _mock_param_slab;
+struct _mock_registration;
+
+/* Per-chain bookkeeping kept on the head node: O(1) append, and the actions
+ * grouped and sorted by call_index so a mock call finds its own in O(1) */
+struct _mock_param_chain
+{
+    struct _mock_param_action *tail;
+    struct _mock_param_slab *slabs;    /* node slabs owned by the chain, newest first */
+    struct _mock_param_action **calls; /* first action of each distinct call_index, ascending */
+    size_t calls_cap;
+    size_t ncalls;
+    struct _mock_param_action *indexed; /* last action merged into calls[], NULL before the first call */
+    size_t cursor;                      /* next calls[] entry, for the common ascending call sequence */
+};
+
+/** Treat parameter as memory and read bytes from it.
+ * This will instruct the mocked function to:
+ * - treat an incoming parameter at position @p paramidx as a pointer
+ * - copy @p buf_size bytes into @p buffer (capturing the data).
+ * - Do this only for @p callidx -th call of the mocked function.
+ * @param[in]  action   existing action chain to append to, or NULL to start new chain
+ * @param[in]  callidx  the call index (0-based) for this action
+ * @param[in]  paramidx the 0-based parameter position
+ * @param[out] buffer   destination to copy data into
+ * @param[in]  buf_size number of bytes to copy
+ * @return     the action chain (use this for subsequent calls or assign to __param_actions)
+ */
+mock_param_action_t mock_param_mem_read(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, void *buffer, size_t buf_size);
+
+/** Treat parameter as memory and write bytes to it.
+ * This will instruct the mocked function to:
+ * - treat an incoming parameter at position @p paramidx as a pointer
+ * - copy @p buf_size bytes from @p buffer into the parameter (injecting data).
+ * - Do this only for @p callidx -th call of the mocked function.
+ * @param[in]  action   existing action chain to append to, or NULL to start new chain
+ * @param[in]  callidx  the call index (0-based) for this action
+ * @param[in]  paramidx the 0-based parameter position
+ * @param[in]  buffer   source data to copy from
+ * @param[in]  buf_size number of bytes to copy
+ * @return     the action chain (use this for subsequent calls or assign to __param_actions)
+ */
+mock_param_action_t mock_param_mem_write(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, void *buffer, size_t buf_size);
+
+/** Treat parameter as a string and read (capture) it.
+ * Like mock_param_mem_read but uses snprintf instead of memcpy,
+ * so it stops at the null terminator and never reads past it.
+ * @param[in]  action   existing action chain to append to, or NULL to start new chain
+ * @param[in]  callidx  the call index (0-based) for this action
+ * @param[in]  paramidx the 0-based parameter position
+ * @param[out] buffer   destination to copy string into
+ * @param[in]  buf_size size of @p buffer (includes null terminator)
+ * @return     the action chain (use this for subsequent calls or assign to __param_actions)
+ */
+mock_param_action_t mock_param_str_read(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, char *buffer, size_t buf_size);
+
+/** Treat parameter as a string buffer and write (inject) into it.
+ * Like mock_param_mem_write but uses snprintf instead of memcpy,
+ * so it null-terminates and never writes past buf_size.
+ * @param[in]  action   existing action chain to append to, or NULL to start new chain
+ * @param[in]  callidx  the call index (0-based) for this action
+ * @param[in]  paramidx the 0-based parameter position
+ * @param[in]  buffer   source string to inject
+ * @param[in]  buf_size size of the destination parameter buffer
+ * @return     the action chain (use this for subsequent calls or assign to __param_actions)
+ */
+mock_param_action_t mock_param_str_write(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, const char *buffer, size_t buf_size);
+
+/** Treat parameter as memory and record only a digest of it.
+ * Like mock_param_mem_read, but instead of copying @p size bytes it stores
+ * their mock_digest() in @p digest, so large buffers (e.g. DMA frames) can
+ * be checked without keeping a copy. Compare with ASSERT_MEM_DIGEST().
+ * @param[in]  action   existing action chain to append to, or NULL to start new chain
+ * @param[in]  callidx  the call index (0-based) for this action
+ * @param[in]  paramidx the 0-based parameter position
+ * @param[out] digest   receives the digest of the pointed-to bytes
+ * @param[in]  size     number of bytes to hash
+ * @return     the action chain (use this for subsequent calls or assign to __param_actions)
+ */
+mock_param_action_t mock_param_mem_digest(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, uint64_t *digest, size_t size);
+
+/** 64-bit non-cryptographic digest of @p size bytes (the XXH64 algorithm, seed 0).
+ * Runs at memory bandwidth; equal digests mean equal bytes for test purposes.
+ */
+uint64_t mock_digest(const void *data, size_t size);
+
+/** Assert that @p _n bytes at @p _e hash to @p _digest (from mock_param_mem_digest) */
+#define ASSERT_MEM_DIGEST(_e, _n, _digest) ASSERT_UINT64_EQUAL(mock_digest((_e), (_n)), (_digest))
+
+/** Frees all linked parameter operations.
+ * The chain's node slabs go back to the mock runtime's pool in one step;
+ * mock_reset_all() returns the pool to the heap.
+ * @param[in] action    parameter action chain to destroy.
+ */
+void mock_param_destroy(mock_param_action_t action);
+
+/** First parameter action scheduled for a call, used by the mock bodies.
+ * Further actions for the same call follow through next_for_call, in the
+ * order they were appended.
+ * @param[in] reg         the calling mock's registry node
+ * @param[in] action      parameter action chain, or NULL
+ * @param[in] call_index  0-based call index of the mock
+ * @return    the first action for @p call_index, or NULL if there is none
+ */
+struct _mock_param_action *_mock_param_actions_for_call(
+        const struct _mock_registration *reg, mock_param_action_t action, size_t call_index);
+
+/* Intrusive registry node; each DEFINE_MOCK_* defines one as _func##__mock_reg */
+struct _mock_registration
+{
+    struct _mock_registration *next;
+    void (*reset_fn)(void);
+    bool registered;
+    const char *name;  /* mocked function name, for the call trace and statistics */
+    uint32_t trace_id; /* 0 until the mock first appears in the call trace */
+    size_t *call_count;
+    size_t storage_max; /* MOCK_CALL_STORAGE_MAX of the defining unit, 0 for dynamic storage */
+    bool storage_wraps; /* MOCK_CALL_STORAGE_RING: calls past storage_max overwrite the oldest */
+    bool thread_safe;   /* defined under MOCK_THREAD_SAFE; only then do its calls take the runtime lock */
+
+    /* statistics, kept across resets */
+    struct _mock_registration *stats_next;
+    bool stats_linked;
+    uint64_t total_calls; /* calls folded in by resets; the live __call_count is added on read */
+    size_t peak_calls;    /* highest __call_count seen at a reset */
+    uint64_t callback_calls;
+    uint64_t callback_ns;
+
+    /* call expectations */
+    int (*expect_cmp)(const void *expected, unsigned mask, const void *actual);
+    size_t params_size;                       /* sizeof the _params struct, 0 without parameters */
+    struct _mock_expectation *expect_cursor;  /* first expectation still able to match */
+    struct _mock_expectation *expect_tail;    /* NULL while the mock has no expectations */
+};
+
+/** Register a mock reset function for bulk reset.
+ * Called automatically by each mock on its first invocation since the last
+ * mock_reset_all(); the mock skips the call while @p reg is registered.
+ * @param[in] reg   the mock's registry node.
+ */
+void _mock_register(struct _mock_registration *reg);
+
+/** Reset all mocks that have been invoked since the last call to mock_reset_all().
+ * Iterates the auto-populated registry and calls each registered reset function,
+ * then clears the registry and releases the pooled param-action slabs.
+ */
+void mock_reset_all(void);
+
+/** Usage of one mock since the start of the run, across resets. */
+typedef struct
+{
+    const char *name;
+    uint64_t total_calls;    /**< every call, including those since the last reset */
+    size_t peak_calls;       /**< highest __call_count reached between resets */
+    size_t storage_max;      /**< MOCK_CALL_STORAGE_MAX of the defining unit, 0 for dynamic storage */
+    bool storage_wraps;      /**< ring storage, so peak_calls may exceed storage_max */
+    uint64_t callback_calls; /**< calls that ran the user __callback, while mock_stats_set_report() is on */
+    uint64_t callback_ns;    /**< wall time spent inside the user __callback, likewise */
+} mock_stats_t;
+
+/** Statistics of the mock named @p name.
+ * @param[in]  name  mocked function name
+ * @param[out] out   filled in when the mock is known
+ * @return     true if the mock has been called at least once
+ */
+bool mock_stats_get(const char *name, mock_stats_t *out);
+
+/** Have lfg_ct_print_summary() list the top @p n mocks in each statistics
+ * table (busiest by peak storage use, slowest by callback time). The tables
+ * follow the result line. Off (0) by default. Callback calls and time are
+ * only collected while this is on.
+ */
+void mock_stats_set_report(unsigned n);
+
+/** Print the statistics tables for the top @p n mocks to @p fp. */
+void mock_stats_print(FILE *fp, unsigned n);
+
+/* Monotonic clock for the statistics and call trace */
+uint64_t _mock_now_ns(void);
+
+/* Fold the live __call_count of @p reg into its statistics (called by __mock_reset) */
+void _mock_stats_fold(struct _mock_registration *reg);
+
+/* Account one user __callback that started at @p start_ns */
+void _mock_stats_callback(struct _mock_registration *reg, uint64_t start_ns);
+
+/* Set while mock_stats_set_report() is on; mock bodies only time callbacks then */
+extern bool _mock_stats_timing;
+
+/** Header at the start of a mock param stream file (64 bytes, native byte order) */
+typedef struct
+{
+    char magic[8];        /**< "LFGMPRM1" */
+    uint32_t version;     /**< 1 */
+    uint32_t record_size; /**< sizeof the mock's _params struct */
+    uint64_t count;       /**< records written; doubles as the append cursor */
+    char name[40];        /**< mocked function name, NUL-terminated (truncated if longer) */
+} mock_param_stream_header_t;
+
+/** Per-mock param stream state (see MOCK_PARAM_STREAM_OPEN) */
+typedef struct
+{
+    mock_param_stream_header_t *hdr; /**< mapped header, NULL while the stream is closed */
+    unsigned char *records;          /**< first record in the mapping */
+    uint64_t capacity;               /**< records the current mapping holds */
+    size_t record_size;
+    int fd;
+    size_t reserved; /**< bytes of address space held for the mapping to grow into */
+} mock_param_stream_t;
+
+/** Start appending every call's parameters of @p _func to the file at @p _path.
+ * The file is created or truncated and mapped with room for @p _capacity
+ * records; it doubles whenever it fills, in place inside an address range
+ * reserved at open, so threads calling a MOCK_THREAD_SAFE mock can keep
+ * writing while it grows. Each call costs one record store and a cursor
+ * increment in the mapping, with no heap use. Records past the reservation
+ * (MOCK_PARAM_STREAM_RESERVE) are dropped with a warning.
+ * The stream keeps recording across resets until MOCK_PARAM_STREAM_CLOSE().
+ * @return true on success, false if the file could not be mapped (always
+ *         false without LFG_CTEST_HAS_MMAP)
+ */
+#define MOCK_PARAM_STREAM_OPEN(_func, _path, _capacity)                                                                \
+    mock_param_stream_open(&_func##__param_stream, #_func, sizeof(_func##_params), _path, _capacity)
+
+/** Stop streaming @p _func, trimming the file to the records written. */
+#define MOCK_PARAM_STREAM_CLOSE(_func) mock_param_stream_close(&_func##__param_stream)
+
+/** Open a param stream; use MOCK_PARAM_STREAM_OPEN(). */
+bool mock_param_stream_open(
+        mock_param_stream_t *stream, const char *name, size_t record_size, const char *path, uint64_t capacity);
+
+/** Close a param stream; use MOCK_PARAM_STREAM_CLOSE(). Closing a closed stream is a no-op. */
+void mock_param_stream_close(mock_param_stream_t *stream);
+
+/** Read-only view of a param stream file */
+typedef struct
+{
+    const char *name;             /**< mocked function name from the header */
+    size_t record_size;
+    uint64_t count;               /**< records available */
+    const unsigned char *records;
+    void *map;
+    size_t map_size;
+} mock_param_reader_t;
+
+/** Map a param stream file for reading.
+ * Also reads files left behind by a process that died without closing the
+ * stream; the count in the header covers every record claimed before then.
+ * @return false if the file cannot be mapped or is not a param stream
+ */
+bool mock_param_reader_open(mock_param_reader_t *reader, const char *path);
+
+/** Record @p n (0 = first call streamed), or NULL if @p n >= reader->count. */
+const void *mock_param_reader_at(const mock_param_reader_t *reader, uint64_t n);
+
+/** Unmap a reader opened with mock_param_reader_open(). */
+void mock_param_reader_close(mock_param_reader_t *reader);
+
+/** Record @p _n of @p _reader as the _params struct of @p _func, or NULL */
+#define MOCK_PARAM_STREAM_AT(_func, _reader, _n) ((const _func##_params *)mock_param_reader_at(_reader, _n))
+
+/* Slow path of _MOCK_STREAM: grow the mapping until record @p n fits, then store it */
+void _mock_param_stream_put(mock_param_stream_t *stream, uint64_t n, const void *record);
+
+/** Handle of one call expectation (owned by the mock runtime) */
+typedef struct _mock_expectation *mock_expect_t;
+
+/** Custom argument matcher: return true if the call's @p params (a pointer to
+ * the mock's _params struct) are acceptable. */
+typedef bool (*mock_expect_match_fn)(const void *params, void *ctx);
+
+/** Expect @p _func to be called at least @p _min and at most @p _max times
+ * (MOCK_FOREVER for no limit), with any arguments until MOCK_EXPECT_ARG() or
+ * mock_expect_match() narrows them. Calls to a mock consume its expectations
+ * in declaration order, and each call is checked as it happens: a call that
+ * no expectation accepts fails at once, at the MOCK_EXPECT() line.
+ */
+#define MOCK_EXPECT(_func, _min, _max) _mock_expect_add(&_func##__mock_reg, _min, _max, __FILE__, __LINE__)
+
+/** Expect exactly one call to @p _func */
+#define MOCK_EXPECT_ONCE(_func) MOCK_EXPECT(_func, 1, 1)
+
+/** Require parameter @p _n (0-based) of calls matched by @p _exp to equal
+ * @p _value. Compared with == (bytewise for struct-safe mocks). */
+#define MOCK_EXPECT_ARG(_exp, _func, _n, _value) (((_func##_params *)_mock_expect_arg(_exp, _n))->p##_n = (_value))
+
+/** Add a custom matcher to @p exp, checked after any MOCK_EXPECT_ARG() values.
+ * @return @p exp
+ */
+mock_expect_t mock_expect_match(mock_expect_t exp, mock_expect_match_fn fn, void *ctx);
+
+/** Expectations created until mock_expect_sequence_end() form an ordered
+ * sequence across mocks: one may only match once every earlier one in the
+ * sequence has reached its minimum, and matching it retires the earlier ones.
+ */
+void mock_expect_sequence_begin(void);
+
+/** End the sequence started by mock_expect_sequence_begin(). */
+void mock_expect_sequence_end(void);
+
+/** Fail every expectation that has not reached its minimum (at its
+ * MOCK_EXPECT() line), then drop all expectations.
+ * @return number of unmet expectations
+ */
+int mock_expect_verify(void);
+
+/** Drop all expectations without checking them (mock_reset_all() does this too). */
+void mock_expect_reset(void);
+
+mock_expect_t _mock_expect_add(struct _mock_registration *reg, size_t min, size_t max, const char *file, int line);
+void *_mock_expect_arg(mock_expect_t exp, unsigned n);
+void _mock_expect_call(struct _mock_registration *reg, size_t call_index, const void *params);
+
+/** One call in the global mock call trace (32 bytes, written as-is by mock_trace_write()). */
+typedef struct
+{
+    uint64_t seq;          /**< global sequence number across all mocks, from 0 */
+    uint64_t timestamp_ns; /**< monotonic time of the call, or 0 when timestamps are off */
+    uint64_t call_index;   /**< the mock's own call index (its __call_count before the call) */
+    uint32_t mock_id;      /**< mock identifier, see mock_trace_name() */
+    uint32_t reserved;
+} mock_trace_record_t;
+
+/** "not found" result of mock_trace_find() */
+#define MOCK_TRACE_NONE ((size_t)-1)
+
+/** Start recording every mock call into a preallocated ring.
+ * Any previous trace is discarded. The ring keeps the most recent
+ * @p capacity calls (rounded up to a power of two).
+ * @param[in] capacity    number of records to keep
+ * @param[in] timestamps  also stamp each record with the monotonic clock
+ *                        (costs a clock read per call)
+ * @return    true on success, false if the ring could not be allocated
+ */
+bool mock_trace_start(size_t capacity, bool timestamps);
+
+/** Stop recording. The records stay available for queries until the next mock_trace_start(). */
+void mock_trace_stop(void);
+
+/** Drop all records, keeping the ring and the recording state. */
+void mock_trace_clear(void);
+
+/** Number of records currently held (at most the ring capacity). */
+size_t mock_trace_count(void);
+
+/** Record at position @p pos, 0 being the oldest held.
+ * @return the record, or NULL if @p pos >= mock_trace_count()
+ */
+const mock_trace_record_t *mock_trace_at(size_t pos);
+
+/** Name of the mock behind a record's mock_id, or NULL if unknown. */
+const char *mock_trace_name(uint32_t mock_id);
+
+/** Position of the first record for mock @p name at or after @p from.
+ * @param[in] name  mocked function name (without __mock)
+ * @param[in] from  first position to look at
+ * @return    the position, or MOCK_TRACE_NONE
+ */
+size_t mock_trace_find(const char *name, size_t from);
+
+/** True if @p first and @p then were both called and @p first was called first. */
+bool mock_trace_called_before(const char *first, const char *then);
+
+/** Identifier form of mock_trace_called_before(), e.g. MOCK_TRACE_BEFORE(spi_select, spi_write) */
+#define MOCK_TRACE_BEFORE(_first, _then) mock_trace_called_before(#_first, #_then)
+
+/** Write the held records and the mock names as a binary log (native byte order).
+ * Layout: "LFGMTRC1", uint32 version (1), uint32 record size, uint64 record
+ * count, uint32 name count, uint32 reserved; then per name (ids 1..n) a uint32
+ * length and the bytes; then the records, oldest first. Read it back with
+ * tools/mocktrace.c.
+ * @param[in] fp  stream opened for binary writing
+ * @return    0 on success, -1 on a write error
+ */
+int mock_trace_write(FILE *fp);
+
+/* Recording state checked by every mock body */
+extern bool _mock_trace_enabled;
+
+/** Append one record for a mock call, used by the mock bodies. */
+void _mock_trace_record(struct _mock_registration *reg, size_t call_index);
+
+/** Grow a dynamic mock storage block so that @p index is addressable.
+ * Used by MOCK_CALL_STORAGE_DYNAMIC mocks. The block at least doubles, new
+ * elements are zeroed, and running out of memory aborts with a message.
+ * @param[in]     data       current block, or NULL
+ * @param[in,out] cap        current capacity in elements, updated on return
+ * @param[in]     elem_size  size of one element in bytes
+ * @param[in]     index      element index that must become addressable
+ * @return        the (possibly moved) block
+ */
+void *_mock_grow(void *data, size_t *cap, size_t elem_size, size_t index);
+
+/** maximum number of return-program steps per R_* mock (override at compile time) */
+#ifndef MOCK_RETURN_PROGRAM_MAX
+#define MOCK_RETURN_PROGRAM_MAX 8
+#endif
+
+/** maximum number of function calls to store (override at compile time) */
+#ifndef MOCK_CALL_STORAGE_MAX
+#define MOCK_CALL_STORAGE_MAX 32
+#endif
+
+/** number of param-action nodes carved from each pooled slab */
+#ifndef MOCK_PARAM_SLAB_NODES
+#define MOCK_PARAM_SLAB_NODES 64
+#endif
+
+/*============================================================================
+ *  Thread-Safe Mocks
+ *
+ *  Defining MOCK_THREAD_SAFE before including this header lets the code under
+ *  test call every mock in the translation unit from several threads. A call
+ *  claims its index with one relaxed atomic fetch-add on __call_count, writes
+ *  its history slot without locking, and passes the claimed index to the
+ *  callback. First-call registration and param-action lookup take a short
+ *  lock inside the mock runtime. Read the history once the calling threads
+ *  have been joined, and do not reset a mock while threads still call it.
+ *  Needs LFG_CTEST_THREAD_SAFE; not available with MOCK_CALL_STORAGE_DYNAMIC,
+ *  whose blocks move when they grow.
+ *==========================================================================*/
+
+#ifdef MOCK_THREAD_SAFE
+
+#ifndef LFG_CTEST_THREAD_SAFE
+#error "MOCK_THREAD_SAFE needs lfg-ctest built with LFG_CTEST_THREAD_SAFE"
+#endif
+#ifdef MOCK_CALL_STORAGE_DYNAMIC
+#error "MOCK_THREAD_SAFE cannot be combined with MOCK_CALL_STORAGE_DYNAMIC"
+#endif
+
+#define _MOCK_CALL_CLAIM(_func) __atomic_fetch_add(&_func##__call_count, 1, __ATOMIC_RELAXED)
+#define _MOCK_CALL_DONE(_func)
+#define _MOCK_REGISTERED(_reg) __atomic_load_n(&(_reg).registered, __ATOMIC_ACQUIRE)
+#define _MOCK_TRACING() __atomic_load_n(&_mock_trace_enabled, __ATOMIC_RELAXED)
+#define _MOCK_STREAM_CLAIM(_s) __atomic_fetch_add(&(_s).hdr->count, 1, __ATOMIC_RELAXED)
+#define _MOCK_STREAM_CAPACITY(_s) __atomic_load_n(&(_s).capacity, __ATOMIC_ACQUIRE)
+#define _MOCK_REG_THREAD_SAFE true
+
+#else
+
+#define _MOCK_CALL_CLAIM(_func) _func##__call_count
+#define _MOCK_CALL_DONE(_func) _func##__call_count++;
+#define _MOCK_REGISTERED(_reg) ((_reg).registered)
+#define _MOCK_TRACING() _mock_trace_enabled
+#define _MOCK_STREAM_CLAIM(_s) ((_s).hdr->count++)
+#define _MOCK_STREAM_CAPACITY(_s) ((_s).capacity)
+#define _MOCK_REG_THREAD_SAFE false
+
+#endif /* MOCK_THREAD_SAFE */
+
+/*============================================================================
+ *  Call Storage
+ *
+ *  By default each mock owns fixed __param_history[MOCK_CALL_STORAGE_MAX] and
+ *  __return_queue[MOCK_CALL_STORAGE_MAX] arrays, and exceeding them aborts.
+ *
+ *  Defining MOCK_CALL_STORAGE_DYNAMIC before including this header switches
+ *  every mock in the translation unit to heap blocks that grow on demand
+ *  (doubling, so appends are amortized O(1)). __param_history and
+ *  __return_queue become pointers, so history[i] still reads for any i below
+ *  __call_count; prime the return queue through MOCK_RETURN_QUEUE(), which
+ *  grows the block first. Reset zeroes the blocks but keeps their capacity.
+ *
+ *  Defining MOCK_CALL_STORAGE_RING instead keeps the fixed arrays but uses
+ *  them as rings for soak tests: __call_count grows without bound, call i
+ *  lands in slot i % MOCK_CALL_STORAGE_MAX, and only the most recent
+ *  MOCK_CALL_STORAGE_MAX calls are retained. Primed return values repeat with
+ *  the same period. Address calls by their logical index through
+ *  MOCK_PARAM_HISTORY() / MOCK_RETURN_QUEUE(). A power-of-two
+ *  MOCK_CALL_STORAGE_MAX turns the wrap into a mask.
+ *
+ *  Only the mock writes __param_history, so each mock tracks the high-water
+ *  slot it has written and reset clears just that prefix. The fixed return
+ *  queue may be primed by direct stores from the test, which cannot be
+ *  tracked, so reset clears all of it. A unit that defines
+ *  MOCK_RETURN_QUEUE_TRACKED promises to prime only through
+ *  MOCK_RETURN_QUEUE(), which then raises a high-water mark of its own, and
+ *  reset clears just that prefix of the queue as well.
+ *
+ *  The DECLARE and DEFINE of a mock must agree on the mode.
+ *==========================================================================*/
+
+#if defined(MOCK_CALL_STORAGE_DYNAMIC) && defined(MOCK_CALL_STORAGE_RING)
+#error "MOCK_CALL_STORAGE_DYNAMIC and MOCK_CALL_STORAGE_RING are mutually exclusive"
+#endif
+
+#ifdef MOCK_THREAD_SAFE
+/* Concurrent calls would race on the mark; reset derives it from the claimed count instead */
+#define _MOCK_HW_MARK(_hw, _s) ((void)0)
+#define _MOCK_HISTORY_HW_SYNC(_func)                                                                                   \
+    _func##__param_history_hw =                                                                                        \
+            _func##__call_count < MOCK_CALL_STORAGE_MAX ? _func##__call_count : MOCK_CALL_STORAGE_MAX;
+#else
+/* Raise a high-water mark to cover slot @p _s */
+#define _MOCK_HW_MARK(_hw, _s) ((_s) >= (_hw) ? ((_hw) = (_s) + 1) : 0)
+#define _MOCK_HISTORY_HW_SYNC(_func)
+#endif
+
+/* The return queue is primed from the test thread, so its mark is kept even under MOCK_THREAD_SAFE */
+#define _MOCK_QUEUE_HW_MARK(_hw, _s) ((_s) >= (_hw) ? ((_hw) = (_s) + 1) : 0)
+
+#ifdef MOCK_CALL_STORAGE_DYNAMIC
+
+#define _MOCK_HISTORY_DECL(_func)                                                                                      \
+    extern _func##_params *_func##__param_history;                                                                     \
+    extern size_t _func##__param_history_cap;                                                                          \
+    _func##_params *_func##__param_history_at(size_t i);
+
+#define _MOCK_HISTORY_DEF(_func)                                                                                       \
+    _func##_params *_func##__param_history = NULL;                                                                     \
+    size_t _func##__param_history_cap = 0;                                                                             \
+    static size_t _func##__param_history_hw = 0;                                                                       \
+    _func##_params *_func##__param_history_at(size_t i)                                                                \
+    {                                                                                                                  \
+        if (i >= _func##__param_history_cap)                                                                           \
+        {                                                                                                              \
+            _func##__param_history = (_func##_params *)_mock_grow(                                                     \
+                    _func##__param_history, &_func##__param_history_cap, sizeof(_func##_params), i);                   \
+        }                                                                                                              \
+        return &_func##__param_history[i];                                                                             \
+    }
+
+#define _MOCK_QUEUE_STORAGE_DECL(_func, _rtype)                                                                        \
+    extern _rtype *_func##__return_queue;                                                                              \
+    extern size_t _func##__return_queue_cap;                                                                           \
+    _rtype *_func##__return_queue_at(size_t i);                                                                        \
+    _rtype _func##__return_queue_get(size_t i);
+
+#define _MOCK_QUEUE_STORAGE_DEF(_func, _rtype)                                                                         \
+    _rtype *_func##__return_queue = NULL;                                                                              \
+    size_t _func##__return_queue_cap = 0;                                                                              \
+    _rtype *_func##__return_queue_at(size_t i)                                                                         \
+    {                                                                                                                  \
+        if (i >= _func##__return_queue_cap)                                                                            \
+        {                                                                                                              \
+            _func##__return_queue = (_rtype *)_mock_grow(                                                              \
+                    _func##__return_queue, &_func##__return_queue_cap, sizeof(_rtype), i);                             \
+        }                                                                                                              \
+        return &_func##__return_queue[i];                                                                              \
+    }                                                                                                                  \
+    _rtype _func##__return_queue_get(size_t i)                                                                         \
+    {                                                                                                                  \
+        _rtype unprimed;                                                                                               \
+        if (i < _func##__return_queue_cap)                                                                             \
+        {                                                                                                              \
+            return _func##__return_queue[i];                                                                           \
+        }                                                                                                              \
+        memset(&unprimed, 0, sizeof(unprimed));                                                                        \
+        return unprimed;                                                                                               \
+    }
+
+/* Unprimed calls read zero without growing the return queue */
+#define _MOCK_HISTORY_SLOT(_func, _i) (_MOCK_HW_MARK(_func##__param_history_hw, _i), _func##__param_history_at(_i))
+#define _MOCK_QUEUE_STORAGE_LOAD(_func, _i) _func##__return_queue_get(_i)
+
+#define _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+    if (_func##__param_history_hw)                                                                                     \
+    {                                                                                                                  \
+        memset(_func##__param_history, 0, _func##__param_history_hw * sizeof(*_func##__param_history));                \
+        _func##__param_history_hw = 0;                                                                                 \
+    }
+
+#define _MOCK_QUEUE_STORAGE_CLEAR(_func)                                                                               \
+    if (_func##__return_queue)                                                                                         \
+    {                                                                                                                  \
+        memset(_func##__return_queue, 0, _func##__return_queue_cap * sizeof(*_func##__return_queue));                  \
+    }
+
+/* Storage grows instead of overflowing */
+#define _MOCK_OVERFLOW_CHECK(_func)
+
+/* Capacity reported by the mock statistics, 0 for unbounded */
+#define _MOCK_STORAGE_CAPACITY 0
+#define _MOCK_STORAGE_WRAPS false
+
+/** Param history entry @p _i of @p _func (a zeroed entry past __call_count) */
+#define MOCK_PARAM_HISTORY(_func, _i) (*_func##__param_history_at(_i))
+
+/** Return queue slot @p _i of @p _func, as an lvalue (grows the queue) */
+#define MOCK_RETURN_QUEUE(_func, _i) (*_func##__return_queue_at(_i))
+
+#else /* fixed MOCK_CALL_STORAGE_MAX arrays, optionally used as rings */
+
+#define _MOCK_STORAGE_CAPACITY MOCK_CALL_STORAGE_MAX
+#ifdef MOCK_CALL_STORAGE_RING
+#define _MOCK_STORAGE_WRAPS true
+#else
+#define _MOCK_STORAGE_WRAPS false
+#endif
+
+#define _MOCK_HISTORY_DECL(_func) extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];
+#define _MOCK_HISTORY_DEF(_func)                                                                                       \
+    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    static size_t _func##__param_history_hw = 0;
+#ifdef MOCK_RETURN_QUEUE_TRACKED
+#define _MOCK_QUEUE_STORAGE_DECL(_func, _rtype)                                                                        \
+    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _rtype *_func##__return_queue_at(size_t s);
+#define _MOCK_QUEUE_STORAGE_DEF(_func, _rtype)                                                                         \
+    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    static size_t _func##__return_queue_hw = 0;                                                                        \
+    _rtype *_func##__return_queue_at(size_t s)                                                                         \
+    {                                                                                                                  \
+        _MOCK_QUEUE_HW_MARK(_func##__return_queue_hw, s);                                                              \
+        return &_func##__return_queue[s];                                                                              \
+    }
+#define _MOCK_QUEUE_STORAGE_CLEAR(_func)                                                                               \
+    memset(_func##__return_queue, 0, _func##__return_queue_hw * sizeof(_func##__return_queue[0]));                     \
+    _func##__return_queue_hw = 0;
+/* Slot @p _s of the return queue as an lvalue, covered by the priming mark */
+#define _MOCK_QUEUE_PRIME(_func, _s) (*_func##__return_queue_at(_s))
+#else
+#define _MOCK_QUEUE_STORAGE_DECL(_func, _rtype) extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];
+#define _MOCK_QUEUE_STORAGE_DEF(_func, _rtype) _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];
+#define _MOCK_QUEUE_STORAGE_CLEAR(_func) memset(_func##__return_queue, 0, sizeof(_func##__return_queue));
+#define _MOCK_QUEUE_PRIME(_func, _s) (_func##__return_queue[_s])
+#endif
+
+#define _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+    _MOCK_HISTORY_HW_SYNC(_func)                                                                                       \
+    memset(_func##__param_history, 0, _func##__param_history_hw * sizeof(_func##__param_history[0]));                  \
+    _func##__param_history_hw = 0;
+
+#ifdef MOCK_CALL_STORAGE_RING
+
+/** Slot holding logical call index @p _i */
+#define MOCK_RING_SLOT(_i) ((size_t)(_i) % MOCK_CALL_STORAGE_MAX)
+
+#define _MOCK_HISTORY_SLOT(_func, _i)                                                                                  \
+    (_MOCK_HW_MARK(_func##__param_history_hw, MOCK_RING_SLOT(_i)), &_func##__param_history[MOCK_RING_SLOT(_i)])
+#define _MOCK_QUEUE_STORAGE_LOAD(_func, _i) (_func##__return_queue[MOCK_RING_SLOT(_i)])
+
+/* Rings wrap instead of overflowing */
+#define _MOCK_OVERFLOW_CHECK(_func)
+
+/** Param history entry for logical call @p _i of @p _func (valid for the last MOCK_CALL_STORAGE_MAX calls) */
+#define MOCK_PARAM_HISTORY(_func, _i) (_func##__param_history[MOCK_RING_SLOT(_i)])
+
+/** Return queue slot serving logical call @p _i of @p _func, as an lvalue */
+#define MOCK_RETURN_QUEUE(_func, _i) _MOCK_QUEUE_PRIME(_func, MOCK_RING_SLOT(_i))
+
+#else
+
+#define _MOCK_HISTORY_SLOT(_func, _i) (_MOCK_HW_MARK(_func##__param_history_hw, _i), &_func##__param_history[_i])
+#define _MOCK_QUEUE_STORAGE_LOAD(_func, _i) (_func##__return_queue[_i])
+
+/* Overflow check - aborts immediately if call limit exceeded */
+#define _MOCK_OVERFLOW_CHECK(_func)                                                                                    \
+    if (i >= MOCK_CALL_STORAGE_MAX)                                                                                    \
+    {                                                                                                                  \
+        fprintf(stderr, "MOCK OVERFLOW: %s exceeded %d calls\n", #_func, MOCK_CALL_STORAGE_MAX);                       \
+        lfg_ct_report_flush();                                                                                         \
+        assert(0 && "mock call storage exceeded");                                                                     \
+    }
+
+/** Param history entry @p _i of @p _func */
+#define MOCK_PARAM_HISTORY(_func, _i) (_func##__param_history[_i])
+
+/** Return queue slot @p _i of @p _func, as an lvalue */
+#define MOCK_RETURN_QUEUE(_func, _i) _MOCK_QUEUE_PRIME(_func, _i)
+
+#endif /* MOCK_CALL_STORAGE_RING */
+
+#endif /* MOCK_CALL_STORAGE_DYNAMIC */
+
+/*============================================================================
+ *  Return Programs
+ *
+ *  An R_* mock can be given a short program of steps instead of (or before)
+ *  a primed return queue. Each step starts where the previous one ends, or at
+ *  the call count when it is added if the previous one is already over:
+ *
+ *    MOCK_RETURNS_REPEAT(f, v, n)          return v for the next n calls
+ *    MOCK_RETURNS_CYCLE(f, vals, len, n)   return vals[0..len-1] round-robin
+ *    MOCK_RETURNS_FN(f, fn, n)             return fn(k), k = 0.. within the step
+ *    MOCK_RETURNS_DEFAULT(f, v)            return v from here on
+ *
+ *  n may be MOCK_FOREVER. Once the steps are used up the return queue is read
+ *  as before. Each call scans at most MOCK_RETURN_PROGRAM_MAX steps, so setup
+ *  and per-call cost are constant however many calls a step covers. Pair with
+ *  MOCK_CALL_STORAGE_RING for runs longer than MOCK_CALL_STORAGE_MAX, since
+ *  the param history is still recorded. Reset clears the program.
+ *==========================================================================*/
+
+/** Step length that never ends */
+#define MOCK_FOREVER ((size_t)-1)
+
+enum _mock_returns_kind
+{
+    eMOCK_RETURNS_VALUE,
+    eMOCK_RETURNS_CYCLE,
+    eMOCK_RETURNS_FN,
+};
+
+#define _MOCK_PROGRAM_DECL(_func, _rtype)                                                                              \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        enum _mock_returns_kind kind;                                                                                  \
+        size_t begin;                                                                                                  \
+        size_t end;                                                                                                    \
+        _rtype value;                                                                                                  \
+        const _rtype *values;                                                                                          \
+        size_t nvalues;                                                                                                \
+        _rtype (*fn)(size_t);                                                                                          \
+    } _func##__return_step_t;                                                                                          \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        size_t nsteps;                                                                                                 \
+        _func##__return_step_t steps[MOCK_RETURN_PROGRAM_MAX];                                                         \
+    } _func##__return_program_t;                                                                                       \
+    extern _func##__return_program_t _func##__return_program;                                                          \
+    void _func##__returns_add(enum _mock_returns_kind kind,                                                            \
+            size_t n,                                                                                                  \
+            const _rtype *value,                                                                                       \
+            const _rtype *values,                                                                                      \
+            size_t nvalues,                                                                                            \
+            _rtype (*fn)(size_t));                                                                                     \
+    _rtype _func##__returns_eval(size_t i);
+
+#define _MOCK_PROGRAM_DEF(_func, _rtype)                                                                               \
+    _func##__return_program_t _func##__return_program;                                                                 \
+    void _func##__returns_add(enum _mock_returns_kind kind,                                                            \
+            size_t n,                                                                                                  \
+            const _rtype *value,                                                                                       \
+            const _rtype *values,                                                                                      \
+            size_t nvalues,                                                                                            \
+            _rtype (*fn)(size_t))                                                                                      \
+    {                                                                                                                  \
+        _func##__return_program_t *prog = &_func##__return_program;                                                    \
+        _func##__return_step_t *step = &prog->steps[prog->nsteps];                                                     \
+        size_t begin = _func##__call_count;                                                                            \
+        const char *why = NULL;                                                                                        \
+        if (prog->nsteps && prog->steps[prog->nsteps - 1].end > begin)                                                 \
+        {                                                                                                              \
+            begin = prog->steps[prog->nsteps - 1].end;                                                                 \
+        }                                                                                                              \
+        if (prog->nsteps >= MOCK_RETURN_PROGRAM_MAX)                                                                   \
+        {                                                                                                              \
+            why = "over MOCK_RETURN_PROGRAM_MAX";                                                                      \
+        }                                                                                                              \
+        else if (begin == MOCK_FOREVER)                                                                                \
+        {                                                                                                              \
+            why = "unreachable";                                                                                       \
+        }                                                                                                              \
+        else if (eMOCK_RETURNS_CYCLE == kind && (!values || 0 == nvalues))                                             \
+        {                                                                                                              \
+            why = "a cycle without values";                                                                            \
+        }                                                                                                              \
+        else if (eMOCK_RETURNS_FN == kind && !fn)                                                                      \
+        {                                                                                                              \
+            why = "missing its function";                                                                              \
+        }                                                                                                              \
+        if (why)                                                                                                       \
+        {                                                                                                              \
+            fprintf(stderr, "MOCK RETURN PROGRAM: %s step %lu is %s\n", #_func, (unsigned long)prog->nsteps, why);     \
+            lfg_ct_report_flush();                                                                                     \
+            assert(0 && "mock return program step rejected");                                                          \
+            return;                                                                                                    \
+        }                                                                                                              \
+        memset(step, 0, sizeof(*step));                                                                                \
+        step->kind = kind;                                                                                             \
+        step->begin = begin;                                                                                           \
+        step->end = (n == MOCK_FOREVER || n > MOCK_FOREVER - begin) ? MOCK_FOREVER : begin + n;                        \
+        if (value)                                                                                                     \
+        {                                                                                                              \
+            step->value = *value;                                                                                      \
+        }                                                                                                              \
+        step->values = values;                                                                                         \
+        step->nvalues = nvalues;                                                                                       \
+        step->fn = fn;                                                                                                 \
+        prog->nsteps++;                                                                                                \
+    }                                                                                                                  \
+    _rtype _func##__returns_eval(size_t i)                                                                             \
+    {                                                                                                                  \
+        const _func##__return_program_t *prog = &_func##__return_program;                                              \
+        size_t s;                                                                                                      \
+        for (s = 0; s < prog->nsteps; s++)                                                                             \
+        {                                                                                                              \
+            const _func##__return_step_t *step = &prog->steps[s];                                                      \
+            if (i < step->begin || i >= step->end)                                                                     \
+            {                                                                                                          \
+                continue;                                                                                              \
+            }                                                                                                          \
+            if (eMOCK_RETURNS_CYCLE == step->kind)                                                                     \
+            {                                                                                                          \
+                return step->values[(i - step->begin) % step->nvalues];                                                \
+            }                                                                                                          \
+            if (eMOCK_RETURNS_FN == step->kind)                                                                        \
+            {                                                                                                          \
+                return step->fn(i - step->begin);                                                                      \
+            }                                                                                                          \
+            return step->value;                                                                                        \
+        }                                                                                                              \
+        return _MOCK_QUEUE_STORAGE_LOAD(_func, i);                                                                     \
+    }
+
+/* The R_* bodies see the program through the return queue helpers */
+#define _MOCK_QUEUE_DECL(_func, _rtype) _MOCK_QUEUE_STORAGE_DECL(_func, _rtype) _MOCK_PROGRAM_DECL(_func, _rtype)
+#define _MOCK_QUEUE_DEF(_func, _rtype) _MOCK_QUEUE_STORAGE_DEF(_func, _rtype) _MOCK_PROGRAM_DEF(_func, _rtype)
+#define _MOCK_QUEUE_LOAD(_func, _i)                                                                                    \
+    (_func##__return_program.nsteps ? _func##__returns_eval(_i) : _MOCK_QUEUE_STORAGE_LOAD(_func, _i))
+#define _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+    _MOCK_QUEUE_STORAGE_CLEAR(_func)                                                                                   \
+    _func##__return_program.nsteps = 0;
+
+/** Return @p _value from @p _func for the next @p _n calls */
+#define MOCK_RETURNS_REPEAT(_func, _value, _n)                                                                         \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        _func##__return_step_t _mock_step;                                                                             \
+        _mock_step.value = (_value);                                                                                   \
+        _func##__returns_add(eMOCK_RETURNS_VALUE, (_n), &_mock_step.value, NULL, 0, NULL);                             \
+    } while (0)
+
+/** Return @p _value from @p _func on every further call */
+#define MOCK_RETURNS_DEFAULT(_func, _value) MOCK_RETURNS_REPEAT(_func, _value, MOCK_FOREVER)
+
+/** Return @p _values[0 .. @p _len - 1] round-robin for the next @p _n calls (the array must outlive them) */
+#define MOCK_RETURNS_CYCLE(_func, _values, _len, _n)                                                                   \
+    _func##__returns_add(eMOCK_RETURNS_CYCLE, (_n), NULL, (_values), (_len), NULL)
+
+/** Return @p _fn(k) for the next @p _n calls, k counting from 0 within the step */
+#define MOCK_RETURNS_FN(_func, _fn, _n) _func##__returns_add(eMOCK_RETURNS_FN, (_n), NULL, NULL, 0, (_fn))
+
+/*============================================================================
+ *  Internal Helper Macros
+ *==========================================================================*/
+
+/* Append the params just stored at p to the mock's param stream, if one is open */
+#define _MOCK_STREAM(_func)                                                                                            \
+    if (_func##__param_stream.hdr)                                                                                     \
+    {                                                                                                                  \
+        uint64_t _mock_n = _MOCK_STREAM_CLAIM(_func##__param_stream);                                                  \
+        if (_mock_n < _MOCK_STREAM_CAPACITY(_func##__param_stream))                                                    \
+        {                                                                                                              \
+            ((_func##_params *)_func##__param_stream.records)[_mock_n] = *p;                                           \
+        }                                                                                                              \
+        else                                                                                                           \
+        {                                                                                                              \
+            _mock_param_stream_put(&_func##__param_stream, _mock_n, p);                                                \
+        }                                                                                                              \
+    }
+
+/* Registry node of @p _func, defined next to its call counter */
+#define _MOCK_REG_DEF(_func, _cmp, _params_size)                                                                       \
+    struct _mock_registration _func##__mock_reg = {NULL, _func##__mock_reset, false, #_func, 0, &_func##__call_count,  \
+            _MOCK_STORAGE_CAPACITY, _MOCK_STORAGE_WRAPS, _MOCK_REG_THREAD_SAFE, NULL, false, 0, 0, 0, 0, _cmp,         \
+            _params_size, NULL, NULL};
+#define _MOCK_REG_DECL(_func) extern struct _mock_registration _func##__mock_reg;
+
+/* Expectation argument comparators: _MOCK_EXPECT_FIELDS_n(_f) applies _f to p0..p(n-1) */
+#define _MOCK_EXPECT_EQ(_n)                                                                                            \
+    if ((mask & (1u << (_n))) && !(e->p##_n == a->p##_n))                                                              \
+    {                                                                                                                  \
+        return _n;                                                                                                     \
+    }
+#define _MOCK_EXPECT_EQ_S(_n)                                                                                          \
+    if ((mask & (1u << (_n))) && 0 != memcmp(&e->p##_n, &a->p##_n, sizeof(e->p##_n)))                                  \
+    {                                                                                                                  \
+        return _n;                                                                                                     \
+    }
+#define _MOCK_EXPECT_FIELDS_1(_f) _f(0)
+#define _MOCK_EXPECT_FIELDS_2(_f) _MOCK_EXPECT_FIELDS_1(_f) _f(1)
+#define _MOCK_EXPECT_FIELDS_3(_f) _MOCK_EXPECT_FIELDS_2(_f) _f(2)
+#define _MOCK_EXPECT_FIELDS_4(_f) _MOCK_EXPECT_FIELDS_3(_f) _f(3)
+#define _MOCK_EXPECT_FIELDS_5(_f) _MOCK_EXPECT_FIELDS_4(_f) _f(4)
+#define _MOCK_EXPECT_FIELDS_6(_f) _MOCK_EXPECT_FIELDS_5(_f) _f(5)
+#define _MOCK_EXPECT_FIELDS_7(_f) _MOCK_EXPECT_FIELDS_6(_f) _f(6)
+#define _MOCK_EXPECT_FIELDS_8(_f) _MOCK_EXPECT_FIELDS_7(_f) _f(7)
+#define _MOCK_EXPECT_FIELDS_9(_f) _MOCK_EXPECT_FIELDS_8(_f) _f(8)
+
+/* Comparator of @p _func: index of the first masked parameter that differs, or -1 */
+#define _MOCK_EXPECT_CMP_DEF(_func, _fields)                                                                           \
+    static int _func##__expect_cmp(const void *expected, unsigned mask, const void *actual)                            \
+    {                                                                                                                  \
+        const _func##_params *e = (const _func##_params *)expected;                                                    \
+        const _func##_params *a = (const _func##_params *)actual;                                                      \
+        _fields                                                                                                        \
+        return -1;                                                                                                     \
+    }
+
+/* Match the call against the mock's expectations, if it has any */
+#define _MOCK_EXPECT_CHECK(_func, _params)                                                                             \
+    if (_func##__mock_reg.expect_tail)                                                                                 \
+    {                                                                                                                  \
+        _mock_expect_call(&_func##__mock_reg, i, _params);                                                             \
+    }
+
+/* Auto-register mock reset function on first invocation, and feed the call trace */
+#define _MOCK_REGISTER(_func)                                                                                          \
+    if (!_MOCK_REGISTERED(_func##__mock_reg))                                                                          \
+    {                                                                                                                  \
+        _mock_register(&_func##__mock_reg);                                                                            \
+    }                                                                                                                  \
+    if (_MOCK_TRACING())                                                                                               \
+    {                                                                                                                  \
+        _mock_trace_record(&_func##__mock_reg, i);                                                                     \
+    }
+
+/* Switch case generators for parameter lookup */
+#define _MOCK_SWITCH_1                                                                                                 \
+    case 0:                                                                                                            \
+        pparam = (void *)(size_t)_p0;                                                                                  \
+        break;
+
+#define _MOCK_SWITCH_2                                                                                                 \
+    _MOCK_SWITCH_1                                                                                                     \
+    case 1:                                                                                                            \
+        pparam = (void *)(size_t)_p1;                                                                                  \
+        break;
+
+#define _MOCK_SWITCH_3                                                                                                 \
+    _MOCK_SWITCH_2                                                                                                     \
+    case 2:                                                                                                            \
+        pparam = (void *)(size_t)_p2;                                                                                  \
+        break;
+
+#define _MOCK_SWITCH_4                                                                                                 \
+    _MOCK_SWITCH_3                                                                                                     \
+    case 3:                                                                                                            \
+        pparam = (void *)(size_t)_p3;                                                                                  \
+        break;
+
+#define _MOCK_SWITCH_5                                                                                                 \
+    _MOCK_SWITCH_4                                                                                                     \
+    case 4:                                                                                                            \
+        pparam = (void *)(size_t)_p4;                                                                                  \
+        break;
+
+#define _MOCK_SWITCH_6                                                                                                 \
+    _MOCK_SWITCH_5                                                                                                     \
+    case 5:                                                                                                            \
+        pparam = (void *)(size_t)_p5;                                                                                  \
+        break;
+
+#define _MOCK_SWITCH_7                                                                                                 \
+    _MOCK_SWITCH_6                                                                                                     \
+    case 6:                                                                                                            \
+        pparam = (void *)(size_t)_p6;                                                                                  \
+        break;
+
+#define _MOCK_SWITCH_8                                                                                                 \
+    _MOCK_SWITCH_7                                                                                                     \
+    case 7:                                                                                                            \
+        pparam = (void *)(size_t)_p7;                                                                                  \
+        break;
+
+#define _MOCK_SWITCH_9                                                                                                 \
+    _MOCK_SWITCH_8                                                                                                     \
+    case 8:                                                                                                            \
+        pparam = (void *)(size_t)_p8;                                                                                  \
+        break;
+
+/* Parameter history storage */
+#define _MOCK_STORE_1 p->p0 = _p0;
+#define _MOCK_STORE_2 _MOCK_STORE_1 p->p1 = _p1;
+#define _MOCK_STORE_3 _MOCK_STORE_2 p->p2 = _p2;
+#define _MOCK_STORE_4 _MOCK_STORE_3 p->p3 = _p3;
+#define _MOCK_STORE_5 _MOCK_STORE_4 p->p4 = _p4;
+#define _MOCK_STORE_6 _MOCK_STORE_5 p->p5 = _p5;
+#define _MOCK_STORE_7 _MOCK_STORE_6 p->p6 = _p6;
+#define _MOCK_STORE_8 _MOCK_STORE_7 p->p7 = _p7;
+#define _MOCK_STORE_9 _MOCK_STORE_8 p->p8 = _p8;
+
+/* Action loop - processes param read/write actions */
+#define _MOCK_ACTION_LOOP(_func, _switch)                                                                              \
+    action = _mock_param_actions_for_call(&_func##__mock_reg, action, i);                                              \
+    while (action)                                                                                                     \
+    {                                                                                                                  \
+        void *pparam = NULL;                                                                                           \
+        switch (action->parameter_index)                                                                               \
+        {                                                                                                              \
+            _switch                                                                                                    \
+        }                                                                                                              \
+        if (eMOCK_PARAM_ACTION_DIR_READ == action->dir)                                                                \
+        {                                                                                                              \
+            memcpy(action->buffer, pparam, action->buf_size);                                                          \
+        }                                                                                                              \
+        else if (eMOCK_PARAM_ACTION_DIR_WRITE == action->dir)                                                          \
+        {                                                                                                              \
+            memcpy(pparam, action->buffer, action->buf_size);                                                          \
+        }                                                                                                              \
+        else if (eMOCK_PARAM_ACTION_DIR_READ_STR == action->dir)                                                       \
+        {                                                                                                              \
+            snprintf(action->buffer, action->buf_size, "%s", (const char *)pparam);                                    \
+        }                                                                                                              \
+        else if (eMOCK_PARAM_ACTION_DIR_WRITE_STR == action->dir)                                                      \
+        {                                                                                                              \
+            snprintf((char *)pparam, action->buf_size, "%s", (const char *)action->buffer);                            \
+        }                                                                                                              \
+        else if (eMOCK_PARAM_ACTION_DIR_DIGEST == action->dir)                                                         \
+        {                                                                                                              \
+            *(uint64_t *)action->buffer = mock_digest(pparam, action->buf_size);                                       \
+        }                                                                                                              \
+        else                                                                                                           \
+        {                                                                                                              \
+            assert(false);                                                                                             \
+        }                                                                                                              \
+        action = action->next_for_call;                                                                                \
+    }
+
+/* Callback invocation helpers.
+ * V-variant: void callback for V_* mocks (no return to control).
+ * R-variant: callback receives a pointer to the mock's local `ret` (already loaded
+ * from __return_queue[i]). Writing to *ret overrides the queue value for this
+ * call; not writing preserves it. Lets tests compute returns from per-call state
+ * (captured args, sequence position, external state map) without priming the
+ * queue, while side-effect-only callbacks need no explicit delegation. */
+
+#define _MOCK_CALLBACK_V_V(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i);                                                                                          \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_V_1(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, _p0);                                                                                     \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_V_2(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, _p0, _p1);                                                                                \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_V_3(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, _p0, _p1, _p2);                                                                           \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_V_4(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, _p0, _p1, _p2, _p3);                                                                      \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_V_5(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, _p0, _p1, _p2, _p3, _p4);                                                                 \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_V_6(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, _p0, _p1, _p2, _p3, _p4, _p5);                                                            \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_V_7(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, _p0, _p1, _p2, _p3, _p4, _p5, _p6);                                                       \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_V_8(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, _p0, _p1, _p2, _p3, _p4, _p5, _p6, _p7);                                                  \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_V_9(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, _p0, _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);                                             \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_V(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret);                                                                                    \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_1(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret, _p0);                                                                               \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_2(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret, _p0, _p1);                                                                          \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_3(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret, _p0, _p1, _p2);                                                                     \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_4(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret, _p0, _p1, _p2, _p3);                                                                \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_5(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4);                                                           \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_6(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4, _p5);                                                      \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_7(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4, _p5, _p6);                                                 \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_8(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4, _p5, _p6, _p7);                                            \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+#define _MOCK_CALLBACK_R_9(_func)                                                                                      \
+    if (_func##__callback)                                                                                             \
+    {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
+        _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);                                       \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
+    }
+
+/* Reset function for void-return mocks */
+#define _MOCK_RESET_V(_func)                                                                                           \
+    void _func##__mock_reset(void)                                                                                     \
+    {                                                                                                                  \
+        _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
+        _func##__call_count = 0;                                                                                       \
+        mock_param_destroy(_func##__param_actions);                                                                    \
+        _func##__param_actions = NULL;                                                                                 \
+        _func##__callback = NULL;                                                                                      \
+    }
+
+/* Reset function for returning mocks */
+#define _MOCK_RESET_R(_func)                                                                                           \
+    void _func##__mock_reset(void)                                                                                     \
+    {                                                                                                                  \
+        _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+        _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
+        _func##__call_count = 0;                                                                                       \
+        mock_param_destroy(_func##__param_actions);                                                                    \
+        _func##__param_actions = NULL;                                                                                 \
+        _func##__callback = NULL;                                                                                      \
+    }
+
+#define _MOCK_OVERFLOW_CHECK_V(_func) _MOCK_OVERFLOW_CHECK(_func)
+#define _MOCK_OVERFLOW_CHECK_R(_func, _rtype) _MOCK_OVERFLOW_CHECK(_func)
+
+/*============================================================================
+ *  Void Return, No Parameters (V_V)
+ *==========================================================================*/
+
+#define DECLARE_MOCK_V_V(_func)                                                                                        \
+    typedef void (*_func##__callback_t)(size_t);                                                                       \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    void _func##__mock(void);                                                                                          \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_V(_func)                                                                                         \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_REG_DEF(_func, NULL, 0)                                                                                      \
+    void _func##__mock(void)                                                                                           \
+    {                                                                                                                  \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        _MOCK_EXPECT_CHECK(_func, NULL)                                                                                \
+        _MOCK_CALLBACK_V_V(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    void _func##__mock_reset(void)                                                                                     \
+    {                                                                                                                  \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
+        _func##__call_count = 0;                                                                                       \
+        _func##__callback = NULL;                                                                                      \
+    }
+
+/*============================================================================
+ *  Returns Value, No Parameters (R_V)
+ *==========================================================================*/
+
+#define DECLARE_MOCK_R_V(_func, _rtype)                                                                                \
+    typedef void (*_func##__callback_t)(size_t, _rtype *);                                                             \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    _rtype _func##__mock(void);                                                                                        \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_V(_func, _rtype)                                                                                 \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_REG_DEF(_func, NULL, 0)                                                                                      \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    _rtype _func##__mock(void)                                                                                         \
+    {                                                                                                                  \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        _MOCK_EXPECT_CHECK(_func, NULL)                                                                                \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_CALLBACK_R_V(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    void _func##__mock_reset(void)                                                                                     \
+    {                                                                                                                  \
+        _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
+        _func##__call_count = 0;                                                                                       \
+        _func##__callback = NULL;                                                                                      \
+    }
+
+/*============================================================================
+ *  Void Return Mocks (V_1 through V_9)
+ *==========================================================================*/
+
+#define DECLARE_MOCK_V_1(_func, _t0)                                                                                   \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0);                                                                  \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    void _func##__mock(_t0);                                                                                           \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_1(_func, _t0)                                                                                    \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_1(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    void _func##__mock(_t0 _p0)                                                                                        \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_1                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_1)                                                                       \
+        _MOCK_CALLBACK_V_1(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V(_func)
+
+#define DECLARE_MOCK_V_2(_func, _t0, _t1)                                                                              \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1);                                                             \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    void _func##__mock(_t0, _t1);                                                                                      \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_2(_func, _t0, _t1)                                                                               \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_2(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    void _func##__mock(_t0 _p0, _t1 _p1)                                                                               \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_2                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_2)                                                                       \
+        _MOCK_CALLBACK_V_2(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V(_func)
+
+#define DECLARE_MOCK_V_3(_func, _t0, _t1, _t2)                                                                         \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2);                                                        \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    void _func##__mock(_t0, _t1, _t2);                                                                                 \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_3(_func, _t0, _t1, _t2)                                                                          \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_3(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2)                                                                      \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_3                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_3)                                                                       \
+        _MOCK_CALLBACK_V_3(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V(_func)
+
+#define DECLARE_MOCK_V_4(_func, _t0, _t1, _t2, _t3)                                                                    \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3);                                                   \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    void _func##__mock(_t0, _t1, _t2, _t3);                                                                            \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_4(_func, _t0, _t1, _t2, _t3)                                                                     \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_4(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3)                                                             \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_4                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_4)                                                                       \
+        _MOCK_CALLBACK_V_4(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V(_func)
+
+#define DECLARE_MOCK_V_5(_func, _t0, _t1, _t2, _t3, _t4)                                                               \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4);                                              \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    void _func##__mock(_t0, _t1, _t2, _t3, _t4);                                                                       \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_5(_func, _t0, _t1, _t2, _t3, _t4)                                                                \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_5(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4)                                                    \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_5                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_5)                                                                       \
+        _MOCK_CALLBACK_V_5(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V(_func)
+
+#define DECLARE_MOCK_V_6(_func, _t0, _t1, _t2, _t3, _t4, _t5)                                                          \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+        _t5 p5;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4, _t5);                                         \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    void _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5);                                                                  \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_6(_func, _t0, _t1, _t2, _t3, _t4, _t5)                                                           \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_6(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5)                                           \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_6                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_6)                                                                       \
+        _MOCK_CALLBACK_V_6(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V(_func)
+
+#define DECLARE_MOCK_V_7(_func, _t0, _t1, _t2, _t3, _t4, _t5, _t6)                                                     \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+        _t5 p5;                                                                                                        \
+        _t6 p6;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4, _t5, _t6);                                    \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    void _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6);                                                             \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_7(_func, _t0, _t1, _t2, _t3, _t4, _t5, _t6)                                                      \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_7(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6)                                  \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_7                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_7)                                                                       \
+        _MOCK_CALLBACK_V_7(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V(_func)
+
+#define DECLARE_MOCK_V_8(_func, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7)                                                \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+        _t5 p5;                                                                                                        \
+        _t6 p6;                                                                                                        \
+        _t7 p7;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7);                               \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    void _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7);                                                        \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_8(_func, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7)                                                 \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_8(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6, _t7 _p7)                         \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_8                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_8)                                                                       \
+        _MOCK_CALLBACK_V_8(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V(_func)
+
+#define DECLARE_MOCK_V_9(_func, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8)                                           \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+        _t5 p5;                                                                                                        \
+        _t6 p6;                                                                                                        \
+        _t7 p7;                                                                                                        \
+        _t8 p8;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8);                          \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    void _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8);                                                   \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_9(_func, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8)                                            \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_9(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6, _t7 _p7, _t8 _p8)                \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_9                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_9)                                                                       \
+        _MOCK_CALLBACK_V_9(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V(_func)
+
+/*============================================================================
+ *  Returning Mocks (R_1 through R_9)
+ *==========================================================================*/
+
+#define DECLARE_MOCK_R_1(_func, _rtype, _t0)                                                                           \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0);                                                        \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    _rtype _func##__mock(_t0);                                                                                         \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_1(_func, _rtype, _t0)                                                                            \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_1(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    _rtype _func##__mock(_t0 _p0)                                                                                      \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_1                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_1)                                                                       \
+        _MOCK_CALLBACK_R_1(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R(_func)
+
+#define DECLARE_MOCK_R_2(_func, _rtype, _t0, _t1)                                                                      \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1);                                                   \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    _rtype _func##__mock(_t0, _t1);                                                                                    \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_2(_func, _rtype, _t0, _t1)                                                                       \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_2(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1)                                                                             \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_2                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_2)                                                                       \
+        _MOCK_CALLBACK_R_2(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R(_func)
+
+#define DECLARE_MOCK_R_3(_func, _rtype, _t0, _t1, _t2)                                                                 \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2);                                              \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    _rtype _func##__mock(_t0, _t1, _t2);                                                                               \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_3(_func, _rtype, _t0, _t1, _t2)                                                                  \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_3(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2)                                                                    \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_3                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_3)                                                                       \
+        _MOCK_CALLBACK_R_3(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R(_func)
+
+#define DECLARE_MOCK_R_4(_func, _rtype, _t0, _t1, _t2, _t3)                                                            \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3);                                         \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    _rtype _func##__mock(_t0, _t1, _t2, _t3);                                                                          \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_4(_func, _rtype, _t0, _t1, _t2, _t3)                                                             \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_4(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3)                                                           \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_4                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_4)                                                                       \
+        _MOCK_CALLBACK_R_4(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R(_func)
+
+#define DECLARE_MOCK_R_5(_func, _rtype, _t0, _t1, _t2, _t3, _t4)                                                       \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4);                                    \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4);                                                                     \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_5(_func, _rtype, _t0, _t1, _t2, _t3, _t4)                                                        \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_5(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4)                                                  \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_5                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_5)                                                                       \
+        _MOCK_CALLBACK_R_5(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R(_func)
+
+#define DECLARE_MOCK_R_6(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5)                                                  \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+        _t5 p5;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5);                               \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5);                                                                \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_6(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5)                                                   \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_6(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5)                                         \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_6                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_6)                                                                       \
+        _MOCK_CALLBACK_R_6(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R(_func)
+
+#define DECLARE_MOCK_R_7(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5, _t6)                                             \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+        _t5 p5;                                                                                                        \
+        _t6 p6;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5, _t6);                          \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6);                                                           \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_7(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5, _t6)                                              \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_7(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6)                                \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_7                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_7)                                                                       \
+        _MOCK_CALLBACK_R_7(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R(_func)
+
+#define DECLARE_MOCK_R_8(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7)                                        \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+        _t5 p5;                                                                                                        \
+        _t6 p6;                                                                                                        \
+        _t7 p7;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7);                     \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7);                                                      \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_8(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7)                                         \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_8(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6, _t7 _p7)                       \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_8                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_8)                                                                       \
+        _MOCK_CALLBACK_R_8(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R(_func)
+
+#define DECLARE_MOCK_R_9(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8)                                   \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+        _t5 p5;                                                                                                        \
+        _t6 p6;                                                                                                        \
+        _t7 p7;                                                                                                        \
+        _t8 p8;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8);                \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    extern mock_param_action_t _func##__param_actions;                                                                 \
+    _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8);                                                 \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_9(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8)                                    \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_9(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    mock_param_action_t _func##__param_actions = NULL;                                                                 \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6, _t7 _p7, _t8 _p8)              \
+    {                                                                                                                  \
+        struct _mock_param_action *action = _func##__param_actions;                                                    \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_9                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_9)                                                                       \
+        _MOCK_CALLBACK_R_9(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R(_func)
+
+/*============================================================================
+ *  Simple Mocks (no param actions) - for struct-by-value support
+ *
+ *  These macros work with any parameter type including structs.
+ *  They don't support mock_param_mem_read/write actions.
+ *  Use these when:
+ *  - Parameters are structs passed by value
+ *  - You only need param_history and return_queue
+ *==========================================================================*/
+
+/* Simple reset - no param actions to destroy */
+#define _MOCK_RESET_V_SIMPLE(_func)                                                                                    \
+    void _func##__mock_reset(void)                                                                                     \
+    {                                                                                                                  \
+        _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
+        _func##__call_count = 0;                                                                                       \
+        _func##__callback = NULL;                                                                                      \
+    }
+
+#define _MOCK_RESET_R_SIMPLE(_func)                                                                                    \
+    void _func##__mock_reset(void)                                                                                     \
+    {                                                                                                                  \
+        _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+        _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
+        _func##__call_count = 0;                                                                                       \
+        _func##__callback = NULL;                                                                                      \
+    }
+
+/* V_1_S: void return, 1 param, struct-safe */
+#define DECLARE_MOCK_V_1_S(_func, _t0)                                                                                 \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0);                                                                  \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    void _func##__mock(_t0);                                                                                           \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_1_S(_func, _t0)                                                                                  \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_1(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    void _func##__mock(_t0 _p0)                                                                                        \
+    {                                                                                                                  \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_1                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_CALLBACK_V_1(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V_SIMPLE(_func)
+
+/* V_2_S: void return, 2 params, struct-safe */
+#define DECLARE_MOCK_V_2_S(_func, _t0, _t1)                                                                            \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1);                                                             \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    void _func##__mock(_t0, _t1);                                                                                      \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_2_S(_func, _t0, _t1)                                                                             \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_2(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    void _func##__mock(_t0 _p0, _t1 _p1)                                                                               \
+    {                                                                                                                  \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_2                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_CALLBACK_V_2(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V_SIMPLE(_func)
+
+/* V_3_S: void return, 3 params, struct-safe */
+#define DECLARE_MOCK_V_3_S(_func, _t0, _t1, _t2)                                                                       \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2);                                                        \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    void _func##__mock(_t0, _t1, _t2);                                                                                 \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_V_3_S(_func, _t0, _t1, _t2)                                                                        \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_3(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2)                                                                      \
+    {                                                                                                                  \
+        _func##_params *p;                                                                                             \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_3                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        _MOCK_CALLBACK_V_3(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+    }                                                                                                                  \
+    _MOCK_RESET_V_SIMPLE(_func)
+
+/* R_V_S: returns value, no params, struct-safe */
+#define DECLARE_MOCK_R_V_S(_func, _rtype)                                                                              \
+    typedef void (*_func##__callback_t)(size_t, _rtype *);                                                             \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    _rtype _func##__mock(void);                                                                                        \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_V_S(_func, _rtype)                                                                               \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_REG_DEF(_func, NULL, 0)                                                                                      \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    _rtype _func##__mock(void)                                                                                         \
+    {                                                                                                                  \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        _MOCK_EXPECT_CHECK(_func, NULL)                                                                                \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_CALLBACK_R_V(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    void _func##__mock_reset(void)                                                                                     \
+    {                                                                                                                  \
+        _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
+        _func##__call_count = 0;                                                                                       \
+        _func##__callback = NULL;                                                                                      \
+    }
+
+/* R_1_S: returns value, 1 param, struct-safe */
+#define DECLARE_MOCK_R_1_S(_func, _rtype, _t0)                                                                         \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0);                                                        \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    _rtype _func##__mock(_t0);                                                                                         \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_1_S(_func, _rtype, _t0)                                                                          \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_1(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    _rtype _func##__mock(_t0 _p0)                                                                                      \
+    {                                                                                                                  \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_1                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_CALLBACK_R_1(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R_SIMPLE(_func)
+
+/* R_2_S: returns value, 2 params, struct-safe */
+#define DECLARE_MOCK_R_2_S(_func, _rtype, _t0, _t1)                                                                    \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1);                                                   \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    _rtype _func##__mock(_t0, _t1);                                                                                    \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_2_S(_func, _rtype, _t0, _t1)                                                                     \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_2(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1)                                                                             \
+    {                                                                                                                  \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_2                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_CALLBACK_R_2(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R_SIMPLE(_func)
+
+/* R_3_S: returns value, 3 params, struct-safe */
+#define DECLARE_MOCK_R_3_S(_func, _rtype, _t0, _t1, _t2)                                                               \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2);                                              \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    _rtype _func##__mock(_t0, _t1, _t2);                                                                               \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_3_S(_func, _rtype, _t0, _t1, _t2)                                                                \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_3(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2)                                                                    \
+    {                                                                                                                  \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_3                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_CALLBACK_R_3(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R_SIMPLE(_func)
+
+/* R_4_S: returns value, 4 params, struct-safe */
+#define DECLARE_MOCK_R_4_S(_func, _rtype, _t0, _t1, _t2, _t3)                                                          \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3);                                         \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    _rtype _func##__mock(_t0, _t1, _t2, _t3);                                                                          \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_4_S(_func, _rtype, _t0, _t1, _t2, _t3)                                                           \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_4(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3)                                                           \
+    {                                                                                                                  \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_4                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_CALLBACK_R_4(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R_SIMPLE(_func)
+
+/* R_5_S: returns value, 5 params, struct-safe */
+#define DECLARE_MOCK_R_5_S(_func, _rtype, _t0, _t1, _t2, _t3, _t4)                                                     \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4);                                    \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4);                                                                     \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_5_S(_func, _rtype, _t0, _t1, _t2, _t3, _t4)                                                      \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_5(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4)                                                  \
+    {                                                                                                                  \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_5                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_CALLBACK_R_5(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R_SIMPLE(_func)
+
+/* R_6_S: returns value, 6 params, struct-safe */
+#define DECLARE_MOCK_R_6_S(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5)                                                \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        _t0 p0;                                                                                                        \
+        _t1 p1;                                                                                                        \
+        _t2 p2;                                                                                                        \
+        _t3 p3;                                                                                                        \
+        _t4 p4;                                                                                                        \
+        _t5 p5;                                                                                                        \
+    } _func##_params;                                                                                                  \
+    typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5);                               \
+    extern _func##__callback_t _func##__callback;                                                                      \
+    extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
+    _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5);                                                                \
+    void _func##__mock_reset(void)
+
+#define DEFINE_MOCK_R_6_S(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5)                                                 \
+    _func##__callback_t _func##__callback = NULL;                                                                      \
+    size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_6(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
+    _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5)                                         \
+    {                                                                                                                  \
+        _func##_params *p;                                                                                             \
+        _rtype ret;                                                                                                    \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
+        _MOCK_REGISTER(_func)                                                                                          \
+        _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
+        _MOCK_STORE_6                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
+        _MOCK_CALLBACK_R_6(_func)                                                                                      \
+        _MOCK_CALL_DONE(_func)                                                                                         \
+        return ret;                                                                                                    \
+    }                                                                                                                  \
+    _MOCK_RESET_R_SIMPLE(_func)
+
+
+/*============================================================================
+ *  Implementation
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_IMPLEMENTATION
+
+/* --- lfg-ctest.c --- */
+/**
+ * @file
+ * @brief       lfg-ctest unit testing API.
+ */
+
+/*============================================================================
+ *  Includes
+ *==========================================================================*/
+
+#include <stdarg.h>
+#include <time.h>
+#if defined(LFG_CTEST_HAS_FLOAT) || defined(LFG_CTEST_HAS_DOUBLE)
+#include <math.h>
+#endif
+#ifdef LFG_CTEST_HAS_FORK
+#include <errno.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#if defined(LFG_CTEST_HAS_FORK) || defined(LFG_CTEST_HAS_WATCHDOG)
+#include <signal.h>
+#endif
+#ifdef LFG_CTEST_HAS_WATCHDOG
+#include <sys/time.h>
+#endif
+#ifdef LFG_CTEST_HAS_BACKTRACE
+#include <execinfo.h>
+#endif
+
+/*============================================================================
+ *  Defines/Typedefs
+ *==========================================================================*/
+
+/** capacity of the slowest-tests and slowest-suites tables (override at compile time) */
+#ifndef LFG_CT_SLOWEST_MAX
+#define LFG_CT_SLOWEST_MAX 32
+#endif
+
+/** maximum number of user reporters (override at compile time) */
+#ifndef LFG_CT_REPORTERS_MAX
+#define LFG_CT_REPORTERS_MAX 8
+#endif
+
+/** size of the console reporter's output batch (override at compile time) */
+#ifndef LFG_CT_REPORT_BUF_SIZE
+#define LFG_CT_REPORT_BUF_SIZE 4096
+#endif
+
+/** stack buffer for one formatted failure message; longer ones are formatted on the heap */
+#ifndef LFG_CT_MESSAGE_MAX
+#define LFG_CT_MESSAGE_MAX 512
+#endif
+
+/** mismatching rows hexdumped by a failed ASSERT_MEM_EQUAL (override at compile time) */
+#ifndef LFG_CT_MEM_DIFF_WINDOWS
+#define LFG_CT_MEM_DIFF_WINDOWS 4
+#endif
+
+/** bytes per hexdump row, and room for its three formatted lines */
+#define _LFG_CT_HEXDUMP_ROW 16
+#define _LFG_CT_HEXDUMP_ROW_MAX (3 * (24 + 3 * _LFG_CT_HEXDUMP_ROW))
+
+/** span handed to one memcmp while skipping equal regions of a failed compare */
+#define _LFG_CT_DIFF_BLOCK 4096
+
+/** mismatching elements listed by a failed array assertion (override at compile time) */
+#ifndef LFG_CT_ARRAY_DIFF_MAX
+#define LFG_CT_ARRAY_DIFF_MAX 8
+#endif
+
+/** room for a failed array assertion's message: header plus one line per listed element */
+#define _LFG_CT_ARRAY_MESSAGE_MAX (LFG_CT_MESSAGE_MAX + LFG_CT_ARRAY_DIFF_MAX * 128)
+
+/** capacity of the benchmark results table (override at compile time) */
+#ifndef LFG_CT_BENCH_MAX
+#define LFG_CT_BENCH_MAX 64
+#endif
+
+/** timed samples taken per benchmark (override at compile time) */
+#ifndef LFG_CT_BENCH_SAMPLES
+#define LFG_CT_BENCH_SAMPLES 32
+#endif
+
+/** target duration of one benchmark sample; iterations are calibrated to it */
+#ifndef LFG_CT_BENCH_SAMPLE_NS
+#define LFG_CT_BENCH_SAMPLE_NS 1000000u
+#endif
+
+/** upper bound on calibrated iterations, for clocks too coarse to ever reach the target */
+#ifndef LFG_CT_BENCH_ITERATIONS_MAX
+#define LFG_CT_BENCH_ITERATIONS_MAX (1ul << 30)
+#endif
+
+/** failed test names remembered for the result file (override at compile time) */
+#ifndef LFG_CT_FAILED_NAMES_MAX
+#define LFG_CT_FAILED_NAMES_MAX 64
+#endif
+
+/** maximum number of --filter patterns accepted by lfg_ct_main() */
+#ifndef LFG_CT_FILTERS_MAX
+#define LFG_CT_FILTERS_MAX 16
+#endif
+
+/** frames printed in a timeout backtrace (override at compile time) */
+#ifndef LFG_CT_BACKTRACE_MAX
+#define LFG_CT_BACKTRACE_MAX 64
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LFG_CT_HAS_CYCLES 1
+#endif
+
+/* Innermost test or suite time budget; deadline_ns 0 means none. */
+struct _lfg_ct_watch
+{
+    const char *what; /* "test" or "suite" */
+    const char *name;
+    unsigned ms;
+    uint64_t deadline_ns;
+};
+
+/* Serialises event delivery so failures raised from several threads do not
+ * interleave inside the console buffer or a reporter. Only contended when
+ * two threads fail at once, so a spin is enough. The owning thread may take
+ * it again, so a reporter can call lfg_ct_report_flush() or fail an ASSERT. */
+#ifdef LFG_CTEST_THREAD_SAFE
+#define _LFG_CT_REPORT_LOCK()                                                                                          \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (0 == _report_lock_depth++)                                                                                 \
+        {                                                                                                              \
+            while (__atomic_test_and_set(&_report_lock, __ATOMIC_ACQUIRE))                                             \
+            {                                                                                                          \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (0)
+#define _LFG_CT_REPORT_UNLOCK()                                                                                        \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (0 == --_report_lock_depth)                                                                                 \
+        {                                                                                                              \
+            __atomic_clear(&_report_lock, __ATOMIC_RELEASE);                                                           \
+        }                                                                                                              \
+    } while (0)
+#else
+#define _LFG_CT_REPORT_LOCK() ((void)0)
+#define _LFG_CT_REPORT_UNLOCK() ((void)0)
+#endif
+
+struct _lfg_ct_reporter
+{
+    lfg_ct_reporter_fn fn;
+    void *ctx;
+};
+
+#ifdef LFG_CTEST_HAS_FORK
+
+/** maximum number of concurrent worker processes (override at compile time) */
+#ifndef LFG_CT_JOBS_MAX
+#define LFG_CT_JOBS_MAX 256
+#endif
+
+/* Counters a worker process sends back to the parent for one test. */
+struct _lfg_ct_result
+{
+    int assertions_executed;
+    int assertions_failed;
+    int assertions_passed;
+    int test_failures;
+    int nested_executed; /* lfg_ctest() calls made from inside the test */
+    int nested_failed;
+    int nested_passed;
+    int expected_failures; /* only used with LFG_CTEST_SELF_TEST */
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+};
+
+struct _lfg_ct_worker
+{
+    pid_t pid;
+    int fd; /* read end of the result pipe */
+    const char *name;
+    uint64_t start_ns; /* wall time at fork, used if the worker dies */
+    unsigned timeout_ms;
+};
+
+/* Exit status of a worker whose time budget ran out (as timeout(1) uses) */
+#define _LFG_CT_TIMEOUT_STATUS 124
+
+#endif /* LFG_CTEST_HAS_FORK */
+
+/*============================================================================
+ *  Private Function Prototypes
+ *==========================================================================*/
+
+static void _lfg_ct_run(void (*fn)(void), const char *name, unsigned timeout_ms);
+static void _lfg_ct_dispatch(void (*fn)(void), const char *name, unsigned timeout_ms);
+static unsigned _lfg_ct_take_timeout(unsigned fallback);
+static void _lfg_ct_watch_begin(const char *what, const char *name, unsigned ms, struct _lfg_ct_watch *saved);
+static void _lfg_ct_watch_end(const struct _lfg_ct_watch *saved);
+#ifdef LFG_CTEST_HAS_WATCHDOG
+static void _lfg_ct_watch_arm(void);
+static void _lfg_ct_watchdog(int sig);
+static void _lfg_ct_sig_append(char *line, size_t size, size_t *len, const char *s);
+static void _lfg_ct_sig_append_uint(char *line, size_t size, size_t *len, unsigned long v);
+#ifdef LFG_CTEST_HAS_FORK
+static void _lfg_ct_watch_pause(void);
+static void _lfg_ct_watch_resume(void);
+#endif
+#endif
+static bool _lfg_ct_shard_skip(void);
+static void _lfg_ct_shard_from_env(void);
+static void _lfg_ct_write_result_file(void);
+static void _lfg_ct_test_finished(
+        const char *name, int failures, uint64_t wall_ns, uint64_t cpu_ns, const char *reason);
+static uint64_t _lfg_ct_ticks_to_ns(clock_t ticks);
+static uint64_t _lfg_ct_wall_ns(void);
+static uint64_t _lfg_ct_cpu_ns(void);
+static void _lfg_ct_slowest_insert(
+        lfg_ct_timing_t *table, unsigned *count, const char *name, uint64_t wall_ns, uint64_t cpu_ns);
+static void _lfg_ct_fail(const char *filename, int line_no, const char *function, const char *fmt, ...);
+static void _lfg_ct_fail_message(const char *filename, int line_no, const char *function, const char *message);
+static size_t _lfg_ct_mem_mismatch(const unsigned char *a, const unsigned char *b, size_t from, size_t n);
+static size_t _lfg_ct_str_mismatch(const char *a, const char *b, size_t n);
+static size_t _lfg_ct_hexdump_row(char *out, size_t room, const unsigned char *expected, const unsigned char *actual,
+        size_t row, size_t n);
+static void _lfg_ct_fail_mem(const unsigned char *expected, const unsigned char *actual, size_t n, size_t first,
+        char *filename, int line_no, const char *function, const char *actual_expr_str);
+static size_t _lfg_ct_appendf(char *buf, size_t size, size_t len, const char *fmt, ...);
+static bool _lfg_ct_array_null(const void *expected, const void *actual, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+#ifdef LFG_CTEST_HAS_FLOAT
+static uint64_t _lfg_ct_float_ulps(float a, float b);
+#endif
+#ifdef LFG_CTEST_HAS_DOUBLE
+static uint64_t _lfg_ct_double_ulps(double a, double b);
+#endif
+static void _lfg_ct_emit(const lfg_ct_event_t *event);
+static void _lfg_ct_console(const lfg_ct_event_t *event);
+static void _lfg_ct_report_write(void);
+static void _lfg_ct_console_printf(const char *fmt, ...);
+static void _lfg_ct_console_slowest(const char *what, const lfg_ct_timing_t *table, unsigned count);
+static void _lfg_ct_console_bench(const lfg_ct_bench_result_t *table, unsigned count);
+static uint64_t _lfg_ct_cycles(void);
+static bool _lfg_ct_glob(const char *pattern, const char *str);
+static int _lfg_ct_node_name_cmp(const void *a, const void *b);
+static const char *_lfg_ct_option(int argc, char *argv[], int *i, const char *long_name, const char *short_name);
+static uint64_t _lfg_ct_bench_sample(void (*fn)(void), unsigned long iterations, uint64_t *cycles);
+
+#ifdef LFG_CTEST_HAS_FORK
+static void _lfg_ct_spawn(void (*fn)(void), const char *name, unsigned timeout_ms);
+static void _lfg_ct_reap_one(void);
+static const char *_lfg_ct_signal_name(int sig);
+#endif
+static void _lfg_ct_drain(void);
+
+/*============================================================================
+ *  Variables
+ *==========================================================================*/
+
+/* Shared with the header so LFG_CTEST_INLINE_ASSERTS can count passes inline. */
+lfg_ct_counters_t lfg_ct_counters = {0, 0, 1};
+static int _assertions_failed = 0;
+static int _tests_executed = 0;
+static int _tests_failed = 0;
+static int _tests_passed = 0;
+static int _current_test_failures = 0;
+static int _current_suite_failures = 0;
+
+static uint64_t _start_wall_ns = 0;
+static uint64_t _tests_wall_ns = 0;
+static uint64_t _tests_cpu_ns = 0;
+static unsigned _report_slowest = 5;
+static lfg_ct_timing_t _slowest_tests[LFG_CT_SLOWEST_MAX];
+static unsigned _slowest_tests_count = 0;
+static lfg_ct_timing_t _slowest_suites[LFG_CT_SLOWEST_MAX];
+static unsigned _slowest_suites_count = 0;
+
+static struct _lfg_ct_reporter _reporters[LFG_CT_REPORTERS_MAX];
+static unsigned _reporters_count = 0;
+static bool _console_enabled = true;
+static char _report_buf[LFG_CT_REPORT_BUF_SIZE];
+static size_t _report_len = 0;
+#ifdef LFG_CTEST_THREAD_SAFE
+static bool _report_lock = false;
+static __thread unsigned _report_lock_depth = 0; /* nesting of _report_lock on this thread */
+#endif
+
+static lfg_ct_bench_result_t _bench_results[LFG_CT_BENCH_MAX];
+static unsigned _bench_results_count = 0;
+
+static unsigned _shard_index = 0;
+static unsigned _shard_count = 1;
+static bool _shard_env_read = false;
+static unsigned _shard_ordinal = 0; /* top-level tests seen, skipped or not */
+static int _tests_skipped = 0;
+static int _test_depth = 0; /* >0 while a test body runs, so nested tests are never sharded */
+static const char *_result_file = NULL;
+static const char *_failed_names[LFG_CT_FAILED_NAMES_MAX];
+static unsigned _failed_names_count = 0;
+
+static unsigned _timeout_ms = 0;       /* default test budget, 0 = none */
+static unsigned _suite_timeout_ms = 0; /* default suite budget, 0 = none */
+static unsigned _timeout_next_ms = 0;
+static bool _timeout_next_set = false; /* lfg_ct_timeout_next() applies to the next test or suite */
+static struct _lfg_ct_watch _watch;
+static const char *_running_name = NULL; /* innermost test running in this process */
+static uint64_t _running_start_ns = 0;
+#ifdef LFG_CTEST_HAS_WATCHDOG
+static bool _watchdog_installed = false;
+static struct sigaction _watchdog_saved; /* SIGALRM action to restore once no budget is active */
+#endif
+
+static lfg_ct_test_node_t *_registry_head = NULL;
+static lfg_ct_test_node_t *_registry_tail = NULL;
+static unsigned _registry_count = 0;
+
+#ifdef LFG_CTEST_HAS_FORK
+static unsigned _jobs = 0;
+static bool _isolate = false;
+static bool _in_worker = false; /* set in a forked child; failures are written through */
+static unsigned _workers_active = 0;
+static struct _lfg_ct_worker _workers[LFG_CT_JOBS_MAX];
+#endif
+
+/*============================================================================
+ *  Self-Test Support (internal only)
+ *
+ *  When LFG_CTEST_SELF_TEST is defined, enables "expect failures" mode for
+ *  testing the framework itself. Failures during this mode are counted but
+ *  don't affect the final test result.
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_SELF_TEST
+static int _expect_failures_mode = 0;
+static int _expected_failures_count = 0;
+
+/* In expect-failures mode, count the failure but don't affect test results */
+#define RECORD_FAILURE()                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (_expect_failures_mode)                                                                                     \
+        {                                                                                                              \
+            _LFG_CT_COUNT(_expected_failures_count, 1);                                                                \
+        }                                                                                                              \
+        else                                                                                                           \
+        {                                                                                                              \
+            _LFG_CT_COUNT(_current_test_failures, 1);                                                                  \
+            _LFG_CT_COUNT(_assertions_failed, 1);                                                                      \
+        }                                                                                                              \
+    } while (0)
+
+#define RECORD_PASS()                                                                                                  \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!_expect_failures_mode)                                                                                    \
+        {                                                                                                              \
+            _LFG_CT_COUNT(lfg_ct_counters.assertions_passed, 1);                                                       \
+        }                                                                                                              \
+    } while (0)
+
+#else
+/* Normal mode: always record failures/passes */
+#define RECORD_FAILURE()                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        _LFG_CT_COUNT(_current_test_failures, 1);                                                                      \
+        _LFG_CT_COUNT(_assertions_failed, 1);                                                                          \
+    } while (0)
+
+#define RECORD_PASS()                                                                                                  \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_passed, 1);                                                           \
+    } while (0)
+
+#endif /* LFG_CTEST_SELF_TEST */
+
+/*============================================================================
+ *  Public API
+ *==========================================================================*/
+
+const char *
+lfg_ct_version(void)
+{
+    return LFG_CTEST_VERSION_FULL;
+}
+
+void lfg_ct_start(void)
+{
+    lfg_ct_event_t ev;
+    unsigned rand_seed = time(NULL) % 1000;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_START;
+    ev.seed = rand_seed;
+    _lfg_ct_shard_from_env();
+    ev.shard_index = _shard_index;
+    ev.shard_count = _shard_count;
+    _lfg_ct_emit(&ev);
+    srand(rand_seed);
+    _start_wall_ns = _lfg_ct_wall_ns();
+}
+
+void lfg_ct_end(void)
+{
+    _lfg_ct_drain();
+    lfg_ct_report_flush();
+}
+
+int lfg_ct_reporter_add(lfg_ct_reporter_fn fn, void *ctx)
+{
+    unsigned i;
+
+    for (i = 0; i < _reporters_count; i++)
+    {
+        if (_reporters[i].fn == fn && _reporters[i].ctx == ctx)
+        {
+            return 0; /* already registered */
+        }
+    }
+    if (NULL == fn || _reporters_count >= LFG_CT_REPORTERS_MAX)
+    {
+        return -1;
+    }
+    _reporters[_reporters_count].fn = fn;
+    _reporters[_reporters_count].ctx = ctx;
+    _reporters_count++;
+    return 0;
+}
+
+void lfg_ct_reporter_remove(lfg_ct_reporter_fn fn, void *ctx)
+{
+    unsigned i;
+
+    for (i = 0; i < _reporters_count; i++)
+    {
+        if (_reporters[i].fn == fn && _reporters[i].ctx == ctx)
+        {
+            /* keep registration order for the remaining reporters */
+            memmove(&_reporters[i], &_reporters[i + 1], (_reporters_count - i - 1) * sizeof(_reporters[0]));
+            _reporters_count--;
+            return;
+        }
+    }
+}
+
+void lfg_ct_reporter_console(bool enable)
+{
+    _console_enabled = enable;
+}
+
+void lfg_ct_report_flush(void)
+{
+    _LFG_CT_REPORT_LOCK();
+    _lfg_ct_report_write();
+    _LFG_CT_REPORT_UNLOCK();
+}
+
+void lfg_ct_parallel(unsigned jobs)
+{
+    _lfg_ct_drain();
+#ifdef LFG_CTEST_HAS_FORK
+    _jobs = jobs > LFG_CT_JOBS_MAX ? LFG_CT_JOBS_MAX : jobs;
+#else
+    (void)jobs;
+#endif
+}
+
+void lfg_ct_isolate(bool enable)
+{
+    _lfg_ct_drain();
+#ifdef LFG_CTEST_HAS_FORK
+    _isolate = enable;
+#else
+    (void)enable;
+#endif
+}
+
+void lfg_ct_set_report_slowest(unsigned n)
+{
+    _report_slowest = n > LFG_CT_SLOWEST_MAX ? LFG_CT_SLOWEST_MAX : n;
+}
+
+void lfg_ct_set_timeout_ms(unsigned test_ms, unsigned suite_ms)
+{
+    _timeout_ms = test_ms;
+    _suite_timeout_ms = suite_ms;
+}
+
+void lfg_ct_timeout_next(unsigned ms)
+{
+    _timeout_next_ms = ms;
+    _timeout_next_set = true;
+}
+
+void lfg_ct_suite_impl(void (*fn)(void), const char *name)
+{
+    lfg_ct_event_t ev;
+    struct _lfg_ct_watch saved;
+    uint64_t wall0 = _lfg_ct_wall_ns();
+    uint64_t cpu0 = _tests_cpu_ns;
+
+    _current_suite_failures = 0;
+    _lfg_ct_watch_begin("suite", name, _lfg_ct_take_timeout(_suite_timeout_ms), &saved);
+    fn();
+    _lfg_ct_drain();
+    _lfg_ct_watch_end(&saved);
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_SUITE_END;
+    ev.name = name;
+    ev.failures = _current_suite_failures;
+    ev.wall_ns = _lfg_ct_wall_ns() - wall0;
+    ev.cpu_ns = _tests_cpu_ns - cpu0; /* sum over its tests, so it includes worker processes */
+    _lfg_ct_slowest_insert(_slowest_suites, &_slowest_suites_count, name, ev.wall_ns, ev.cpu_ns);
+    _lfg_ct_emit(&ev);
+}
+
+void lfg_ct_impl(void (*fn)(void), const char *name)
+{
+    unsigned timeout_ms = _lfg_ct_take_timeout(_timeout_ms); /* consumed even if sharded out */
+
+    if (0 == _test_depth && _lfg_ct_shard_skip())
+    {
+        return;
+    }
+    _lfg_ct_dispatch(fn, name, timeout_ms);
+}
+
+int lfg_ct_set_shard(unsigned index, unsigned count)
+{
+    if (0 == count || index >= count)
+    {
+        return -1;
+    }
+    _shard_env_read = true; /* an explicit setting wins over the environment */
+    _shard_index = index;
+    _shard_count = count;
+    return 0;
+}
+
+void lfg_ct_set_result_file(const char *path)
+{
+    _result_file = path;
+}
+
+void lfg_ct_bench_impl(void (*fn)(void), const char *name)
+{
+    uint64_t samples[LFG_CT_BENCH_SAMPLES];
+    uint64_t cycle_samples[LFG_CT_BENCH_SAMPLES];
+    uint64_t sum = 0;
+    uint64_t cycles = 0;
+    unsigned long iterations = 1;
+    lfg_ct_bench_result_t result;
+    lfg_ct_event_t ev;
+    unsigned i;
+    unsigned j;
+
+    /* workers still running would compete for the CPU */
+    _lfg_ct_drain();
+
+    /* calibrate: double the batch until one sample reaches the target time;
+     * this also serves as warmup for caches and branch predictors */
+    while (_lfg_ct_bench_sample(fn, iterations, &cycles) < LFG_CT_BENCH_SAMPLE_NS &&
+            iterations < LFG_CT_BENCH_ITERATIONS_MAX)
+    {
+        iterations *= 2;
+    }
+    _lfg_ct_bench_sample(fn, iterations, &cycles); /* one more warmup pass at the final size */
+
+    /* per-op times are kept in picoseconds so sub-nanosecond ops survive integer division */
+    for (i = 0; i < LFG_CT_BENCH_SAMPLES; i++)
+    {
+        uint64_t ps = _lfg_ct_bench_sample(fn, iterations, &cycles) * 1000u / iterations;
+        uint64_t cyc = cycles * 1000u / iterations;
+
+        sum += ps;
+        for (j = i; j > 0 && samples[j - 1] > ps; j--)
+        {
+            samples[j] = samples[j - 1];
+        }
+        samples[j] = ps;
+        for (j = i; j > 0 && cycle_samples[j - 1] > cyc; j--)
+        {
+            cycle_samples[j] = cycle_samples[j - 1];
+        }
+        cycle_samples[j] = cyc;
+    }
+
+    memset(&result, 0, sizeof(result));
+    result.name = name;
+    result.iterations = iterations;
+    result.samples = LFG_CT_BENCH_SAMPLES;
+    result.min_ps = samples[0];
+    result.median_ps = samples[LFG_CT_BENCH_SAMPLES / 2];
+    result.mean_ps = sum / LFG_CT_BENCH_SAMPLES;
+    result.p99_ps = samples[(LFG_CT_BENCH_SAMPLES * 99 + 99) / 100 - 1]; /* nearest rank */
+#ifdef LFG_CT_HAS_CYCLES
+    result.median_mcycles = cycle_samples[LFG_CT_BENCH_SAMPLES / 2];
+#endif
+
+    if (_bench_results_count < LFG_CT_BENCH_MAX)
+    {
+        _bench_results[_bench_results_count++] = result;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_BENCH;
+    ev.name = name;
+    ev.bench = &result;
+    _lfg_ct_emit(&ev);
+}
+
+void lfg_ct_print_summary(void)
+{
+    lfg_ct_event_t ev;
+
+    _lfg_ct_drain();
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_SUMMARY;
+    ev.failures = _tests_failed;
+    ev.assertions_executed = lfg_ct_counters.assertions_executed;
+    ev.tests_executed = _tests_executed;
+    ev.wall_ns = _tests_wall_ns;
+    ev.cpu_ns = _tests_cpu_ns;
+    ev.elapsed_ns = _lfg_ct_wall_ns() - _start_wall_ns;
+    ev.slowest_tests = _slowest_tests;
+    ev.slowest_tests_count = _slowest_tests_count < _report_slowest ? _slowest_tests_count : _report_slowest;
+    ev.slowest_suites = _slowest_suites;
+    ev.slowest_suites_count = _slowest_suites_count < _report_slowest ? _slowest_suites_count : _report_slowest;
+    ev.bench = _bench_results;
+    ev.bench_count = _bench_results_count;
+    ev.tests_skipped = _tests_skipped;
+    ev.shard_index = _shard_index;
+    ev.shard_count = _shard_count;
+    _lfg_ct_emit(&ev);
+    _lfg_ct_write_result_file();
+}
+
+int lfg_ct_return(void)
+{
+    _lfg_ct_drain();
+    return -_tests_failed;
+}
+
+void lfg_ct_register(lfg_ct_test_node_t *node)
+{
+    if (node->registered)
+    {
+        return;
+    }
+    node->registered = true;
+    node->next = NULL;
+    if (_registry_tail)
+    {
+        _registry_tail->next = node;
+    }
+    else
+    {
+        _registry_head = node;
+    }
+    _registry_tail = node;
+    _registry_count++;
+}
+
+int lfg_ct_main(int argc, char *argv[])
+{
+    const char *filters[LFG_CT_FILTERS_MAX];
+    unsigned filters_count = 0;
+    const char *order = "declaration";
+    const char *shard_index = NULL;
+    const char *shard_count = NULL;
+    unsigned jobs = 0;
+    bool isolate = false;
+    bool list = false;
+    lfg_ct_test_node_t **selected;
+    lfg_ct_test_node_t *node;
+    unsigned count = 0;
+    unsigned i;
+    int a;
+
+    for (a = 1; a < argc; a++)
+    {
+        const char *value;
+
+        if (0 == strcmp(argv[a], "--list"))
+        {
+            list = true;
+        }
+        else if (0 == strcmp(argv[a], "--isolate"))
+        {
+            isolate = true;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--filter", NULL)))
+        {
+            if (filters_count >= LFG_CT_FILTERS_MAX)
+            {
+                fprintf(stderr, "too many --filter options (max %d)\n", LFG_CT_FILTERS_MAX);
+                return -1;
+            }
+            filters[filters_count++] = value;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--order", NULL)))
+        {
+            if (strcmp(value, "declaration") != 0 && strcmp(value, "name") != 0 && strcmp(value, "random") != 0)
+            {
+                fprintf(stderr, "unknown --order '%s' (declaration, name or random)\n", value);
+                return -1;
+            }
+            order = value;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--jobs", "-j")))
+        {
+            jobs = (unsigned)strtoul(value, NULL, 10);
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--shard-index", NULL)))
+        {
+            shard_index = value;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--shard-count", NULL)))
+        {
+            shard_count = value;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--result-file", NULL)))
+        {
+            lfg_ct_set_result_file(value);
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--timeout", NULL)))
+        {
+            lfg_ct_set_timeout_ms((unsigned)strtoul(value, NULL, 10), _suite_timeout_ms);
+        }
+        else
+        {
+            fprintf(stderr,
+                    "usage: %s [--list] [--filter=GLOB]... [--order=declaration|name|random] [-j N] [--isolate]\n"
+                    "          [--shard-index=I --shard-count=N] [--result-file=PATH] [--timeout=MS]\n"
+                    "unknown option '%s'\n",
+                    argv[0], argv[a]);
+            return -1;
+        }
+    }
+
+    _lfg_ct_shard_from_env();
+    if (shard_index || shard_count)
+    {
+        unsigned index = shard_index ? (unsigned)strtoul(shard_index, NULL, 10) : 0;
+        unsigned n = shard_count ? (unsigned)strtoul(shard_count, NULL, 10) : 1;
+        if (lfg_ct_set_shard(index, n) != 0)
+        {
+            fprintf(stderr, "invalid shard %u/%u (need index < count)\n", index, n);
+            return -1;
+        }
+    }
+
+    selected = malloc((_registry_count ? _registry_count : 1) * sizeof(*selected));
+    if (NULL == selected)
+    {
+        fprintf(stderr, "out of memory selecting %u tests\n", _registry_count);
+        return -1;
+    }
+    for (node = _registry_head; node; node = node->next)
+    {
+        bool match = (0 == filters_count);
+        for (i = 0; i < filters_count && !match; i++)
+        {
+            match = _lfg_ct_glob(filters[i], node->name);
+        }
+        /* shard on declaration order, before any reordering, so every
+         * shard agrees on the split even with --order=random */
+        if (match && !_lfg_ct_shard_skip())
+        {
+            selected[count++] = node;
+        }
+    }
+
+    if (!list)
+    {
+        lfg_ct_start(); /* seeds rand() for --order=random */
+    }
+    if (0 == strcmp(order, "name"))
+    {
+        qsort(selected, count, sizeof(*selected), _lfg_ct_node_name_cmp);
+    }
+    else if (0 == strcmp(order, "random"))
+    {
+        for (i = count; i > 1; i--)
+        {
+            unsigned j = (unsigned)rand() % i;
+            node = selected[i - 1];
+            selected[i - 1] = selected[j];
+            selected[j] = node;
+        }
+    }
+
+    if (list)
+    {
+        for (i = 0; i < count; i++)
+        {
+            printf("%s\n", selected[i]->name);
+        }
+        free(selected);
+        return 0;
+    }
+
+    lfg_ct_parallel(jobs);
+    lfg_ct_isolate(isolate);
+    for (i = 0; i < count; i++)
+    {
+        _lfg_ct_dispatch(selected[i]->fn, selected[i]->name, _timeout_ms);
+    }
+    free(selected);
+    lfg_ct_print_summary();
+    lfg_ct_end();
+    return lfg_ct_return();
+}
+
+/*============================================================================
+ *  Self-Test API (only available when LFG_CTEST_SELF_TEST is defined)
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_SELF_TEST
+
+void lfg_ct_expect_failures_begin(void)
+{
+    _expect_failures_mode = 1;
+    _expected_failures_count = 0;
+    lfg_ct_counters.pass_weight = 0;
+}
+
+int lfg_ct_expect_failures_end(void)
+{
+    _lfg_ct_drain();
+    _expect_failures_mode = 0;
+    lfg_ct_counters.pass_weight = 1;
+    return _expected_failures_count;
+}
+
+void lfg_ct_self_test_counts(lfg_ct_counts_t *counts)
+{
+    _lfg_ct_drain();
+    counts->tests_executed = _tests_executed;
+    counts->tests_failed = _tests_failed;
+    counts->tests_passed = _tests_passed;
+    counts->assertions_executed = lfg_ct_counters.assertions_executed;
+    counts->assertions_failed = _assertions_failed;
+    counts->assertions_passed = lfg_ct_counters.assertions_passed;
+    counts->tests_wall_ns = _tests_wall_ns;
+    counts->tests_cpu_ns = _tests_cpu_ns;
+}
+
+#endif /* LFG_CTEST_SELF_TEST */
+
+int lfg_ct_assert_false_impl(
+        bool condition, char *filename, int line_no, const char *function, const char *condition_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (condition)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should be false", condition_str);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_true_impl(
+        bool condition, char *filename, int line_no, const char *function, const char *condition_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!condition)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should be true", condition_str);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int_equal_impl(
+        int expected, int actual, char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should equal %d", actual_expr_str, actual, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int_not_equal_impl(
+        int expected, int actual, char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %d", actual_expr_str, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint_equal_impl(unsigned expected, unsigned actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%u) should equal %u", actual_expr_str, actual, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint_not_equal_impl(unsigned expected, unsigned actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %u", actual_expr_str, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint8_equal_impl(uint8_t expected, uint8_t actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%02X) should equal 0x%02X", actual_expr_str, actual, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint8_not_equal_impl(uint8_t expected, uint8_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal 0x%02X", actual_expr_str, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint16_equal_impl(uint16_t expected, uint16_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%04X) should equal 0x%04X", actual_expr_str, actual, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint16_not_equal_impl(uint16_t expected, uint16_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal 0x%04X", actual_expr_str, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint32_equal_impl(uint32_t expected, uint32_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should equal 0x%08X", actual_expr_str, actual, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint32_not_equal_impl(uint32_t expected, uint32_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal 0x%08X", actual_expr_str, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_ptr_equal_impl(void *expected, void *actual, const char *filename, int line_no, const char *function,
+        const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p", actual_expr_str, actual, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_ptr_not_equal_impl(void *expected, void *actual, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %p", actual_expr_str, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_ptr_not_null(
+        void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (NULL == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not be NULL", actual_expr_str);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_ptr_null(
+        void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (NULL != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should be NULL but is %p", actual_expr_str, actual);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int8_equal_impl(
+        int8_t expected, int8_t actual, char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should equal %d", actual_expr_str, actual, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int8_not_equal_impl(
+        int8_t expected, int8_t actual, char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %d", actual_expr_str, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int16_equal_impl(int16_t expected, int16_t actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should equal %d", actual_expr_str, actual, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int16_not_equal_impl(int16_t expected, int16_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %d", actual_expr_str, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int32_equal_impl(int32_t expected, int32_t actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should equal %d", actual_expr_str, actual, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int32_not_equal_impl(int32_t expected, int32_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %d", actual_expr_str, expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int64_equal_impl(int64_t expected, int64_t actual, char *filename, int line_no, const char *function,
+        const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%lld) should equal %lld", actual_expr_str, (long long)actual,
+                (long long)expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_int64_not_equal_impl(int64_t expected, int64_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %lld", actual_expr_str, (long long)expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint64_equal_impl(uint64_t expected, uint64_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected != actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%016llX) should equal 0x%016llX", actual_expr_str,
+                (unsigned long long)actual, (unsigned long long)expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_uint64_not_equal_impl(uint64_t expected, uint64_t actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (expected == actual)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal 0x%016llX", actual_expr_str,
+                (unsigned long long)expected);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_str_equal_impl(const char *expected, const char *actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (NULL == expected || NULL == actual)
+    {
+        if (expected != actual)
+        {
+            _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p (NULL mismatch)", actual_expr_str,
+                    (void *)actual, (void *)expected);
+            RECORD_FAILURE();
+            return -1;
+        }
+    }
+    else if (strcmp(expected, actual) != 0)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (\"%s\") should equal \"%s\" (differs at index %zu)",
+                actual_expr_str, actual, expected, _lfg_ct_str_mismatch(expected, actual, SIZE_MAX));
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_str_not_equal_impl(const char *expected, const char *actual, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if ((NULL == expected && NULL == actual) || (expected != NULL && actual != NULL && strcmp(expected, actual) == 0))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal \"%s\"", actual_expr_str,
+                expected ? expected : "(null)");
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_strn_equal_impl(const char *expected, const char *actual, size_t n, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (NULL == expected || NULL == actual)
+    {
+        if (expected != actual)
+        {
+            _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p (NULL mismatch)", actual_expr_str,
+                    (void *)actual, (void *)expected);
+            RECORD_FAILURE();
+            return -1;
+        }
+    }
+    else if (strncmp(expected, actual, n) != 0)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (first %zu chars) does not match expected (differs at index %zu)",
+                actual_expr_str, n, _lfg_ct_str_mismatch(expected, actual, n));
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_mem_equal_impl(const void *expected, const void *actual, size_t n, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (NULL == expected || NULL == actual)
+    {
+        if (expected != actual)
+        {
+            _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p (NULL mismatch)", actual_expr_str,
+                    actual, expected);
+            RECORD_FAILURE();
+            return -1;
+        }
+    }
+    else if (memcmp(expected, actual, n) != 0)
+    {
+        /* the pass path is a single memcmp; locating the difference is left to the failure */
+        _lfg_ct_fail_mem(expected, actual, n, _lfg_ct_mem_mismatch(expected, actual, 0, n), filename, line_no,
+                function, actual_expr_str);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_mem_not_equal_impl(const void *expected, const void *actual, size_t n, char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if ((NULL == expected && NULL == actual) ||
+            (expected != NULL && actual != NULL && memcmp(expected, actual, n) == 0))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s memory (%zu bytes) should not match", actual_expr_str, n);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_greater_than_impl(
+        int a, int b, char *filename, int line_no, const char *function, const char *a_expr_str, const char *b_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(a > b))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be > %s (%d)", a_expr_str, a, b_expr_str, b);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_less_than_impl(
+        int a, int b, char *filename, int line_no, const char *function, const char *a_expr_str, const char *b_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(a < b))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be < %s (%d)", a_expr_str, a, b_expr_str, b);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_greater_or_equal_impl(
+        int a, int b, char *filename, int line_no, const char *function, const char *a_expr_str, const char *b_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(a >= b))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be >= %s (%d)", a_expr_str, a, b_expr_str, b);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_less_or_equal_impl(
+        int a, int b, char *filename, int line_no, const char *function, const char *a_expr_str, const char *b_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(a <= b))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be <= %s (%d)", a_expr_str, a, b_expr_str, b);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_in_range_impl(
+        int val, int min, int max, char *filename, int line_no, const char *function, const char *val_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(val >= min && val <= max))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be in range [%d, %d]", val_expr_str, val, min, max);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_bit_set_impl(unsigned val, unsigned bit, char *filename, int line_no, const char *function,
+        const char *val_expr_str, unsigned bit_num)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(val & (1u << bit)))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should have bit %u set", val_expr_str, val, bit_num);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_bit_clear_impl(unsigned val, unsigned bit, char *filename, int line_no, const char *function,
+        const char *val_expr_str, unsigned bit_num)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (val & (1u << bit))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should have bit %u clear", val_expr_str, val, bit_num);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_bits_set_impl(unsigned val, unsigned mask, char *filename, int line_no, const char *function,
+        const char *val_expr_str, unsigned mask_val)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if ((val & mask) != mask)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should have bits 0x%08X set", val_expr_str, val,
+                mask_val);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_bits_clear_impl(unsigned val, unsigned mask, char *filename, int line_no, const char *function,
+        const char *val_expr_str, unsigned mask_val)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (val & mask)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should have bits 0x%08X clear", val_expr_str, val,
+                mask_val);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_fail_impl(char *filename, int line_no, const char *function, const char *message)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    _lfg_ct_fail(filename, line_no, function, "%s", message ? message : "Explicit failure");
+    RECORD_FAILURE();
+    return -1;
+}
+
+/*============================================================================
+ *  Array Assertions
+ *
+ *  Each array assertion counts once. The pass path is a single memcmp for
+ *  integers and a branch-free loop the compiler can vectorize for floating
+ *  point; listing the first LFG_CT_ARRAY_DIFF_MAX mismatches only happens on
+ *  failure.
+ *==========================================================================*/
+
+#define _LFG_CT_INT_ARRAY_EQUAL_DEF(_name, _type, _fmt, _cast)                                                         \
+    int lfg_ct_assert_##_name##_array_equal_impl(const _type *expected, const _type *actual, size_t n,                 \
+            char *filename, int line_no, const char *function, const char *actual_expr_str)                            \
+    {                                                                                                                  \
+        char message[_LFG_CT_ARRAY_MESSAGE_MAX];                                                                       \
+        size_t bad = 0;                                                                                                \
+        size_t shown = 0;                                                                                              \
+        size_t len;                                                                                                    \
+        size_t i;                                                                                                      \
+                                                                                                                       \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);                                                         \
+        if (_lfg_ct_array_null(expected, actual, filename, line_no, function, actual_expr_str))                        \
+        {                                                                                                              \
+            RECORD_FAILURE();                                                                                          \
+            return -1;                                                                                                 \
+        }                                                                                                              \
+        if (0 == n || NULL == expected || memcmp(expected, actual, n * sizeof(_type)) == 0)                            \
+        {                                                                                                              \
+            RECORD_PASS();                                                                                             \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        for (i = 0; i < n; i++)                                                                                        \
+        {                                                                                                              \
+            bad += (expected[i] != actual[i]);                                                                         \
+        }                                                                                                              \
+        len = _lfg_ct_appendf(message, sizeof(message), 0,                                                             \
+                "%s array (%zu elements) does not match expected: %zu differ", actual_expr_str, n, bad);               \
+        for (i = 0; i < n && shown < LFG_CT_ARRAY_DIFF_MAX; i++)                                                       \
+        {                                                                                                              \
+            if (expected[i] != actual[i])                                                                              \
+            {                                                                                                          \
+                len = _lfg_ct_appendf(message, sizeof(message), len, "\r\n    [%zu] expected " _fmt ", actual " _fmt,  \
+                        i, (_cast)expected[i], (_cast)actual[i]);                                                      \
+                shown++;                                                                                               \
+            }                                                                                                          \
+        }                                                                                                              \
+        _lfg_ct_fail_message(filename, line_no, function, message);                                                    \
+        RECORD_FAILURE();                                                                                              \
+        return -1;                                                                                                     \
+    }
+
+_LFG_CT_INT_ARRAY_EQUAL_DEF(int8, int8_t, "%lld", long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(int16, int16_t, "%lld", long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(int32, int32_t, "%lld", long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(int64, int64_t, "%lld", long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(uint8, uint8_t, "0x%02llX", unsigned long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(uint16, uint16_t, "0x%04llX", unsigned long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(uint32, uint32_t, "0x%08llX", unsigned long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(uint64, uint64_t, "0x%016llX", unsigned long long)
+
+/* Floating-point arrays: _near(e, a, tol) decides one element without branching, so the counting loop vectorizes */
+#define _LFG_CT_FP_ARRAY_DEF(_impl, _type, _tol_type, _near, _fmt, _tol_fmt, _tol_cast)                                \
+    int lfg_ct_assert_##_impl(const _type *expected, const _type *actual, size_t n, _tol_type tolerance,               \
+            const char *filename, int line_no, const char *function, const char *actual_expr_str)                      \
+    {                                                                                                                  \
+        char message[_LFG_CT_ARRAY_MESSAGE_MAX];                                                                       \
+        size_t bad = 0;                                                                                                \
+        size_t shown = 0;                                                                                              \
+        size_t len;                                                                                                    \
+        size_t i;                                                                                                      \
+                                                                                                                       \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);                                                         \
+        if (_lfg_ct_array_null(expected, actual, filename, line_no, function, actual_expr_str))                        \
+        {                                                                                                              \
+            RECORD_FAILURE();                                                                                          \
+            return -1;                                                                                                 \
+        }                                                                                                              \
+        for (i = 0; i < (NULL == expected ? 0 : n); i++)                                                               \
+        {                                                                                                              \
+            bad += !_near(expected[i], actual[i], tolerance);                                                          \
+        }                                                                                                              \
+        if (0 == bad)                                                                                                  \
+        {                                                                                                              \
+            RECORD_PASS();                                                                                             \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        len = _lfg_ct_appendf(message, sizeof(message), 0,                                                             \
+                "%s array (%zu elements) does not match expected: %zu differ (" _tol_fmt ")", actual_expr_str, n, bad, \
+                (_tol_cast)tolerance);                                                                                 \
+        for (i = 0; i < n && shown < LFG_CT_ARRAY_DIFF_MAX; i++)                                                       \
+        {                                                                                                              \
+            if (!_near(expected[i], actual[i], tolerance))                                                             \
+            {                                                                                                          \
+                len = _lfg_ct_appendf(message, sizeof(message), len,                                                   \
+                        "\r\n    [%zu] expected " _fmt ", actual " _fmt " (diff=%.3g, ulps=%llu)", i, expected[i],     \
+                        actual[i], (double)(actual[i] - expected[i]),                                                  \
+                        (unsigned long long)_lfg_ct_##_type##_ulps(expected[i], actual[i]));                           \
+                shown++;                                                                                               \
+            }                                                                                                          \
+        }                                                                                                              \
+        _lfg_ct_fail_message(filename, line_no, function, message);                                                    \
+        RECORD_FAILURE();                                                                                              \
+        return -1;                                                                                                     \
+    }
+
+/* equal values (including matching infinities) or within the tolerance; NaN never matches */
+#define _LFG_CT_NEAR_EPS(_fabs, _e, _a, _eps) (((_e) == (_a)) | (_fabs((_e) - (_a)) <= (_eps)))
+#define _LFG_CT_NEAR_ULP(_ulps_fn, _e, _a, _ulps)                                                                      \
+    (((_e) == (_a)) | (((_e) == (_e)) & ((_a) == (_a)) & (_ulps_fn((_e), (_a)) <= (_ulps))))
+
+#ifdef LFG_CTEST_HAS_FLOAT
+#define _LFG_CT_FLOAT_NEAR_EPS(_e, _a, _eps) _LFG_CT_NEAR_EPS(fabsf, _e, _a, _eps)
+#define _LFG_CT_FLOAT_NEAR_ULP(_e, _a, _ulps) _LFG_CT_NEAR_ULP(_lfg_ct_float_ulps, _e, _a, _ulps)
+
+_LFG_CT_FP_ARRAY_DEF(float_array_equal_impl, float, float, _LFG_CT_FLOAT_NEAR_EPS, "%.9g", "eps=%g", double)
+_LFG_CT_FP_ARRAY_DEF(float_array_equal_ulp_impl, float, uint64_t, _LFG_CT_FLOAT_NEAR_ULP, "%.9g", "ulps=%llu",
+        unsigned long long)
+#endif /* LFG_CTEST_HAS_FLOAT */
+
+#ifdef LFG_CTEST_HAS_DOUBLE
+#define _LFG_CT_DOUBLE_NEAR_EPS(_e, _a, _eps) _LFG_CT_NEAR_EPS(fabs, _e, _a, _eps)
+#define _LFG_CT_DOUBLE_NEAR_ULP(_e, _a, _ulps) _LFG_CT_NEAR_ULP(_lfg_ct_double_ulps, _e, _a, _ulps)
+
+_LFG_CT_FP_ARRAY_DEF(double_array_equal_impl, double, double, _LFG_CT_DOUBLE_NEAR_EPS, "%.17g", "eps=%g", double)
+_LFG_CT_FP_ARRAY_DEF(double_array_equal_ulp_impl, double, uint64_t, _LFG_CT_DOUBLE_NEAR_ULP, "%.17g", "ulps=%llu",
+        unsigned long long)
+#endif /* LFG_CTEST_HAS_DOUBLE */
+
+/*============================================================================
+ *  32-bit Float Assertions (optional)
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_HAS_FLOAT
+
+int lfg_ct_assert_float_equal_impl(float expected, float actual, float epsilon, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    float diff = fabsf(expected - actual);
+    if (diff > epsilon)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should equal %.6g (diff=%.6g, eps=%.6g)", actual_expr_str,
+                actual, expected, diff, epsilon);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_float_not_equal_impl(float expected, float actual, float epsilon, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    float diff = fabsf(expected - actual);
+    if (diff <= epsilon)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should not equal %.6g (diff=%.6g, eps=%.6g)",
+                actual_expr_str, actual, expected, diff, epsilon);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_float_greater_impl(float a, float b, const char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(a > b))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be > %s (%.6g)", a_expr_str, a, b_expr_str, b);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_float_less_impl(float a, float b, const char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(a < b))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be < %s (%.6g)", a_expr_str, a, b_expr_str, b);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_float_ge_impl(float a, float b, const char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(a >= b))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be >= %s (%.6g)", a_expr_str, a, b_expr_str, b);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_float_le_impl(float a, float b, const char *filename, int line_no, const char *function,
+        const char *a_expr_str, const char *b_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(a <= b))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be <= %s (%.6g)", a_expr_str, a, b_expr_str, b);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_float_in_range_impl(float val, float min, float max, const char *filename, int line_no,
+        const char *function, const char *val_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    if (!(val >= min && val <= max))
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be in range [%.6g, %.6g]", val_expr_str, val, min,
+                max);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+#endif /* LFG_CTEST_HAS_FLOAT */
+
+/*============================================================================
+ *  64-bit Double Assertions (optional)
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_HAS_DOUBLE
+
+int lfg_ct_assert_double_equal_impl(double expected, double actual, double epsilon, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    double diff = fabs(expected - actual);
+    if (diff > epsilon)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.10g) should equal %.10g (diff=%.10g, eps=%.10g)",
+                actual_expr_str, actual, expected, diff, epsilon);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_double_not_equal_impl(double expected, double actual, double epsilon, const char *filename,
+        int line_no, const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    double diff = fabs(expected - actual);
+    if (diff <= epsilon)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.10g) should not equal %.10g (diff=%.10g, eps=%.10g)",
+                actual_expr_str, actual, expected, diff, epsilon);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+#endif /* LFG_CTEST_HAS_DOUBLE */
+
+/*============================================================================
+ *  Private Functions
+ *==========================================================================*/
+
+/* Run one test in this process, timing it. A test run from inside another
+ * test keeps the outer test's failure count intact. */
+static void _lfg_ct_run(void (*fn)(void), const char *name, unsigned timeout_ms)
+{
+    int outer_failures = _current_test_failures;
+    const char *outer_name = _running_name;
+    uint64_t outer_start_ns = _running_start_ns;
+    struct _lfg_ct_watch saved;
+    uint64_t wall0 = _lfg_ct_wall_ns();
+    uint64_t cpu0 = _lfg_ct_cpu_ns();
+
+    _tests_executed++;
+    _current_test_failures = 0;
+    _running_name = name;
+    _running_start_ns = wall0;
+    _test_depth++;
+    _lfg_ct_watch_begin("test", name, timeout_ms, &saved);
+    fn();
+    _lfg_ct_watch_end(&saved);
+    _test_depth--;
+    _running_name = outer_name;
+    _running_start_ns = outer_start_ns;
+    _lfg_ct_test_finished(
+            name, _current_test_failures, _lfg_ct_wall_ns() - wall0, _lfg_ct_cpu_ns() - cpu0, NULL);
+    _current_test_failures = outer_failures;
+}
+
+/* Run a test that has already passed shard selection. */
+static void _lfg_ct_dispatch(void (*fn)(void), const char *name, unsigned timeout_ms)
+{
+#ifdef LFG_CTEST_HAS_FORK
+    if (_jobs > 1)
+    {
+        _lfg_ct_spawn(fn, name, timeout_ms);
+        return;
+    }
+    if (_isolate)
+    {
+        /* one worker at a time, so output and order match an in-process run */
+        _lfg_ct_spawn(fn, name, timeout_ms);
+        _lfg_ct_drain();
+        return;
+    }
+#endif
+    _lfg_ct_run(fn, name, timeout_ms);
+}
+
+/* Budget for the test or suite about to start: a pending
+ * lfg_ct_timeout_next() value, else @p fallback. */
+static unsigned _lfg_ct_take_timeout(unsigned fallback)
+{
+    if (_timeout_next_set)
+    {
+        _timeout_next_set = false;
+        return _timeout_next_ms;
+    }
+    return fallback;
+}
+
+/* Enter a test or suite with an @p ms budget (0 = none). The tighter of it
+ * and any enclosing budget is armed; @p saved restores the enclosing one. */
+static void _lfg_ct_watch_begin(const char *what, const char *name, unsigned ms, struct _lfg_ct_watch *saved)
+{
+    *saved = _watch;
+    if (ms > 0)
+    {
+        uint64_t deadline_ns = _lfg_ct_wall_ns() + (uint64_t)ms * 1000000u;
+        if (0 == _watch.deadline_ns || deadline_ns < _watch.deadline_ns)
+        {
+            _watch.what = what;
+            _watch.name = name;
+            _watch.ms = ms;
+            _watch.deadline_ns = deadline_ns;
+        }
+    }
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    if (_watch.deadline_ns != 0)
+    {
+        _lfg_ct_watch_arm(); /* also re-arms an inherited budget in a fresh worker */
+    }
+#endif
+}
+
+static void _lfg_ct_watch_end(const struct _lfg_ct_watch *saved)
+{
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    bool changed = saved->deadline_ns != _watch.deadline_ns;
+#endif
+
+    _watch = *saved;
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    if (changed)
+    {
+        _lfg_ct_watch_arm();
+    }
+#endif
+}
+
+#ifdef LFG_CTEST_HAS_WATCHDOG
+
+/* Point ITIMER_REAL at the current deadline, or disarm it and put back the
+ * SIGALRM action that was in place before the first budget. */
+static void _lfg_ct_watch_arm(void)
+{
+    struct itimerval it;
+
+    memset(&it, 0, sizeof(it));
+    if (_watch.deadline_ns != 0)
+    {
+        uint64_t now_ns = _lfg_ct_wall_ns();
+        uint64_t left_ns = _watch.deadline_ns > now_ns ? _watch.deadline_ns - now_ns : 1000u;
+
+        if (!_watchdog_installed)
+        {
+            struct sigaction sa;
+#ifdef LFG_CTEST_HAS_BACKTRACE
+            void *frame;
+
+            backtrace(&frame, 1); /* loads the unwinder now, not inside the handler */
+#endif
+            memset(&sa, 0, sizeof(sa));
+            sa.sa_handler = _lfg_ct_watchdog;
+            sigemptyset(&sa.sa_mask);
+            sigaction(SIGALRM, &sa, &_watchdog_saved);
+            _watchdog_installed = true;
+        }
+        it.it_value.tv_sec = (time_t)(left_ns / 1000000000u);
+        it.it_value.tv_usec = (suseconds_t)(left_ns / 1000u % 1000000u);
+        if (0 == it.it_value.tv_sec && 0 == it.it_value.tv_usec)
+        {
+            it.it_value.tv_usec = 1;
+        }
+    }
+    else if (!_watchdog_installed)
+    {
+        return; /* never armed, nothing to cancel */
+    }
+    setitimer(ITIMER_REAL, &it, NULL);
+    if (0 == _watch.deadline_ns)
+    {
+        sigaction(SIGALRM, &_watchdog_saved, NULL);
+        _watchdog_installed = false;
+    }
+}
+
+/* SIGALRM: the innermost budget ran out and whatever is running is stuck.
+ * Only async-signal-safe calls here: write(), the stack of the stuck code,
+ * kill() and _exit(). A worker's parent sees the exit status and reports the
+ * timeout. In-process nobody else can, so the handler writes the pending
+ * console batch, the timeout, the failed test and the summary line itself,
+ * in the console reporter's format, and ends the run with status 1. Other
+ * reporters and the result file get nothing; lfg_ct_isolate() keeps them. */
+static void _lfg_ct_watchdog(int sig)
+{
+    static const char message[] = "\r\n*** TIME BUDGET EXCEEDED, stopping\r\n";
+    char line[512];
+    size_t len = 0;
+    unsigned long failures = (unsigned long)_tests_failed;
+    ssize_t n;
+#ifdef LFG_CTEST_HAS_BACKTRACE
+    void *frames[LFG_CT_BACKTRACE_MAX];
+    int frames_count;
+#endif
+#ifdef LFG_CTEST_HAS_FORK
+    unsigned i;
+#endif
+
+    (void)sig;
+#ifdef LFG_CTEST_HAS_FORK
+    if (_in_worker)
+    {
+        n = write(STDOUT_FILENO, message, sizeof(message) - 1);
+        (void)n;
+#ifdef LFG_CTEST_HAS_BACKTRACE
+        frames_count = backtrace(frames, LFG_CT_BACKTRACE_MAX);
+        backtrace_symbols_fd(frames, frames_count, STDOUT_FILENO);
+#endif
+        _exit(_LFG_CT_TIMEOUT_STATUS);
+    }
+    for (i = 0; i < _workers_active; i++)
+    {
+        kill(_workers[i].pid, SIGKILL);
+    }
+#else
+    (void)message;
+#endif
+
+    n = write(STDOUT_FILENO, _report_buf, _report_len);
+    _lfg_ct_sig_append(line, sizeof(line), &len, "*** ");
+    _lfg_ct_sig_append(line, sizeof(line), &len, _watch.what);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " ");
+    _lfg_ct_sig_append(line, sizeof(line), &len, _watch.name);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " TIMED OUT after ");
+    _lfg_ct_sig_append_uint(line, sizeof(line), &len, _watch.ms);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " ms\r\n");
+    n = write(STDOUT_FILENO, line, len);
+#ifdef LFG_CTEST_HAS_BACKTRACE
+    frames_count = backtrace(frames, LFG_CT_BACKTRACE_MAX);
+    backtrace_symbols_fd(frames, frames_count, STDOUT_FILENO);
+#endif
+
+    len = 0;
+    if (_running_name)
+    {
+        _lfg_ct_sig_append(line, sizeof(line), &len, "*** test FAILURE: ");
+        _lfg_ct_sig_append(line, sizeof(line), &len, _running_name);
+        _lfg_ct_sig_append(line, sizeof(line), &len, " (timed out)\r\n");
+        failures++;
+    }
+    _lfg_ct_sig_append(line, sizeof(line), &len, "*** Executed ");
+    _lfg_ct_sig_append_uint(line, sizeof(line), &len, (unsigned long)lfg_ct_counters.assertions_executed);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " assertions in ");
+    _lfg_ct_sig_append_uint(line, sizeof(line), &len, (unsigned long)_tests_executed);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " tests. Failures: ");
+    _lfg_ct_sig_append_uint(line, sizeof(line), &len, failures);
+    _lfg_ct_sig_append(line, sizeof(line), &len, "\r\n*** Testing complete. Result: FAIL\r\n");
+    n = write(STDOUT_FILENO, line, len);
+    (void)n;
+    _exit(1);
+}
+
+/* Append @p s to @p line, truncating at @p size; async-signal-safe. */
+static void _lfg_ct_sig_append(char *line, size_t size, size_t *len, const char *s)
+{
+    while (*s && *len < size)
+    {
+        line[(*len)++] = *s++;
+    }
+}
+
+/* Append @p v in decimal to @p line; async-signal-safe. */
+static void _lfg_ct_sig_append_uint(char *line, size_t size, size_t *len, unsigned long v)
+{
+    char digits[24];
+    size_t i = sizeof(digits) - 1;
+
+    digits[i] = '\0';
+    do
+    {
+        digits[--i] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v > 0);
+    _lfg_ct_sig_append(line, size, len, digits + i);
+}
+
+#ifdef LFG_CTEST_HAS_FORK
+
+/* Stop this process's own timer while it waits on workers, so an enclosing
+ * budget that runs out meanwhile is reported by _lfg_ct_watch_resume() instead
+ * of ending the run from the signal handler. */
+static void _lfg_ct_watch_pause(void)
+{
+    struct itimerval it;
+
+    if (_watchdog_installed)
+    {
+        memset(&it, 0, sizeof(it));
+        setitimer(ITIMER_REAL, &it, NULL);
+    }
+}
+
+/* Done waiting on a worker: re-arm, or if the budget ran out meanwhile report
+ * it, stop the other workers, print the summary and end the run. */
+static void _lfg_ct_watch_resume(void)
+{
+    lfg_ct_event_t ev;
+    unsigned i;
+
+    if (0 == _watch.deadline_ns || _lfg_ct_wall_ns() < _watch.deadline_ns)
+    {
+        _lfg_ct_watch_arm();
+        return;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_TIMEOUT;
+    ev.name = _watch.name;
+    ev.message = _watch.what;
+    ev.wall_ns = (uint64_t)_watch.ms * 1000000u;
+    _lfg_ct_emit(&ev);
+
+    memset(&_watch, 0, sizeof(_watch)); /* the drain below must not come back here */
+    _lfg_ct_watch_arm();
+    for (i = 0; i < _workers_active; i++)
+    {
+        kill(_workers[i].pid, SIGKILL);
+    }
+    _lfg_ct_drain();
+    if (_running_name)
+    {
+        _lfg_ct_test_finished(_running_name, 1, _lfg_ct_wall_ns() - _running_start_ns, 0, "timed out");
+    }
+    lfg_ct_print_summary();
+    lfg_ct_end();
+    exit(1);
+}
+
+#endif /* LFG_CTEST_HAS_FORK */
+
+#endif /* LFG_CTEST_HAS_WATCHDOG */
+
+/* Advance the shard ordinal; true if the test belongs to another shard.
+ * Round-robin on the ordinal splits tests evenly and deterministically as
+ * long as every shard runs the same binary with the same selection. */
+static bool _lfg_ct_shard_skip(void)
+{
+    unsigned ordinal;
+
+    _lfg_ct_shard_from_env();
+    ordinal = _shard_ordinal++;
+    if (ordinal % _shard_count != _shard_index)
+    {
+        _tests_skipped++;
+        return true;
+    }
+    return false;
+}
+
+/* Pick up LFG_CT_SHARD_INDEX / LFG_CT_SHARD_COUNT / LFG_CT_RESULT_FILE once.
+ * Invalid values are reported and ignored, so the binary runs every test
+ * rather than silently dropping some. */
+static void _lfg_ct_shard_from_env(void)
+{
+    const char *index;
+    const char *count;
+    const char *file;
+
+    if (_shard_env_read)
+    {
+        return;
+    }
+    _shard_env_read = true;
+
+    file = getenv("LFG_CT_RESULT_FILE");
+    if (file && *file && NULL == _result_file)
+    {
+        _result_file = file;
+    }
+    index = getenv("LFG_CT_SHARD_INDEX");
+    count = getenv("LFG_CT_SHARD_COUNT");
+    if (index && count)
+    {
+        unsigned i = (unsigned)strtoul(index, NULL, 10);
+        unsigned n = (unsigned)strtoul(count, NULL, 10);
+        if (0 == n || i >= n)
+        {
+            fprintf(stderr, "lfg-ctest: ignoring invalid shard %s/%s\n", index, count);
+            return;
+        }
+        _shard_index = i;
+        _shard_count = n;
+    }
+}
+
+/* Write the run totals as key=value lines for a CI merge step. */
+static void _lfg_ct_write_result_file(void)
+{
+    FILE *f;
+    unsigned i;
+
+    if (NULL == _result_file)
+    {
+        return;
+    }
+    f = fopen(_result_file, "w");
+    if (NULL == f)
+    {
+        fprintf(stderr, "lfg-ctest: cannot write result file %s\n", _result_file);
+        return;
+    }
+    fprintf(f,
+            "shard_index=%u\nshard_count=%u\ntests_executed=%d\ntests_passed=%d\ntests_failed=%d\n"
+            "tests_skipped=%d\nassertions_executed=%d\nassertions_failed=%d\nwall_ns=%llu\ncpu_ns=%llu\n"
+            "result=%s\n",
+            _shard_index, _shard_count, _tests_executed, _tests_passed, _tests_failed, _tests_skipped,
+            lfg_ct_counters.assertions_executed, _assertions_failed, (unsigned long long)_tests_wall_ns,
+            (unsigned long long)_tests_cpu_ns, _tests_failed ? "FAIL" : "PASS");
+    for (i = 0; i < _failed_names_count; i++)
+    {
+        fprintf(f, "failed_test=%s\n", _failed_names[i]);
+    }
+    fclose(f);
+}
+
+/* Fold one finished test into the test/suite counters and timing tables.
+ * @p reason describes a test that failed without an assertion (worker crash). */
+static void _lfg_ct_test_finished(
+        const char *name, int failures, uint64_t wall_ns, uint64_t cpu_ns, const char *reason)
+{
+    lfg_ct_event_t ev;
+
+    _tests_wall_ns += wall_ns;
+    _tests_cpu_ns += cpu_ns;
+    _lfg_ct_slowest_insert(_slowest_tests, &_slowest_tests_count, name, wall_ns, cpu_ns);
+    if (failures > 0)
+    {
+#ifdef LFG_CTEST_SELF_TEST
+        /* a whole test failing (e.g. a crashed worker) counts like a failed
+         * assertion while the parent is in expect-failures mode */
+        if (_expect_failures_mode)
+        {
+            _expected_failures_count++;
+            failures = 0;
+        }
+        else
+#endif
+        {
+            _current_suite_failures++;
+            _tests_failed++;
+            if (_failed_names_count < LFG_CT_FAILED_NAMES_MAX)
+            {
+                _failed_names[_failed_names_count++] = name;
+            }
+        }
+    }
+    if (0 == failures)
+    {
+        _tests_passed++;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_TEST_END;
+    ev.name = name;
+    ev.message = reason;
+    ev.failures = failures;
+    ev.wall_ns = wall_ns;
+    ev.cpu_ns = cpu_ns;
+    _lfg_ct_emit(&ev);
+}
+
+/* Format an assertion failure and hand it to every reporter. */
+static void _lfg_ct_fail(const char *filename, int line_no, const char *function, const char *fmt, ...)
+{
+    char message[LFG_CT_MESSAGE_MAX];
+    char *text = message;
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(message, sizeof(message), fmt, ap);
+    va_end(ap);
+
+    /* long strings in STR/STRN failures must not be cut short: format those on the heap */
+    if (n >= (int)sizeof(message) && NULL != (text = malloc((size_t)n + 1)))
+    {
+        va_start(ap, fmt);
+        vsnprintf(text, (size_t)n + 1, fmt, ap);
+        va_end(ap);
+    }
+    else
+    {
+        text = message;
+    }
+
+    _lfg_ct_fail_message(filename, line_no, function, text);
+    if (text != message)
+    {
+        free(text);
+    }
+}
+
+static void _lfg_ct_fail_message(const char *filename, int line_no, const char *function, const char *message)
+{
+    lfg_ct_event_t ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_FAILURE;
+    ev.file = filename;
+    ev.line = line_no;
+    ev.function = function;
+    ev.message = message;
+    _lfg_ct_emit(&ev);
+}
+
+/* vsnprintf onto @p buf at @p len, returning the new length clamped to the buffer */
+static size_t _lfg_ct_appendf(char *buf, size_t size, size_t len, const char *fmt, ...)
+{
+    va_list ap;
+    int w;
+
+    if (len + 1 >= size)
+    {
+        return len;
+    }
+    va_start(ap, fmt);
+    w = vsnprintf(buf + len, size - len, fmt, ap);
+    va_end(ap);
+    if (w < 0)
+    {
+        return len;
+    }
+    return ((size_t)w < size - len) ? len + (size_t)w : size - 1;
+}
+
+/* Report an array assertion given exactly one NULL array. Two NULLs compare equal. */
+static bool _lfg_ct_array_null(const void *expected, const void *actual, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    if ((NULL == expected) == (NULL == actual))
+    {
+        return false;
+    }
+    _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p (NULL mismatch)", actual_expr_str, actual,
+            expected);
+    return true;
+}
+
+#ifdef LFG_CTEST_HAS_FLOAT
+/* Distance in representable floats: map the bits onto a monotonic unsigned scale and subtract */
+static uint64_t _lfg_ct_float_ulps(float a, float b)
+{
+    uint32_t ua, ub;
+
+    memcpy(&ua, &a, sizeof(ua));
+    memcpy(&ub, &b, sizeof(ub));
+    ua ^= (0u - (ua >> 31)) | 0x80000000u; /* negative: flip all bits; positive: set the sign */
+    ub ^= (0u - (ub >> 31)) | 0x80000000u;
+    return (ua > ub) ? ua - ub : ub - ua;
+}
+#endif
+
+#ifdef LFG_CTEST_HAS_DOUBLE
+static uint64_t _lfg_ct_double_ulps(double a, double b)
+{
+    const uint64_t sign = (uint64_t)1 << 63;
+    uint64_t ua, ub;
+
+    memcpy(&ua, &a, sizeof(ua));
+    memcpy(&ub, &b, sizeof(ub));
+    ua ^= (0u - (ua >> 63)) | sign;
+    ub ^= (0u - (ub >> 63)) | sign;
+    return (ua > ub) ? ua - ub : ub - ua;
+}
+#endif
+
+/* First offset in [from, n) where @p a and @p b differ, or n. Equal blocks are
+ * skipped with memcmp, which libc already vectorizes, and only the block that
+ * differs is narrowed down, a word and then a byte at a time. */
+static size_t _lfg_ct_mem_mismatch(const unsigned char *a, const unsigned char *b, size_t from, size_t n)
+{
+    while (from < n)
+    {
+        size_t block = (n - from < _LFG_CT_DIFF_BLOCK) ? n - from : _LFG_CT_DIFF_BLOCK;
+        if (memcmp(a + from, b + from, block) != 0)
+        {
+            break;
+        }
+        from += block;
+    }
+    while (n - from >= sizeof(uint64_t))
+    {
+        uint64_t wa, wb;
+        memcpy(&wa, a + from, sizeof(wa));
+        memcpy(&wb, b + from, sizeof(wb));
+        if (wa != wb)
+        {
+            break;
+        }
+        from += sizeof(uint64_t);
+    }
+    while (from < n && a[from] == b[from])
+    {
+        from++;
+    }
+    return from;
+}
+
+/* Index of the first differing char within the first @p n, stopping at a shared terminator */
+static size_t _lfg_ct_str_mismatch(const char *a, const char *b, size_t n)
+{
+    size_t i = 0;
+
+    while (i < n && a[i] == b[i] && a[i] != '\0')
+    {
+        i++;
+    }
+    return i;
+}
+
+/* Format the row of @p n bytes starting at @p row as expected, actual and a ^^ line under the
+ * bytes that differ. Returns the length written, or 0 if it did not fit in @p room. */
+static size_t _lfg_ct_hexdump_row(char *out, size_t room, const unsigned char *expected, const unsigned char *actual,
+        size_t row, size_t n)
+{
+    size_t end = (n - row < _LFG_CT_HEXDUMP_ROW) ? n : row + _LFG_CT_HEXDUMP_ROW;
+    size_t last = row;
+    size_t len;
+    size_t i;
+    int w;
+
+    w = snprintf(out, room, "\r\n    0x%08zx exp:", row);
+    len = (w > 0) ? (size_t)w : 0;
+    for (i = row; i < end && len < room; i++)
+    {
+        len += (size_t)snprintf(out + len, room - len, " %02x", expected[i]);
+    }
+    if (len < room)
+    {
+        len += (size_t)snprintf(out + len, room - len, "\r\n               act:");
+    }
+    for (i = row; i < end && len < room; i++)
+    {
+        len += (size_t)snprintf(out + len, room - len, " %02x", actual[i]);
+        if (expected[i] != actual[i])
+        {
+            last = i;
+        }
+    }
+    if (len < room)
+    {
+        len += (size_t)snprintf(out + len, room - len, "\r\n                   ");
+    }
+    for (i = row; i <= last && len < room; i++)
+    {
+        len += (size_t)snprintf(out + len, room - len, "%s", (expected[i] != actual[i]) ? " ^^" : "   ");
+    }
+    return (len < room) ? len : 0;
+}
+
+/* Report a failed ASSERT_MEM_EQUAL whose first difference is at @p first: count every
+ * differing byte and run, then hexdump the rows of the first LFG_CT_MEM_DIFF_WINDOWS runs. */
+static void _lfg_ct_fail_mem(const unsigned char *expected, const unsigned char *actual, size_t n, size_t first,
+        char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    char message[LFG_CT_MESSAGE_MAX + LFG_CT_MEM_DIFF_WINDOWS * _LFG_CT_HEXDUMP_ROW_MAX];
+    size_t rows[LFG_CT_MEM_DIFF_WINDOWS];
+    unsigned nrows = 0;
+    size_t bytes = 0;
+    size_t runs = 0;
+    size_t off = first;
+    size_t len;
+    unsigned i;
+    int w;
+
+    while (off < n)
+    {
+        size_t row = off - off % _LFG_CT_HEXDUMP_ROW;
+        if (nrows < LFG_CT_MEM_DIFF_WINDOWS && (0 == nrows || rows[nrows - 1] != row))
+        {
+            rows[nrows++] = row;
+        }
+        runs++;
+        while (off < n && expected[off] != actual[off])
+        {
+            bytes++;
+            off++;
+        }
+        off = _lfg_ct_mem_mismatch(expected, actual, off, n);
+    }
+
+    w = snprintf(message, LFG_CT_MESSAGE_MAX,
+            "%s memory (%zu bytes) does not match expected: %zu bytes differ in %zu runs, first at offset %zu (0x%zx)",
+            actual_expr_str, n, bytes, runs, first, first);
+    len = (w < 0) ? 0 : ((size_t)w < LFG_CT_MESSAGE_MAX) ? (size_t)w : LFG_CT_MESSAGE_MAX - 1;
+    for (i = 0; i < nrows; i++)
+    {
+        len += _lfg_ct_hexdump_row(message + len, sizeof(message) - len, expected, actual, rows[i], n);
+    }
+    message[len] = '\0';
+    _lfg_ct_fail_message(filename, line_no, function, message);
+}
+
+static void _lfg_ct_emit(const lfg_ct_event_t *event)
+{
+    unsigned i;
+
+    _LFG_CT_REPORT_LOCK();
+    if (_console_enabled)
+    {
+        _lfg_ct_console(event);
+    }
+    for (i = 0; i < _reporters_count; i++)
+    {
+        _reporters[i].fn(event, _reporters[i].ctx);
+    }
+    _LFG_CT_REPORT_UNLOCK();
+}
+
+/* Write out the console batch. Callers hold the report lock. */
+static void _lfg_ct_report_write(void)
+{
+    if (_report_len > 0)
+    {
+        fwrite(_report_buf, 1, _report_len, stdout);
+        _report_len = 0;
+    }
+    fflush(stdout);
+}
+
+/* Built-in console reporter. Lines are collected in _report_buf and written
+ * in one go at the end of each test, suite and run (or when the buffer fills),
+ * instead of one stdio call per failure. */
+static void _lfg_ct_console(const lfg_ct_event_t *event)
+{
+    switch (event->type)
+    {
+    case LFG_CT_EVENT_START:
+        _lfg_ct_console_printf("*** begin unit test\r\n*** random seed is %u\r\n", event->seed);
+        if (event->shard_count > 1)
+        {
+            _lfg_ct_console_printf("*** shard %u of %u\r\n", event->shard_index, event->shard_count);
+        }
+        _lfg_ct_report_write();
+        break;
+
+    case LFG_CT_EVENT_FAILURE:
+        _lfg_ct_console_printf("*** %s: %u: FAILURE in %s(): %s\r\n", event->file, event->line, event->function,
+                event->message);
+#ifdef LFG_CTEST_HAS_FORK
+        if (_in_worker || _isolate)
+        {
+            _lfg_ct_report_write(); /* a crash is expected to be survivable here; it would lose the batch */
+        }
+#endif
+        break;
+
+    case LFG_CT_EVENT_TEST_END:
+        if (event->failures > 0)
+        {
+            if (event->message)
+            {
+                _lfg_ct_console_printf("*** test FAILURE: %s (%s)\r\n", event->name, event->message);
+            }
+            else
+            {
+                _lfg_ct_console_printf("*** test FAILURE: %s\r\n", event->name);
+            }
+        }
+        else if (event->message)
+        {
+            _lfg_ct_console_printf("*** test %s: %s\r\n", event->name, event->message);
+        }
+        _lfg_ct_report_write();
+        break;
+
+    case LFG_CT_EVENT_SUITE_END:
+        if (event->failures > 0)
+        {
+            _lfg_ct_console_printf("*** suite FAILURE: %s\r\n", event->name);
+        }
+        _lfg_ct_report_write();
+        break;
+
+    case LFG_CT_EVENT_TIMEOUT:
+        _lfg_ct_console_printf("*** %s %s TIMED OUT after %lu ms\r\n", event->message, event->name,
+                (unsigned long)(event->wall_ns / 1000000u));
+        _lfg_ct_report_write(); /* ahead of the backtrace, which goes straight to stdout */
+        break;
+
+    case LFG_CT_EVENT_SUMMARY:
+        _lfg_ct_console_printf("*** Executed %d assertions in %d tests. Failures: %d\r\n", event->assertions_executed,
+                event->tests_executed, event->failures);
+        _lfg_ct_console_printf("*** Time: %lu.%03lu ms elapsed, tests %lu.%03lu ms wall, %lu.%03lu ms cpu\r\n",
+                (unsigned long)(event->elapsed_ns / 1000000u), (unsigned long)(event->elapsed_ns / 1000u % 1000u),
+                (unsigned long)(event->wall_ns / 1000000u), (unsigned long)(event->wall_ns / 1000u % 1000u),
+                (unsigned long)(event->cpu_ns / 1000000u), (unsigned long)(event->cpu_ns / 1000u % 1000u));
+        _lfg_ct_console_slowest("tests", event->slowest_tests, event->slowest_tests_count);
+        _lfg_ct_console_slowest("suites", event->slowest_suites, event->slowest_suites_count);
+        _lfg_ct_console_bench(event->bench, event->bench_count);
+        if (event->shard_count > 1)
+        {
+            /* one self-contained line a CI merge step can grep for */
+            _lfg_ct_console_printf("LFG_CT_RESULT shard=%u/%u tests=%d failed=%d skipped=%d assertions=%d "
+                                   "wall_ns=%llu result=%s\r\n",
+                    event->shard_index, event->shard_count, event->tests_executed, event->failures,
+                    event->tests_skipped, event->assertions_executed, (unsigned long long)event->wall_ns,
+                    event->failures ? "FAIL" : "PASS");
+        }
+        _lfg_ct_console_printf("*** Testing complete. Result: %s\r\n", event->failures ? "FAIL" : "PASS");
+        _lfg_ct_report_write();
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* Append one formatted line to the console batch, flushing first if it does
+ * not fit. Lines longer than the whole buffer are written straight through. */
+static void _lfg_ct_console_printf(const char *fmt, ...)
+{
+    size_t room = sizeof(_report_buf) - _report_len;
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(_report_buf + _report_len, room, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+    {
+        return;
+    }
+    if ((size_t)n < room)
+    {
+        _report_len += (size_t)n;
+        return;
+    }
+
+    _lfg_ct_report_write();
+    va_start(ap, fmt);
+    if ((size_t)n < sizeof(_report_buf))
+    {
+        vsnprintf(_report_buf, sizeof(_report_buf), fmt, ap);
+        _report_len = (size_t)n;
+    }
+    else
+    {
+        vprintf(fmt, ap);
+    }
+    va_end(ap);
+}
+
+/* Convert clock() ticks to nanoseconds without overflowing the intermediate. */
+static uint64_t _lfg_ct_ticks_to_ns(clock_t ticks)
+{
+    uint64_t t = (uint64_t)ticks;
+    return t / CLOCKS_PER_SEC * 1000000000u + t % CLOCKS_PER_SEC * 1000000000u / CLOCKS_PER_SEC;
+}
+
+/* Monotonic wall time. Falls back to clock() where clock_gettime() is missing
+ * (that measures CPU time on most hosted platforms, but is the only tick many
+ * embedded C libraries provide). */
+static uint64_t _lfg_ct_wall_ns(void)
+{
+#if defined(LFG_CTEST_HAS_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    if (0 == clock_gettime(CLOCK_MONOTONIC, &ts))
+    {
+        return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    }
+#endif
+    return _lfg_ct_ticks_to_ns(clock());
+}
+
+/* CPU time consumed by this process. */
+static uint64_t _lfg_ct_cpu_ns(void)
+{
+#if defined(LFG_CTEST_HAS_CLOCK_GETTIME) && defined(CLOCK_PROCESS_CPUTIME_ID)
+    struct timespec ts;
+    if (0 == clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts))
+    {
+        return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    }
+#endif
+    return _lfg_ct_ticks_to_ns(clock());
+}
+
+/* Insert into a table sorted by descending wall time, dropping the fastest
+ * entry once full. Tables hold LFG_CT_SLOWEST_MAX entries regardless of the
+ * report size so lfg_ct_set_report_slowest() may be called at any time. */
+static void _lfg_ct_slowest_insert(
+        lfg_ct_timing_t *table, unsigned *count, const char *name, uint64_t wall_ns, uint64_t cpu_ns)
+{
+    unsigned i = *count;
+
+    if (i == LFG_CT_SLOWEST_MAX)
+    {
+        if (wall_ns <= table[i - 1].wall_ns)
+        {
+            return;
+        }
+        i--;
+    }
+    else
+    {
+        (*count)++;
+    }
+    while (i > 0 && table[i - 1].wall_ns < wall_ns)
+    {
+        table[i] = table[i - 1];
+        i--;
+    }
+    table[i].name = name;
+    table[i].wall_ns = wall_ns;
+    table[i].cpu_ns = cpu_ns;
+}
+
+static void _lfg_ct_console_slowest(const char *what, const lfg_ct_timing_t *table, unsigned count)
+{
+    unsigned i;
+
+    if (0 == count)
+    {
+        return;
+    }
+    _lfg_ct_console_printf("*** Slowest %u %s:\r\n", count, what);
+    for (i = 0; i < count; i++)
+    {
+        _lfg_ct_console_printf("***   %lu.%03lu ms wall, %lu.%03lu ms cpu  %s\r\n",
+                (unsigned long)(table[i].wall_ns / 1000000u), (unsigned long)(table[i].wall_ns / 1000u % 1000u),
+                (unsigned long)(table[i].cpu_ns / 1000000u), (unsigned long)(table[i].cpu_ns / 1000u % 1000u),
+                table[i].name);
+    }
+}
+
+static void _lfg_ct_console_bench(const lfg_ct_bench_result_t *table, unsigned count)
+{
+    unsigned i;
+
+    if (0 == count)
+    {
+        return;
+    }
+    _lfg_ct_console_printf("*** Benchmarks (ns/op: min / median / mean / p99):\r\n");
+    for (i = 0; i < count; i++)
+    {
+        const lfg_ct_bench_result_t *b = &table[i];
+
+        _lfg_ct_console_printf("***   %lu.%03lu / %lu.%03lu / %lu.%03lu / %lu.%03lu",
+                (unsigned long)(b->min_ps / 1000u), (unsigned long)(b->min_ps % 1000u),
+                (unsigned long)(b->median_ps / 1000u), (unsigned long)(b->median_ps % 1000u),
+                (unsigned long)(b->mean_ps / 1000u), (unsigned long)(b->mean_ps % 1000u),
+                (unsigned long)(b->p99_ps / 1000u), (unsigned long)(b->p99_ps % 1000u));
+        if (b->median_mcycles > 0)
+        {
+            _lfg_ct_console_printf(", %lu.%03lu cycles", (unsigned long)(b->median_mcycles / 1000u),
+                    (unsigned long)(b->median_mcycles % 1000u));
+        }
+        _lfg_ct_console_printf("  %s (%u x %lu)\r\n", b->name, b->samples, b->iterations);
+    }
+}
+
+/* Match @p str against a glob supporting '*' (any run) and '?' (any char). */
+static bool _lfg_ct_glob(const char *pattern, const char *str)
+{
+    const char *star = NULL;
+    const char *resume = NULL;
+
+    while (*str)
+    {
+        if ('*' == *pattern)
+        {
+            star = pattern++;
+            resume = str;
+        }
+        else if ('?' == *pattern || *pattern == *str)
+        {
+            pattern++;
+            str++;
+        }
+        else if (star)
+        {
+            /* backtrack: let the last '*' swallow one more character */
+            pattern = star + 1;
+            str = ++resume;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while ('*' == *pattern)
+    {
+        pattern++;
+    }
+    return '\0' == *pattern;
+}
+
+static int _lfg_ct_node_name_cmp(const void *a, const void *b)
+{
+    const lfg_ct_test_node_t *na = *(const lfg_ct_test_node_t *const *)a;
+    const lfg_ct_test_node_t *nb = *(const lfg_ct_test_node_t *const *)b;
+    return strcmp(na->name, nb->name);
+}
+
+/* Match argv[*i] against "--name=value", "--name value" or "-s value". Returns
+ * the value (advancing *i past a separate value argument) or NULL. */
+static const char *_lfg_ct_option(int argc, char *argv[], int *i, const char *long_name, const char *short_name)
+{
+    const char *arg = argv[*i];
+    size_t n = strlen(long_name);
+
+    if (0 == strncmp(arg, long_name, n) && '=' == arg[n])
+    {
+        return arg + n + 1;
+    }
+    if ((0 == strcmp(arg, long_name) || (short_name && 0 == strcmp(arg, short_name))) && *i + 1 < argc)
+    {
+        return argv[++*i];
+    }
+    return NULL;
+}
+
+/* Time stamp counter where one is available, 0 elsewhere. */
+static uint64_t _lfg_ct_cycles(void)
+{
+#ifdef LFG_CT_HAS_CYCLES
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* Run @p fn @p iterations times; return elapsed wall ns and store elapsed cycles. */
+static uint64_t _lfg_ct_bench_sample(void (*fn)(void), unsigned long iterations, uint64_t *cycles)
+{
+    unsigned long i;
+    uint64_t c0 = _lfg_ct_cycles();
+    uint64_t t0 = _lfg_ct_wall_ns();
+
+    for (i = 0; i < iterations; i++)
+    {
+        fn();
+    }
+    *cycles = _lfg_ct_cycles() - c0;
+    return _lfg_ct_wall_ns() - t0;
+}
+
+/* Wait for every outstanding worker so the counters are complete. */
+static void _lfg_ct_drain(void)
+{
+#ifdef LFG_CTEST_HAS_FORK
+    while (_workers_active > 0)
+    {
+        _lfg_ct_reap_one();
+    }
+#endif
+}
+
+#ifdef LFG_CTEST_HAS_FORK
+
+/* Run one test in a forked worker. Blocks while all job slots are busy. If a
+ * pipe or process cannot be created the test runs in-process instead. */
+static void _lfg_ct_spawn(void (*fn)(void), const char *name, unsigned timeout_ms)
+{
+    int fds[2];
+    uint64_t start_ns;
+    pid_t pid;
+
+    while (_workers_active > 0 && _workers_active >= _jobs)
+    {
+        _lfg_ct_reap_one();
+    }
+
+    /* anything still buffered would otherwise be printed again by the child */
+    lfg_ct_report_flush();
+    fflush(stderr);
+
+    if (pipe(fds) != 0)
+    {
+        _lfg_ct_run(fn, name, timeout_ms);
+        return;
+    }
+
+    start_ns = _lfg_ct_wall_ns();
+    pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        _lfg_ct_run(fn, name, timeout_ms);
+        return;
+    }
+
+    if (0 == pid)
+    {
+        /* Child: start from zero so the parent can add the result as-is */
+        struct _lfg_ct_result r;
+        struct _lfg_ct_watch saved;
+        const char *p = (const char *)&r;
+        size_t left = sizeof(r);
+        uint64_t cpu0 = _lfg_ct_cpu_ns();
+
+        close(fds[0]);
+        _jobs = 0; /* nested lfg_ctest() calls run in this process */
+        _isolate = false;
+        _in_worker = true;
+        _workers_active = 0;
+        lfg_ct_counters.assertions_executed = 0;
+        _assertions_failed = 0;
+        lfg_ct_counters.assertions_passed = 0;
+        _current_test_failures = 0;
+        _tests_executed = 0;
+        _tests_failed = 0;
+        _tests_passed = 0;
+        _test_depth = 1;
+#ifdef LFG_CTEST_SELF_TEST
+        _expected_failures_count = 0;
+#endif
+        _running_name = name;
+        _running_start_ns = start_ns;
+
+        _lfg_ct_watch_begin("test", name, timeout_ms, &saved);
+        fn();
+        _lfg_ct_watch_end(&saved);
+
+        memset(&r, 0, sizeof(r));
+#ifdef LFG_CTEST_SELF_TEST
+        r.expected_failures = _expected_failures_count;
+#endif
+        r.assertions_executed = lfg_ct_counters.assertions_executed;
+        r.assertions_failed = _assertions_failed;
+        r.assertions_passed = lfg_ct_counters.assertions_passed;
+        r.test_failures = _current_test_failures;
+        r.nested_executed = _tests_executed;
+        r.nested_failed = _tests_failed;
+        r.nested_passed = _tests_passed;
+        r.wall_ns = _lfg_ct_wall_ns() - start_ns;
+        r.cpu_ns = _lfg_ct_cpu_ns() - cpu0;
+        lfg_ct_report_flush();
+        fflush(stderr);
+        while (left > 0)
+        {
+            ssize_t n = write(fds[1], p, left);
+            if (n < 0 && EINTR == errno)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                _exit(1);
+            }
+            p += n;
+            left -= (size_t)n;
+        }
+        _exit(0);
+    }
+
+    close(fds[1]);
+    _workers[_workers_active].pid = pid;
+    _workers[_workers_active].fd = fds[0];
+    _workers[_workers_active].name = name;
+    _workers[_workers_active].start_ns = start_ns;
+    _workers[_workers_active].timeout_ms = timeout_ms;
+    _workers_active++;
+}
+
+/* Block until some worker finishes, then merge its result. A worker whose
+ * result is missing (crash, abort, _exit) counts as a failed test. */
+static void _lfg_ct_reap_one(void)
+{
+    struct pollfd pfds[LFG_CT_JOBS_MAX];
+    struct _lfg_ct_worker w;
+    struct _lfg_ct_result r;
+    char reason[64];
+    char *p = (char *)&r;
+    size_t got = 0;
+    unsigned i;
+    int status = 0;
+
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    _lfg_ct_watch_pause();
+#endif
+    for (i = 0; i < _workers_active; i++)
+    {
+        pfds[i].fd = _workers[i].fd;
+        pfds[i].events = POLLIN;
+        pfds[i].revents = 0;
+    }
+    while (poll(pfds, _workers_active, -1) < 0 && EINTR == errno)
+    {
+    }
+    for (i = 0; i < _workers_active && 0 == pfds[i].revents; i++)
+    {
+    }
+    if (i == _workers_active)
+    {
+        i = 0; /* poll failed outright: block on the oldest worker */
+    }
+
+    w = _workers[i];
+    _workers[i] = _workers[--_workers_active];
+
+    while (got < sizeof(r))
+    {
+        ssize_t n = read(w.fd, p + got, sizeof(r) - got);
+        if (n < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        got += (size_t)n;
+    }
+    close(w.fd);
+    while (waitpid(w.pid, &status, 0) < 0 && EINTR == errno)
+    {
+    }
+
+    _tests_executed++;
+    if (got == sizeof(r) && WIFEXITED(status) && 0 == WEXITSTATUS(status))
+    {
+        lfg_ct_counters.assertions_executed += r.assertions_executed;
+        _assertions_failed += r.assertions_failed;
+        lfg_ct_counters.assertions_passed += r.assertions_passed;
+        _tests_executed += r.nested_executed;
+        _tests_failed += r.nested_failed;
+        _tests_passed += r.nested_passed;
+        _current_suite_failures += r.nested_failed;
+#ifdef LFG_CTEST_SELF_TEST
+        _expected_failures_count += r.expected_failures;
+#endif
+        _lfg_ct_test_finished(w.name, r.test_failures, r.wall_ns, r.cpu_ns, NULL);
+#ifdef LFG_CTEST_HAS_WATCHDOG
+        _lfg_ct_watch_resume();
+#endif
+        return;
+    }
+
+    if (WIFSIGNALED(status))
+    {
+        snprintf(reason, sizeof(reason), "killed by %s", _lfg_ct_signal_name(WTERMSIG(status)));
+    }
+    else if (WIFEXITED(status) && _LFG_CT_TIMEOUT_STATUS == WEXITSTATUS(status))
+    {
+        snprintf(reason, sizeof(reason), "timed out");
+        if (w.timeout_ms > 0 && (0 == _watch.deadline_ns || _lfg_ct_wall_ns() < _watch.deadline_ns))
+        {
+            /* the test's own budget; an enclosing one is reported by _lfg_ct_watch_resume() */
+            lfg_ct_event_t ev;
+
+            memset(&ev, 0, sizeof(ev));
+            ev.type = LFG_CT_EVENT_TIMEOUT;
+            ev.name = w.name;
+            ev.message = "test";
+            ev.wall_ns = (uint64_t)w.timeout_ms * 1000000u;
+            _lfg_ct_emit(&ev);
+        }
+    }
+    else
+    {
+        snprintf(reason, sizeof(reason), "worker exited abnormally (status %d)",
+                WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+    }
+    _lfg_ct_test_finished(w.name, 1, _lfg_ct_wall_ns() - w.start_ns, 0, reason);
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    _lfg_ct_watch_resume();
+#endif
+}
+
+/* Name of a signal that ended a worker, e.g. "SIGSEGV (segmentation fault)". */
+static const char *_lfg_ct_signal_name(int sig)
+{
+    static const struct
+    {
+        int sig;
+        const char *name;
+    } names[] = {
+        {SIGSEGV, "SIGSEGV (segmentation fault)"},
+        {SIGABRT, "SIGABRT (abort, e.g. a failed assert())"},
+        {SIGBUS, "SIGBUS (bus error)"},
+        {SIGFPE, "SIGFPE (arithmetic exception)"},
+        {SIGILL, "SIGILL (illegal instruction)"},
+        {SIGTRAP, "SIGTRAP (trace/breakpoint trap)"},
+        {SIGPIPE, "SIGPIPE (broken pipe)"},
+        {SIGALRM, "SIGALRM (alarm clock)"},
+        {SIGTERM, "SIGTERM (terminated)"},
+        {SIGKILL, "SIGKILL (killed)"},
+        {SIGINT, "SIGINT (interrupted)"},
+    };
+    static char unknown[32];
+    unsigned i;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if (names[i].sig == sig)
+        {
+            return names[i].name;
+        }
+    }
+    snprintf(unknown, sizeof(unknown), "signal %d", sig);
+    return unknown;
+}
+
+#endif /* LFG_CTEST_HAS_FORK */
+
+/* --- lfg-ctest-mock.c --- */
+/**
+ * @file
+ * @brief       lfg-ctest mocking API.
+ */
+
+/*============================================================================
+ *  Includes
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*============================================================================
+ *  Defines/Typedefs
+ *==========================================================================*/
+
+/** first allocation of a dynamic mock storage block, in elements */
+#define _MOCK_GROW_MIN 16
+
+/* Registration and param-action lookup can be reached from MOCK_THREAD_SAFE
+ * mocks on several threads. Both are short and rarely contended, so a spin is
+ * enough. Per-call paths take it through _MOCK_LOCK_FOR() so that ordinary
+ * mocks, which are never called concurrently, stay lock-free. */
+#ifdef LFG_CTEST_THREAD_SAFE
+#define _MOCK_LOCK()                                                                                                   \
+    do                                                                                                                 \
+    {                                                                                                                  \
+    } while (__atomic_test_and_set(&_mock_lock, __ATOMIC_ACQUIRE))
+#define _MOCK_UNLOCK() __atomic_clear(&_mock_lock, __ATOMIC_RELEASE)
+#define _MOCK_LOCK_FOR(_reg)                                                                                           \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if ((_reg)->thread_safe)                                                                                       \
+        {                                                                                                              \
+            _MOCK_LOCK();                                                                                              \
+        }                                                                                                              \
+    } while (0)
+#define _MOCK_UNLOCK_FOR(_reg)                                                                                         \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if ((_reg)->thread_safe)                                                                                       \
+        {                                                                                                              \
+            _MOCK_UNLOCK();                                                                                            \
+        }                                                                                                              \
+    } while (0)
+#define _MOCK_SET_REGISTERED(_reg, _val) __atomic_store_n(&(_reg)->registered, _val, __ATOMIC_RELEASE)
+#define _MOCK_STREAM_SET_CAPACITY(_s, _val) __atomic_store_n(&(_s)->capacity, _val, __ATOMIC_RELEASE)
+#define _MOCK_STREAM_GET_CAPACITY(_s) __atomic_load_n(&(_s)->capacity, __ATOMIC_ACQUIRE)
+#define _MOCK_TRACE_ID(_reg) __atomic_load_n(&(_reg)->trace_id, __ATOMIC_ACQUIRE)
+#define _MOCK_TRACE_NEXT_SEQ() __atomic_fetch_add(&_mock_trace_seq, 1, __ATOMIC_RELAXED)
+#define _MOCK_STATS_ADD(_field, _val) __atomic_fetch_add(&(_field), _val, __ATOMIC_RELAXED)
+#else
+#define _MOCK_LOCK() ((void)0)
+#define _MOCK_UNLOCK() ((void)0)
+#define _MOCK_LOCK_FOR(_reg) ((void)(_reg))
+#define _MOCK_UNLOCK_FOR(_reg) ((void)(_reg))
+#define _MOCK_SET_REGISTERED(_reg, _val) ((_reg)->registered = (_val))
+#define _MOCK_STREAM_SET_CAPACITY(_s, _val) ((_s)->capacity = (_val))
+#define _MOCK_STREAM_GET_CAPACITY(_s) ((_s)->capacity)
+#define _MOCK_TRACE_ID(_reg) ((_reg)->trace_id)
+#define _MOCK_TRACE_NEXT_SEQ() (_mock_trace_seq++)
+#define _MOCK_STATS_ADD(_field, _val) ((_field) += (_val))
+#endif
+
+/** smallest call trace ring, in records */
+#define _MOCK_TRACE_MIN 16
+
+/** call trace log header magic and format version */
+#define _MOCK_TRACE_MAGIC "LFGMTRC1"
+#define _MOCK_TRACE_VERSION 1u
+
+/** param stream file magic and format version */
+#define _MOCK_STREAM_MAGIC "LFGMPRM1"
+#define _MOCK_STREAM_VERSION 1u
+
+/** smallest param stream mapping, in records */
+#define _MOCK_STREAM_MIN 1024
+
+/** address space reserved per open param stream, in bytes (override at compile time) */
+#ifndef MOCK_PARAM_STREAM_RESERVE
+#if SIZE_MAX > 0xFFFFFFFFu
+#define MOCK_PARAM_STREAM_RESERVE ((size_t)1 << 36)
+#else
+#define MOCK_PARAM_STREAM_RESERVE ((size_t)1 << 26)
+#endif
+#endif
+
+/* mock_digest() (XXH64) primes */
+#define _MOCK_DIGEST_P1 0x9E3779B185EBCA87ull
+#define _MOCK_DIGEST_P2 0xC2B2AE3D27D4EB4Full
+#define _MOCK_DIGEST_P3 0x165667B19E3779F9ull
+#define _MOCK_DIGEST_P4 0x85EBCA77C2B2AE63ull
+#define _MOCK_DIGEST_P5 0x27D4EB2F165667C5ull
+
+#define _MOCK_ROTL64(_x, _r) (((_x) << (_r)) | ((_x) >> (64 - (_r))))
+
+/* Param-action nodes are carved from slabs. A chain's first slab also holds
+ * the chain bookkeeping, so starting a chain is a single allocation. */
+struct _mock_param_slab
+{
+    struct _mock_param_slab *next;
+    size_t used;
+    struct _mock_param_chain chain; /* valid in a chain's first slab only */
+    struct _mock_param_action nodes[MOCK_PARAM_SLAB_NODES];
+};
+
+/* One MOCK_EXPECT(); the expected _params struct follows the node */
+struct _mock_expectation
+{
+    struct _mock_expectation *next;          /* all expectations, in declaration order */
+    struct _mock_expectation *next_for_mock; /* the same mock's expectations */
+    struct _mock_expectation *next_in_seq;   /* sequenced expectations */
+    struct _mock_registration *reg;
+    const char *file;
+    int line;
+    size_t min;
+    size_t max;
+    size_t count;
+    size_t seq_pos; /* 1-based position in the sequence, 0 if not sequenced */
+    unsigned mask;  /* parameters set with MOCK_EXPECT_ARG() */
+    mock_expect_match_fn match;
+    void *match_ctx;
+    union
+    {
+        long double ld;
+        void *ptr;
+        uint64_t u;
+    } expected[];
+};
+
+/*============================================================================
+ *  Private Function Prototypes
+ *==========================================================================*/
+
+static mock_param_action_t _mock_param_append(mock_param_action_t action,
+        enum _mock_param_action_dir dir,
+        unsigned callidx,
+        unsigned paramidx,
+        void *buffer,
+        size_t buf_size);
+static struct _mock_param_slab *_mock_slab_get(void);
+static void _mock_param_index(struct _mock_param_chain *chain, struct _mock_param_action *head);
+static void _mock_trace_assign_id(struct _mock_registration *reg);
+static void _mock_stats_snapshot(const struct _mock_registration *reg, mock_stats_t *out);
+static int _mock_stats_cmp_peak(const void *a, const void *b);
+static int _mock_stats_cmp_callback(const void *a, const void *b);
+static void _mock_stats_reporter(const lfg_ct_event_t *event, void *ctx);
+static int _mock_expect_matches(const struct _mock_expectation *e, const void *params);
+static bool _mock_expect_in_sequence(const struct _mock_expectation *e);
+static uint64_t _mock_read64(const unsigned char *p);
+static uint32_t _mock_read32(const unsigned char *p);
+static uint64_t _mock_digest_round(uint64_t acc, uint64_t input);
+static uint64_t _mock_digest_merge(uint64_t acc, uint64_t val);
+static int _mock_write_u32(FILE *fp, uint32_t v);
+#ifdef LFG_CTEST_HAS_MMAP
+static bool _mock_param_stream_map(mock_param_stream_t *stream, uint64_t capacity);
+#endif
+
+/*============================================================================
+ *  Variables
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_THREAD_SAFE
+static bool _mock_lock;
+#endif
+
+/* registered mocks in registration order */
+static struct _mock_registration *_mock_registry_head;
+static struct _mock_registration *_mock_registry_tail;
+
+/* slabs returned by destroyed chains, reused before the heap */
+static struct _mock_param_slab *_mock_slab_pool;
+
+/* call trace: a power-of-two ring indexed by the global sequence number */
+bool _mock_trace_enabled;
+static bool _mock_trace_timestamps;
+static mock_trace_record_t *_mock_trace_ring;
+static size_t _mock_trace_mask;
+static uint64_t _mock_trace_seq;
+
+/* traced mocks by trace_id - 1 */
+static struct _mock_registration **_mock_trace_mocks;
+static size_t _mock_trace_nmocks;
+static size_t _mock_trace_mocks_cap;
+
+/* every mock called since the start of the run, in first-call order; never detached */
+static struct _mock_registration *_mock_stats_head;
+static struct _mock_registration *_mock_stats_tail;
+
+/* mocks listed per statistics table in the summary */
+static unsigned _mock_stats_top = 0;
+bool _mock_stats_timing = false;
+
+/* expectations in declaration order; each mock also chains its own */
+static struct _mock_expectation *_mock_expect_head;
+static struct _mock_expectation *_mock_expect_tail;
+
+/* cross-mock sequence: the cursor is the first sequenced expectation below
+ * its minimum, and nothing before the highest matched position may match */
+static bool _mock_expect_sequencing;
+static struct _mock_expectation *_mock_expect_seq_tail;
+static struct _mock_expectation *_mock_expect_seq_cursor;
+static size_t _mock_expect_seq_count;
+static size_t _mock_expect_seq_high;
+
+/*============================================================================
+ *  Public API
+ *==========================================================================*/
+
+mock_param_action_t mock_param_mem_read(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, void *buffer, size_t buf_size)
+{
+    return _mock_param_append(action, eMOCK_PARAM_ACTION_DIR_READ, callidx, paramidx, buffer, buf_size);
+}
+
+mock_param_action_t mock_param_mem_write(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, void *buffer, size_t buf_size)
+{
+    return _mock_param_append(action, eMOCK_PARAM_ACTION_DIR_WRITE, callidx, paramidx, buffer, buf_size);
+}
+
+mock_param_action_t mock_param_str_read(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, char *buffer, size_t buf_size)
+{
+    return _mock_param_append(action, eMOCK_PARAM_ACTION_DIR_READ_STR, callidx, paramidx, buffer, buf_size);
+}
+
+mock_param_action_t mock_param_str_write(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, const char *buffer, size_t buf_size)
+{
+    return _mock_param_append(
+            action, eMOCK_PARAM_ACTION_DIR_WRITE_STR, callidx, paramidx, (void *)buffer, buf_size);
+}
+
+mock_param_action_t mock_param_mem_digest(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, uint64_t *digest, size_t size)
+{
+    return _mock_param_append(action, eMOCK_PARAM_ACTION_DIR_DIGEST, callidx, paramidx, digest, size);
+}
+
+uint64_t mock_digest(const void *data, size_t size)
+{
+    const unsigned char *p = data;
+    const unsigned char *end = p + size;
+    uint64_t h;
+
+    if (size >= 32)
+    {
+        uint64_t v1 = _MOCK_DIGEST_P1 + _MOCK_DIGEST_P2;
+        uint64_t v2 = _MOCK_DIGEST_P2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - _MOCK_DIGEST_P1;
+
+        /* four independent lanes keep the multipliers busy */
+        do
+        {
+            v1 = _mock_digest_round(v1, _mock_read64(p));
+            v2 = _mock_digest_round(v2, _mock_read64(p + 8));
+            v3 = _mock_digest_round(v3, _mock_read64(p + 16));
+            v4 = _mock_digest_round(v4, _mock_read64(p + 24));
+            p += 32;
+        } while (end - p >= 32);
+
+        h = _MOCK_ROTL64(v1, 1) + _MOCK_ROTL64(v2, 7) + _MOCK_ROTL64(v3, 12) + _MOCK_ROTL64(v4, 18);
+        h = _mock_digest_merge(h, v1);
+        h = _mock_digest_merge(h, v2);
+        h = _mock_digest_merge(h, v3);
+        h = _mock_digest_merge(h, v4);
+    }
+    else
+    {
+        h = _MOCK_DIGEST_P5;
+    }
+
+    h += (uint64_t)size;
+
+    for (; end - p >= 8; p += 8)
+    {
+        h ^= _mock_digest_round(0, _mock_read64(p));
+        h = _MOCK_ROTL64(h, 27) * _MOCK_DIGEST_P1 + _MOCK_DIGEST_P4;
+    }
+    if (end - p >= 4)
+    {
+        h ^= (uint64_t)_mock_read32(p) * _MOCK_DIGEST_P1;
+        h = _MOCK_ROTL64(h, 23) * _MOCK_DIGEST_P2 + _MOCK_DIGEST_P3;
+        p += 4;
+    }
+    for (; p < end; p++)
+    {
+        h ^= *p * _MOCK_DIGEST_P5;
+        h = _MOCK_ROTL64(h, 11) * _MOCK_DIGEST_P1;
+    }
+
+    h ^= h >> 33;
+    h *= _MOCK_DIGEST_P2;
+    h ^= h >> 29;
+    h *= _MOCK_DIGEST_P3;
+    h ^= h >> 32;
+    return h;
+}
+
+void _mock_register(struct _mock_registration *reg)
+{
+    _MOCK_LOCK();
+    if (!reg->registered)
+    {
+        reg->next = NULL;
+        if (_mock_registry_tail)
+        {
+            _mock_registry_tail->next = reg;
+        }
+        else
+        {
+            _mock_registry_head = reg;
+        }
+        _mock_registry_tail = reg;
+        _MOCK_SET_REGISTERED(reg, true);
+
+        /* nodes without a call counter (hand-made registrations) have nothing to report */
+        if (!reg->stats_linked && reg->call_count)
+        {
+            if (_mock_stats_tail)
+            {
+                _mock_stats_tail->stats_next = reg;
+            }
+            else
+            {
+                _mock_stats_head = reg;
+                lfg_ct_reporter_add(_mock_stats_reporter, NULL);
+            }
+            _mock_stats_tail = reg;
+            reg->stats_linked = true;
+        }
+    }
+    _MOCK_UNLOCK();
+}
+
+void mock_reset_all(void)
+{
+    struct _mock_registration *reg;
+
+    _MOCK_LOCK();
+    reg = _mock_registry_head;
+    _mock_registry_head = NULL;
+    _mock_registry_tail = NULL;
+    _MOCK_UNLOCK();
+
+    while (reg)
+    {
+        struct _mock_registration *next = reg->next;
+        reg->next = NULL;
+        _MOCK_SET_REGISTERED(reg, false);
+        reg->reset_fn();
+        reg = next;
+    }
+
+    while (_mock_slab_pool)
+    {
+        struct _mock_param_slab *next = _mock_slab_pool->next;
+        free(_mock_slab_pool);
+        _mock_slab_pool = next;
+    }
+
+    mock_expect_reset();
+}
+
+struct _mock_param_action *_mock_param_actions_for_call(
+        const struct _mock_registration *reg, mock_param_action_t action, size_t call_index)
+{
+    struct _mock_param_action *head = action;
+    struct _mock_param_action *found = NULL;
+    struct _mock_param_chain *chain;
+    size_t lo, hi;
+
+    if (!head)
+    {
+        return NULL;
+    }
+
+    _MOCK_LOCK_FOR(reg);
+    chain = head->chain;
+    if (chain->indexed != chain->tail)
+    {
+        _mock_param_index(chain, head);
+    }
+
+    /* mocks are called with ascending indices, so the cursor nearly always answers */
+    lo = chain->cursor;
+    if (lo < chain->ncalls && chain->calls[lo]->call_index >= call_index
+            && (lo == 0 || chain->calls[lo - 1]->call_index < call_index))
+    {
+        hi = lo;
+    }
+    else
+    {
+        /* binary search for the first entry >= call_index */
+        lo = 0;
+        hi = chain->ncalls;
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (chain->calls[mid]->call_index < call_index)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+    }
+
+    if (hi < chain->ncalls && chain->calls[hi]->call_index == call_index)
+    {
+        found = chain->calls[hi++];
+    }
+    chain->cursor = hi;
+    _MOCK_UNLOCK_FOR(reg);
+
+    return found;
+}
+
+void mock_param_destroy(mock_param_action_t action)
+{
+    struct _mock_param_action *head = action;
+    struct _mock_param_slab *first, *last;
+
+    if (!head)
+    {
+        return;
+    }
+
+    /* the chain lives in one of its own slabs: detach everything first */
+    free(head->chain->calls);
+    first = head->chain->slabs;
+    last = first;
+    while (last->next)
+    {
+        last = last->next;
+    }
+
+    /* hand the whole slab list back to the pool */
+    last->next = _mock_slab_pool;
+    _mock_slab_pool = first;
+}
+
+mock_expect_t mock_expect_match(mock_expect_t exp, mock_expect_match_fn fn, void *ctx)
+{
+    exp->match = fn;
+    exp->match_ctx = ctx;
+    return exp;
+}
+
+void mock_expect_sequence_begin(void)
+{
+    _mock_expect_sequencing = true;
+}
+
+void mock_expect_sequence_end(void)
+{
+    _mock_expect_sequencing = false;
+}
+
+int mock_expect_verify(void)
+{
+    struct _mock_expectation *e;
+    char msg[256];
+    int unmet = 0;
+
+    for (e = _mock_expect_head; e; e = e->next)
+    {
+        if (e->count < e->min)
+        {
+            snprintf(msg, sizeof(msg), "%s expected at least %lu calls, got %lu", e->reg->name, (unsigned long)e->min,
+                    (unsigned long)e->count);
+            lfg_ct_assert_fail_impl((char *)e->file, e->line, e->reg->name, msg);
+            unmet++;
+        }
+    }
+
+    mock_expect_reset();
+    return unmet;
+}
+
+void mock_expect_reset(void)
+{
+    _MOCK_LOCK();
+    while (_mock_expect_head)
+    {
+        struct _mock_expectation *next = _mock_expect_head->next;
+        _mock_expect_head->reg->expect_cursor = NULL;
+        _mock_expect_head->reg->expect_tail = NULL;
+        free(_mock_expect_head);
+        _mock_expect_head = next;
+    }
+    _mock_expect_tail = NULL;
+    _mock_expect_sequencing = false;
+    _mock_expect_seq_tail = NULL;
+    _mock_expect_seq_cursor = NULL;
+    _mock_expect_seq_count = 0;
+    _mock_expect_seq_high = 0;
+    _MOCK_UNLOCK();
+}
+
+mock_expect_t _mock_expect_add(struct _mock_registration *reg, size_t min, size_t max, const char *file, int line)
+{
+    struct _mock_expectation *e = calloc(1, sizeof(*e) + reg->params_size);
+
+    if (!e)
+    {
+        fprintf(stderr, "MOCK EXPECT: out of memory adding an expectation for %s\n", reg->name);
+        lfg_ct_report_flush();
+        abort();
+    }
+    e->reg = reg;
+    e->file = file;
+    e->line = line;
+    e->min = min;
+    e->max = max;
+
+    _MOCK_LOCK();
+    if (_mock_expect_tail)
+    {
+        _mock_expect_tail->next = e;
+    }
+    else
+    {
+        _mock_expect_head = e;
+    }
+    _mock_expect_tail = e;
+
+    if (reg->expect_tail)
+    {
+        reg->expect_tail->next_for_mock = e;
+    }
+    reg->expect_tail = e;
+    if (!reg->expect_cursor)
+    {
+        reg->expect_cursor = e;
+    }
+
+    if (_mock_expect_sequencing)
+    {
+        e->seq_pos = ++_mock_expect_seq_count;
+        if (_mock_expect_seq_tail)
+        {
+            _mock_expect_seq_tail->next_in_seq = e;
+        }
+        _mock_expect_seq_tail = e;
+        if (!_mock_expect_seq_cursor && e->min > 0)
+        {
+            _mock_expect_seq_cursor = e;
+        }
+    }
+    _MOCK_UNLOCK();
+
+    return e;
+}
+
+void *_mock_expect_arg(mock_expect_t exp, unsigned n)
+{
+    exp->mask |= 1u << n;
+    return exp->expected;
+}
+
+/* Each call advances the mock's cursor past expectations that are used up,
+ * or that have their minimum and do not accept the call. Cursors only move
+ * forward, so matching costs amortized O(1) per call. The comparator and
+ * matcher run with the lock released, since a matcher may call other mocks.
+ * A call that runs off the end after passing expectations that rejected it
+ * is reported with the last one's reason, not as using them up. */
+void _mock_expect_call(struct _mock_registration *reg, size_t call_index, const void *params)
+{
+    struct _mock_expectation *e;
+    struct _mock_expectation *rejected = NULL;
+    struct _mock_expectation *fail_at = NULL;
+    char msg[256];
+    int verdict = -1;
+    int rejected_verdict = -1;
+
+    _MOCK_LOCK_FOR(reg);
+    e = reg->expect_cursor;
+    for (;;)
+    {
+        while (e && e->count >= e->max)
+        {
+            e = e->next_for_mock;
+        }
+        if (!e)
+        {
+            break;
+        }
+
+        _MOCK_UNLOCK_FOR(reg);
+        verdict = _mock_expect_matches(e, params);
+        _MOCK_LOCK_FOR(reg);
+
+        if (e->count >= e->max)
+        {
+            continue; /* used up meanwhile, by another thread or by the matcher itself */
+        }
+        if (verdict == -1 && !_mock_expect_in_sequence(e))
+        {
+            verdict = -3;
+        }
+        if (verdict == -1 || e->count < e->min)
+        {
+            break;
+        }
+        rejected = e;
+        rejected_verdict = verdict;
+        e = e->next_for_mock;
+    }
+    reg->expect_cursor = e;
+    if (!e && rejected)
+    {
+        e = rejected;
+        verdict = rejected_verdict;
+    }
+
+    if (!e)
+    {
+        fail_at = reg->expect_tail;
+        snprintf(msg, sizeof(msg), "%s call %lu is unexpected: its expectations are used up", reg->name,
+                (unsigned long)call_index);
+    }
+    else if (verdict == -1)
+    {
+        e->count++;
+        if (e->seq_pos)
+        {
+            if (e->seq_pos > _mock_expect_seq_high)
+            {
+                _mock_expect_seq_high = e->seq_pos;
+            }
+            while (_mock_expect_seq_cursor && _mock_expect_seq_cursor->count >= _mock_expect_seq_cursor->min)
+            {
+                _mock_expect_seq_cursor = _mock_expect_seq_cursor->next_in_seq;
+            }
+        }
+    }
+    else
+    {
+        fail_at = e;
+        if (verdict >= 0)
+        {
+            snprintf(msg, sizeof(msg), "%s call %lu: parameter p%d does not match the expectation", reg->name,
+                    (unsigned long)call_index, verdict);
+        }
+        else if (verdict == -2)
+        {
+            snprintf(msg, sizeof(msg), "%s call %lu is rejected by the expectation's matcher", reg->name,
+                    (unsigned long)call_index);
+        }
+        else if (e->seq_pos < _mock_expect_seq_high)
+        {
+            snprintf(msg, sizeof(msg), "%s call %lu is out of sequence: a later expectation already matched",
+                    reg->name, (unsigned long)call_index);
+        }
+        else
+        {
+            snprintf(msg, sizeof(msg), "%s call %lu is out of sequence: %s is expected first", reg->name,
+                    (unsigned long)call_index, _mock_expect_seq_cursor->reg->name);
+        }
+    }
+    _MOCK_UNLOCK_FOR(reg);
+
+    if (fail_at)
+    {
+        lfg_ct_assert_fail_impl((char *)fail_at->file, fail_at->line, reg->name, msg);
+    }
+}
+
+bool mock_stats_get(const char *name, mock_stats_t *out)
+{
+    struct _mock_registration *reg;
+
+    for (reg = _mock_stats_head; reg; reg = reg->stats_next)
+    {
+        if (0 == strcmp(reg->name, name))
+        {
+            _mock_stats_snapshot(reg, out);
+            return true;
+        }
+    }
+    return false;
+}
+
+void mock_stats_set_report(unsigned n)
+{
+    _mock_stats_top = n;
+    _mock_stats_timing = n > 0;
+}
+
+void mock_stats_print(FILE *fp, unsigned n)
+{
+    struct _mock_registration *reg;
+    mock_stats_t *stats;
+    size_t count = 0;
+    size_t shown;
+    size_t i;
+
+    for (reg = _mock_stats_head; reg; reg = reg->stats_next)
+    {
+        count++;
+    }
+    if (0 == count || 0 == n)
+    {
+        return;
+    }
+
+    stats = malloc(count * sizeof(*stats));
+    if (!stats)
+    {
+        return;
+    }
+    for (reg = _mock_stats_head, i = 0; reg; reg = reg->stats_next, i++)
+    {
+        _mock_stats_snapshot(reg, &stats[i]);
+    }
+
+    shown = count < n ? count : n;
+    qsort(stats, count, sizeof(*stats), _mock_stats_cmp_peak);
+    fprintf(fp, "*** Busiest %u mocks (peak calls between resets / storage, total calls):\r\n", (unsigned)shown);
+    for (i = 0; i < shown; i++)
+    {
+        if (stats[i].storage_wraps)
+        {
+            fprintf(fp, "***   %lu/%lu wrapping, %llu calls  %s\r\n", (unsigned long)stats[i].peak_calls,
+                    (unsigned long)stats[i].storage_max, (unsigned long long)stats[i].total_calls, stats[i].name);
+        }
+        else if (stats[i].storage_max)
+        {
+            fprintf(fp, "***   %lu/%lu (%lu%%), %llu calls  %s\r\n", (unsigned long)stats[i].peak_calls,
+                    (unsigned long)stats[i].storage_max,
+                    (unsigned long)(stats[i].peak_calls * 100u / stats[i].storage_max),
+                    (unsigned long long)stats[i].total_calls, stats[i].name);
+        }
+        else
+        {
+            fprintf(fp, "***   %lu/dynamic, %llu calls  %s\r\n", (unsigned long)stats[i].peak_calls,
+                    (unsigned long long)stats[i].total_calls, stats[i].name);
+        }
+    }
+
+    qsort(stats, count, sizeof(*stats), _mock_stats_cmp_callback);
+    shown = 0;
+    while (shown < count && shown < n && stats[shown].callback_calls)
+    {
+        shown++;
+    }
+    if (shown)
+    {
+        fprintf(fp, "*** Slowest %u mock callbacks:\r\n", (unsigned)shown);
+    }
+    for (i = 0; i < shown; i++)
+    {
+        fprintf(fp, "***   %lu.%03lu ms in %llu calls  %s\r\n", (unsigned long)(stats[i].callback_ns / 1000000u),
+                (unsigned long)(stats[i].callback_ns / 1000u % 1000u), (unsigned long long)stats[i].callback_calls,
+                stats[i].name);
+    }
+
+    free(stats);
+}
+
+void _mock_stats_fold(struct _mock_registration *reg)
+{
+    size_t calls = *reg->call_count;
+
+    reg->total_calls += calls;
+    if (calls > reg->peak_calls)
+    {
+        reg->peak_calls = calls;
+    }
+}
+
+void _mock_stats_callback(struct _mock_registration *reg, uint64_t start_ns)
+{
+    uint64_t ns = _mock_now_ns() - start_ns;
+
+    _MOCK_STATS_ADD(reg->callback_calls, 1);
+    _MOCK_STATS_ADD(reg->callback_ns, ns);
+}
+
+uint64_t _mock_now_ns(void)
+{
+#if defined(LFG_CTEST_HAS_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    if (0 == clock_gettime(CLOCK_MONOTONIC, &ts))
+    {
+        return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    }
+#endif
+    return (uint64_t)clock() * (1000000000u / CLOCKS_PER_SEC);
+}
+
+bool mock_param_stream_open(
+        mock_param_stream_t *stream, const char *name, size_t record_size, const char *path, uint64_t capacity)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    size_t reserved = MOCK_PARAM_STREAM_RESERVE;
+    void *base;
+    int fd;
+
+    mock_param_stream_close(stream);
+
+    if (capacity < _MOCK_STREAM_MIN)
+    {
+        capacity = _MOCK_STREAM_MIN;
+    }
+    if (sizeof(mock_param_stream_header_t) + capacity * record_size > reserved)
+    {
+        reserved = sizeof(mock_param_stream_header_t) + capacity * record_size;
+    }
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    /* the mapping only ever grows inside this range, so its address is stable */
+    base = mmap(NULL, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (MAP_FAILED == base)
+    {
+        close(fd);
+        return false;
+    }
+    stream->fd = fd;
+    stream->record_size = record_size;
+    stream->reserved = reserved;
+    stream->capacity = 0;
+    stream->hdr = base;
+    stream->records = (unsigned char *)base + sizeof(*stream->hdr);
+    if (!_mock_param_stream_map(stream, capacity))
+    {
+        munmap(base, reserved);
+        close(fd);
+        stream->hdr = NULL;
+        stream->records = NULL;
+        stream->fd = -1;
+        stream->reserved = 0;
+        return false;
+    }
+
+    /* the fresh mapping is zero-filled, so the name stays NUL-terminated */
+    memcpy(stream->hdr->magic, _MOCK_STREAM_MAGIC, sizeof(stream->hdr->magic));
+    stream->hdr->version = _MOCK_STREAM_VERSION;
+    stream->hdr->record_size = (uint32_t)record_size;
+    stream->hdr->count = 0;
+    strncpy(stream->hdr->name, name, sizeof(stream->hdr->name) - 1);
+    return true;
+#else
+    (void)stream;
+    (void)name;
+    (void)record_size;
+    (void)path;
+    (void)capacity;
+    return false;
+#endif
+}
+
+void mock_param_stream_close(mock_param_stream_t *stream)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    uint64_t count;
+
+    if (!stream->hdr)
+    {
+        return;
+    }
+
+    count = stream->hdr->count < stream->capacity ? stream->hdr->count : stream->capacity;
+    stream->hdr->count = count;
+    munmap(stream->hdr, stream->reserved);
+    if (ftruncate(stream->fd, (off_t)(sizeof(*stream->hdr) + count * stream->record_size)) != 0)
+    {
+        fprintf(stderr, "MOCK STREAM: cannot trim stream file\n");
+    }
+    close(stream->fd);
+
+    stream->hdr = NULL;
+    stream->records = NULL;
+    stream->capacity = 0;
+    stream->fd = -1;
+    stream->reserved = 0;
+#else
+    (void)stream;
+#endif
+}
+
+bool mock_param_reader_open(mock_param_reader_t *reader, const char *path)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    const mock_param_stream_header_t *hdr;
+    struct stat st;
+    uint64_t fits;
+    void *map;
+    int fd;
+
+    memset(reader, 0, sizeof(*reader));
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(*hdr))
+    {
+        close(fd);
+        return false;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == map)
+    {
+        return false;
+    }
+
+    hdr = map;
+    if (memcmp(hdr->magic, _MOCK_STREAM_MAGIC, sizeof(hdr->magic)) != 0 || hdr->version != _MOCK_STREAM_VERSION
+            || 0 == hdr->record_size || !memchr(hdr->name, '\0', sizeof(hdr->name)))
+    {
+        munmap(map, (size_t)st.st_size);
+        return false;
+    }
+
+    /* a stream that was never closed still has its whole mapping on disk */
+    fits = ((size_t)st.st_size - sizeof(*hdr)) / hdr->record_size;
+    reader->name = hdr->name;
+    reader->record_size = hdr->record_size;
+    reader->count = hdr->count < fits ? hdr->count : fits;
+    reader->records = (const unsigned char *)map + sizeof(*hdr);
+    reader->map = map;
+    reader->map_size = (size_t)st.st_size;
+    return true;
+#else
+    (void)path;
+    memset(reader, 0, sizeof(*reader));
+    return false;
+#endif
+}
+
+const void *mock_param_reader_at(const mock_param_reader_t *reader, uint64_t n)
+{
+    if (n >= reader->count)
+    {
+        return NULL;
+    }
+    return reader->records + n * reader->record_size;
+}
+
+void mock_param_reader_close(mock_param_reader_t *reader)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    if (reader->map)
+    {
+        munmap(reader->map, reader->map_size);
+    }
+#endif
+    memset(reader, 0, sizeof(*reader));
+}
+
+void _mock_param_stream_put(mock_param_stream_t *stream, uint64_t n, const void *record)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    uint64_t cap;
+    bool mapped = true;
+
+    _MOCK_LOCK();
+    cap = _MOCK_STREAM_GET_CAPACITY(stream);
+    if (cap <= n)
+    {
+        while (cap <= n)
+        {
+            cap *= 2;
+        }
+        mapped = _mock_param_stream_map(stream, cap);
+    }
+    _MOCK_UNLOCK();
+
+    if (!mapped)
+    {
+        /* other threads may still be writing, so the stream stays open; only
+         * the first record that does not fit reports it */
+        if (n == _MOCK_STREAM_GET_CAPACITY(stream))
+        {
+            fprintf(stderr, "MOCK STREAM: cannot grow %s to %lu records, dropping further calls\n",
+                    stream->hdr->name, (unsigned long)cap);
+        }
+        return;
+    }
+    memcpy(stream->records + n * stream->record_size, record, stream->record_size);
+#else
+    (void)stream;
+    (void)n;
+    (void)record;
+#endif
+}
+
+bool mock_trace_start(size_t capacity, bool timestamps)
+{
+    size_t cap = _MOCK_TRACE_MIN;
+    mock_trace_record_t *ring;
+
+    mock_trace_stop();
+
+    while (cap < capacity)
+    {
+        cap *= 2;
+    }
+
+    ring = realloc(_mock_trace_ring, cap * sizeof(*ring));
+    if (!ring)
+    {
+        return false;
+    }
+
+    _mock_trace_ring = ring;
+    _mock_trace_mask = cap - 1;
+    _mock_trace_seq = 0;
+    _mock_trace_timestamps = timestamps;
+    _mock_trace_enabled = true;
+    return true;
+}
+
+void mock_trace_stop(void)
+{
+    _mock_trace_enabled = false;
+}
+
+void mock_trace_clear(void)
+{
+    _mock_trace_seq = 0;
+}
+
+size_t mock_trace_count(void)
+{
+    if (!_mock_trace_ring)
+    {
+        return 0;
+    }
+    return _mock_trace_seq > _mock_trace_mask ? _mock_trace_mask + 1 : (size_t)_mock_trace_seq;
+}
+
+const mock_trace_record_t *mock_trace_at(size_t pos)
+{
+    size_t count = mock_trace_count();
+
+    if (pos >= count)
+    {
+        return NULL;
+    }
+    return &_mock_trace_ring[(_mock_trace_seq - count + pos) & _mock_trace_mask];
+}
+
+const char *mock_trace_name(uint32_t mock_id)
+{
+    if (mock_id == 0 || mock_id > _mock_trace_nmocks)
+    {
+        return NULL;
+    }
+    return _mock_trace_mocks[mock_id - 1]->name;
+}
+
+size_t mock_trace_find(const char *name, size_t from)
+{
+    size_t count = mock_trace_count();
+    uint32_t id;
+
+    /* resolve the name once, then compare ids */
+    for (id = 1; id <= _mock_trace_nmocks; id++)
+    {
+        if (0 == strcmp(_mock_trace_mocks[id - 1]->name, name))
+        {
+            break;
+        }
+    }
+    if (id > _mock_trace_nmocks)
+    {
+        return MOCK_TRACE_NONE;
+    }
+
+    for (; from < count; from++)
+    {
+        if (mock_trace_at(from)->mock_id == id)
+        {
+            return from;
+        }
+    }
+    return MOCK_TRACE_NONE;
+}
+
+bool mock_trace_called_before(const char *first, const char *then)
+{
+    size_t a = mock_trace_find(first, 0);
+    size_t b = mock_trace_find(then, 0);
+
+    return a != MOCK_TRACE_NONE && b != MOCK_TRACE_NONE && a < b;
+}
+
+int mock_trace_write(FILE *fp)
+{
+    size_t count = mock_trace_count();
+    uint64_t count64 = count;
+    size_t i;
+
+    if (fwrite(_MOCK_TRACE_MAGIC, 1, 8, fp) != 8 || _mock_write_u32(fp, _MOCK_TRACE_VERSION)
+            || _mock_write_u32(fp, (uint32_t)sizeof(mock_trace_record_t))
+            || fwrite(&count64, sizeof(count64), 1, fp) != 1 || _mock_write_u32(fp, (uint32_t)_mock_trace_nmocks)
+            || _mock_write_u32(fp, 0))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < _mock_trace_nmocks; i++)
+    {
+        const char *name = _mock_trace_mocks[i]->name;
+        uint32_t len = (uint32_t)strlen(name);
+        if (_mock_write_u32(fp, len) || fwrite(name, 1, len, fp) != len)
+        {
+            return -1;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (fwrite(mock_trace_at(i), sizeof(mock_trace_record_t), 1, fp) != 1)
+        {
+            return -1;
+        }
+    }
+
+    return fflush(fp) ? -1 : 0;
+}
+
+void _mock_trace_record(struct _mock_registration *reg, size_t call_index)
+{
+    mock_trace_record_t *rec;
+    uint64_t seq;
+
+    if (!_MOCK_TRACE_ID(reg))
+    {
+        _mock_trace_assign_id(reg);
+    }
+
+    seq = _MOCK_TRACE_NEXT_SEQ();
+    rec = &_mock_trace_ring[seq & _mock_trace_mask];
+    rec->seq = seq;
+    rec->timestamp_ns = _mock_trace_timestamps ? _mock_now_ns() : 0;
+    rec->call_index = call_index;
+    rec->mock_id = _MOCK_TRACE_ID(reg);
+    rec->reserved = 0;
+}
+
+void *_mock_grow(void *data, size_t *cap, size_t elem_size, size_t index)
+{
+    size_t new_cap = *cap ? *cap : _MOCK_GROW_MIN;
+    void *p;
+
+    while (new_cap <= index)
+    {
+        new_cap *= 2;
+    }
+
+    p = realloc(data, new_cap * elem_size);
+    if (!p)
+    {
+        fprintf(stderr, "MOCK STORAGE: out of memory growing to %lu calls\n", (unsigned long)new_cap);
+        lfg_ct_report_flush();
+        abort();
+    }
+
+    memset((char *)p + *cap * elem_size, 0, (new_cap - *cap) * elem_size);
+    *cap = new_cap;
+    return p;
+}
+
+/*============================================================================
+ *  Private Functions
+ *==========================================================================*/
+
+static mock_param_action_t _mock_param_append(mock_param_action_t action,
+        enum _mock_param_action_dir dir,
+        unsigned callidx,
+        unsigned paramidx,
+        void *buffer,
+        size_t buf_size)
+{
+    struct _mock_param_action *head = action;
+    struct _mock_param_chain *chain;
+    struct _mock_param_slab *slab;
+    struct _mock_param_action *p;
+
+    if (!head)
+    {
+        slab = _mock_slab_get();
+        chain = &slab->chain;
+        chain->slabs = slab;
+    }
+    else
+    {
+        chain = head->chain;
+        slab = chain->slabs;
+        if (slab->used == MOCK_PARAM_SLAB_NODES)
+        {
+            slab = _mock_slab_get();
+            slab->next = chain->slabs;
+            chain->slabs = slab;
+        }
+    }
+
+    p = &slab->nodes[slab->used++];
+    memset(p, 0, sizeof(*p));
+    p->dir = dir;
+    p->call_index = callidx;
+    p->parameter_index = paramidx;
+    p->buffer = buffer;
+    p->buf_size = buf_size;
+
+    if (!head)
+    {
+        head = p; /* new head */
+        head->chain = chain;
+    }
+    else
+    {
+        chain->tail->next = p;
+    }
+
+    chain->tail = p;
+    return head;
+}
+
+/* Take a slab from the pool, or the heap when the pool is empty */
+static struct _mock_param_slab *_mock_slab_get(void)
+{
+    struct _mock_param_slab *slab = _mock_slab_pool;
+
+    if (slab)
+    {
+        _mock_slab_pool = slab->next;
+    }
+    else
+    {
+        slab = malloc(sizeof(*slab));
+        assert(slab);
+    }
+
+    slab->next = NULL;
+    slab->used = 0;
+    memset(&slab->chain, 0, sizeof(slab->chain));
+    return slab;
+}
+
+/* Merge the actions appended since the last call into the per-call index, in
+ * append order. An action for a call index past the last one is a push and
+ * one for a known index joins the end of its next_for_call list, both O(1)
+ * apart from the search; only a new index below the last shifts calls[]. */
+static void _mock_param_index(struct _mock_param_chain *chain, struct _mock_param_action *head)
+{
+    struct _mock_param_action *p = chain->indexed ? chain->indexed->next : head;
+
+    for (; p; p = p->next)
+    {
+        size_t lo = 0;
+        size_t hi = chain->ncalls;
+
+        p->next_for_call = NULL;
+        p->last_for_call = p;
+        if (hi > 0 && chain->calls[hi - 1]->call_index <= p->call_index)
+        {
+            lo = chain->calls[hi - 1]->call_index == p->call_index ? hi - 1 : hi;
+        }
+        else
+        {
+            while (lo < hi)
+            {
+                size_t mid = lo + (hi - lo) / 2;
+                if (chain->calls[mid]->call_index < p->call_index)
+                {
+                    lo = mid + 1;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+        }
+
+        if (lo < chain->ncalls && chain->calls[lo]->call_index == p->call_index)
+        {
+            chain->calls[lo]->last_for_call->next_for_call = p;
+            chain->calls[lo]->last_for_call = p;
+            continue;
+        }
+        if (chain->ncalls == chain->calls_cap)
+        {
+            chain->calls = _mock_grow(chain->calls, &chain->calls_cap, sizeof(*chain->calls), chain->ncalls);
+        }
+        memmove(&chain->calls[lo + 1], &chain->calls[lo], (chain->ncalls - lo) * sizeof(*chain->calls));
+        chain->calls[lo] = p;
+        chain->ncalls++;
+        if (lo < chain->cursor)
+        {
+            chain->cursor++; /* keep the hint on the same entry */
+        }
+    }
+    chain->indexed = chain->tail;
+}
+
+/* Give a mock its trace id on its first traced call. Ids stay valid for the
+ * life of the process so records from different traces keep their names. */
+static void _mock_trace_assign_id(struct _mock_registration *reg)
+{
+    _MOCK_LOCK();
+    if (!reg->trace_id)
+    {
+        if (_mock_trace_nmocks == _mock_trace_mocks_cap)
+        {
+            _mock_trace_mocks = _mock_grow(
+                    _mock_trace_mocks, &_mock_trace_mocks_cap, sizeof(*_mock_trace_mocks), _mock_trace_nmocks);
+        }
+        _mock_trace_mocks[_mock_trace_nmocks++] = reg;
+#ifdef LFG_CTEST_THREAD_SAFE
+        __atomic_store_n(&reg->trace_id, (uint32_t)_mock_trace_nmocks, __ATOMIC_RELEASE);
+#else
+        reg->trace_id = (uint32_t)_mock_trace_nmocks;
+#endif
+    }
+    _MOCK_UNLOCK();
+}
+
+/* Little-endian loads, so digests agree across hosts */
+static uint64_t _mock_read64(const unsigned char *p)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return (uint64_t)_mock_read32(p) | ((uint64_t)_mock_read32(p + 4) << 32);
+#endif
+}
+
+static uint32_t _mock_read32(const unsigned char *p)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+#endif
+}
+
+static uint64_t _mock_digest_round(uint64_t acc, uint64_t input)
+{
+    acc += input * _MOCK_DIGEST_P2;
+    acc = _MOCK_ROTL64(acc, 31);
+    return acc * _MOCK_DIGEST_P1;
+}
+
+static uint64_t _mock_digest_merge(uint64_t acc, uint64_t val)
+{
+    acc ^= _mock_digest_round(0, val);
+    return acc * _MOCK_DIGEST_P1 + _MOCK_DIGEST_P4;
+}
+
+/* Check one call's parameters against @p e: -1 if they match, the index of
+ * the first mismatching parameter, or -2 if the matcher rejects them. Reads
+ * only what is fixed once the expectation is set up, so it needs no lock. */
+static int _mock_expect_matches(const struct _mock_expectation *e, const void *params)
+{
+    if (e->mask && e->reg->expect_cmp)
+    {
+        int n = e->reg->expect_cmp(e->expected, e->mask, params);
+        if (n >= 0)
+        {
+            return n;
+        }
+    }
+    if (e->match && !e->match(params, e->match_ctx))
+    {
+        return -2;
+    }
+    return -1;
+}
+
+/* Whether @p e may match now: nothing after the highest matched position,
+ * and nothing past the first sequenced expectation still below its minimum */
+static bool _mock_expect_in_sequence(const struct _mock_expectation *e)
+{
+    return !e->seq_pos
+            || (e->seq_pos >= _mock_expect_seq_high
+                    && (!_mock_expect_seq_cursor || e->seq_pos <= _mock_expect_seq_cursor->seq_pos));
+}
+
+/* Statistics of @p reg including the calls made since its last reset */
+static void _mock_stats_snapshot(const struct _mock_registration *reg, mock_stats_t *out)
+{
+    size_t live = *reg->call_count;
+
+    out->name = reg->name;
+    out->total_calls = reg->total_calls + live;
+    out->peak_calls = live > reg->peak_calls ? live : reg->peak_calls;
+    out->storage_max = reg->storage_max;
+    out->storage_wraps = reg->storage_wraps;
+    out->callback_calls = reg->callback_calls;
+    out->callback_ns = reg->callback_ns;
+}
+
+/* Fullest storage first; storage that cannot fill up (dynamic, ring) ranks by peak after the bounded mocks */
+static int _mock_stats_cmp_peak(const void *a, const void *b)
+{
+    const mock_stats_t *x = a;
+    const mock_stats_t *y = b;
+    unsigned long long xr =
+            x->storage_max && !x->storage_wraps ? (unsigned long long)x->peak_calls * 1000u / x->storage_max : 0;
+    unsigned long long yr =
+            y->storage_max && !y->storage_wraps ? (unsigned long long)y->peak_calls * 1000u / y->storage_max : 0;
+
+    if (xr != yr)
+    {
+        return xr < yr ? 1 : -1;
+    }
+    if (x->peak_calls != y->peak_calls)
+    {
+        return x->peak_calls < y->peak_calls ? 1 : -1;
+    }
+    return 0;
+}
+
+static int _mock_stats_cmp_callback(const void *a, const void *b)
+{
+    const mock_stats_t *x = a;
+    const mock_stats_t *y = b;
+
+    if (x->callback_ns != y->callback_ns)
+    {
+        return x->callback_ns < y->callback_ns ? 1 : -1;
+    }
+    if (x->callback_calls != y->callback_calls)
+    {
+        return x->callback_calls < y->callback_calls ? 1 : -1;
+    }
+    return 0;
+}
+
+/* Appends the statistics tables to the run summary once mock_stats_set_report() asked for them */
+static void _mock_stats_reporter(const lfg_ct_event_t *event, void *ctx)
+{
+    (void)ctx;
+    if (LFG_CT_EVENT_SUMMARY == event->type)
+    {
+        mock_stats_print(stdout, _mock_stats_top);
+    }
+}
+
+static int _mock_write_u32(FILE *fp, uint32_t v)
+{
+    return fwrite(&v, sizeof(v), 1, fp) != 1;
+}
+
+#ifdef LFG_CTEST_HAS_MMAP
+/* Size the stream file for @p capacity records and map the pages it gained
+ * into the range reserved at open, so hdr and records never move. Pages that
+ * are already mapped are left alone, as other threads may be storing into
+ * them; the new ones are only used once the new capacity is published. If the
+ * file cannot grow, the current mapping is left in place. */
+static bool _mock_param_stream_map(mock_param_stream_t *stream, uint64_t capacity)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = sizeof(mock_param_stream_header_t) + capacity * stream->record_size;
+    size_t mapped = 0;
+
+    if (stream->capacity)
+    {
+        mapped = sizeof(mock_param_stream_header_t) + stream->capacity * stream->record_size;
+        mapped = (mapped + page - 1) / page * page;
+    }
+    if (size > stream->reserved || ftruncate(stream->fd, (off_t)size) != 0)
+    {
+        return false;
+    }
+    if (size > mapped
+            && MAP_FAILED == mmap((unsigned char *)stream->hdr + mapped, size - mapped, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_FIXED, stream->fd, (off_t)mapped))
+    {
+        return false;
+    }
+
+    _MOCK_STREAM_SET_CAPACITY(stream, capacity);
+    return true;
+}
+#endif
+
+
+#endif /* LFG_CTEST_IMPLEMENTATION */
+#endif /* LFG_CTEST_SINGLE_H_ */
@@ -10,22 +10,207 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
+#ifdef LFG_CTEST_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include "lfg-ctest-mock.h"
 
 /*============================================================================
  *  Defines/Typedefs
  *==========================================================================*/
 
+/** first allocation of a dynamic mock storage block, in elements */
+#define _MOCK_GROW_MIN 16
+
+/* Registration and param-action lookup can be reached from MOCK_THREAD_SAFE
+ * mocks on several threads. Both are short and rarely contended, so a spin is
+ * enough. Per-call paths take it through _MOCK_LOCK_FOR() so that ordinary
+ * mocks, which are never called concurrently, stay lock-free. */
+#ifdef LFG_CTEST_THREAD_SAFE
+#define _MOCK_LOCK()                                                                                                   \
+    do                                                                                                                 \
+    {                                                                                                                  \
+    } while (__atomic_test_and_set(&_mock_lock, __ATOMIC_ACQUIRE))
+#define _MOCK_UNLOCK() __atomic_clear(&_mock_lock, __ATOMIC_RELEASE)
+#define _MOCK_LOCK_FOR(_reg)                                                                                           \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if ((_reg)->thread_safe)                                                                                       \
+        {                                                                                                              \
+            _MOCK_LOCK();                                                                                              \
+        }                                                                                                              \
+    } while (0)
+#define _MOCK_UNLOCK_FOR(_reg)                                                                                         \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if ((_reg)->thread_safe)                                                                                       \
+        {                                                                                                              \
+            _MOCK_UNLOCK();                                                                                            \
+        }                                                                                                              \
+    } while (0)
+#define _MOCK_SET_REGISTERED(_reg, _val) __atomic_store_n(&(_reg)->registered, _val, __ATOMIC_RELEASE)
+#define _MOCK_STREAM_SET_CAPACITY(_s, _val) __atomic_store_n(&(_s)->capacity, _val, __ATOMIC_RELEASE)
+#define _MOCK_STREAM_GET_CAPACITY(_s) __atomic_load_n(&(_s)->capacity, __ATOMIC_ACQUIRE)
+#define _MOCK_TRACE_ID(_reg) __atomic_load_n(&(_reg)->trace_id, __ATOMIC_ACQUIRE)
+#define _MOCK_TRACE_NEXT_SEQ() __atomic_fetch_add(&_mock_trace_seq, 1, __ATOMIC_RELAXED)
+#define _MOCK_STATS_ADD(_field, _val) __atomic_fetch_add(&(_field), _val, __ATOMIC_RELAXED)
+#else
+#define _MOCK_LOCK() ((void)0)
+#define _MOCK_UNLOCK() ((void)0)
+#define _MOCK_LOCK_FOR(_reg) ((void)(_reg))
+#define _MOCK_UNLOCK_FOR(_reg) ((void)(_reg))
+#define _MOCK_SET_REGISTERED(_reg, _val) ((_reg)->registered = (_val))
+#define _MOCK_STREAM_SET_CAPACITY(_s, _val) ((_s)->capacity = (_val))
+#define _MOCK_STREAM_GET_CAPACITY(_s) ((_s)->capacity)
+#define _MOCK_TRACE_ID(_reg) ((_reg)->trace_id)
+#define _MOCK_TRACE_NEXT_SEQ() (_mock_trace_seq++)
+#define _MOCK_STATS_ADD(_field, _val) ((_field) += (_val))
+#endif
+
+/** smallest call trace ring, in records */
+#define _MOCK_TRACE_MIN 16
+
+/** call trace log header magic and format version */
+#define _MOCK_TRACE_MAGIC "LFGMTRC1"
+#define _MOCK_TRACE_VERSION 1u
+
+/** param stream file magic and format version */
+#define _MOCK_STREAM_MAGIC "LFGMPRM1"
+#define _MOCK_STREAM_VERSION 1u
+
+/** smallest param stream mapping, in records */
+#define _MOCK_STREAM_MIN 1024
+
+/** address space reserved per open param stream, in bytes (override at compile time) */
+#ifndef MOCK_PARAM_STREAM_RESERVE
+#if SIZE_MAX > 0xFFFFFFFFu
+#define MOCK_PARAM_STREAM_RESERVE ((size_t)1 << 36)
+#else
+#define MOCK_PARAM_STREAM_RESERVE ((size_t)1 << 26)
+#endif
+#endif
+
+/* mock_digest() (XXH64) primes */
+#define _MOCK_DIGEST_P1 0x9E3779B185EBCA87ull
+#define _MOCK_DIGEST_P2 0xC2B2AE3D27D4EB4Full
+#define _MOCK_DIGEST_P3 0x165667B19E3779F9ull
+#define _MOCK_DIGEST_P4 0x85EBCA77C2B2AE63ull
+#define _MOCK_DIGEST_P5 0x27D4EB2F165667C5ull
+
+#define _MOCK_ROTL64(_x, _r) (((_x) << (_r)) | ((_x) >> (64 - (_r))))
+
+/* Param-action nodes are carved from slabs. A chain's first slab also holds
+ * the chain bookkeeping, so starting a chain is a single allocation. */
+struct _mock_param_slab
+{
+    struct _mock_param_slab *next;
+    size_t used;
+    struct _mock_param_chain chain; /* valid in a chain's first slab only */
+    struct _mock_param_action nodes[MOCK_PARAM_SLAB_NODES];
+};
+
+/* One MOCK_EXPECT(); the expected _params struct follows the node */
+struct _mock_expectation
+{
+    struct _mock_expectation *next;          /* all expectations, in declaration order */
+    struct _mock_expectation *next_for_mock; /* the same mock's expectations */
+    struct _mock_expectation *next_in_seq;   /* sequenced expectations */
+    struct _mock_registration *reg;
+    const char *file;
+    int line;
+    size_t min;
+    size_t max;
+    size_t count;
+    size_t seq_pos; /* 1-based position in the sequence, 0 if not sequenced */
+    unsigned mask;  /* parameters set with MOCK_EXPECT_ARG() */
+    mock_expect_match_fn match;
+    void *match_ctx;
+    union
+    {
+        long double ld;
+        void *ptr;
+        uint64_t u;
+    } expected[];
+};
+
 /*============================================================================
  *  Private Function Prototypes
  *==========================================================================*/
 
+static mock_param_action_t _mock_param_append(mock_param_action_t action,
+        enum _mock_param_action_dir dir,
+        unsigned callidx,
+        unsigned paramidx,
+        void *buffer,
+        size_t buf_size);
+static struct _mock_param_slab *_mock_slab_get(void);
+static void _mock_param_index(struct _mock_param_chain *chain, struct _mock_param_action *head);
+static void _mock_trace_assign_id(struct _mock_registration *reg);
+static void _mock_stats_snapshot(const struct _mock_registration *reg, mock_stats_t *out);
+static int _mock_stats_cmp_peak(const void *a, const void *b);
+static int _mock_stats_cmp_callback(const void *a, const void *b);
+static void _mock_stats_reporter(const lfg_ct_event_t *event, void *ctx);
+static int _mock_expect_matches(const struct _mock_expectation *e, const void *params);
+static bool _mock_expect_in_sequence(const struct _mock_expectation *e);
+static uint64_t _mock_read64(const unsigned char *p);
+static uint32_t _mock_read32(const unsigned char *p);
+static uint64_t _mock_digest_round(uint64_t acc, uint64_t input);
+static uint64_t _mock_digest_merge(uint64_t acc, uint64_t val);
+static int _mock_write_u32(FILE *fp, uint32_t v);
+#ifdef LFG_CTEST_HAS_MMAP
+static bool _mock_param_stream_map(mock_param_stream_t *stream, uint64_t capacity);
+#endif
+
 /*============================================================================
  *  Variables
  *==========================================================================*/
 
-static void (*_mock_reset_registry[MOCK_REGISTRY_MAX])(void);
-static size_t _mock_reset_registry_count;
+#ifdef LFG_CTEST_THREAD_SAFE
+static bool _mock_lock;
+#endif
+
+/* registered mocks in registration order */
+static struct _mock_registration *_mock_registry_head;
+static struct _mock_registration *_mock_registry_tail;
+
+/* slabs returned by destroyed chains, reused before the heap */
+static struct _mock_param_slab *_mock_slab_pool;
+
+/* call trace: a power-of-two ring indexed by the global sequence number */
+bool _mock_trace_enabled;
+static bool _mock_trace_timestamps;
+static mock_trace_record_t *_mock_trace_ring;
+static size_t _mock_trace_mask;
+static uint64_t _mock_trace_seq;
+
+/* traced mocks by trace_id - 1 */
+static struct _mock_registration **_mock_trace_mocks;
+static size_t _mock_trace_nmocks;
+static size_t _mock_trace_mocks_cap;
+
+/* every mock called since the start of the run, in first-call order; never detached */
+static struct _mock_registration *_mock_stats_head;
+static struct _mock_registration *_mock_stats_tail;
+
+/* mocks listed per statistics table in the summary */
+static unsigned _mock_stats_top = 0;
+bool _mock_stats_timing = false;
+
+/* expectations in declaration order; each mock also chains its own */
+static struct _mock_expectation *_mock_expect_head;
+static struct _mock_expectation *_mock_expect_tail;
+
+/* cross-mock sequence: the cursor is the first sequenced expectation below
+ * its minimum, and nothing before the highest matched position may match */
+static bool _mock_expect_sequencing;
+static struct _mock_expectation *_mock_expect_seq_tail;
+static struct _mock_expectation *_mock_expect_seq_cursor;
+static size_t _mock_expect_seq_count;
+static size_t _mock_expect_seq_high;
 
 /*============================================================================
  *  Public API
@@ -34,145 +219,1287 @@ static size_t _mock_reset_registry_count;
 mock_param_action_t mock_param_mem_read(
         mock_param_action_t action, unsigned callidx, unsigned paramidx, void *buffer, size_t buf_size)
 {
-    struct _mock_param_action *p, *p0;
-    p0 = action;
-    p = calloc(sizeof(*p), 1);
-    assert(p);
-    p->dir = eMOCK_PARAM_ACTION_DIR_READ;
-    p->call_index = callidx;
-    p->parameter_index = paramidx;
-    p->buffer = buffer;
-    p->buf_size = buf_size;
-    if (p0)
+    return _mock_param_append(action, eMOCK_PARAM_ACTION_DIR_READ, callidx, paramidx, buffer, buf_size);
+}
+
+mock_param_action_t mock_param_mem_write(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, void *buffer, size_t buf_size)
+{
+    return _mock_param_append(action, eMOCK_PARAM_ACTION_DIR_WRITE, callidx, paramidx, buffer, buf_size);
+}
+
+mock_param_action_t mock_param_str_read(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, char *buffer, size_t buf_size)
+{
+    return _mock_param_append(action, eMOCK_PARAM_ACTION_DIR_READ_STR, callidx, paramidx, buffer, buf_size);
+}
+
+mock_param_action_t mock_param_str_write(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, const char *buffer, size_t buf_size)
+{
+    return _mock_param_append(
+            action, eMOCK_PARAM_ACTION_DIR_WRITE_STR, callidx, paramidx, (void *)buffer, buf_size);
+}
+
+mock_param_action_t mock_param_mem_digest(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, uint64_t *digest, size_t size)
+{
+    return _mock_param_append(action, eMOCK_PARAM_ACTION_DIR_DIGEST, callidx, paramidx, digest, size);
+}
+
+uint64_t mock_digest(const void *data, size_t size)
+{
+    const unsigned char *p = data;
+    const unsigned char *end = p + size;
+    uint64_t h;
+
+    if (size >= 32)
     {
-        while (p0->next)
+        uint64_t v1 = _MOCK_DIGEST_P1 + _MOCK_DIGEST_P2;
+        uint64_t v2 = _MOCK_DIGEST_P2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - _MOCK_DIGEST_P1;
+
+        /* four independent lanes keep the multipliers busy */
+        do
         {
-            p0 = p0->next;
+            v1 = _mock_digest_round(v1, _mock_read64(p));
+            v2 = _mock_digest_round(v2, _mock_read64(p + 8));
+            v3 = _mock_digest_round(v3, _mock_read64(p + 16));
+            v4 = _mock_digest_round(v4, _mock_read64(p + 24));
+            p += 32;
+        } while (end - p >= 32);
+
+        h = _MOCK_ROTL64(v1, 1) + _MOCK_ROTL64(v2, 7) + _MOCK_ROTL64(v3, 12) + _MOCK_ROTL64(v4, 18);
+        h = _mock_digest_merge(h, v1);
+        h = _mock_digest_merge(h, v2);
+        h = _mock_digest_merge(h, v3);
+        h = _mock_digest_merge(h, v4);
+    }
+    else
+    {
+        h = _MOCK_DIGEST_P5;
+    }
+
+    h += (uint64_t)size;
+
+    for (; end - p >= 8; p += 8)
+    {
+        h ^= _mock_digest_round(0, _mock_read64(p));
+        h = _MOCK_ROTL64(h, 27) * _MOCK_DIGEST_P1 + _MOCK_DIGEST_P4;
+    }
+    if (end - p >= 4)
+    {
+        h ^= (uint64_t)_mock_read32(p) * _MOCK_DIGEST_P1;
+        h = _MOCK_ROTL64(h, 23) * _MOCK_DIGEST_P2 + _MOCK_DIGEST_P3;
+        p += 4;
+    }
+    for (; p < end; p++)
+    {
+        h ^= *p * _MOCK_DIGEST_P5;
+        h = _MOCK_ROTL64(h, 11) * _MOCK_DIGEST_P1;
+    }
+
+    h ^= h >> 33;
+    h *= _MOCK_DIGEST_P2;
+    h ^= h >> 29;
+    h *= _MOCK_DIGEST_P3;
+    h ^= h >> 32;
+    return h;
+}
+
+void _mock_register(struct _mock_registration *reg)
+{
+    _MOCK_LOCK();
+    if (!reg->registered)
+    {
+        reg->next = NULL;
+        if (_mock_registry_tail)
+        {
+            _mock_registry_tail->next = reg;
+        }
+        else
+        {
+            _mock_registry_head = reg;
+        }
+        _mock_registry_tail = reg;
+        _MOCK_SET_REGISTERED(reg, true);
+
+        /* nodes without a call counter (hand-made registrations) have nothing to report */
+        if (!reg->stats_linked && reg->call_count)
+        {
+            if (_mock_stats_tail)
+            {
+                _mock_stats_tail->stats_next = reg;
+            }
+            else
+            {
+                _mock_stats_head = reg;
+                lfg_ct_reporter_add(_mock_stats_reporter, NULL);
+            }
+            _mock_stats_tail = reg;
+            reg->stats_linked = true;
         }
-        p0->next = p;
-        return action; /* return head of list */
     }
-    return p; /* new head */
+    _MOCK_UNLOCK();
 }
 
-mock_param_action_t mock_param_mem_write(
-        mock_param_action_t action, unsigned callidx, unsigned paramidx, void *buffer, size_t buf_size)
+void mock_reset_all(void)
 {
-    struct _mock_param_action *p, *p0;
-    p0 = action;
-    p = calloc(sizeof(*p), 1);
-    assert(p);
-    p->dir = eMOCK_PARAM_ACTION_DIR_WRITE;
-    p->call_index = callidx;
-    p->parameter_index = paramidx;
-    p->buffer = buffer;
-    p->buf_size = buf_size;
-    if (p0)
+    struct _mock_registration *reg;
+
+    _MOCK_LOCK();
+    reg = _mock_registry_head;
+    _mock_registry_head = NULL;
+    _mock_registry_tail = NULL;
+    _MOCK_UNLOCK();
+
+    while (reg)
+    {
+        struct _mock_registration *next = reg->next;
+        reg->next = NULL;
+        _MOCK_SET_REGISTERED(reg, false);
+        reg->reset_fn();
+        reg = next;
+    }
+
+    while (_mock_slab_pool)
+    {
+        struct _mock_param_slab *next = _mock_slab_pool->next;
+        free(_mock_slab_pool);
+        _mock_slab_pool = next;
+    }
+
+    mock_expect_reset();
+}
+
+struct _mock_param_action *_mock_param_actions_for_call(
+        const struct _mock_registration *reg, mock_param_action_t action, size_t call_index)
+{
+    struct _mock_param_action *head = action;
+    struct _mock_param_action *found = NULL;
+    struct _mock_param_chain *chain;
+    size_t lo, hi;
+
+    if (!head)
     {
-        while (p0->next)
+        return NULL;
+    }
+
+    _MOCK_LOCK_FOR(reg);
+    chain = head->chain;
+    if (chain->indexed != chain->tail)
+    {
+        _mock_param_index(chain, head);
+    }
+
+    /* mocks are called with ascending indices, so the cursor nearly always answers */
+    lo = chain->cursor;
+    if (lo < chain->ncalls && chain->calls[lo]->call_index >= call_index
+            && (lo == 0 || chain->calls[lo - 1]->call_index < call_index))
+    {
+        hi = lo;
+    }
+    else
+    {
+        /* binary search for the first entry >= call_index */
+        lo = 0;
+        hi = chain->ncalls;
+        while (lo < hi)
         {
-            p0 = p0->next;
+            size_t mid = lo + (hi - lo) / 2;
+            if (chain->calls[mid]->call_index < call_index)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
         }
-        p0->next = p;
-        return action; /* return head of list */
     }
-    return p; /* new head */
+
+    if (hi < chain->ncalls && chain->calls[hi]->call_index == call_index)
+    {
+        found = chain->calls[hi++];
+    }
+    chain->cursor = hi;
+    _MOCK_UNLOCK_FOR(reg);
+
+    return found;
 }
 
-mock_param_action_t mock_param_str_read(
-        mock_param_action_t action, unsigned callidx, unsigned paramidx, char *buffer, size_t buf_size)
+void mock_param_destroy(mock_param_action_t action)
 {
-    struct _mock_param_action *p, *p0;
-    p0 = action;
-    p = calloc(sizeof(*p), 1);
-    assert(p);
-    p->dir = eMOCK_PARAM_ACTION_DIR_READ_STR;
-    p->call_index = callidx;
-    p->parameter_index = paramidx;
-    p->buffer = buffer;
-    p->buf_size = buf_size;
-    if (p0)
+    struct _mock_param_action *head = action;
+    struct _mock_param_slab *first, *last;
+
+    if (!head)
     {
-        while (p0->next)
+        return;
+    }
+
+    /* the chain lives in one of its own slabs: detach everything first */
+    free(head->chain->calls);
+    first = head->chain->slabs;
+    last = first;
+    while (last->next)
+    {
+        last = last->next;
+    }
+
+    /* hand the whole slab list back to the pool */
+    last->next = _mock_slab_pool;
+    _mock_slab_pool = first;
+}
+
+mock_expect_t mock_expect_match(mock_expect_t exp, mock_expect_match_fn fn, void *ctx)
+{
+    exp->match = fn;
+    exp->match_ctx = ctx;
+    return exp;
+}
+
+void mock_expect_sequence_begin(void)
+{
+    _mock_expect_sequencing = true;
+}
+
+void mock_expect_sequence_end(void)
+{
+    _mock_expect_sequencing = false;
+}
+
+int mock_expect_verify(void)
+{
+    struct _mock_expectation *e;
+    char msg[256];
+    int unmet = 0;
+
+    for (e = _mock_expect_head; e; e = e->next)
+    {
+        if (e->count < e->min)
         {
-            p0 = p0->next;
+            snprintf(msg, sizeof(msg), "%s expected at least %lu calls, got %lu", e->reg->name, (unsigned long)e->min,
+                    (unsigned long)e->count);
+            lfg_ct_assert_fail_impl((char *)e->file, e->line, e->reg->name, msg);
+            unmet++;
         }
-        p0->next = p;
-        return action; /* return head of list */
     }
-    return p; /* new head */
+
+    mock_expect_reset();
+    return unmet;
 }
 
-mock_param_action_t mock_param_str_write(
-        mock_param_action_t action, unsigned callidx, unsigned paramidx, const char *buffer, size_t buf_size)
+void mock_expect_reset(void)
 {
-    struct _mock_param_action *p, *p0;
-    p0 = action;
-    p = calloc(sizeof(*p), 1);
-    assert(p);
-    p->dir = eMOCK_PARAM_ACTION_DIR_WRITE_STR;
-    p->call_index = callidx;
-    p->parameter_index = paramidx;
-    p->buffer = (void *)buffer;
-    p->buf_size = buf_size;
-    if (p0)
+    _MOCK_LOCK();
+    while (_mock_expect_head)
+    {
+        struct _mock_expectation *next = _mock_expect_head->next;
+        _mock_expect_head->reg->expect_cursor = NULL;
+        _mock_expect_head->reg->expect_tail = NULL;
+        free(_mock_expect_head);
+        _mock_expect_head = next;
+    }
+    _mock_expect_tail = NULL;
+    _mock_expect_sequencing = false;
+    _mock_expect_seq_tail = NULL;
+    _mock_expect_seq_cursor = NULL;
+    _mock_expect_seq_count = 0;
+    _mock_expect_seq_high = 0;
+    _MOCK_UNLOCK();
+}
+
+mock_expect_t _mock_expect_add(struct _mock_registration *reg, size_t min, size_t max, const char *file, int line)
+{
+    struct _mock_expectation *e = calloc(1, sizeof(*e) + reg->params_size);
+
+    if (!e)
+    {
+        fprintf(stderr, "MOCK EXPECT: out of memory adding an expectation for %s\n", reg->name);
+        lfg_ct_report_flush();
+        abort();
+    }
+    e->reg = reg;
+    e->file = file;
+    e->line = line;
+    e->min = min;
+    e->max = max;
+
+    _MOCK_LOCK();
+    if (_mock_expect_tail)
+    {
+        _mock_expect_tail->next = e;
+    }
+    else
+    {
+        _mock_expect_head = e;
+    }
+    _mock_expect_tail = e;
+
+    if (reg->expect_tail)
+    {
+        reg->expect_tail->next_for_mock = e;
+    }
+    reg->expect_tail = e;
+    if (!reg->expect_cursor)
+    {
+        reg->expect_cursor = e;
+    }
+
+    if (_mock_expect_sequencing)
+    {
+        e->seq_pos = ++_mock_expect_seq_count;
+        if (_mock_expect_seq_tail)
+        {
+            _mock_expect_seq_tail->next_in_seq = e;
+        }
+        _mock_expect_seq_tail = e;
+        if (!_mock_expect_seq_cursor && e->min > 0)
+        {
+            _mock_expect_seq_cursor = e;
+        }
+    }
+    _MOCK_UNLOCK();
+
+    return e;
+}
+
+void *_mock_expect_arg(mock_expect_t exp, unsigned n)
+{
+    exp->mask |= 1u << n;
+    return exp->expected;
+}
+
+/* Each call advances the mock's cursor past expectations that are used up,
+ * or that have their minimum and do not accept the call. Cursors only move
+ * forward, so matching costs amortized O(1) per call. The comparator and
+ * matcher run with the lock released, since a matcher may call other mocks.
+ * A call that runs off the end after passing expectations that rejected it
+ * is reported with the last one's reason, not as using them up. */
+void _mock_expect_call(struct _mock_registration *reg, size_t call_index, const void *params)
+{
+    struct _mock_expectation *e;
+    struct _mock_expectation *rejected = NULL;
+    struct _mock_expectation *fail_at = NULL;
+    char msg[256];
+    int verdict = -1;
+    int rejected_verdict = -1;
+
+    _MOCK_LOCK_FOR(reg);
+    e = reg->expect_cursor;
+    for (;;)
+    {
+        while (e && e->count >= e->max)
+        {
+            e = e->next_for_mock;
+        }
+        if (!e)
+        {
+            break;
+        }
+
+        _MOCK_UNLOCK_FOR(reg);
+        verdict = _mock_expect_matches(e, params);
+        _MOCK_LOCK_FOR(reg);
+
+        if (e->count >= e->max)
+        {
+            continue; /* used up meanwhile, by another thread or by the matcher itself */
+        }
+        if (verdict == -1 && !_mock_expect_in_sequence(e))
+        {
+            verdict = -3;
+        }
+        if (verdict == -1 || e->count < e->min)
+        {
+            break;
+        }
+        rejected = e;
+        rejected_verdict = verdict;
+        e = e->next_for_mock;
+    }
+    reg->expect_cursor = e;
+    if (!e && rejected)
+    {
+        e = rejected;
+        verdict = rejected_verdict;
+    }
+
+    if (!e)
+    {
+        fail_at = reg->expect_tail;
+        snprintf(msg, sizeof(msg), "%s call %lu is unexpected: its expectations are used up", reg->name,
+                (unsigned long)call_index);
+    }
+    else if (verdict == -1)
+    {
+        e->count++;
+        if (e->seq_pos)
+        {
+            if (e->seq_pos > _mock_expect_seq_high)
+            {
+                _mock_expect_seq_high = e->seq_pos;
+            }
+            while (_mock_expect_seq_cursor && _mock_expect_seq_cursor->count >= _mock_expect_seq_cursor->min)
+            {
+                _mock_expect_seq_cursor = _mock_expect_seq_cursor->next_in_seq;
+            }
+        }
+    }
+    else
+    {
+        fail_at = e;
+        if (verdict >= 0)
+        {
+            snprintf(msg, sizeof(msg), "%s call %lu: parameter p%d does not match the expectation", reg->name,
+                    (unsigned long)call_index, verdict);
+        }
+        else if (verdict == -2)
+        {
+            snprintf(msg, sizeof(msg), "%s call %lu is rejected by the expectation's matcher", reg->name,
+                    (unsigned long)call_index);
+        }
+        else if (e->seq_pos < _mock_expect_seq_high)
+        {
+            snprintf(msg, sizeof(msg), "%s call %lu is out of sequence: a later expectation already matched",
+                    reg->name, (unsigned long)call_index);
+        }
+        else
+        {
+            snprintf(msg, sizeof(msg), "%s call %lu is out of sequence: %s is expected first", reg->name,
+                    (unsigned long)call_index, _mock_expect_seq_cursor->reg->name);
+        }
+    }
+    _MOCK_UNLOCK_FOR(reg);
+
+    if (fail_at)
+    {
+        lfg_ct_assert_fail_impl((char *)fail_at->file, fail_at->line, reg->name, msg);
+    }
+}
+
+bool mock_stats_get(const char *name, mock_stats_t *out)
+{
+    struct _mock_registration *reg;
+
+    for (reg = _mock_stats_head; reg; reg = reg->stats_next)
     {
-        while (p0->next)
+        if (0 == strcmp(reg->name, name))
         {
-            p0 = p0->next;
+            _mock_stats_snapshot(reg, out);
+            return true;
         }
-        p0->next = p;
-        return action; /* return head of list */
     }
-    return p; /* new head */
+    return false;
 }
 
-void _mock_register_reset(void (*reset_fn)(void))
+void mock_stats_set_report(unsigned n)
 {
+    _mock_stats_top = n;
+    _mock_stats_timing = n > 0;
+}
+
+void mock_stats_print(FILE *fp, unsigned n)
+{
+    struct _mock_registration *reg;
+    mock_stats_t *stats;
+    size_t count = 0;
+    size_t shown;
     size_t i;
 
-    for (i = 0; i < _mock_reset_registry_count; i++)
+    for (reg = _mock_stats_head; reg; reg = reg->stats_next)
+    {
+        count++;
+    }
+    if (0 == count || 0 == n)
+    {
+        return;
+    }
+
+    stats = malloc(count * sizeof(*stats));
+    if (!stats)
     {
-        if (_mock_reset_registry[i] == reset_fn)
+        return;
+    }
+    for (reg = _mock_stats_head, i = 0; reg; reg = reg->stats_next, i++)
+    {
+        _mock_stats_snapshot(reg, &stats[i]);
+    }
+
+    shown = count < n ? count : n;
+    qsort(stats, count, sizeof(*stats), _mock_stats_cmp_peak);
+    fprintf(fp, "*** Busiest %u mocks (peak calls between resets / storage, total calls):\r\n", (unsigned)shown);
+    for (i = 0; i < shown; i++)
+    {
+        if (stats[i].storage_wraps)
+        {
+            fprintf(fp, "***   %lu/%lu wrapping, %llu calls  %s\r\n", (unsigned long)stats[i].peak_calls,
+                    (unsigned long)stats[i].storage_max, (unsigned long long)stats[i].total_calls, stats[i].name);
+        }
+        else if (stats[i].storage_max)
+        {
+            fprintf(fp, "***   %lu/%lu (%lu%%), %llu calls  %s\r\n", (unsigned long)stats[i].peak_calls,
+                    (unsigned long)stats[i].storage_max,
+                    (unsigned long)(stats[i].peak_calls * 100u / stats[i].storage_max),
+                    (unsigned long long)stats[i].total_calls, stats[i].name);
+        }
+        else
         {
-            return; /* already registered */
+            fprintf(fp, "***   %lu/dynamic, %llu calls  %s\r\n", (unsigned long)stats[i].peak_calls,
+                    (unsigned long long)stats[i].total_calls, stats[i].name);
         }
     }
 
-    if (_mock_reset_registry_count >= MOCK_REGISTRY_MAX)
+    qsort(stats, count, sizeof(*stats), _mock_stats_cmp_callback);
+    shown = 0;
+    while (shown < count && shown < n && stats[shown].callback_calls)
+    {
+        shown++;
+    }
+    if (shown)
+    {
+        fprintf(fp, "*** Slowest %u mock callbacks:\r\n", (unsigned)shown);
+    }
+    for (i = 0; i < shown; i++)
     {
-        fprintf(stderr, "MOCK REGISTRY OVERFLOW: exceeded %d distinct mocks\n", MOCK_REGISTRY_MAX);
-        assert(0 && "mock reset registry exceeded");
+        fprintf(fp, "***   %lu.%03lu ms in %llu calls  %s\r\n", (unsigned long)(stats[i].callback_ns / 1000000u),
+                (unsigned long)(stats[i].callback_ns / 1000u % 1000u), (unsigned long long)stats[i].callback_calls,
+                stats[i].name);
     }
 
-    _mock_reset_registry[_mock_reset_registry_count++] = reset_fn;
+    free(stats);
 }
 
-void mock_reset_all(void)
+void _mock_stats_fold(struct _mock_registration *reg)
+{
+    size_t calls = *reg->call_count;
+
+    reg->total_calls += calls;
+    if (calls > reg->peak_calls)
+    {
+        reg->peak_calls = calls;
+    }
+}
+
+void _mock_stats_callback(struct _mock_registration *reg, uint64_t start_ns)
 {
+    uint64_t ns = _mock_now_ns() - start_ns;
+
+    _MOCK_STATS_ADD(reg->callback_calls, 1);
+    _MOCK_STATS_ADD(reg->callback_ns, ns);
+}
+
+uint64_t _mock_now_ns(void)
+{
+#if defined(LFG_CTEST_HAS_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    if (0 == clock_gettime(CLOCK_MONOTONIC, &ts))
+    {
+        return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    }
+#endif
+    return (uint64_t)clock() * (1000000000u / CLOCKS_PER_SEC);
+}
+
+bool mock_param_stream_open(
+        mock_param_stream_t *stream, const char *name, size_t record_size, const char *path, uint64_t capacity)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    size_t reserved = MOCK_PARAM_STREAM_RESERVE;
+    void *base;
+    int fd;
+
+    mock_param_stream_close(stream);
+
+    if (capacity < _MOCK_STREAM_MIN)
+    {
+        capacity = _MOCK_STREAM_MIN;
+    }
+    if (sizeof(mock_param_stream_header_t) + capacity * record_size > reserved)
+    {
+        reserved = sizeof(mock_param_stream_header_t) + capacity * record_size;
+    }
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    /* the mapping only ever grows inside this range, so its address is stable */
+    base = mmap(NULL, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (MAP_FAILED == base)
+    {
+        close(fd);
+        return false;
+    }
+    stream->fd = fd;
+    stream->record_size = record_size;
+    stream->reserved = reserved;
+    stream->capacity = 0;
+    stream->hdr = base;
+    stream->records = (unsigned char *)base + sizeof(*stream->hdr);
+    if (!_mock_param_stream_map(stream, capacity))
+    {
+        munmap(base, reserved);
+        close(fd);
+        stream->hdr = NULL;
+        stream->records = NULL;
+        stream->fd = -1;
+        stream->reserved = 0;
+        return false;
+    }
+
+    /* the fresh mapping is zero-filled, so the name stays NUL-terminated */
+    memcpy(stream->hdr->magic, _MOCK_STREAM_MAGIC, sizeof(stream->hdr->magic));
+    stream->hdr->version = _MOCK_STREAM_VERSION;
+    stream->hdr->record_size = (uint32_t)record_size;
+    stream->hdr->count = 0;
+    strncpy(stream->hdr->name, name, sizeof(stream->hdr->name) - 1);
+    return true;
+#else
+    (void)stream;
+    (void)name;
+    (void)record_size;
+    (void)path;
+    (void)capacity;
+    return false;
+#endif
+}
+
+void mock_param_stream_close(mock_param_stream_t *stream)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    uint64_t count;
+
+    if (!stream->hdr)
+    {
+        return;
+    }
+
+    count = stream->hdr->count < stream->capacity ? stream->hdr->count : stream->capacity;
+    stream->hdr->count = count;
+    munmap(stream->hdr, stream->reserved);
+    if (ftruncate(stream->fd, (off_t)(sizeof(*stream->hdr) + count * stream->record_size)) != 0)
+    {
+        fprintf(stderr, "MOCK STREAM: cannot trim stream file\n");
+    }
+    close(stream->fd);
+
+    stream->hdr = NULL;
+    stream->records = NULL;
+    stream->capacity = 0;
+    stream->fd = -1;
+    stream->reserved = 0;
+#else
+    (void)stream;
+#endif
+}
+
+bool mock_param_reader_open(mock_param_reader_t *reader, const char *path)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    const mock_param_stream_header_t *hdr;
+    struct stat st;
+    uint64_t fits;
+    void *map;
+    int fd;
+
+    memset(reader, 0, sizeof(*reader));
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(*hdr))
+    {
+        close(fd);
+        return false;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == map)
+    {
+        return false;
+    }
+
+    hdr = map;
+    if (memcmp(hdr->magic, _MOCK_STREAM_MAGIC, sizeof(hdr->magic)) != 0 || hdr->version != _MOCK_STREAM_VERSION
+            || 0 == hdr->record_size || !memchr(hdr->name, '\0', sizeof(hdr->name)))
+    {
+        munmap(map, (size_t)st.st_size);
+        return false;
+    }
+
+    /* a stream that was never closed still has its whole mapping on disk */
+    fits = ((size_t)st.st_size - sizeof(*hdr)) / hdr->record_size;
+    reader->name = hdr->name;
+    reader->record_size = hdr->record_size;
+    reader->count = hdr->count < fits ? hdr->count : fits;
+    reader->records = (const unsigned char *)map + sizeof(*hdr);
+    reader->map = map;
+    reader->map_size = (size_t)st.st_size;
+    return true;
+#else
+    (void)path;
+    memset(reader, 0, sizeof(*reader));
+    return false;
+#endif
+}
+
+const void *mock_param_reader_at(const mock_param_reader_t *reader, uint64_t n)
+{
+    if (n >= reader->count)
+    {
+        return NULL;
+    }
+    return reader->records + n * reader->record_size;
+}
+
+void mock_param_reader_close(mock_param_reader_t *reader)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    if (reader->map)
+    {
+        munmap(reader->map, reader->map_size);
+    }
+#endif
+    memset(reader, 0, sizeof(*reader));
+}
+
+void _mock_param_stream_put(mock_param_stream_t *stream, uint64_t n, const void *record)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    uint64_t cap;
+    bool mapped = true;
+
+    _MOCK_LOCK();
+    cap = _MOCK_STREAM_GET_CAPACITY(stream);
+    if (cap <= n)
+    {
+        while (cap <= n)
+        {
+            cap *= 2;
+        }
+        mapped = _mock_param_stream_map(stream, cap);
+    }
+    _MOCK_UNLOCK();
+
+    if (!mapped)
+    {
+        /* other threads may still be writing, so the stream stays open; only
+         * the first record that does not fit reports it */
+        if (n == _MOCK_STREAM_GET_CAPACITY(stream))
+        {
+            fprintf(stderr, "MOCK STREAM: cannot grow %s to %lu records, dropping further calls\n",
+                    stream->hdr->name, (unsigned long)cap);
+        }
+        return;
+    }
+    memcpy(stream->records + n * stream->record_size, record, stream->record_size);
+#else
+    (void)stream;
+    (void)n;
+    (void)record;
+#endif
+}
+
+bool mock_trace_start(size_t capacity, bool timestamps)
+{
+    size_t cap = _MOCK_TRACE_MIN;
+    mock_trace_record_t *ring;
+
+    mock_trace_stop();
+
+    while (cap < capacity)
+    {
+        cap *= 2;
+    }
+
+    ring = realloc(_mock_trace_ring, cap * sizeof(*ring));
+    if (!ring)
+    {
+        return false;
+    }
+
+    _mock_trace_ring = ring;
+    _mock_trace_mask = cap - 1;
+    _mock_trace_seq = 0;
+    _mock_trace_timestamps = timestamps;
+    _mock_trace_enabled = true;
+    return true;
+}
+
+void mock_trace_stop(void)
+{
+    _mock_trace_enabled = false;
+}
+
+void mock_trace_clear(void)
+{
+    _mock_trace_seq = 0;
+}
+
+size_t mock_trace_count(void)
+{
+    if (!_mock_trace_ring)
+    {
+        return 0;
+    }
+    return _mock_trace_seq > _mock_trace_mask ? _mock_trace_mask + 1 : (size_t)_mock_trace_seq;
+}
+
+const mock_trace_record_t *mock_trace_at(size_t pos)
+{
+    size_t count = mock_trace_count();
+
+    if (pos >= count)
+    {
+        return NULL;
+    }
+    return &_mock_trace_ring[(_mock_trace_seq - count + pos) & _mock_trace_mask];
+}
+
+const char *mock_trace_name(uint32_t mock_id)
+{
+    if (mock_id == 0 || mock_id > _mock_trace_nmocks)
+    {
+        return NULL;
+    }
+    return _mock_trace_mocks[mock_id - 1]->name;
+}
+
+size_t mock_trace_find(const char *name, size_t from)
+{
+    size_t count = mock_trace_count();
+    uint32_t id;
+
+    /* resolve the name once, then compare ids */
+    for (id = 1; id <= _mock_trace_nmocks; id++)
+    {
+        if (0 == strcmp(_mock_trace_mocks[id - 1]->name, name))
+        {
+            break;
+        }
+    }
+    if (id > _mock_trace_nmocks)
+    {
+        return MOCK_TRACE_NONE;
+    }
+
+    for (; from < count; from++)
+    {
+        if (mock_trace_at(from)->mock_id == id)
+        {
+            return from;
+        }
+    }
+    return MOCK_TRACE_NONE;
+}
+
+bool mock_trace_called_before(const char *first, const char *then)
+{
+    size_t a = mock_trace_find(first, 0);
+    size_t b = mock_trace_find(then, 0);
+
+    return a != MOCK_TRACE_NONE && b != MOCK_TRACE_NONE && a < b;
+}
+
+int mock_trace_write(FILE *fp)
+{
+    size_t count = mock_trace_count();
+    uint64_t count64 = count;
     size_t i;
 
-    for (i = 0; i < _mock_reset_registry_count; i++)
+    if (fwrite(_MOCK_TRACE_MAGIC, 1, 8, fp) != 8 || _mock_write_u32(fp, _MOCK_TRACE_VERSION)
+            || _mock_write_u32(fp, (uint32_t)sizeof(mock_trace_record_t))
+            || fwrite(&count64, sizeof(count64), 1, fp) != 1 || _mock_write_u32(fp, (uint32_t)_mock_trace_nmocks)
+            || _mock_write_u32(fp, 0))
     {
-        _mock_reset_registry[i]();
+        return -1;
     }
 
-    _mock_reset_registry_count = 0;
+    for (i = 0; i < _mock_trace_nmocks; i++)
+    {
+        const char *name = _mock_trace_mocks[i]->name;
+        uint32_t len = (uint32_t)strlen(name);
+        if (_mock_write_u32(fp, len) || fwrite(name, 1, len, fp) != len)
+        {
+            return -1;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (fwrite(mock_trace_at(i), sizeof(mock_trace_record_t), 1, fp) != 1)
+        {
+            return -1;
+        }
+    }
+
+    return fflush(fp) ? -1 : 0;
 }
 
-void mock_param_destroy(mock_param_action_t action)
+void _mock_trace_record(struct _mock_registration *reg, size_t call_index)
+{
+    mock_trace_record_t *rec;
+    uint64_t seq;
+
+    if (!_MOCK_TRACE_ID(reg))
+    {
+        _mock_trace_assign_id(reg);
+    }
+
+    seq = _MOCK_TRACE_NEXT_SEQ();
+    rec = &_mock_trace_ring[seq & _mock_trace_mask];
+    rec->seq = seq;
+    rec->timestamp_ns = _mock_trace_timestamps ? _mock_now_ns() : 0;
+    rec->call_index = call_index;
+    rec->mock_id = _MOCK_TRACE_ID(reg);
+    rec->reserved = 0;
+}
+
+void *_mock_grow(void *data, size_t *cap, size_t elem_size, size_t index)
 {
-    struct _mock_param_action *p = action;
+    size_t new_cap = *cap ? *cap : _MOCK_GROW_MIN;
+    void *p;
+
+    while (new_cap <= index)
+    {
+        new_cap *= 2;
+    }
 
-    /* traverse the linked-list and free each node */
-    while (p)
+    p = realloc(data, new_cap * elem_size);
+    if (!p)
     {
-        struct _mock_param_action *next = p->next;
-        free(p);
-        p = next;
+        fprintf(stderr, "MOCK STORAGE: out of memory growing to %lu calls\n", (unsigned long)new_cap);
+        lfg_ct_report_flush();
+        abort();
     }
+
+    memset((char *)p + *cap * elem_size, 0, (new_cap - *cap) * elem_size);
+    *cap = new_cap;
+    return p;
 }
 
 /*============================================================================
  *  Private Functions
  *==========================================================================*/
+
+static mock_param_action_t _mock_param_append(mock_param_action_t action,
+        enum _mock_param_action_dir dir,
+        unsigned callidx,
+        unsigned paramidx,
+        void *buffer,
+        size_t buf_size)
+{
+    struct _mock_param_action *head = action;
+    struct _mock_param_chain *chain;
+    struct _mock_param_slab *slab;
+    struct _mock_param_action *p;
+
+    if (!head)
+    {
+        slab = _mock_slab_get();
+        chain = &slab->chain;
+        chain->slabs = slab;
+    }
+    else
+    {
+        chain = head->chain;
+        slab = chain->slabs;
+        if (slab->used == MOCK_PARAM_SLAB_NODES)
+        {
+            slab = _mock_slab_get();
+            slab->next = chain->slabs;
+            chain->slabs = slab;
+        }
+    }
+
+    p = &slab->nodes[slab->used++];
+    memset(p, 0, sizeof(*p));
+    p->dir = dir;
+    p->call_index = callidx;
+    p->parameter_index = paramidx;
+    p->buffer = buffer;
+    p->buf_size = buf_size;
+
+    if (!head)
+    {
+        head = p; /* new head */
+        head->chain = chain;
+    }
+    else
+    {
+        chain->tail->next = p;
+    }
+
+    chain->tail = p;
+    return head;
+}
+
+/* Take a slab from the pool, or the heap when the pool is empty */
+static struct _mock_param_slab *_mock_slab_get(void)
+{
+    struct _mock_param_slab *slab = _mock_slab_pool;
+
+    if (slab)
+    {
+        _mock_slab_pool = slab->next;
+    }
+    else
+    {
+        slab = malloc(sizeof(*slab));
+        assert(slab);
+    }
+
+    slab->next = NULL;
+    slab->used = 0;
+    memset(&slab->chain, 0, sizeof(slab->chain));
+    return slab;
+}
+
+/* Merge the actions appended since the last call into the per-call index, in
+ * append order. An action for a call index past the last one is a push and
+ * one for a known index joins the end of its next_for_call list, both O(1)
+ * apart from the search; only a new index below the last shifts calls[]. */
+static void _mock_param_index(struct _mock_param_chain *chain, struct _mock_param_action *head)
+{
+    struct _mock_param_action *p = chain->indexed ? chain->indexed->next : head;
+
+    for (; p; p = p->next)
+    {
+        size_t lo = 0;
+        size_t hi = chain->ncalls;
+
+        p->next_for_call = NULL;
+        p->last_for_call = p;
+        if (hi > 0 && chain->calls[hi - 1]->call_index <= p->call_index)
+        {
+            lo = chain->calls[hi - 1]->call_index == p->call_index ? hi - 1 : hi;
+        }
+        else
+        {
+            while (lo < hi)
+            {
+                size_t mid = lo + (hi - lo) / 2;
+                if (chain->calls[mid]->call_index < p->call_index)
+                {
+                    lo = mid + 1;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+        }
+
+        if (lo < chain->ncalls && chain->calls[lo]->call_index == p->call_index)
+        {
+            chain->calls[lo]->last_for_call->next_for_call = p;
+            chain->calls[lo]->last_for_call = p;
+            continue;
+        }
+        if (chain->ncalls == chain->calls_cap)
+        {
+            chain->calls = _mock_grow(chain->calls, &chain->calls_cap, sizeof(*chain->calls), chain->ncalls);
+        }
+        memmove(&chain->calls[lo + 1], &chain->calls[lo], (chain->ncalls - lo) * sizeof(*chain->calls));
+        chain->calls[lo] = p;
+        chain->ncalls++;
+        if (lo < chain->cursor)
+        {
+            chain->cursor++; /* keep the hint on the same entry */
+        }
+    }
+    chain->indexed = chain->tail;
+}
+
+/* Give a mock its trace id on its first traced call. Ids stay valid for the
+ * life of the process so records from different traces keep their names. */
+static void _mock_trace_assign_id(struct _mock_registration *reg)
+{
+    _MOCK_LOCK();
+    if (!reg->trace_id)
+    {
+        if (_mock_trace_nmocks == _mock_trace_mocks_cap)
+        {
+            _mock_trace_mocks = _mock_grow(
+                    _mock_trace_mocks, &_mock_trace_mocks_cap, sizeof(*_mock_trace_mocks), _mock_trace_nmocks);
+        }
+        _mock_trace_mocks[_mock_trace_nmocks++] = reg;
+#ifdef LFG_CTEST_THREAD_SAFE
+        __atomic_store_n(&reg->trace_id, (uint32_t)_mock_trace_nmocks, __ATOMIC_RELEASE);
+#else
+        reg->trace_id = (uint32_t)_mock_trace_nmocks;
+#endif
+    }
+    _MOCK_UNLOCK();
+}
+
+/* Little-endian loads, so digests agree across hosts */
+static uint64_t _mock_read64(const unsigned char *p)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return (uint64_t)_mock_read32(p) | ((uint64_t)_mock_read32(p + 4) << 32);
+#endif
+}
+
+static uint32_t _mock_read32(const unsigned char *p)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+#endif
+}
+
+static uint64_t _mock_digest_round(uint64_t acc, uint64_t input)
+{
+    acc += input * _MOCK_DIGEST_P2;
+    acc = _MOCK_ROTL64(acc, 31);
+    return acc * _MOCK_DIGEST_P1;
+}
+
+static uint64_t _mock_digest_merge(uint64_t acc, uint64_t val)
+{
+    acc ^= _mock_digest_round(0, val);
+    return acc * _MOCK_DIGEST_P1 + _MOCK_DIGEST_P4;
+}
+
+/* Check one call's parameters against @p e: -1 if they match, the index of
+ * the first mismatching parameter, or -2 if the matcher rejects them. Reads
+ * only what is fixed once the expectation is set up, so it needs no lock. */
+static int _mock_expect_matches(const struct _mock_expectation *e, const void *params)
+{
+    if (e->mask && e->reg->expect_cmp)
+    {
+        int n = e->reg->expect_cmp(e->expected, e->mask, params);
+        if (n >= 0)
+        {
+            return n;
+        }
+    }
+    if (e->match && !e->match(params, e->match_ctx))
+    {
+        return -2;
+    }
+    return -1;
+}
+
+/* Whether @p e may match now: nothing after the highest matched position,
+ * and nothing past the first sequenced expectation still below its minimum */
+static bool _mock_expect_in_sequence(const struct _mock_expectation *e)
+{
+    return !e->seq_pos
+            || (e->seq_pos >= _mock_expect_seq_high
+                    && (!_mock_expect_seq_cursor || e->seq_pos <= _mock_expect_seq_cursor->seq_pos));
+}
+
+/* Statistics of @p reg including the calls made since its last reset */
+static void _mock_stats_snapshot(const struct _mock_registration *reg, mock_stats_t *out)
+{
+    size_t live = *reg->call_count;
+
+    out->name = reg->name;
+    out->total_calls = reg->total_calls + live;
+    out->peak_calls = live > reg->peak_calls ? live : reg->peak_calls;
+    out->storage_max = reg->storage_max;
+    out->storage_wraps = reg->storage_wraps;
+    out->callback_calls = reg->callback_calls;
+    out->callback_ns = reg->callback_ns;
+}
+
+/* Fullest storage first; storage that cannot fill up (dynamic, ring) ranks by peak after the bounded mocks */
+static int _mock_stats_cmp_peak(const void *a, const void *b)
+{
+    const mock_stats_t *x = a;
+    const mock_stats_t *y = b;
+    unsigned long long xr =
+            x->storage_max && !x->storage_wraps ? (unsigned long long)x->peak_calls * 1000u / x->storage_max : 0;
+    unsigned long long yr =
+            y->storage_max && !y->storage_wraps ? (unsigned long long)y->peak_calls * 1000u / y->storage_max : 0;
+
+    if (xr != yr)
+    {
+        return xr < yr ? 1 : -1;
+    }
+    if (x->peak_calls != y->peak_calls)
+    {
+        return x->peak_calls < y->peak_calls ? 1 : -1;
+    }
+    return 0;
+}
+
+static int _mock_stats_cmp_callback(const void *a, const void *b)
+{
+    const mock_stats_t *x = a;
+    const mock_stats_t *y = b;
+
+    if (x->callback_ns != y->callback_ns)
+    {
+        return x->callback_ns < y->callback_ns ? 1 : -1;
+    }
+    if (x->callback_calls != y->callback_calls)
+    {
+        return x->callback_calls < y->callback_calls ? 1 : -1;
+    }
+    return 0;
+}
+
+/* Appends the statistics tables to the run summary once mock_stats_set_report() asked for them */
+static void _mock_stats_reporter(const lfg_ct_event_t *event, void *ctx)
+{
+    (void)ctx;
+    if (LFG_CT_EVENT_SUMMARY == event->type)
+    {
+        mock_stats_print(stdout, _mock_stats_top);
+    }
+}
+
+static int _mock_write_u32(FILE *fp, uint32_t v)
+{
+    return fwrite(&v, sizeof(v), 1, fp) != 1;
+}
+
+#ifdef LFG_CTEST_HAS_MMAP
+/* Size the stream file for @p capacity records and map the pages it gained
+ * into the range reserved at open, so hdr and records never move. Pages that
+ * are already mapped are left alone, as other threads may be storing into
+ * them; the new ones are only used once the new capacity is published. If the
+ * file cannot grow, the current mapping is left in place. */
+static bool _mock_param_stream_map(mock_param_stream_t *stream, uint64_t capacity)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = sizeof(mock_param_stream_header_t) + capacity * stream->record_size;
+    size_t mapped = 0;
+
+    if (stream->capacity)
+    {
+        mapped = sizeof(mock_param_stream_header_t) + stream->capacity * stream->record_size;
+        mapped = (mapped + page - 1) / page * page;
+    }
+    if (size > stream->reserved || ftruncate(stream->fd, (off_t)size) != 0)
+    {
+        return false;
+    }
+    if (size > mapped
+            && MAP_FAILED == mmap((unsigned char *)stream->hdr + mapped, size - mapped, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_FIXED, stream->fd, (off_t)mapped))
+    {
+        return false;
+    }
+
+    _MOCK_STREAM_SET_CAPACITY(stream, capacity);
+    return true;
+}
+#endif
+
@@ -31,6 +31,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "lfg-ctest.h"
 
@@ -46,6 +47,7 @@ enum _mock_param_action_dir
     eMOCK_PARAM_ACTION_DIR_WRITE,
     eMOCK_PARAM_ACTION_DIR_READ_STR,
     eMOCK_PARAM_ACTION_DIR_WRITE_STR,
+    eMOCK_PARAM_ACTION_DIR_DIGEST,
 };
 
 struct _mock_param_action
@@ -56,6 +58,25 @@ struct _mock_param_action
     unsigned parameter_index;
     void *buffer;
     size_t buf_size;
+    struct _mock_param_action *next_for_call; /* next action with the same call_index (built by the index) */
+    struct _mock_param_action *last_for_call; /* first action of a call only: end of its next_for_call list */
+    struct _mock_param_chain *chain;          /* head node only: tail and call index */
+};
+
+struct _mock_param_slab;
+struct _mock_registration;
+
+/* Per-chain bookkeeping kept on the head node: O(1) append, and the actions
+ * grouped and sorted by call_index so a mock call finds its own in O(1) */
+struct _mock_param_chain
+{
+    struct _mock_param_action *tail;
+    struct _mock_param_slab *slabs;    /* node slabs owned by the chain, newest first */
+    struct _mock_param_action **calls; /* first action of each distinct call_index, ascending */
+    size_t calls_cap;
+    size_t ncalls;
+    struct _mock_param_action *indexed; /* last action merged into calls[], NULL before the first call */
+    size_t cursor;                      /* next calls[] entry, for the common ascending call sequence */
 };
 
 /** Treat parameter as memory and read bytes from it.
@@ -114,39 +135,838 @@ mock_param_action_t mock_param_str_read(
 mock_param_action_t mock_param_str_write(
         mock_param_action_t action, unsigned callidx, unsigned paramidx, const char *buffer, size_t buf_size);
 
+/** Treat parameter as memory and record only a digest of it.
+ * Like mock_param_mem_read, but instead of copying @p size bytes it stores
+ * their mock_digest() in @p digest, so large buffers (e.g. DMA frames) can
+ * be checked without keeping a copy. Compare with ASSERT_MEM_DIGEST().
+ * @param[in]  action   existing action chain to append to, or NULL to start new chain
+ * @param[in]  callidx  the call index (0-based) for this action
+ * @param[in]  paramidx the 0-based parameter position
+ * @param[out] digest   receives the digest of the pointed-to bytes
+ * @param[in]  size     number of bytes to hash
+ * @return     the action chain (use this for subsequent calls or assign to __param_actions)
+ */
+mock_param_action_t mock_param_mem_digest(
+        mock_param_action_t action, unsigned callidx, unsigned paramidx, uint64_t *digest, size_t size);
+
+/** 64-bit non-cryptographic digest of @p size bytes (the XXH64 algorithm, seed 0).
+ * Runs at memory bandwidth; equal digests mean equal bytes for test purposes.
+ */
+uint64_t mock_digest(const void *data, size_t size);
+
+/** Assert that @p _n bytes at @p _e hash to @p _digest (from mock_param_mem_digest) */
+#define ASSERT_MEM_DIGEST(_e, _n, _digest) ASSERT_UINT64_EQUAL(mock_digest((_e), (_n)), (_digest))
+
 /** Frees all linked parameter operations.
+ * The chain's node slabs go back to the mock runtime's pool in one step;
+ * mock_reset_all() returns the pool to the heap.
  * @param[in] action    parameter action chain to destroy.
  */
 void mock_param_destroy(mock_param_action_t action);
 
+/** First parameter action scheduled for a call, used by the mock bodies.
+ * Further actions for the same call follow through next_for_call, in the
+ * order they were appended.
+ * @param[in] reg         the calling mock's registry node
+ * @param[in] action      parameter action chain, or NULL
+ * @param[in] call_index  0-based call index of the mock
+ * @return    the first action for @p call_index, or NULL if there is none
+ */
+struct _mock_param_action *_mock_param_actions_for_call(
+        const struct _mock_registration *reg, mock_param_action_t action, size_t call_index);
+
+/* Intrusive registry node; each DEFINE_MOCK_* defines one as _func##__mock_reg */
+struct _mock_registration
+{
+    struct _mock_registration *next;
+    void (*reset_fn)(void);
+    bool registered;
+    const char *name;  /* mocked function name, for the call trace and statistics */
+    uint32_t trace_id; /* 0 until the mock first appears in the call trace */
+    size_t *call_count;
+    size_t storage_max; /* MOCK_CALL_STORAGE_MAX of the defining unit, 0 for dynamic storage */
+    bool storage_wraps; /* MOCK_CALL_STORAGE_RING: calls past storage_max overwrite the oldest */
+    bool thread_safe;   /* defined under MOCK_THREAD_SAFE; only then do its calls take the runtime lock */
+
+    /* statistics, kept across resets */
+    struct _mock_registration *stats_next;
+    bool stats_linked;
+    uint64_t total_calls; /* calls folded in by resets; the live __call_count is added on read */
+    size_t peak_calls;    /* highest __call_count seen at a reset */
+    uint64_t callback_calls;
+    uint64_t callback_ns;
+
+    /* call expectations */
+    int (*expect_cmp)(const void *expected, unsigned mask, const void *actual);
+    size_t params_size;                       /* sizeof the _params struct, 0 without parameters */
+    struct _mock_expectation *expect_cursor;  /* first expectation still able to match */
+    struct _mock_expectation *expect_tail;    /* NULL while the mock has no expectations */
+};
+
 /** Register a mock reset function for bulk reset.
- * Called automatically by each mock on first invocation. Deduplicates entries.
- * @param[in] reset_fn   pointer to the mock's __mock_reset function.
+ * Called automatically by each mock on its first invocation since the last
+ * mock_reset_all(); the mock skips the call while @p reg is registered.
+ * @param[in] reg   the mock's registry node.
  */
-void _mock_register_reset(void (*reset_fn)(void));
+void _mock_register(struct _mock_registration *reg);
 
 /** Reset all mocks that have been invoked since the last call to mock_reset_all().
  * Iterates the auto-populated registry and calls each registered reset function,
- * then clears the registry.
+ * then clears the registry and releases the pooled param-action slabs.
  */
 void mock_reset_all(void);
 
+/** Usage of one mock since the start of the run, across resets. */
+typedef struct
+{
+    const char *name;
+    uint64_t total_calls;    /**< every call, including those since the last reset */
+    size_t peak_calls;       /**< highest __call_count reached between resets */
+    size_t storage_max;      /**< MOCK_CALL_STORAGE_MAX of the defining unit, 0 for dynamic storage */
+    bool storage_wraps;      /**< ring storage, so peak_calls may exceed storage_max */
+    uint64_t callback_calls; /**< calls that ran the user __callback, while mock_stats_set_report() is on */
+    uint64_t callback_ns;    /**< wall time spent inside the user __callback, likewise */
+} mock_stats_t;
+
+/** Statistics of the mock named @p name.
+ * @param[in]  name  mocked function name
+ * @param[out] out   filled in when the mock is known
+ * @return     true if the mock has been called at least once
+ */
+bool mock_stats_get(const char *name, mock_stats_t *out);
+
+/** Have lfg_ct_print_summary() list the top @p n mocks in each statistics
+ * table (busiest by peak storage use, slowest by callback time). The tables
+ * follow the result line. Off (0) by default. Callback calls and time are
+ * only collected while this is on.
+ */
+void mock_stats_set_report(unsigned n);
+
+/** Print the statistics tables for the top @p n mocks to @p fp. */
+void mock_stats_print(FILE *fp, unsigned n);
+
+/* Monotonic clock for the statistics and call trace */
+uint64_t _mock_now_ns(void);
+
+/* Fold the live __call_count of @p reg into its statistics (called by __mock_reset) */
+void _mock_stats_fold(struct _mock_registration *reg);
+
+/* Account one user __callback that started at @p start_ns */
+void _mock_stats_callback(struct _mock_registration *reg, uint64_t start_ns);
+
+/* Set while mock_stats_set_report() is on; mock bodies only time callbacks then */
+extern bool _mock_stats_timing;
+
+/** Header at the start of a mock param stream file (64 bytes, native byte order) */
+typedef struct
+{
+    char magic[8];        /**< "LFGMPRM1" */
+    uint32_t version;     /**< 1 */
+    uint32_t record_size; /**< sizeof the mock's _params struct */
+    uint64_t count;       /**< records written; doubles as the append cursor */
+    char name[40];        /**< mocked function name, NUL-terminated (truncated if longer) */
+} mock_param_stream_header_t;
+
+/** Per-mock param stream state (see MOCK_PARAM_STREAM_OPEN) */
+typedef struct
+{
+    mock_param_stream_header_t *hdr; /**< mapped header, NULL while the stream is closed */
+    unsigned char *records;          /**< first record in the mapping */
+    uint64_t capacity;               /**< records the current mapping holds */
+    size_t record_size;
+    int fd;
+    size_t reserved; /**< bytes of address space held for the mapping to grow into */
+} mock_param_stream_t;
+
+/** Start appending every call's parameters of @p _func to the file at @p _path.
+ * The file is created or truncated and mapped with room for @p _capacity
+ * records; it doubles whenever it fills, in place inside an address range
+ * reserved at open, so threads calling a MOCK_THREAD_SAFE mock can keep
+ * writing while it grows. Each call costs one record store and a cursor
+ * increment in the mapping, with no heap use. Records past the reservation
+ * (MOCK_PARAM_STREAM_RESERVE) are dropped with a warning.
+ * The stream keeps recording across resets until MOCK_PARAM_STREAM_CLOSE().
+ * @return true on success, false if the file could not be mapped (always
+ *         false without LFG_CTEST_HAS_MMAP)
+ */
+#define MOCK_PARAM_STREAM_OPEN(_func, _path, _capacity)                                                                \
+    mock_param_stream_open(&_func##__param_stream, #_func, sizeof(_func##_params), _path, _capacity)
+
+/** Stop streaming @p _func, trimming the file to the records written. */
+#define MOCK_PARAM_STREAM_CLOSE(_func) mock_param_stream_close(&_func##__param_stream)
+
+/** Open a param stream; use MOCK_PARAM_STREAM_OPEN(). */
+bool mock_param_stream_open(
+        mock_param_stream_t *stream, const char *name, size_t record_size, const char *path, uint64_t capacity);
+
+/** Close a param stream; use MOCK_PARAM_STREAM_CLOSE(). Closing a closed stream is a no-op. */
+void mock_param_stream_close(mock_param_stream_t *stream);
+
+/** Read-only view of a param stream file */
+typedef struct
+{
+    const char *name;             /**< mocked function name from the header */
+    size_t record_size;
+    uint64_t count;               /**< records available */
+    const unsigned char *records;
+    void *map;
+    size_t map_size;
+} mock_param_reader_t;
+
+/** Map a param stream file for reading.
+ * Also reads files left behind by a process that died without closing the
+ * stream; the count in the header covers every record claimed before then.
+ * @return false if the file cannot be mapped or is not a param stream
+ */
+bool mock_param_reader_open(mock_param_reader_t *reader, const char *path);
+
+/** Record @p n (0 = first call streamed), or NULL if @p n >= reader->count. */
+const void *mock_param_reader_at(const mock_param_reader_t *reader, uint64_t n);
+
+/** Unmap a reader opened with mock_param_reader_open(). */
+void mock_param_reader_close(mock_param_reader_t *reader);
+
+/** Record @p _n of @p _reader as the _params struct of @p _func, or NULL */
+#define MOCK_PARAM_STREAM_AT(_func, _reader, _n) ((const _func##_params *)mock_param_reader_at(_reader, _n))
+
+/* Slow path of _MOCK_STREAM: grow the mapping until record @p n fits, then store it */
+void _mock_param_stream_put(mock_param_stream_t *stream, uint64_t n, const void *record);
+
+/** Handle of one call expectation (owned by the mock runtime) */
+typedef struct _mock_expectation *mock_expect_t;
+
+/** Custom argument matcher: return true if the call's @p params (a pointer to
+ * the mock's _params struct) are acceptable. */
+typedef bool (*mock_expect_match_fn)(const void *params, void *ctx);
+
+/** Expect @p _func to be called at least @p _min and at most @p _max times
+ * (MOCK_FOREVER for no limit), with any arguments until MOCK_EXPECT_ARG() or
+ * mock_expect_match() narrows them. Calls to a mock consume its expectations
+ * in declaration order, and each call is checked as it happens: a call that
+ * no expectation accepts fails at once, at the MOCK_EXPECT() line.
+ */
+#define MOCK_EXPECT(_func, _min, _max) _mock_expect_add(&_func##__mock_reg, _min, _max, __FILE__, __LINE__)
+
+/** Expect exactly one call to @p _func */
+#define MOCK_EXPECT_ONCE(_func) MOCK_EXPECT(_func, 1, 1)
+
+/** Require parameter @p _n (0-based) of calls matched by @p _exp to equal
+ * @p _value. Compared with == (bytewise for struct-safe mocks). */
+#define MOCK_EXPECT_ARG(_exp, _func, _n, _value) (((_func##_params *)_mock_expect_arg(_exp, _n))->p##_n = (_value))
+
+/** Add a custom matcher to @p exp, checked after any MOCK_EXPECT_ARG() values.
+ * @return @p exp
+ */
+mock_expect_t mock_expect_match(mock_expect_t exp, mock_expect_match_fn fn, void *ctx);
+
+/** Expectations created until mock_expect_sequence_end() form an ordered
+ * sequence across mocks: one may only match once every earlier one in the
+ * sequence has reached its minimum, and matching it retires the earlier ones.
+ */
+void mock_expect_sequence_begin(void);
+
+/** End the sequence started by mock_expect_sequence_begin(). */
+void mock_expect_sequence_end(void);
+
+/** Fail every expectation that has not reached its minimum (at its
+ * MOCK_EXPECT() line), then drop all expectations.
+ * @return number of unmet expectations
+ */
+int mock_expect_verify(void);
+
+/** Drop all expectations without checking them (mock_reset_all() does this too). */
+void mock_expect_reset(void);
+
+mock_expect_t _mock_expect_add(struct _mock_registration *reg, size_t min, size_t max, const char *file, int line);
+void *_mock_expect_arg(mock_expect_t exp, unsigned n);
+void _mock_expect_call(struct _mock_registration *reg, size_t call_index, const void *params);
+
+/** One call in the global mock call trace (32 bytes, written as-is by mock_trace_write()). */
+typedef struct
+{
+    uint64_t seq;          /**< global sequence number across all mocks, from 0 */
+    uint64_t timestamp_ns; /**< monotonic time of the call, or 0 when timestamps are off */
+    uint64_t call_index;   /**< the mock's own call index (its __call_count before the call) */
+    uint32_t mock_id;      /**< mock identifier, see mock_trace_name() */
+    uint32_t reserved;
+} mock_trace_record_t;
+
+/** "not found" result of mock_trace_find() */
+#define MOCK_TRACE_NONE ((size_t)-1)
+
+/** Start recording every mock call into a preallocated ring.
+ * Any previous trace is discarded. The ring keeps the most recent
+ * @p capacity calls (rounded up to a power of two).
+ * @param[in] capacity    number of records to keep
+ * @param[in] timestamps  also stamp each record with the monotonic clock
+ *                        (costs a clock read per call)
+ * @return    true on success, false if the ring could not be allocated
+ */
+bool mock_trace_start(size_t capacity, bool timestamps);
+
+/** Stop recording. The records stay available for queries until the next mock_trace_start(). */
+void mock_trace_stop(void);
+
+/** Drop all records, keeping the ring and the recording state. */
+void mock_trace_clear(void);
+
+/** Number of records currently held (at most the ring capacity). */
+size_t mock_trace_count(void);
+
+/** Record at position @p pos, 0 being the oldest held.
+ * @return the record, or NULL if @p pos >= mock_trace_count()
+ */
+const mock_trace_record_t *mock_trace_at(size_t pos);
+
+/** Name of the mock behind a record's mock_id, or NULL if unknown. */
+const char *mock_trace_name(uint32_t mock_id);
+
+/** Position of the first record for mock @p name at or after @p from.
+ * @param[in] name  mocked function name (without __mock)
+ * @param[in] from  first position to look at
+ * @return    the position, or MOCK_TRACE_NONE
+ */
+size_t mock_trace_find(const char *name, size_t from);
+
+/** True if @p first and @p then were both called and @p first was called first. */
+bool mock_trace_called_before(const char *first, const char *then);
+
+/** Identifier form of mock_trace_called_before(), e.g. MOCK_TRACE_BEFORE(spi_select, spi_write) */
+#define MOCK_TRACE_BEFORE(_first, _then) mock_trace_called_before(#_first, #_then)
+
+/** Write the held records and the mock names as a binary log (native byte order).
+ * Layout: "LFGMTRC1", uint32 version (1), uint32 record size, uint64 record
+ * count, uint32 name count, uint32 reserved; then per name (ids 1..n) a uint32
+ * length and the bytes; then the records, oldest first. Read it back with
+ * tools/mocktrace.c.
+ * @param[in] fp  stream opened for binary writing
+ * @return    0 on success, -1 on a write error
+ */
+int mock_trace_write(FILE *fp);
+
+/* Recording state checked by every mock body */
+extern bool _mock_trace_enabled;
+
+/** Append one record for a mock call, used by the mock bodies. */
+void _mock_trace_record(struct _mock_registration *reg, size_t call_index);
+
+/** Grow a dynamic mock storage block so that @p index is addressable.
+ * Used by MOCK_CALL_STORAGE_DYNAMIC mocks. The block at least doubles, new
+ * elements are zeroed, and running out of memory aborts with a message.
+ * @param[in]     data       current block, or NULL
+ * @param[in,out] cap        current capacity in elements, updated on return
+ * @param[in]     elem_size  size of one element in bytes
+ * @param[in]     index      element index that must become addressable
+ * @return        the (possibly moved) block
+ */
+void *_mock_grow(void *data, size_t *cap, size_t elem_size, size_t index);
+
+/** maximum number of return-program steps per R_* mock (override at compile time) */
+#ifndef MOCK_RETURN_PROGRAM_MAX
+#define MOCK_RETURN_PROGRAM_MAX 8
+#endif
+
 /** maximum number of function calls to store (override at compile time) */
 #ifndef MOCK_CALL_STORAGE_MAX
 #define MOCK_CALL_STORAGE_MAX 32
 #endif
 
-/** maximum number of distinct mocks that can be registered for bulk reset */
-#ifndef MOCK_REGISTRY_MAX
-#define MOCK_REGISTRY_MAX 64
+/** number of param-action nodes carved from each pooled slab */
+#ifndef MOCK_PARAM_SLAB_NODES
+#define MOCK_PARAM_SLAB_NODES 64
+#endif
+
+/*============================================================================
+ *  Thread-Safe Mocks
+ *
+ *  Defining MOCK_THREAD_SAFE before including this header lets the code under
+ *  test call every mock in the translation unit from several threads. A call
+ *  claims its index with one relaxed atomic fetch-add on __call_count, writes
+ *  its history slot without locking, and passes the claimed index to the
+ *  callback. First-call registration and param-action lookup take a short
+ *  lock inside the mock runtime. Read the history once the calling threads
+ *  have been joined, and do not reset a mock while threads still call it.
+ *  Needs LFG_CTEST_THREAD_SAFE; not available with MOCK_CALL_STORAGE_DYNAMIC,
+ *  whose blocks move when they grow.
+ *==========================================================================*/
+
+#ifdef MOCK_THREAD_SAFE
+
+#ifndef LFG_CTEST_THREAD_SAFE
+#error "MOCK_THREAD_SAFE needs lfg-ctest built with LFG_CTEST_THREAD_SAFE"
 #endif
+#ifdef MOCK_CALL_STORAGE_DYNAMIC
+#error "MOCK_THREAD_SAFE cannot be combined with MOCK_CALL_STORAGE_DYNAMIC"
+#endif
+
+#define _MOCK_CALL_CLAIM(_func) __atomic_fetch_add(&_func##__call_count, 1, __ATOMIC_RELAXED)
+#define _MOCK_CALL_DONE(_func)
+#define _MOCK_REGISTERED(_reg) __atomic_load_n(&(_reg).registered, __ATOMIC_ACQUIRE)
+#define _MOCK_TRACING() __atomic_load_n(&_mock_trace_enabled, __ATOMIC_RELAXED)
+#define _MOCK_STREAM_CLAIM(_s) __atomic_fetch_add(&(_s).hdr->count, 1, __ATOMIC_RELAXED)
+#define _MOCK_STREAM_CAPACITY(_s) __atomic_load_n(&(_s).capacity, __ATOMIC_ACQUIRE)
+#define _MOCK_REG_THREAD_SAFE true
+
+#else
+
+#define _MOCK_CALL_CLAIM(_func) _func##__call_count
+#define _MOCK_CALL_DONE(_func) _func##__call_count++;
+#define _MOCK_REGISTERED(_reg) ((_reg).registered)
+#define _MOCK_TRACING() _mock_trace_enabled
+#define _MOCK_STREAM_CLAIM(_s) ((_s).hdr->count++)
+#define _MOCK_STREAM_CAPACITY(_s) ((_s).capacity)
+#define _MOCK_REG_THREAD_SAFE false
+
+#endif /* MOCK_THREAD_SAFE */
+
+/*============================================================================
+ *  Call Storage
+ *
+ *  By default each mock owns fixed __param_history[MOCK_CALL_STORAGE_MAX] and
+ *  __return_queue[MOCK_CALL_STORAGE_MAX] arrays, and exceeding them aborts.
+ *
+ *  Defining MOCK_CALL_STORAGE_DYNAMIC before including this header switches
+ *  every mock in the translation unit to heap blocks that grow on demand
+ *  (doubling, so appends are amortized O(1)). __param_history and
+ *  __return_queue become pointers, so history[i] still reads for any i below
+ *  __call_count; prime the return queue through MOCK_RETURN_QUEUE(), which
+ *  grows the block first. Reset zeroes the blocks but keeps their capacity.
+ *
+ *  Defining MOCK_CALL_STORAGE_RING instead keeps the fixed arrays but uses
+ *  them as rings for soak tests: __call_count grows without bound, call i
+ *  lands in slot i % MOCK_CALL_STORAGE_MAX, and only the most recent
+ *  MOCK_CALL_STORAGE_MAX calls are retained. Primed return values repeat with
+ *  the same period. Address calls by their logical index through
+ *  MOCK_PARAM_HISTORY() / MOCK_RETURN_QUEUE(). A power-of-two
+ *  MOCK_CALL_STORAGE_MAX turns the wrap into a mask.
+ *
+ *  Only the mock writes __param_history, so each mock tracks the high-water
+ *  slot it has written and reset clears just that prefix. The fixed return
+ *  queue may be primed by direct stores from the test, which cannot be
+ *  tracked, so reset clears all of it. A unit that defines
+ *  MOCK_RETURN_QUEUE_TRACKED promises to prime only through
+ *  MOCK_RETURN_QUEUE(), which then raises a high-water mark of its own, and
+ *  reset clears just that prefix of the queue as well.
+ *
+ *  The DECLARE and DEFINE of a mock must agree on the mode.
+ *==========================================================================*/
+
+#if defined(MOCK_CALL_STORAGE_DYNAMIC) && defined(MOCK_CALL_STORAGE_RING)
+#error "MOCK_CALL_STORAGE_DYNAMIC and MOCK_CALL_STORAGE_RING are mutually exclusive"
+#endif
+
+#ifdef MOCK_THREAD_SAFE
+/* Concurrent calls would race on the mark; reset derives it from the claimed count instead */
+#define _MOCK_HW_MARK(_hw, _s) ((void)0)
+#define _MOCK_HISTORY_HW_SYNC(_func)                                                                                   \
+    _func##__param_history_hw =                                                                                        \
+            _func##__call_count < MOCK_CALL_STORAGE_MAX ? _func##__call_count : MOCK_CALL_STORAGE_MAX;
+#else
+/* Raise a high-water mark to cover slot @p _s */
+#define _MOCK_HW_MARK(_hw, _s) ((_s) >= (_hw) ? ((_hw) = (_s) + 1) : 0)
+#define _MOCK_HISTORY_HW_SYNC(_func)
+#endif
+
+/* The return queue is primed from the test thread, so its mark is kept even under MOCK_THREAD_SAFE */
+#define _MOCK_QUEUE_HW_MARK(_hw, _s) ((_s) >= (_hw) ? ((_hw) = (_s) + 1) : 0)
+
+#ifdef MOCK_CALL_STORAGE_DYNAMIC
+
+#define _MOCK_HISTORY_DECL(_func)                                                                                      \
+    extern _func##_params *_func##__param_history;                                                                     \
+    extern size_t _func##__param_history_cap;                                                                          \
+    _func##_params *_func##__param_history_at(size_t i);
+
+#define _MOCK_HISTORY_DEF(_func)                                                                                       \
+    _func##_params *_func##__param_history = NULL;                                                                     \
+    size_t _func##__param_history_cap = 0;                                                                             \
+    static size_t _func##__param_history_hw = 0;                                                                       \
+    _func##_params *_func##__param_history_at(size_t i)                                                                \
+    {                                                                                                                  \
+        if (i >= _func##__param_history_cap)                                                                           \
+        {                                                                                                              \
+            _func##__param_history = (_func##_params *)_mock_grow(                                                     \
+                    _func##__param_history, &_func##__param_history_cap, sizeof(_func##_params), i);                   \
+        }                                                                                                              \
+        return &_func##__param_history[i];                                                                             \
+    }
+
+#define _MOCK_QUEUE_STORAGE_DECL(_func, _rtype)                                                                        \
+    extern _rtype *_func##__return_queue;                                                                              \
+    extern size_t _func##__return_queue_cap;                                                                           \
+    _rtype *_func##__return_queue_at(size_t i);                                                                        \
+    _rtype _func##__return_queue_get(size_t i);
+
+#define _MOCK_QUEUE_STORAGE_DEF(_func, _rtype)                                                                         \
+    _rtype *_func##__return_queue = NULL;                                                                              \
+    size_t _func##__return_queue_cap = 0;                                                                              \
+    _rtype *_func##__return_queue_at(size_t i)                                                                         \
+    {                                                                                                                  \
+        if (i >= _func##__return_queue_cap)                                                                            \
+        {                                                                                                              \
+            _func##__return_queue = (_rtype *)_mock_grow(                                                              \
+                    _func##__return_queue, &_func##__return_queue_cap, sizeof(_rtype), i);                             \
+        }                                                                                                              \
+        return &_func##__return_queue[i];                                                                              \
+    }                                                                                                                  \
+    _rtype _func##__return_queue_get(size_t i)                                                                         \
+    {                                                                                                                  \
+        _rtype unprimed;                                                                                               \
+        if (i < _func##__return_queue_cap)                                                                             \
+        {                                                                                                              \
+            return _func##__return_queue[i];                                                                           \
+        }                                                                                                              \
+        memset(&unprimed, 0, sizeof(unprimed));                                                                        \
+        return unprimed;                                                                                               \
+    }
+
+/* Unprimed calls read zero without growing the return queue */
+#define _MOCK_HISTORY_SLOT(_func, _i) (_MOCK_HW_MARK(_func##__param_history_hw, _i), _func##__param_history_at(_i))
+#define _MOCK_QUEUE_STORAGE_LOAD(_func, _i) _func##__return_queue_get(_i)
+
+#define _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+    if (_func##__param_history_hw)                                                                                     \
+    {                                                                                                                  \
+        memset(_func##__param_history, 0, _func##__param_history_hw * sizeof(*_func##__param_history));                \
+        _func##__param_history_hw = 0;                                                                                 \
+    }
+
+#define _MOCK_QUEUE_STORAGE_CLEAR(_func)                                                                               \
+    if (_func##__return_queue)                                                                                         \
+    {                                                                                                                  \
+        memset(_func##__return_queue, 0, _func##__return_queue_cap * sizeof(*_func##__return_queue));                  \
+    }
+
+/* Storage grows instead of overflowing */
+#define _MOCK_OVERFLOW_CHECK(_func)
+
+/* Capacity reported by the mock statistics, 0 for unbounded */
+#define _MOCK_STORAGE_CAPACITY 0
+#define _MOCK_STORAGE_WRAPS false
+
+/** Param history entry @p _i of @p _func (a zeroed entry past __call_count) */
+#define MOCK_PARAM_HISTORY(_func, _i) (*_func##__param_history_at(_i))
+
+/** Return queue slot @p _i of @p _func, as an lvalue (grows the queue) */
+#define MOCK_RETURN_QUEUE(_func, _i) (*_func##__return_queue_at(_i))
+
+#else /* fixed MOCK_CALL_STORAGE_MAX arrays, optionally used as rings */
+
+#define _MOCK_STORAGE_CAPACITY MOCK_CALL_STORAGE_MAX
+#ifdef MOCK_CALL_STORAGE_RING
+#define _MOCK_STORAGE_WRAPS true
+#else
+#define _MOCK_STORAGE_WRAPS false
+#endif
+
+#define _MOCK_HISTORY_DECL(_func) extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];
+#define _MOCK_HISTORY_DEF(_func)                                                                                       \
+    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    static size_t _func##__param_history_hw = 0;
+#ifdef MOCK_RETURN_QUEUE_TRACKED
+#define _MOCK_QUEUE_STORAGE_DECL(_func, _rtype)                                                                        \
+    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _rtype *_func##__return_queue_at(size_t s);
+#define _MOCK_QUEUE_STORAGE_DEF(_func, _rtype)                                                                         \
+    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    static size_t _func##__return_queue_hw = 0;                                                                        \
+    _rtype *_func##__return_queue_at(size_t s)                                                                         \
+    {                                                                                                                  \
+        _MOCK_QUEUE_HW_MARK(_func##__return_queue_hw, s);                                                              \
+        return &_func##__return_queue[s];                                                                              \
+    }
+#define _MOCK_QUEUE_STORAGE_CLEAR(_func)                                                                               \
+    memset(_func##__return_queue, 0, _func##__return_queue_hw * sizeof(_func##__return_queue[0]));                     \
+    _func##__return_queue_hw = 0;
+/* Slot @p _s of the return queue as an lvalue, covered by the priming mark */
+#define _MOCK_QUEUE_PRIME(_func, _s) (*_func##__return_queue_at(_s))
+#else
+#define _MOCK_QUEUE_STORAGE_DECL(_func, _rtype) extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];
+#define _MOCK_QUEUE_STORAGE_DEF(_func, _rtype) _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];
+#define _MOCK_QUEUE_STORAGE_CLEAR(_func) memset(_func##__return_queue, 0, sizeof(_func##__return_queue));
+#define _MOCK_QUEUE_PRIME(_func, _s) (_func##__return_queue[_s])
+#endif
+
+#define _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+    _MOCK_HISTORY_HW_SYNC(_func)                                                                                       \
+    memset(_func##__param_history, 0, _func##__param_history_hw * sizeof(_func##__param_history[0]));                  \
+    _func##__param_history_hw = 0;
+
+#ifdef MOCK_CALL_STORAGE_RING
+
+/** Slot holding logical call index @p _i */
+#define MOCK_RING_SLOT(_i) ((size_t)(_i) % MOCK_CALL_STORAGE_MAX)
+
+#define _MOCK_HISTORY_SLOT(_func, _i)                                                                                  \
+    (_MOCK_HW_MARK(_func##__param_history_hw, MOCK_RING_SLOT(_i)), &_func##__param_history[MOCK_RING_SLOT(_i)])
+#define _MOCK_QUEUE_STORAGE_LOAD(_func, _i) (_func##__return_queue[MOCK_RING_SLOT(_i)])
+
+/* Rings wrap instead of overflowing */
+#define _MOCK_OVERFLOW_CHECK(_func)
+
+/** Param history entry for logical call @p _i of @p _func (valid for the last MOCK_CALL_STORAGE_MAX calls) */
+#define MOCK_PARAM_HISTORY(_func, _i) (_func##__param_history[MOCK_RING_SLOT(_i)])
+
+/** Return queue slot serving logical call @p _i of @p _func, as an lvalue */
+#define MOCK_RETURN_QUEUE(_func, _i) _MOCK_QUEUE_PRIME(_func, MOCK_RING_SLOT(_i))
+
+#else
+
+#define _MOCK_HISTORY_SLOT(_func, _i) (_MOCK_HW_MARK(_func##__param_history_hw, _i), &_func##__param_history[_i])
+#define _MOCK_QUEUE_STORAGE_LOAD(_func, _i) (_func##__return_queue[_i])
+
+/* Overflow check - aborts immediately if call limit exceeded */
+#define _MOCK_OVERFLOW_CHECK(_func)                                                                                    \
+    if (i >= MOCK_CALL_STORAGE_MAX)                                                                                    \
+    {                                                                                                                  \
+        fprintf(stderr, "MOCK OVERFLOW: %s exceeded %d calls\n", #_func, MOCK_CALL_STORAGE_MAX);                       \
+        lfg_ct_report_flush();                                                                                         \
+        assert(0 && "mock call storage exceeded");                                                                     \
+    }
+
+/** Param history entry @p _i of @p _func */
+#define MOCK_PARAM_HISTORY(_func, _i) (_func##__param_history[_i])
+
+/** Return queue slot @p _i of @p _func, as an lvalue */
+#define MOCK_RETURN_QUEUE(_func, _i) _MOCK_QUEUE_PRIME(_func, _i)
+
+#endif /* MOCK_CALL_STORAGE_RING */
+
+#endif /* MOCK_CALL_STORAGE_DYNAMIC */
+
+/*============================================================================
+ *  Return Programs
+ *
+ *  An R_* mock can be given a short program of steps instead of (or before)
+ *  a primed return queue. Each step starts where the previous one ends, or at
+ *  the call count when it is added if the previous one is already over:
+ *
+ *    MOCK_RETURNS_REPEAT(f, v, n)          return v for the next n calls
+ *    MOCK_RETURNS_CYCLE(f, vals, len, n)   return vals[0..len-1] round-robin
+ *    MOCK_RETURNS_FN(f, fn, n)             return fn(k), k = 0.. within the step
+ *    MOCK_RETURNS_DEFAULT(f, v)            return v from here on
+ *
+ *  n may be MOCK_FOREVER. Once the steps are used up the return queue is read
+ *  as before. Each call scans at most MOCK_RETURN_PROGRAM_MAX steps, so setup
+ *  and per-call cost are constant however many calls a step covers. Pair with
+ *  MOCK_CALL_STORAGE_RING for runs longer than MOCK_CALL_STORAGE_MAX, since
+ *  the param history is still recorded. Reset clears the program.
+ *==========================================================================*/
+
+/** Step length that never ends */
+#define MOCK_FOREVER ((size_t)-1)
+
+enum _mock_returns_kind
+{
+    eMOCK_RETURNS_VALUE,
+    eMOCK_RETURNS_CYCLE,
+    eMOCK_RETURNS_FN,
+};
+
+#define _MOCK_PROGRAM_DECL(_func, _rtype)                                                                              \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        enum _mock_returns_kind kind;                                                                                  \
+        size_t begin;                                                                                                  \
+        size_t end;                                                                                                    \
+        _rtype value;                                                                                                  \
+        const _rtype *values;                                                                                          \
+        size_t nvalues;                                                                                                \
+        _rtype (*fn)(size_t);                                                                                          \
+    } _func##__return_step_t;                                                                                          \
+    typedef struct                                                                                                     \
+    {                                                                                                                  \
+        size_t nsteps;                                                                                                 \
+        _func##__return_step_t steps[MOCK_RETURN_PROGRAM_MAX];                                                         \
+    } _func##__return_program_t;                                                                                       \
+    extern _func##__return_program_t _func##__return_program;                                                          \
+    void _func##__returns_add(enum _mock_returns_kind kind,                                                            \
+            size_t n,                                                                                                  \
+            const _rtype *value,                                                                                       \
+            const _rtype *values,                                                                                      \
+            size_t nvalues,                                                                                            \
+            _rtype (*fn)(size_t));                                                                                     \
+    _rtype _func##__returns_eval(size_t i);
+
+#define _MOCK_PROGRAM_DEF(_func, _rtype)                                                                               \
+    _func##__return_program_t _func##__return_program;                                                                 \
+    void _func##__returns_add(enum _mock_returns_kind kind,                                                            \
+            size_t n,                                                                                                  \
+            const _rtype *value,                                                                                       \
+            const _rtype *values,                                                                                      \
+            size_t nvalues,                                                                                            \
+            _rtype (*fn)(size_t))                                                                                      \
+    {                                                                                                                  \
+        _func##__return_program_t *prog = &_func##__return_program;                                                    \
+        _func##__return_step_t *step = &prog->steps[prog->nsteps];                                                     \
+        size_t begin = _func##__call_count;                                                                            \
+        const char *why = NULL;                                                                                        \
+        if (prog->nsteps && prog->steps[prog->nsteps - 1].end > begin)                                                 \
+        {                                                                                                              \
+            begin = prog->steps[prog->nsteps - 1].end;                                                                 \
+        }                                                                                                              \
+        if (prog->nsteps >= MOCK_RETURN_PROGRAM_MAX)                                                                   \
+        {                                                                                                              \
+            why = "over MOCK_RETURN_PROGRAM_MAX";                                                                      \
+        }                                                                                                              \
+        else if (begin == MOCK_FOREVER)                                                                                \
+        {                                                                                                              \
+            why = "unreachable";                                                                                       \
+        }                                                                                                              \
+        else if (eMOCK_RETURNS_CYCLE == kind && (!values || 0 == nvalues))                                             \
+        {                                                                                                              \
+            why = "a cycle without values";                                                                            \
+        }                                                                                                              \
+        else if (eMOCK_RETURNS_FN == kind && !fn)                                                                      \
+        {                                                                                                              \
+            why = "missing its function";                                                                              \
+        }                                                                                                              \
+        if (why)                                                                                                       \
+        {                                                                                                              \
+            fprintf(stderr, "MOCK RETURN PROGRAM: %s step %lu is %s\n", #_func, (unsigned long)prog->nsteps, why);     \
+            lfg_ct_report_flush();                                                                                     \
+            assert(0 && "mock return program step rejected");                                                          \
+            return;                                                                                                    \
+        }                                                                                                              \
+        memset(step, 0, sizeof(*step));                                                                                \
+        step->kind = kind;                                                                                             \
+        step->begin = begin;                                                                                           \
+        step->end = (n == MOCK_FOREVER || n > MOCK_FOREVER - begin) ? MOCK_FOREVER : begin + n;                        \
+        if (value)                                                                                                     \
+        {                                                                                                              \
+            step->value = *value;                                                                                      \
+        }                                                                                                              \
+        step->values = values;                                                                                         \
+        step->nvalues = nvalues;                                                                                       \
+        step->fn = fn;                                                                                                 \
+        prog->nsteps++;                                                                                                \
+    }                                                                                                                  \
+    _rtype _func##__returns_eval(size_t i)                                                                             \
+    {                                                                                                                  \
+        const _func##__return_program_t *prog = &_func##__return_program;                                              \
+        size_t s;                                                                                                      \
+        for (s = 0; s < prog->nsteps; s++)                                                                             \
+        {                                                                                                              \
+            const _func##__return_step_t *step = &prog->steps[s];                                                      \
+            if (i < step->begin || i >= step->end)                                                                     \
+            {                                                                                                          \
+                continue;                                                                                              \
+            }                                                                                                          \
+            if (eMOCK_RETURNS_CYCLE == step->kind)                                                                     \
+            {                                                                                                          \
+                return step->values[(i - step->begin) % step->nvalues];                                                \
+            }                                                                                                          \
+            if (eMOCK_RETURNS_FN == step->kind)                                                                        \
+            {                                                                                                          \
+                return step->fn(i - step->begin);                                                                      \
+            }                                                                                                          \
+            return step->value;                                                                                        \
+        }                                                                                                              \
+        return _MOCK_QUEUE_STORAGE_LOAD(_func, i);                                                                     \
+    }
+
+/* The R_* bodies see the program through the return queue helpers */
+#define _MOCK_QUEUE_DECL(_func, _rtype) _MOCK_QUEUE_STORAGE_DECL(_func, _rtype) _MOCK_PROGRAM_DECL(_func, _rtype)
+#define _MOCK_QUEUE_DEF(_func, _rtype) _MOCK_QUEUE_STORAGE_DEF(_func, _rtype) _MOCK_PROGRAM_DEF(_func, _rtype)
+#define _MOCK_QUEUE_LOAD(_func, _i)                                                                                    \
+    (_func##__return_program.nsteps ? _func##__returns_eval(_i) : _MOCK_QUEUE_STORAGE_LOAD(_func, _i))
+#define _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+    _MOCK_QUEUE_STORAGE_CLEAR(_func)                                                                                   \
+    _func##__return_program.nsteps = 0;
+
+/** Return @p _value from @p _func for the next @p _n calls */
+#define MOCK_RETURNS_REPEAT(_func, _value, _n)                                                                         \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        _func##__return_step_t _mock_step;                                                                             \
+        _mock_step.value = (_value);                                                                                   \
+        _func##__returns_add(eMOCK_RETURNS_VALUE, (_n), &_mock_step.value, NULL, 0, NULL);                             \
+    } while (0)
+
+/** Return @p _value from @p _func on every further call */
+#define MOCK_RETURNS_DEFAULT(_func, _value) MOCK_RETURNS_REPEAT(_func, _value, MOCK_FOREVER)
+
+/** Return @p _values[0 .. @p _len - 1] round-robin for the next @p _n calls (the array must outlive them) */
+#define MOCK_RETURNS_CYCLE(_func, _values, _len, _n)                                                                   \
+    _func##__returns_add(eMOCK_RETURNS_CYCLE, (_n), NULL, (_values), (_len), NULL)
+
+/** Return @p _fn(k) for the next @p _n calls, k counting from 0 within the step */
+#define MOCK_RETURNS_FN(_func, _fn, _n) _func##__returns_add(eMOCK_RETURNS_FN, (_n), NULL, NULL, 0, (_fn))
 
 /*============================================================================
  *  Internal Helper Macros
  *==========================================================================*/
 
-/* Auto-register mock reset function on first invocation */
-#define _MOCK_REGISTER(_func) _mock_register_reset(_func##__mock_reset);
+/* Append the params just stored at p to the mock's param stream, if one is open */
+#define _MOCK_STREAM(_func)                                                                                            \
+    if (_func##__param_stream.hdr)                                                                                     \
+    {                                                                                                                  \
+        uint64_t _mock_n = _MOCK_STREAM_CLAIM(_func##__param_stream);                                                  \
+        if (_mock_n < _MOCK_STREAM_CAPACITY(_func##__param_stream))                                                    \
+        {                                                                                                              \
+            ((_func##_params *)_func##__param_stream.records)[_mock_n] = *p;                                           \
+        }                                                                                                              \
+        else                                                                                                           \
+        {                                                                                                              \
+            _mock_param_stream_put(&_func##__param_stream, _mock_n, p);                                                \
+        }                                                                                                              \
+    }
+
+/* Registry node of @p _func, defined next to its call counter */
+#define _MOCK_REG_DEF(_func, _cmp, _params_size)                                                                       \
+    struct _mock_registration _func##__mock_reg = {NULL, _func##__mock_reset, false, #_func, 0, &_func##__call_count,  \
+            _MOCK_STORAGE_CAPACITY, _MOCK_STORAGE_WRAPS, _MOCK_REG_THREAD_SAFE, NULL, false, 0, 0, 0, 0, _cmp,         \
+            _params_size, NULL, NULL};
+#define _MOCK_REG_DECL(_func) extern struct _mock_registration _func##__mock_reg;
+
+/* Expectation argument comparators: _MOCK_EXPECT_FIELDS_n(_f) applies _f to p0..p(n-1) */
+#define _MOCK_EXPECT_EQ(_n)                                                                                            \
+    if ((mask & (1u << (_n))) && !(e->p##_n == a->p##_n))                                                              \
+    {                                                                                                                  \
+        return _n;                                                                                                     \
+    }
+#define _MOCK_EXPECT_EQ_S(_n)                                                                                          \
+    if ((mask & (1u << (_n))) && 0 != memcmp(&e->p##_n, &a->p##_n, sizeof(e->p##_n)))                                  \
+    {                                                                                                                  \
+        return _n;                                                                                                     \
+    }
+#define _MOCK_EXPECT_FIELDS_1(_f) _f(0)
+#define _MOCK_EXPECT_FIELDS_2(_f) _MOCK_EXPECT_FIELDS_1(_f) _f(1)
+#define _MOCK_EXPECT_FIELDS_3(_f) _MOCK_EXPECT_FIELDS_2(_f) _f(2)
+#define _MOCK_EXPECT_FIELDS_4(_f) _MOCK_EXPECT_FIELDS_3(_f) _f(3)
+#define _MOCK_EXPECT_FIELDS_5(_f) _MOCK_EXPECT_FIELDS_4(_f) _f(4)
+#define _MOCK_EXPECT_FIELDS_6(_f) _MOCK_EXPECT_FIELDS_5(_f) _f(5)
+#define _MOCK_EXPECT_FIELDS_7(_f) _MOCK_EXPECT_FIELDS_6(_f) _f(6)
+#define _MOCK_EXPECT_FIELDS_8(_f) _MOCK_EXPECT_FIELDS_7(_f) _f(7)
+#define _MOCK_EXPECT_FIELDS_9(_f) _MOCK_EXPECT_FIELDS_8(_f) _f(8)
+
+/* Comparator of @p _func: index of the first masked parameter that differs, or -1 */
+#define _MOCK_EXPECT_CMP_DEF(_func, _fields)                                                                           \
+    static int _func##__expect_cmp(const void *expected, unsigned mask, const void *actual)                            \
+    {                                                                                                                  \
+        const _func##_params *e = (const _func##_params *)expected;                                                    \
+        const _func##_params *a = (const _func##_params *)actual;                                                      \
+        _fields                                                                                                        \
+        return -1;                                                                                                     \
+    }
+
+/* Match the call against the mock's expectations, if it has any */
+#define _MOCK_EXPECT_CHECK(_func, _params)                                                                             \
+    if (_func##__mock_reg.expect_tail)                                                                                 \
+    {                                                                                                                  \
+        _mock_expect_call(&_func##__mock_reg, i, _params);                                                             \
+    }
+
+/* Auto-register mock reset function on first invocation, and feed the call trace */
+#define _MOCK_REGISTER(_func)                                                                                          \
+    if (!_MOCK_REGISTERED(_func##__mock_reg))                                                                          \
+    {                                                                                                                  \
+        _mock_register(&_func##__mock_reg);                                                                            \
+    }                                                                                                                  \
+    if (_MOCK_TRACING())                                                                                               \
+    {                                                                                                                  \
+        _mock_trace_record(&_func##__mock_reg, i);                                                                     \
+    }
 
 /* Switch case generators for parameter lookup */
 #define _MOCK_SWITCH_1                                                                                                 \
@@ -215,14 +1035,10 @@ void mock_reset_all(void);
 
 /* Action loop - processes param read/write actions */
 #define _MOCK_ACTION_LOOP(_func, _switch)                                                                              \
+    action = _mock_param_actions_for_call(&_func##__mock_reg, action, i);                                              \
     while (action)                                                                                                     \
     {                                                                                                                  \
         void *pparam = NULL;                                                                                           \
-        if (action->call_index != _func##__call_count)                                                                 \
-        {                                                                                                              \
-            action = action->next;                                                                                     \
-            continue;                                                                                                  \
-        }                                                                                                              \
         switch (action->parameter_index)                                                                               \
         {                                                                                                              \
             _switch                                                                                                    \
@@ -243,11 +1059,15 @@ void mock_reset_all(void);
         {                                                                                                              \
             snprintf((char *)pparam, action->buf_size, "%s", (const char *)action->buffer);                            \
         }                                                                                                              \
+        else if (eMOCK_PARAM_ACTION_DIR_DIGEST == action->dir)                                                         \
+        {                                                                                                              \
+            *(uint64_t *)action->buffer = mock_digest(pparam, action->buf_size);                                       \
+        }                                                                                                              \
         else                                                                                                           \
         {                                                                                                              \
             assert(false);                                                                                             \
         }                                                                                                              \
-        action = action->next;                                                                                         \
+        action = action->next_for_call;                                                                                \
     }
 
 /* Callback invocation helpers.
@@ -261,128 +1081,249 @@ void mock_reset_all(void);
 #define _MOCK_CALLBACK_V_V(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i);                                                                                          \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_V_1(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, _p0);                                                                                     \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_V_2(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, _p0, _p1);                                                                                \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_V_3(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, _p0, _p1, _p2);                                                                           \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_V_4(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, _p0, _p1, _p2, _p3);                                                                      \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_V_5(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, _p0, _p1, _p2, _p3, _p4);                                                                 \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_V_6(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, _p0, _p1, _p2, _p3, _p4, _p5);                                                            \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_V_7(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, _p0, _p1, _p2, _p3, _p4, _p5, _p6);                                                       \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_V_8(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, _p0, _p1, _p2, _p3, _p4, _p5, _p6, _p7);                                                  \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_V_9(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, _p0, _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);                                             \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_V(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret);                                                                                    \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_1(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret, _p0);                                                                               \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_2(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret, _p0, _p1);                                                                          \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_3(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret, _p0, _p1, _p2);                                                                     \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_4(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret, _p0, _p1, _p2, _p3);                                                                \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_5(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4);                                                           \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_6(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4, _p5);                                                      \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_7(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4, _p5, _p6);                                                 \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_8(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4, _p5, _p6, _p7);                                            \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 #define _MOCK_CALLBACK_R_9(_func)                                                                                      \
     if (_func##__callback)                                                                                             \
     {                                                                                                                  \
+        bool _mock_timed = _mock_stats_timing;                                                                         \
+        uint64_t _mock_t0 = _mock_timed ? _mock_now_ns() : 0;                                                          \
         _func##__callback(i, &ret, _p0, _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);                                       \
+        if (_mock_timed)                                                                                               \
+        {                                                                                                              \
+            _mock_stats_callback(&_func##__mock_reg, _mock_t0);                                                        \
+        }                                                                                                              \
     }
 
 /* Reset function for void-return mocks */
 #define _MOCK_RESET_V(_func)                                                                                           \
     void _func##__mock_reset(void)                                                                                     \
     {                                                                                                                  \
-        memset(_func##__param_history, 0, sizeof(_func##__param_history));                                             \
+        _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
         _func##__call_count = 0;                                                                                       \
         mock_param_destroy(_func##__param_actions);                                                                    \
         _func##__param_actions = NULL;                                                                                 \
@@ -393,22 +1334,15 @@ void mock_reset_all(void);
 #define _MOCK_RESET_R(_func)                                                                                           \
     void _func##__mock_reset(void)                                                                                     \
     {                                                                                                                  \
-        memset(_func##__return_queue, 0, sizeof(_func##__return_queue));                                               \
-        memset(_func##__param_history, 0, sizeof(_func##__param_history));                                             \
+        _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+        _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
         _func##__call_count = 0;                                                                                       \
         mock_param_destroy(_func##__param_actions);                                                                    \
         _func##__param_actions = NULL;                                                                                 \
         _func##__callback = NULL;                                                                                      \
     }
 
-/* Overflow check - aborts immediately if call limit exceeded */
-#define _MOCK_OVERFLOW_CHECK(_func)                                                                                    \
-    if (i >= MOCK_CALL_STORAGE_MAX)                                                                                    \
-    {                                                                                                                  \
-        fprintf(stderr, "MOCK OVERFLOW: %s exceeded %d calls\n", #_func, MOCK_CALL_STORAGE_MAX);                       \
-        assert(0 && "mock call storage exceeded");                                                                     \
-    }
-
 #define _MOCK_OVERFLOW_CHECK_V(_func) _MOCK_OVERFLOW_CHECK(_func)
 #define _MOCK_OVERFLOW_CHECK_R(_func, _rtype) _MOCK_OVERFLOW_CHECK(_func)
 
@@ -420,22 +1354,26 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t);                                                                       \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
+    _MOCK_REG_DECL(_func)                                                                                              \
     void _func##__mock(void);                                                                                          \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_V_V(_func)                                                                                         \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
+    _MOCK_REG_DEF(_func, NULL, 0)                                                                                      \
     void _func##__mock(void)                                                                                           \
     {                                                                                                                  \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
+        _MOCK_EXPECT_CHECK(_func, NULL)                                                                                \
         _MOCK_CALLBACK_V_V(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     void _func##__mock_reset(void)                                                                                     \
     {                                                                                                                  \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
         _func##__call_count = 0;                                                                                       \
         _func##__callback = NULL;                                                                                      \
     }
@@ -448,28 +1386,32 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *);                                                             \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     _rtype _func##__mock(void);                                                                                        \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_R_V(_func, _rtype)                                                                                 \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_REG_DEF(_func, NULL, 0)                                                                                      \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     _rtype _func##__mock(void)                                                                                         \
     {                                                                                                                  \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_EXPECT_CHECK(_func, NULL)                                                                                \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_CALLBACK_R_V(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     void _func##__mock_reset(void)                                                                                     \
     {                                                                                                                  \
-        memset(_func##__return_queue, 0, sizeof(_func##__return_queue));                                               \
+        _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
         _func##__call_count = 0;                                                                                       \
         _func##__callback = NULL;                                                                                      \
     }
@@ -486,7 +1428,9 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0);                                                                  \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     void _func##__mock(_t0);                                                                                           \
     void _func##__mock_reset(void)
@@ -494,20 +1438,25 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_V_1(_func, _t0)                                                                                    \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_1(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     void _func##__mock(_t0 _p0)                                                                                        \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_1                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_1)                                                                       \
         _MOCK_CALLBACK_V_1(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V(_func)
 
@@ -520,7 +1469,9 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1);                                                             \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     void _func##__mock(_t0, _t1);                                                                                      \
     void _func##__mock_reset(void)
@@ -528,20 +1479,25 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_V_2(_func, _t0, _t1)                                                                               \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_2(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     void _func##__mock(_t0 _p0, _t1 _p1)                                                                               \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_2                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_2)                                                                       \
         _MOCK_CALLBACK_V_2(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V(_func)
 
@@ -555,7 +1511,9 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2);                                                        \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     void _func##__mock(_t0, _t1, _t2);                                                                                 \
     void _func##__mock_reset(void)
@@ -563,20 +1521,25 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_V_3(_func, _t0, _t1, _t2)                                                                          \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_3(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2)                                                                      \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_3                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_3)                                                                       \
         _MOCK_CALLBACK_V_3(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V(_func)
 
@@ -591,7 +1554,9 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3);                                                   \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     void _func##__mock(_t0, _t1, _t2, _t3);                                                                            \
     void _func##__mock_reset(void)
@@ -599,20 +1564,25 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_V_4(_func, _t0, _t1, _t2, _t3)                                                                     \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_4(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3)                                                             \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_4                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_4)                                                                       \
         _MOCK_CALLBACK_V_4(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V(_func)
 
@@ -628,7 +1598,9 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4);                                              \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     void _func##__mock(_t0, _t1, _t2, _t3, _t4);                                                                       \
     void _func##__mock_reset(void)
@@ -636,20 +1608,25 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_V_5(_func, _t0, _t1, _t2, _t3, _t4)                                                                \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_5(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4)                                                    \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_5                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_5)                                                                       \
         _MOCK_CALLBACK_V_5(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V(_func)
 
@@ -666,7 +1643,9 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4, _t5);                                         \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     void _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5);                                                                  \
     void _func##__mock_reset(void)
@@ -674,20 +1653,25 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_V_6(_func, _t0, _t1, _t2, _t3, _t4, _t5)                                                           \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_6(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5)                                           \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_6                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_6)                                                                       \
         _MOCK_CALLBACK_V_6(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V(_func)
 
@@ -705,7 +1689,9 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4, _t5, _t6);                                    \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     void _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6);                                                             \
     void _func##__mock_reset(void)
@@ -713,20 +1699,25 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_V_7(_func, _t0, _t1, _t2, _t3, _t4, _t5, _t6)                                                      \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_7(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6)                                  \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_7                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_7)                                                                       \
         _MOCK_CALLBACK_V_7(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V(_func)
 
@@ -745,7 +1736,9 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7);                               \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     void _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7);                                                        \
     void _func##__mock_reset(void)
@@ -753,20 +1746,25 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_V_8(_func, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7)                                                 \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_8(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6, _t7 _p7)                         \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_8                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_8)                                                                       \
         _MOCK_CALLBACK_V_8(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V(_func)
 
@@ -786,7 +1784,9 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8);                          \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     void _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8);                                                   \
     void _func##__mock_reset(void)
@@ -794,20 +1794,25 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_V_9(_func, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8)                                            \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_9(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6, _t7 _p7, _t8 _p8)                \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_9                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_9)                                                                       \
         _MOCK_CALLBACK_V_9(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V(_func)
 
@@ -823,8 +1828,10 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0);                                                        \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     _rtype _func##__mock(_t0);                                                                                         \
     void _func##__mock_reset(void)
@@ -832,23 +1839,28 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_R_1(_func, _rtype, _t0)                                                                            \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_1(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     _rtype _func##__mock(_t0 _p0)                                                                                      \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_1                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_1)                                                                       \
         _MOCK_CALLBACK_R_1(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R(_func)
@@ -862,8 +1874,10 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1);                                                   \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     _rtype _func##__mock(_t0, _t1);                                                                                    \
     void _func##__mock_reset(void)
@@ -871,23 +1885,28 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_R_2(_func, _rtype, _t0, _t1)                                                                       \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_2(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     _rtype _func##__mock(_t0 _p0, _t1 _p1)                                                                             \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_2                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_2)                                                                       \
         _MOCK_CALLBACK_R_2(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R(_func)
@@ -902,8 +1921,10 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2);                                              \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     _rtype _func##__mock(_t0, _t1, _t2);                                                                               \
     void _func##__mock_reset(void)
@@ -911,23 +1932,28 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_R_3(_func, _rtype, _t0, _t1, _t2)                                                                  \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_3(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2)                                                                    \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_3                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_3)                                                                       \
         _MOCK_CALLBACK_R_3(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R(_func)
@@ -943,8 +1969,10 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3);                                         \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     _rtype _func##__mock(_t0, _t1, _t2, _t3);                                                                          \
     void _func##__mock_reset(void)
@@ -952,23 +1980,28 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_R_4(_func, _rtype, _t0, _t1, _t2, _t3)                                                             \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_4(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3)                                                           \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_4                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_4)                                                                       \
         _MOCK_CALLBACK_R_4(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R(_func)
@@ -985,8 +2018,10 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4);                                    \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4);                                                                     \
     void _func##__mock_reset(void)
@@ -994,23 +2029,28 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_R_5(_func, _rtype, _t0, _t1, _t2, _t3, _t4)                                                        \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_5(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4)                                                  \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_5                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_5)                                                                       \
         _MOCK_CALLBACK_R_5(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R(_func)
@@ -1028,8 +2068,10 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5);                               \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5);                                                                \
     void _func##__mock_reset(void)
@@ -1037,23 +2079,28 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_R_6(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5)                                                   \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_6(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5)                                         \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_6                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_6)                                                                       \
         _MOCK_CALLBACK_R_6(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R(_func)
@@ -1072,8 +2119,10 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5, _t6);                          \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6);                                                           \
     void _func##__mock_reset(void)
@@ -1081,23 +2130,28 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_R_7(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5, _t6)                                              \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_7(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6)                                \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_7                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_7)                                                                       \
         _MOCK_CALLBACK_R_7(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R(_func)
@@ -1117,8 +2171,10 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7);                     \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7);                                                      \
     void _func##__mock_reset(void)
@@ -1126,23 +2182,28 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_R_8(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7)                                         \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_8(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6, _t7 _p7)                       \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_8                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_8)                                                                       \
         _MOCK_CALLBACK_R_8(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R(_func)
@@ -1163,8 +2224,10 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8);                \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     extern mock_param_action_t _func##__param_actions;                                                                 \
     _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8);                                                 \
     void _func##__mock_reset(void)
@@ -1172,23 +2235,28 @@ void mock_reset_all(void);
 #define DEFINE_MOCK_R_9(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5, _t6, _t7, _t8)                                    \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_9(_MOCK_EXPECT_EQ))                                                \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     mock_param_action_t _func##__param_actions = NULL;                                                                 \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5, _t6 _p6, _t7 _p7, _t8 _p8)              \
     {                                                                                                                  \
         struct _mock_param_action *action = _func##__param_actions;                                                    \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_9                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_ACTION_LOOP(_func, _MOCK_SWITCH_9)                                                                       \
         _MOCK_CALLBACK_R_9(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R(_func)
@@ -1207,7 +2275,8 @@ void mock_reset_all(void);
 #define _MOCK_RESET_V_SIMPLE(_func)                                                                                    \
     void _func##__mock_reset(void)                                                                                     \
     {                                                                                                                  \
-        memset(_func##__param_history, 0, sizeof(_func##__param_history));                                             \
+        _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
         _func##__call_count = 0;                                                                                       \
         _func##__callback = NULL;                                                                                      \
     }
@@ -1215,8 +2284,9 @@ void mock_reset_all(void);
 #define _MOCK_RESET_R_SIMPLE(_func)                                                                                    \
     void _func##__mock_reset(void)                                                                                     \
     {                                                                                                                  \
-        memset(_func##__return_queue, 0, sizeof(_func##__return_queue));                                               \
-        memset(_func##__param_history, 0, sizeof(_func##__param_history));                                             \
+        _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+        _MOCK_HISTORY_CLEAR(_func)                                                                                     \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
         _func##__call_count = 0;                                                                                       \
         _func##__callback = NULL;                                                                                      \
     }
@@ -1230,24 +2300,31 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0);                                                                  \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     void _func##__mock(_t0);                                                                                           \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_V_1_S(_func, _t0)                                                                                  \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_1(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     void _func##__mock(_t0 _p0)                                                                                        \
     {                                                                                                                  \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_1                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_CALLBACK_V_1(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V_SIMPLE(_func)
 
@@ -1261,24 +2338,31 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1);                                                             \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     void _func##__mock(_t0, _t1);                                                                                      \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_V_2_S(_func, _t0, _t1)                                                                             \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_2(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     void _func##__mock(_t0 _p0, _t1 _p1)                                                                               \
     {                                                                                                                  \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_2                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_CALLBACK_V_2(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V_SIMPLE(_func)
 
@@ -1293,24 +2377,31 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _t0, _t1, _t2);                                                        \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
     void _func##__mock(_t0, _t1, _t2);                                                                                 \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_V_3_S(_func, _t0, _t1, _t2)                                                                        \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_3(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
     void _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2)                                                                      \
     {                                                                                                                  \
         _func##_params *p;                                                                                             \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_V(_func)                                                                                  \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_3                                                                                                  \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
         _MOCK_CALLBACK_V_3(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
     }                                                                                                                  \
     _MOCK_RESET_V_SIMPLE(_func)
 
@@ -1319,28 +2410,32 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *);                                                             \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     _rtype _func##__mock(void);                                                                                        \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_R_V_S(_func, _rtype)                                                                               \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_REG_DEF(_func, NULL, 0)                                                                                      \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     _rtype _func##__mock(void)                                                                                         \
     {                                                                                                                  \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_EXPECT_CHECK(_func, NULL)                                                                                \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_CALLBACK_R_V(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     void _func##__mock_reset(void)                                                                                     \
     {                                                                                                                  \
-        memset(_func##__return_queue, 0, sizeof(_func##__return_queue));                                               \
+        _MOCK_QUEUE_CLEAR(_func)                                                                                       \
+        _mock_stats_fold(&_func##__mock_reg);                                                                          \
         _func##__call_count = 0;                                                                                       \
         _func##__callback = NULL;                                                                                      \
     }
@@ -1354,28 +2449,35 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0);                                                        \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     _rtype _func##__mock(_t0);                                                                                         \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_R_1_S(_func, _rtype, _t0)                                                                          \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_1(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     _rtype _func##__mock(_t0 _p0)                                                                                      \
     {                                                                                                                  \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_1                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_CALLBACK_R_1(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R_SIMPLE(_func)
@@ -1390,28 +2492,35 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1);                                                   \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     _rtype _func##__mock(_t0, _t1);                                                                                    \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_R_2_S(_func, _rtype, _t0, _t1)                                                                     \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_2(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     _rtype _func##__mock(_t0 _p0, _t1 _p1)                                                                             \
     {                                                                                                                  \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_2                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_CALLBACK_R_2(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R_SIMPLE(_func)
@@ -1427,28 +2536,35 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2);                                              \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     _rtype _func##__mock(_t0, _t1, _t2);                                                                               \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_R_3_S(_func, _rtype, _t0, _t1, _t2)                                                                \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_3(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2)                                                                    \
     {                                                                                                                  \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_3                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_CALLBACK_R_3(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R_SIMPLE(_func)
@@ -1465,28 +2581,35 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3);                                         \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     _rtype _func##__mock(_t0, _t1, _t2, _t3);                                                                          \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_R_4_S(_func, _rtype, _t0, _t1, _t2, _t3)                                                           \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_4(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3)                                                           \
     {                                                                                                                  \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_4                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_CALLBACK_R_4(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R_SIMPLE(_func)
@@ -1504,28 +2627,35 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4);                                    \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4);                                                                     \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_R_5_S(_func, _rtype, _t0, _t1, _t2, _t3, _t4)                                                      \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_5(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4)                                                  \
     {                                                                                                                  \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_5                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_CALLBACK_R_5(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R_SIMPLE(_func)
@@ -1544,28 +2674,35 @@ void mock_reset_all(void);
     typedef void (*_func##__callback_t)(size_t, _rtype *, _t0, _t1, _t2, _t3, _t4, _t5);                               \
     extern _func##__callback_t _func##__callback;                                                                      \
     extern size_t _func##__call_count;                                                                                 \
-    extern _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                               \
-    extern _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                        \
+    _MOCK_REG_DECL(_func)                                                                                              \
+    _MOCK_HISTORY_DECL(_func)                                                                                          \
+    extern mock_param_stream_t _func##__param_stream;                                                                  \
+    _MOCK_QUEUE_DECL(_func, _rtype)                                                                                    \
     _rtype _func##__mock(_t0, _t1, _t2, _t3, _t4, _t5);                                                                \
     void _func##__mock_reset(void)
 
 #define DEFINE_MOCK_R_6_S(_func, _rtype, _t0, _t1, _t2, _t3, _t4, _t5)                                                 \
     _func##__callback_t _func##__callback = NULL;                                                                      \
     size_t _func##__call_count = 0;                                                                                    \
-    _func##_params _func##__param_history[MOCK_CALL_STORAGE_MAX];                                                      \
-    _rtype _func##__return_queue[MOCK_CALL_STORAGE_MAX];                                                               \
+    _MOCK_EXPECT_CMP_DEF(_func, _MOCK_EXPECT_FIELDS_6(_MOCK_EXPECT_EQ_S))                                              \
+    _MOCK_REG_DEF(_func, _func##__expect_cmp, sizeof(_func##_params))                                                  \
+    _MOCK_HISTORY_DEF(_func)                                                                                           \
+    mock_param_stream_t _func##__param_stream = {NULL, NULL, 0, 0, -1, 0};                                             \
+    _MOCK_QUEUE_DEF(_func, _rtype)                                                                                     \
     _rtype _func##__mock(_t0 _p0, _t1 _p1, _t2 _p2, _t3 _p3, _t4 _p4, _t5 _p5)                                         \
     {                                                                                                                  \
         _func##_params *p;                                                                                             \
         _rtype ret;                                                                                                    \
-        size_t i = _func##__call_count;                                                                                \
+        size_t i = _MOCK_CALL_CLAIM(_func);                                                                            \
         _MOCK_REGISTER(_func)                                                                                          \
         _MOCK_OVERFLOW_CHECK_R(_func, _rtype)                                                                          \
-        p = &_func##__param_history[i];                                                                                \
+        p = _MOCK_HISTORY_SLOT(_func, i);                                                                              \
         _MOCK_STORE_6                                                                                                  \
-        ret = _func##__return_queue[i];                                                                                \
+        _MOCK_STREAM(_func)                                                                                            \
+        _MOCK_EXPECT_CHECK(_func, p)                                                                                   \
+        ret = _MOCK_QUEUE_LOAD(_func, i);                                                                              \
         _MOCK_CALLBACK_R_6(_func)                                                                                      \
-        _func##__call_count++;                                                                                         \
+        _MOCK_CALL_DONE(_func)                                                                                         \
         return ret;                                                                                                    \
     }                                                                                                                  \
     _MOCK_RESET_R_SIMPLE(_func)
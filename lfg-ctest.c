@@ -7,35 +7,328 @@
  *  Includes
  *==========================================================================*/
 
+#include <stdarg.h>
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
 #if defined(LFG_CTEST_HAS_FLOAT) || defined(LFG_CTEST_HAS_DOUBLE)
 #include <math.h>
 #endif
+#ifdef LFG_CTEST_HAS_FORK
+#include <errno.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#if defined(LFG_CTEST_HAS_FORK) || defined(LFG_CTEST_HAS_WATCHDOG)
+#include <signal.h>
+#endif
+#ifdef LFG_CTEST_HAS_WATCHDOG
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+#ifdef LFG_CTEST_HAS_BACKTRACE
+#include <execinfo.h>
+#endif
 #include "lfg-ctest.h"
 
 /*============================================================================
  *  Defines/Typedefs
  *==========================================================================*/
 
+/** capacity of the slowest-tests and slowest-suites tables (override at compile time) */
+#ifndef LFG_CT_SLOWEST_MAX
+#define LFG_CT_SLOWEST_MAX 32
+#endif
+
+/** maximum number of user reporters (override at compile time) */
+#ifndef LFG_CT_REPORTERS_MAX
+#define LFG_CT_REPORTERS_MAX 8
+#endif
+
+/** size of the console reporter's output batch (override at compile time) */
+#ifndef LFG_CT_REPORT_BUF_SIZE
+#define LFG_CT_REPORT_BUF_SIZE 4096
+#endif
+
+/** stack buffer for one formatted failure message; longer ones are formatted on the heap */
+#ifndef LFG_CT_MESSAGE_MAX
+#define LFG_CT_MESSAGE_MAX 512
+#endif
+
+/** mismatching rows hexdumped by a failed ASSERT_MEM_EQUAL (override at compile time) */
+#ifndef LFG_CT_MEM_DIFF_WINDOWS
+#define LFG_CT_MEM_DIFF_WINDOWS 4
+#endif
+
+/** bytes per hexdump row, and room for its three formatted lines */
+#define _LFG_CT_HEXDUMP_ROW 16
+#define _LFG_CT_HEXDUMP_ROW_MAX (3 * (24 + 3 * _LFG_CT_HEXDUMP_ROW))
+
+/** span handed to one memcmp while skipping equal regions of a failed compare */
+#define _LFG_CT_DIFF_BLOCK 4096
+
+/** mismatching elements listed by a failed array assertion (override at compile time) */
+#ifndef LFG_CT_ARRAY_DIFF_MAX
+#define LFG_CT_ARRAY_DIFF_MAX 8
+#endif
+
+/** room for a failed array assertion's message: header plus one line per listed element */
+#define _LFG_CT_ARRAY_MESSAGE_MAX (LFG_CT_MESSAGE_MAX + LFG_CT_ARRAY_DIFF_MAX * 128)
+
+/** capacity of the benchmark results table (override at compile time) */
+#ifndef LFG_CT_BENCH_MAX
+#define LFG_CT_BENCH_MAX 64
+#endif
+
+/** timed samples taken per benchmark (override at compile time) */
+#ifndef LFG_CT_BENCH_SAMPLES
+#define LFG_CT_BENCH_SAMPLES 32
+#endif
+
+/** target duration of one benchmark sample; iterations are calibrated to it */
+#ifndef LFG_CT_BENCH_SAMPLE_NS
+#define LFG_CT_BENCH_SAMPLE_NS 1000000u
+#endif
+
+/** upper bound on calibrated iterations, for clocks too coarse to ever reach the target */
+#ifndef LFG_CT_BENCH_ITERATIONS_MAX
+#define LFG_CT_BENCH_ITERATIONS_MAX (1ul << 30)
+#endif
+
+/** failed test names remembered for the result file (override at compile time) */
+#ifndef LFG_CT_FAILED_NAMES_MAX
+#define LFG_CT_FAILED_NAMES_MAX 64
+#endif
+
+/** maximum number of --filter patterns accepted by lfg_ct_main() */
+#ifndef LFG_CT_FILTERS_MAX
+#define LFG_CT_FILTERS_MAX 16
+#endif
+
+/** frames printed in a timeout backtrace (override at compile time) */
+#ifndef LFG_CT_BACKTRACE_MAX
+#define LFG_CT_BACKTRACE_MAX 64
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LFG_CT_HAS_CYCLES 1
+#endif
+
+/* Innermost test or suite time budget; deadline_ns 0 means none. */
+struct _lfg_ct_watch
+{
+    const char *what; /* "test" or "suite" */
+    const char *name;
+    unsigned ms;
+    uint64_t deadline_ns;
+};
+
+/* Serialises event delivery so failures raised from several threads do not
+ * interleave inside the console buffer or a reporter. Only contended when
+ * two threads fail at once, so a spin is enough. The owning thread may take
+ * it again, so a reporter can call lfg_ct_report_flush() or fail an ASSERT. */
+#ifdef LFG_CTEST_THREAD_SAFE
+#define _LFG_CT_REPORT_LOCK()                                                                                          \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (0 == _report_lock_depth++)                                                                                 \
+        {                                                                                                              \
+            while (__atomic_test_and_set(&_report_lock, __ATOMIC_ACQUIRE))                                             \
+            {                                                                                                          \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (0)
+#define _LFG_CT_REPORT_UNLOCK()                                                                                        \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (0 == --_report_lock_depth)                                                                                 \
+        {                                                                                                              \
+            __atomic_clear(&_report_lock, __ATOMIC_RELEASE);                                                           \
+        }                                                                                                              \
+    } while (0)
+#else
+#define _LFG_CT_REPORT_LOCK() ((void)0)
+#define _LFG_CT_REPORT_UNLOCK() ((void)0)
+#endif
+
+struct _lfg_ct_reporter
+{
+    lfg_ct_reporter_fn fn;
+    void *ctx;
+};
+
+#ifdef LFG_CTEST_HAS_FORK
+
+/** maximum number of concurrent worker processes (override at compile time) */
+#ifndef LFG_CT_JOBS_MAX
+#define LFG_CT_JOBS_MAX 256
+#endif
+
+/* Counters a worker process sends back to the parent for one test. */
+struct _lfg_ct_result
+{
+    int assertions_executed;
+    int assertions_failed;
+    int assertions_passed;
+    int test_failures;
+    int nested_executed; /* lfg_ctest() calls made from inside the test */
+    int nested_failed;
+    int nested_passed;
+    int expected_failures; /* only used with LFG_CTEST_SELF_TEST */
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+};
+
+struct _lfg_ct_worker
+{
+    pid_t pid;
+    int fd; /* read end of the result pipe */
+    const char *name;
+    uint64_t start_ns; /* wall time at fork, used if the worker dies */
+    unsigned timeout_ms;
+};
+
+/* Exit status of a worker whose time budget ran out (as timeout(1) uses) */
+#define _LFG_CT_TIMEOUT_STATUS 124
+
+#endif /* LFG_CTEST_HAS_FORK */
+
 /*============================================================================
  *  Private Function Prototypes
  *==========================================================================*/
 
+static void _lfg_ct_run(void (*fn)(void), const char *name, unsigned timeout_ms);
+static void _lfg_ct_dispatch(void (*fn)(void), const char *name, unsigned timeout_ms);
+static unsigned _lfg_ct_take_timeout(unsigned fallback);
+static void _lfg_ct_watch_begin(const char *what, const char *name, unsigned ms, struct _lfg_ct_watch *saved);
+static void _lfg_ct_watch_end(const struct _lfg_ct_watch *saved);
+#ifdef LFG_CTEST_HAS_WATCHDOG
+static void _lfg_ct_watch_arm(void);
+static void _lfg_ct_watchdog(int sig);
+static void _lfg_ct_sig_append(char *line, size_t size, size_t *len, const char *s);
+static void _lfg_ct_sig_append_uint(char *line, size_t size, size_t *len, unsigned long v);
+#ifdef LFG_CTEST_HAS_FORK
+static void _lfg_ct_watch_pause(void);
+static void _lfg_ct_watch_resume(void);
+#endif
+#endif
+static bool _lfg_ct_shard_skip(void);
+static void _lfg_ct_shard_from_env(void);
+static void _lfg_ct_write_result_file(void);
+static void _lfg_ct_test_finished(
+        const char *name, int failures, uint64_t wall_ns, uint64_t cpu_ns, const char *reason);
+static uint64_t _lfg_ct_ticks_to_ns(clock_t ticks);
+static uint64_t _lfg_ct_wall_ns(void);
+static uint64_t _lfg_ct_cpu_ns(void);
+static void _lfg_ct_slowest_insert(
+        lfg_ct_timing_t *table, unsigned *count, const char *name, uint64_t wall_ns, uint64_t cpu_ns);
+static void _lfg_ct_fail(const char *filename, int line_no, const char *function, const char *fmt, ...);
+static void _lfg_ct_fail_message(const char *filename, int line_no, const char *function, const char *message);
+static size_t _lfg_ct_mem_mismatch(const unsigned char *a, const unsigned char *b, size_t from, size_t n);
+static size_t _lfg_ct_str_mismatch(const char *a, const char *b, size_t n);
+static size_t _lfg_ct_hexdump_row(char *out, size_t room, const unsigned char *expected, const unsigned char *actual,
+        size_t row, size_t n);
+static void _lfg_ct_fail_mem(const unsigned char *expected, const unsigned char *actual, size_t n, size_t first,
+        char *filename, int line_no, const char *function, const char *actual_expr_str);
+static size_t _lfg_ct_appendf(char *buf, size_t size, size_t len, const char *fmt, ...);
+static bool _lfg_ct_array_null(const void *expected, const void *actual, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str);
+#ifdef LFG_CTEST_HAS_FLOAT
+static uint64_t _lfg_ct_float_ulps(float a, float b);
+#endif
+#ifdef LFG_CTEST_HAS_DOUBLE
+static uint64_t _lfg_ct_double_ulps(double a, double b);
+#endif
+static void _lfg_ct_emit(const lfg_ct_event_t *event);
+static void _lfg_ct_console(const lfg_ct_event_t *event);
+static void _lfg_ct_report_write(void);
+static void _lfg_ct_console_printf(const char *fmt, ...);
+static void _lfg_ct_console_slowest(const char *what, const lfg_ct_timing_t *table, unsigned count);
+static void _lfg_ct_console_bench(const lfg_ct_bench_result_t *table, unsigned count);
+static uint64_t _lfg_ct_cycles(void);
+static bool _lfg_ct_glob(const char *pattern, const char *str);
+static int _lfg_ct_node_name_cmp(const void *a, const void *b);
+static const char *_lfg_ct_option(int argc, char *argv[], int *i, const char *long_name, const char *short_name);
+static uint64_t _lfg_ct_bench_sample(void (*fn)(void), unsigned long iterations, uint64_t *cycles);
+
+#ifdef LFG_CTEST_HAS_FORK
+static void _lfg_ct_spawn(void (*fn)(void), const char *name, unsigned timeout_ms);
+static void _lfg_ct_reap_one(void);
+static const char *_lfg_ct_signal_name(int sig);
+#endif
+static void _lfg_ct_drain(void);
+
 /*============================================================================
  *  Variables
  *==========================================================================*/
 
-static int _assertions_executed = 0;
+/* Shared with the header so LFG_CTEST_INLINE_ASSERTS can count passes inline. */
+lfg_ct_counters_t lfg_ct_counters = {0, 0, 1};
 static int _assertions_failed = 0;
-static int _assertions_passed = 0;
 static int _tests_executed = 0;
 static int _tests_failed = 0;
 static int _tests_passed = 0;
 static int _current_test_failures = 0;
 static int _current_suite_failures = 0;
 
+static uint64_t _start_wall_ns = 0;
+static uint64_t _tests_wall_ns = 0;
+static uint64_t _tests_cpu_ns = 0;
+static unsigned _report_slowest = 5;
+static lfg_ct_timing_t _slowest_tests[LFG_CT_SLOWEST_MAX];
+static unsigned _slowest_tests_count = 0;
+static lfg_ct_timing_t _slowest_suites[LFG_CT_SLOWEST_MAX];
+static unsigned _slowest_suites_count = 0;
+
+static struct _lfg_ct_reporter _reporters[LFG_CT_REPORTERS_MAX];
+static unsigned _reporters_count = 0;
+static bool _console_enabled = true;
+static char _report_buf[LFG_CT_REPORT_BUF_SIZE];
+static size_t _report_len = 0;
+#ifdef LFG_CTEST_THREAD_SAFE
+static bool _report_lock = false;
+static __thread unsigned _report_lock_depth = 0; /* nesting of _report_lock on this thread */
+#endif
+
+static lfg_ct_bench_result_t _bench_results[LFG_CT_BENCH_MAX];
+static unsigned _bench_results_count = 0;
+
+static unsigned _shard_index = 0;
+static unsigned _shard_count = 1;
+static bool _shard_env_read = false;
+static unsigned _shard_ordinal = 0; /* top-level tests seen, skipped or not */
+static int _tests_skipped = 0;
+static int _test_depth = 0; /* >0 while a test body runs, so nested tests are never sharded */
+static const char *_result_file = NULL;
+static const char *_failed_names[LFG_CT_FAILED_NAMES_MAX];
+static unsigned _failed_names_count = 0;
+
+static unsigned _timeout_ms = 0;       /* default test budget, 0 = none */
+static unsigned _suite_timeout_ms = 0; /* default suite budget, 0 = none */
+static unsigned _timeout_next_ms = 0;
+static bool _timeout_next_set = false; /* lfg_ct_timeout_next() applies to the next test or suite */
+static struct _lfg_ct_watch _watch;
+static const char *_running_name = NULL; /* innermost test running in this process */
+static uint64_t _running_start_ns = 0;
+#ifdef LFG_CTEST_HAS_WATCHDOG
+static bool _watchdog_installed = false;
+static struct sigaction _watchdog_saved; /* SIGALRM action to restore once no budget is active */
+#endif
+
+static lfg_ct_test_node_t *_registry_head = NULL;
+static lfg_ct_test_node_t *_registry_tail = NULL;
+static unsigned _registry_count = 0;
+
+#ifdef LFG_CTEST_HAS_FORK
+static unsigned _jobs = 0;
+static bool _isolate = false;
+static bool _in_worker = false; /* set in a forked child; failures are written through */
+static unsigned _workers_active = 0;
+static struct _lfg_ct_worker _workers[LFG_CT_JOBS_MAX];
+#endif
+
 /*============================================================================
  *  Self-Test Support (internal only)
  *
@@ -54,12 +347,12 @@ static int _expected_failures_count = 0;
     {                                                                                                                  \
         if (_expect_failures_mode)                                                                                     \
         {                                                                                                              \
-            _expected_failures_count++;                                                                                \
+            _LFG_CT_COUNT(_expected_failures_count, 1);                                                                \
         }                                                                                                              \
         else                                                                                                           \
         {                                                                                                              \
-            _current_test_failures++;                                                                                  \
-            _assertions_failed++;                                                                                      \
+            _LFG_CT_COUNT(_current_test_failures, 1);                                                                  \
+            _LFG_CT_COUNT(_assertions_failed, 1);                                                                      \
         }                                                                                                              \
     } while (0)
 
@@ -68,7 +361,7 @@ static int _expected_failures_count = 0;
     {                                                                                                                  \
         if (!_expect_failures_mode)                                                                                    \
         {                                                                                                              \
-            _assertions_passed++;                                                                                      \
+            _LFG_CT_COUNT(lfg_ct_counters.assertions_passed, 1);                                                       \
         }                                                                                                              \
     } while (0)
 
@@ -77,14 +370,14 @@ static int _expected_failures_count = 0;
 #define RECORD_FAILURE()                                                                                               \
     do                                                                                                                 \
     {                                                                                                                  \
-        _current_test_failures++;                                                                                      \
-        _assertions_failed++;                                                                                          \
+        _LFG_CT_COUNT(_current_test_failures, 1);                                                                      \
+        _LFG_CT_COUNT(_assertions_failed, 1);                                                                          \
     } while (0)
 
 #define RECORD_PASS()                                                                                                  \
     do                                                                                                                 \
     {                                                                                                                  \
-        _assertions_passed++;                                                                                          \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_passed, 1);                                                           \
     } while (0)
 
 #endif /* LFG_CTEST_SELF_TEST */
@@ -101,55 +394,433 @@ lfg_ct_version(void)
 
 void lfg_ct_start(void)
 {
+    lfg_ct_event_t ev;
     unsigned rand_seed = time(NULL) % 1000;
-    printf("*** begin unit test\r\n");
-    printf("*** random seed is %u\r\n", rand_seed);
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_START;
+    ev.seed = rand_seed;
+    _lfg_ct_shard_from_env();
+    ev.shard_index = _shard_index;
+    ev.shard_count = _shard_count;
+    _lfg_ct_emit(&ev);
     srand(rand_seed);
+    _start_wall_ns = _lfg_ct_wall_ns();
 }
 
 void lfg_ct_end(void)
 {
+    _lfg_ct_drain();
+    lfg_ct_report_flush();
+}
+
+int lfg_ct_reporter_add(lfg_ct_reporter_fn fn, void *ctx)
+{
+    unsigned i;
+
+    for (i = 0; i < _reporters_count; i++)
+    {
+        if (_reporters[i].fn == fn && _reporters[i].ctx == ctx)
+        {
+            return 0; /* already registered */
+        }
+    }
+    if (NULL == fn || _reporters_count >= LFG_CT_REPORTERS_MAX)
+    {
+        return -1;
+    }
+    _reporters[_reporters_count].fn = fn;
+    _reporters[_reporters_count].ctx = ctx;
+    _reporters_count++;
+    return 0;
+}
+
+void lfg_ct_reporter_remove(lfg_ct_reporter_fn fn, void *ctx)
+{
+    unsigned i;
+
+    for (i = 0; i < _reporters_count; i++)
+    {
+        if (_reporters[i].fn == fn && _reporters[i].ctx == ctx)
+        {
+            /* keep registration order for the remaining reporters */
+            memmove(&_reporters[i], &_reporters[i + 1], (_reporters_count - i - 1) * sizeof(_reporters[0]));
+            _reporters_count--;
+            return;
+        }
+    }
+}
+
+void lfg_ct_reporter_console(bool enable)
+{
+    _console_enabled = enable;
+}
+
+void lfg_ct_report_flush(void)
+{
+    _LFG_CT_REPORT_LOCK();
+    _lfg_ct_report_write();
+    _LFG_CT_REPORT_UNLOCK();
+}
+
+void lfg_ct_parallel(unsigned jobs)
+{
+    _lfg_ct_drain();
+#ifdef LFG_CTEST_HAS_FORK
+    _jobs = jobs > LFG_CT_JOBS_MAX ? LFG_CT_JOBS_MAX : jobs;
+#else
+    (void)jobs;
+#endif
+}
+
+void lfg_ct_isolate(bool enable)
+{
+    _lfg_ct_drain();
+#ifdef LFG_CTEST_HAS_FORK
+    _isolate = enable;
+#else
+    (void)enable;
+#endif
+}
+
+void lfg_ct_set_report_slowest(unsigned n)
+{
+    _report_slowest = n > LFG_CT_SLOWEST_MAX ? LFG_CT_SLOWEST_MAX : n;
+}
+
+void lfg_ct_set_timeout_ms(unsigned test_ms, unsigned suite_ms)
+{
+    _timeout_ms = test_ms;
+    _suite_timeout_ms = suite_ms;
+}
+
+void lfg_ct_timeout_next(unsigned ms)
+{
+    _timeout_next_ms = ms;
+    _timeout_next_set = true;
 }
 
 void lfg_ct_suite_impl(void (*fn)(void), const char *name)
 {
+    lfg_ct_event_t ev;
+    struct _lfg_ct_watch saved;
+    uint64_t wall0 = _lfg_ct_wall_ns();
+    uint64_t cpu0 = _tests_cpu_ns;
+
     _current_suite_failures = 0;
+    _lfg_ct_watch_begin("suite", name, _lfg_ct_take_timeout(_suite_timeout_ms), &saved);
     fn();
-    if (_current_suite_failures > 0)
+    _lfg_ct_drain();
+    _lfg_ct_watch_end(&saved);
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_SUITE_END;
+    ev.name = name;
+    ev.failures = _current_suite_failures;
+    ev.wall_ns = _lfg_ct_wall_ns() - wall0;
+    ev.cpu_ns = _tests_cpu_ns - cpu0; /* sum over its tests, so it includes worker processes */
+    _lfg_ct_slowest_insert(_slowest_suites, &_slowest_suites_count, name, ev.wall_ns, ev.cpu_ns);
+    _lfg_ct_emit(&ev);
+}
+
+void lfg_ct_impl(void (*fn)(void), const char *name)
+{
+    unsigned timeout_ms = _lfg_ct_take_timeout(_timeout_ms); /* consumed even if sharded out */
+
+    if (0 == _test_depth && _lfg_ct_shard_skip())
     {
-        printf("*** suite FAILURE: %s\r\n", name);
+        return;
     }
+    _lfg_ct_dispatch(fn, name, timeout_ms);
 }
 
-void lfg_ct_impl(void (*fn)(void), const char *name)
+int lfg_ct_set_shard(unsigned index, unsigned count)
 {
-    _tests_executed++;
-    _current_test_failures = 0;
-    fn();
-    if (_current_test_failures > 0)
+    if (0 == count || index >= count)
     {
-        _current_suite_failures++;
-        _tests_failed++;
-        printf("*** test FAILURE: %s\r\n", name);
+        return -1;
     }
-    else
+    _shard_env_read = true; /* an explicit setting wins over the environment */
+    _shard_index = index;
+    _shard_count = count;
+    return 0;
+}
+
+void lfg_ct_set_result_file(const char *path)
+{
+    _result_file = path;
+}
+
+void lfg_ct_bench_impl(void (*fn)(void), const char *name)
+{
+    uint64_t samples[LFG_CT_BENCH_SAMPLES];
+    uint64_t cycle_samples[LFG_CT_BENCH_SAMPLES];
+    uint64_t sum = 0;
+    uint64_t cycles = 0;
+    unsigned long iterations = 1;
+    lfg_ct_bench_result_t result;
+    lfg_ct_event_t ev;
+    unsigned i;
+    unsigned j;
+
+    /* workers still running would compete for the CPU */
+    _lfg_ct_drain();
+
+    /* calibrate: double the batch until one sample reaches the target time;
+     * this also serves as warmup for caches and branch predictors */
+    while (_lfg_ct_bench_sample(fn, iterations, &cycles) < LFG_CT_BENCH_SAMPLE_NS &&
+            iterations < LFG_CT_BENCH_ITERATIONS_MAX)
     {
-        _tests_passed++;
+        iterations *= 2;
+    }
+    _lfg_ct_bench_sample(fn, iterations, &cycles); /* one more warmup pass at the final size */
+
+    /* per-op times are kept in picoseconds so sub-nanosecond ops survive integer division */
+    for (i = 0; i < LFG_CT_BENCH_SAMPLES; i++)
+    {
+        uint64_t ps = _lfg_ct_bench_sample(fn, iterations, &cycles) * 1000u / iterations;
+        uint64_t cyc = cycles * 1000u / iterations;
+
+        sum += ps;
+        for (j = i; j > 0 && samples[j - 1] > ps; j--)
+        {
+            samples[j] = samples[j - 1];
+        }
+        samples[j] = ps;
+        for (j = i; j > 0 && cycle_samples[j - 1] > cyc; j--)
+        {
+            cycle_samples[j] = cycle_samples[j - 1];
+        }
+        cycle_samples[j] = cyc;
+    }
+
+    memset(&result, 0, sizeof(result));
+    result.name = name;
+    result.iterations = iterations;
+    result.samples = LFG_CT_BENCH_SAMPLES;
+    result.min_ps = samples[0];
+    result.median_ps = samples[LFG_CT_BENCH_SAMPLES / 2];
+    result.mean_ps = sum / LFG_CT_BENCH_SAMPLES;
+    result.p99_ps = samples[(LFG_CT_BENCH_SAMPLES * 99 + 99) / 100 - 1]; /* nearest rank */
+#ifdef LFG_CT_HAS_CYCLES
+    result.median_mcycles = cycle_samples[LFG_CT_BENCH_SAMPLES / 2];
+#endif
+
+    if (_bench_results_count < LFG_CT_BENCH_MAX)
+    {
+        _bench_results[_bench_results_count++] = result;
     }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_BENCH;
+    ev.name = name;
+    ev.bench = &result;
+    _lfg_ct_emit(&ev);
 }
 
 void lfg_ct_print_summary(void)
 {
-    printf("*** Executed %d assertions in %d tests. Failures: %d\r\n"
-           "*** Testing complete. Result: %s\r\n",
-            _assertions_executed, _tests_executed, _tests_failed, _tests_failed ? "FAIL" : "PASS");
+    lfg_ct_event_t ev;
+
+    _lfg_ct_drain();
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_SUMMARY;
+    ev.failures = _tests_failed;
+    ev.assertions_executed = lfg_ct_counters.assertions_executed;
+    ev.tests_executed = _tests_executed;
+    ev.wall_ns = _tests_wall_ns;
+    ev.cpu_ns = _tests_cpu_ns;
+    ev.elapsed_ns = _lfg_ct_wall_ns() - _start_wall_ns;
+    ev.slowest_tests = _slowest_tests;
+    ev.slowest_tests_count = _slowest_tests_count < _report_slowest ? _slowest_tests_count : _report_slowest;
+    ev.slowest_suites = _slowest_suites;
+    ev.slowest_suites_count = _slowest_suites_count < _report_slowest ? _slowest_suites_count : _report_slowest;
+    ev.bench = _bench_results;
+    ev.bench_count = _bench_results_count;
+    ev.tests_skipped = _tests_skipped;
+    ev.shard_index = _shard_index;
+    ev.shard_count = _shard_count;
+    _lfg_ct_emit(&ev);
+    _lfg_ct_write_result_file();
 }
 
 int lfg_ct_return(void)
 {
+    _lfg_ct_drain();
     return -_tests_failed;
 }
 
+void lfg_ct_register(lfg_ct_test_node_t *node)
+{
+    if (node->registered)
+    {
+        return;
+    }
+    node->registered = true;
+    node->next = NULL;
+    if (_registry_tail)
+    {
+        _registry_tail->next = node;
+    }
+    else
+    {
+        _registry_head = node;
+    }
+    _registry_tail = node;
+    _registry_count++;
+}
+
+int lfg_ct_main(int argc, char *argv[])
+{
+    const char *filters[LFG_CT_FILTERS_MAX];
+    unsigned filters_count = 0;
+    const char *order = "declaration";
+    const char *shard_index = NULL;
+    const char *shard_count = NULL;
+    unsigned jobs = 0;
+    bool isolate = false;
+    bool list = false;
+    lfg_ct_test_node_t **selected;
+    lfg_ct_test_node_t *node;
+    unsigned count = 0;
+    unsigned i;
+    int a;
+
+    for (a = 1; a < argc; a++)
+    {
+        const char *value;
+
+        if (0 == strcmp(argv[a], "--list"))
+        {
+            list = true;
+        }
+        else if (0 == strcmp(argv[a], "--isolate"))
+        {
+            isolate = true;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--filter", NULL)))
+        {
+            if (filters_count >= LFG_CT_FILTERS_MAX)
+            {
+                fprintf(stderr, "too many --filter options (max %d)\n", LFG_CT_FILTERS_MAX);
+                return -1;
+            }
+            filters[filters_count++] = value;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--order", NULL)))
+        {
+            if (strcmp(value, "declaration") != 0 && strcmp(value, "name") != 0 && strcmp(value, "random") != 0)
+            {
+                fprintf(stderr, "unknown --order '%s' (declaration, name or random)\n", value);
+                return -1;
+            }
+            order = value;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--jobs", "-j")))
+        {
+            jobs = (unsigned)strtoul(value, NULL, 10);
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--shard-index", NULL)))
+        {
+            shard_index = value;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--shard-count", NULL)))
+        {
+            shard_count = value;
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--result-file", NULL)))
+        {
+            lfg_ct_set_result_file(value);
+        }
+        else if (NULL != (value = _lfg_ct_option(argc, argv, &a, "--timeout", NULL)))
+        {
+            lfg_ct_set_timeout_ms((unsigned)strtoul(value, NULL, 10), _suite_timeout_ms);
+        }
+        else
+        {
+            fprintf(stderr,
+                    "usage: %s [--list] [--filter=GLOB]... [--order=declaration|name|random] [-j N] [--isolate]\n"
+                    "          [--shard-index=I --shard-count=N] [--result-file=PATH] [--timeout=MS]\n"
+                    "unknown option '%s'\n",
+                    argv[0], argv[a]);
+            return -1;
+        }
+    }
+
+    _lfg_ct_shard_from_env();
+    if (shard_index || shard_count)
+    {
+        unsigned index = shard_index ? (unsigned)strtoul(shard_index, NULL, 10) : 0;
+        unsigned n = shard_count ? (unsigned)strtoul(shard_count, NULL, 10) : 1;
+        if (lfg_ct_set_shard(index, n) != 0)
+        {
+            fprintf(stderr, "invalid shard %u/%u (need index < count)\n", index, n);
+            return -1;
+        }
+    }
+
+    selected = malloc((_registry_count ? _registry_count : 1) * sizeof(*selected));
+    if (NULL == selected)
+    {
+        fprintf(stderr, "out of memory selecting %u tests\n", _registry_count);
+        return -1;
+    }
+    for (node = _registry_head; node; node = node->next)
+    {
+        bool match = (0 == filters_count);
+        for (i = 0; i < filters_count && !match; i++)
+        {
+            match = _lfg_ct_glob(filters[i], node->name);
+        }
+        /* shard on declaration order, before any reordering, so every
+         * shard agrees on the split even with --order=random */
+        if (match && !_lfg_ct_shard_skip())
+        {
+            selected[count++] = node;
+        }
+    }
+
+    if (!list)
+    {
+        lfg_ct_start(); /* seeds rand() for --order=random */
+    }
+    if (0 == strcmp(order, "name"))
+    {
+        qsort(selected, count, sizeof(*selected), _lfg_ct_node_name_cmp);
+    }
+    else if (0 == strcmp(order, "random"))
+    {
+        for (i = count; i > 1; i--)
+        {
+            unsigned j = (unsigned)rand() % i;
+            node = selected[i - 1];
+            selected[i - 1] = selected[j];
+            selected[j] = node;
+        }
+    }
+
+    if (list)
+    {
+        for (i = 0; i < count; i++)
+        {
+            printf("%s\n", selected[i]->name);
+        }
+        free(selected);
+        return 0;
+    }
+
+    lfg_ct_parallel(jobs);
+    lfg_ct_isolate(isolate);
+    for (i = 0; i < count; i++)
+    {
+        _lfg_ct_dispatch(selected[i]->fn, selected[i]->name, _timeout_ms);
+    }
+    free(selected);
+    lfg_ct_print_summary();
+    lfg_ct_end();
+    return lfg_ct_return();
+}
+
 /*============================================================================
  *  Self-Test API (only available when LFG_CTEST_SELF_TEST is defined)
  *==========================================================================*/
@@ -160,23 +831,39 @@ void lfg_ct_expect_failures_begin(void)
 {
     _expect_failures_mode = 1;
     _expected_failures_count = 0;
+    lfg_ct_counters.pass_weight = 0;
 }
 
 int lfg_ct_expect_failures_end(void)
 {
+    _lfg_ct_drain();
     _expect_failures_mode = 0;
+    lfg_ct_counters.pass_weight = 1;
     return _expected_failures_count;
 }
 
+void lfg_ct_self_test_counts(lfg_ct_counts_t *counts)
+{
+    _lfg_ct_drain();
+    counts->tests_executed = _tests_executed;
+    counts->tests_failed = _tests_failed;
+    counts->tests_passed = _tests_passed;
+    counts->assertions_executed = lfg_ct_counters.assertions_executed;
+    counts->assertions_failed = _assertions_failed;
+    counts->assertions_passed = lfg_ct_counters.assertions_passed;
+    counts->tests_wall_ns = _tests_wall_ns;
+    counts->tests_cpu_ns = _tests_cpu_ns;
+}
+
 #endif /* LFG_CTEST_SELF_TEST */
 
 int lfg_ct_assert_false_impl(
         bool condition, char *filename, int line_no, const char *function, const char *condition_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (condition)
     {
-        printf("*** %s: %u: FAILURE: in %s(): %s should be false\r\n", filename, line_no, function, condition_str);
+        _lfg_ct_fail(filename, line_no, function, "%s should be false", condition_str);
         RECORD_FAILURE();
         return -1;
     }
@@ -187,10 +874,10 @@ int lfg_ct_assert_false_impl(
 int lfg_ct_assert_true_impl(
         bool condition, char *filename, int line_no, const char *function, const char *condition_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!condition)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should be true\r\n", filename, line_no, function, condition_str);
+        _lfg_ct_fail(filename, line_no, function, "%s should be true", condition_str);
         RECORD_FAILURE();
         return -1;
     }
@@ -201,11 +888,10 @@ int lfg_ct_assert_true_impl(
 int lfg_ct_assert_int_equal_impl(
         int expected, int actual, char *filename, int line_no, const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%d) should equal %d\r\n", filename, line_no, function, actual_expr_str,
-                actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should equal %d", actual_expr_str, actual, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -216,11 +902,10 @@ int lfg_ct_assert_int_equal_impl(
 int lfg_ct_assert_int_not_equal_impl(
         int expected, int actual, char *filename, int line_no, const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal %d\r\n", filename, line_no, function, actual_expr_str,
-                expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %d", actual_expr_str, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -231,11 +916,10 @@ int lfg_ct_assert_int_not_equal_impl(
 int lfg_ct_assert_uint_equal_impl(unsigned expected, unsigned actual, char *filename, int line_no, const char *function,
         const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%u) should equal %u\r\n", filename, line_no, function, actual_expr_str,
-                actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (%u) should equal %u", actual_expr_str, actual, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -246,11 +930,10 @@ int lfg_ct_assert_uint_equal_impl(unsigned expected, unsigned actual, char *file
 int lfg_ct_assert_uint_not_equal_impl(unsigned expected, unsigned actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal %u\r\n", filename, line_no, function, actual_expr_str,
-                expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %u", actual_expr_str, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -261,11 +944,10 @@ int lfg_ct_assert_uint_not_equal_impl(unsigned expected, unsigned actual, char *
 int lfg_ct_assert_uint8_equal_impl(uint8_t expected, uint8_t actual, char *filename, int line_no, const char *function,
         const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (0x%02X) should equal 0x%02X\r\n", filename, line_no, function,
-                actual_expr_str, actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%02X) should equal 0x%02X", actual_expr_str, actual, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -276,11 +958,10 @@ int lfg_ct_assert_uint8_equal_impl(uint8_t expected, uint8_t actual, char *filen
 int lfg_ct_assert_uint8_not_equal_impl(uint8_t expected, uint8_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal 0x%02X\r\n", filename, line_no, function,
-                actual_expr_str, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal 0x%02X", actual_expr_str, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -291,11 +972,10 @@ int lfg_ct_assert_uint8_not_equal_impl(uint8_t expected, uint8_t actual, char *f
 int lfg_ct_assert_uint16_equal_impl(uint16_t expected, uint16_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (0x%04X) should equal 0x%04X\r\n", filename, line_no, function,
-                actual_expr_str, actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%04X) should equal 0x%04X", actual_expr_str, actual, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -306,11 +986,10 @@ int lfg_ct_assert_uint16_equal_impl(uint16_t expected, uint16_t actual, char *fi
 int lfg_ct_assert_uint16_not_equal_impl(uint16_t expected, uint16_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal 0x%04X\r\n", filename, line_no, function,
-                actual_expr_str, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal 0x%04X", actual_expr_str, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -321,11 +1000,10 @@ int lfg_ct_assert_uint16_not_equal_impl(uint16_t expected, uint16_t actual, char
 int lfg_ct_assert_uint32_equal_impl(uint32_t expected, uint32_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (0x%08X) should equal 0x%08X\r\n", filename, line_no, function,
-                actual_expr_str, actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should equal 0x%08X", actual_expr_str, actual, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -336,11 +1014,10 @@ int lfg_ct_assert_uint32_equal_impl(uint32_t expected, uint32_t actual, char *fi
 int lfg_ct_assert_uint32_not_equal_impl(uint32_t expected, uint32_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal 0x%08X\r\n", filename, line_no, function,
-                actual_expr_str, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal 0x%08X", actual_expr_str, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -351,11 +1028,10 @@ int lfg_ct_assert_uint32_not_equal_impl(uint32_t expected, uint32_t actual, char
 int lfg_ct_assert_ptr_equal_impl(void *expected, void *actual, const char *filename, int line_no, const char *function,
         const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%p) should equal %p\r\n", filename, line_no, function, actual_expr_str,
-                actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p", actual_expr_str, actual, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -366,11 +1042,10 @@ int lfg_ct_assert_ptr_equal_impl(void *expected, void *actual, const char *filen
 int lfg_ct_assert_ptr_not_equal_impl(void *expected, void *actual, const char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal %p\r\n", filename, line_no, function, actual_expr_str,
-                expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %p", actual_expr_str, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -381,10 +1056,10 @@ int lfg_ct_assert_ptr_not_equal_impl(void *expected, void *actual, const char *f
 int lfg_ct_assert_ptr_not_null(
         void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (NULL == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not be NULL\r\n", filename, line_no, function, actual_expr_str);
+        _lfg_ct_fail(filename, line_no, function, "%s should not be NULL", actual_expr_str);
         RECORD_FAILURE();
         return -1;
     }
@@ -395,11 +1070,10 @@ int lfg_ct_assert_ptr_not_null(
 int lfg_ct_assert_ptr_null(
         void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (NULL != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should be NULL but is %p\r\n", filename, line_no, function,
-                actual_expr_str, actual);
+        _lfg_ct_fail(filename, line_no, function, "%s should be NULL but is %p", actual_expr_str, actual);
         RECORD_FAILURE();
         return -1;
     }
@@ -410,11 +1084,10 @@ int lfg_ct_assert_ptr_null(
 int lfg_ct_assert_int8_equal_impl(
         int8_t expected, int8_t actual, char *filename, int line_no, const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%d) should equal %d\r\n", filename, line_no, function, actual_expr_str,
-                actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should equal %d", actual_expr_str, actual, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -425,11 +1098,10 @@ int lfg_ct_assert_int8_equal_impl(
 int lfg_ct_assert_int8_not_equal_impl(
         int8_t expected, int8_t actual, char *filename, int line_no, const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal %d\r\n", filename, line_no, function, actual_expr_str,
-                expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %d", actual_expr_str, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -440,11 +1112,10 @@ int lfg_ct_assert_int8_not_equal_impl(
 int lfg_ct_assert_int16_equal_impl(int16_t expected, int16_t actual, char *filename, int line_no, const char *function,
         const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%d) should equal %d\r\n", filename, line_no, function, actual_expr_str,
-                actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should equal %d", actual_expr_str, actual, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -455,11 +1126,10 @@ int lfg_ct_assert_int16_equal_impl(int16_t expected, int16_t actual, char *filen
 int lfg_ct_assert_int16_not_equal_impl(int16_t expected, int16_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal %d\r\n", filename, line_no, function, actual_expr_str,
-                expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %d", actual_expr_str, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -470,11 +1140,10 @@ int lfg_ct_assert_int16_not_equal_impl(int16_t expected, int16_t actual, char *f
 int lfg_ct_assert_int32_equal_impl(int32_t expected, int32_t actual, char *filename, int line_no, const char *function,
         const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%d) should equal %d\r\n", filename, line_no, function, actual_expr_str,
-                actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should equal %d", actual_expr_str, actual, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -485,11 +1154,10 @@ int lfg_ct_assert_int32_equal_impl(int32_t expected, int32_t actual, char *filen
 int lfg_ct_assert_int32_not_equal_impl(int32_t expected, int32_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal %d\r\n", filename, line_no, function, actual_expr_str,
-                expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %d", actual_expr_str, expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -500,11 +1168,11 @@ int lfg_ct_assert_int32_not_equal_impl(int32_t expected, int32_t actual, char *f
 int lfg_ct_assert_int64_equal_impl(int64_t expected, int64_t actual, char *filename, int line_no, const char *function,
         const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%lld) should equal %lld\r\n", filename, line_no, function,
-                actual_expr_str, (long long)actual, (long long)expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (%lld) should equal %lld", actual_expr_str, (long long)actual,
+                (long long)expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -515,11 +1183,10 @@ int lfg_ct_assert_int64_equal_impl(int64_t expected, int64_t actual, char *filen
 int lfg_ct_assert_int64_not_equal_impl(int64_t expected, int64_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal %lld\r\n", filename, line_no, function,
-                actual_expr_str, (long long)expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal %lld", actual_expr_str, (long long)expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -530,11 +1197,11 @@ int lfg_ct_assert_int64_not_equal_impl(int64_t expected, int64_t actual, char *f
 int lfg_ct_assert_uint64_equal_impl(uint64_t expected, uint64_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected != actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (0x%016llX) should equal 0x%016llX\r\n", filename, line_no, function,
-                actual_expr_str, (unsigned long long)actual, (unsigned long long)expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%016llX) should equal 0x%016llX", actual_expr_str,
+                (unsigned long long)actual, (unsigned long long)expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -545,11 +1212,11 @@ int lfg_ct_assert_uint64_equal_impl(uint64_t expected, uint64_t actual, char *fi
 int lfg_ct_assert_uint64_not_equal_impl(uint64_t expected, uint64_t actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (expected == actual)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal 0x%016llX\r\n", filename, line_no, function,
-                actual_expr_str, (unsigned long long)expected);
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal 0x%016llX", actual_expr_str,
+                (unsigned long long)expected);
         RECORD_FAILURE();
         return -1;
     }
@@ -560,21 +1227,21 @@ int lfg_ct_assert_uint64_not_equal_impl(uint64_t expected, uint64_t actual, char
 int lfg_ct_assert_str_equal_impl(const char *expected, const char *actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (NULL == expected || NULL == actual)
     {
         if (expected != actual)
         {
-            printf("*** %s: %u: FAILURE in %s(): %s (%p) should equal %p (NULL mismatch)\r\n", filename, line_no,
-                    function, actual_expr_str, (void *)actual, (void *)expected);
+            _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p (NULL mismatch)", actual_expr_str,
+                    (void *)actual, (void *)expected);
             RECORD_FAILURE();
             return -1;
         }
     }
     else if (strcmp(expected, actual) != 0)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (\"%s\") should equal \"%s\"\r\n", filename, line_no, function,
-                actual_expr_str, actual, expected);
+        _lfg_ct_fail(filename, line_no, function, "%s (\"%s\") should equal \"%s\" (differs at index %zu)",
+                actual_expr_str, actual, expected, _lfg_ct_str_mismatch(expected, actual, SIZE_MAX));
         RECORD_FAILURE();
         return -1;
     }
@@ -585,11 +1252,11 @@ int lfg_ct_assert_str_equal_impl(const char *expected, const char *actual, char
 int lfg_ct_assert_str_not_equal_impl(const char *expected, const char *actual, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if ((NULL == expected && NULL == actual) || (expected != NULL && actual != NULL && strcmp(expected, actual) == 0))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s should not equal \"%s\"\r\n", filename, line_no, function,
-                actual_expr_str, expected ? expected : "(null)");
+        _lfg_ct_fail(filename, line_no, function, "%s should not equal \"%s\"", actual_expr_str,
+                expected ? expected : "(null)");
         RECORD_FAILURE();
         return -1;
     }
@@ -600,21 +1267,21 @@ int lfg_ct_assert_str_not_equal_impl(const char *expected, const char *actual, c
 int lfg_ct_assert_strn_equal_impl(const char *expected, const char *actual, size_t n, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (NULL == expected || NULL == actual)
     {
         if (expected != actual)
         {
-            printf("*** %s: %u: FAILURE in %s(): %s (%p) should equal %p (NULL mismatch)\r\n", filename, line_no,
-                    function, actual_expr_str, (void *)actual, (void *)expected);
+            _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p (NULL mismatch)", actual_expr_str,
+                    (void *)actual, (void *)expected);
             RECORD_FAILURE();
             return -1;
         }
     }
     else if (strncmp(expected, actual, n) != 0)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (first %zu chars) does not match expected\r\n", filename, line_no,
-                function, actual_expr_str, n);
+        _lfg_ct_fail(filename, line_no, function, "%s (first %zu chars) does not match expected (differs at index %zu)",
+                actual_expr_str, n, _lfg_ct_str_mismatch(expected, actual, n));
         RECORD_FAILURE();
         return -1;
     }
@@ -625,21 +1292,22 @@ int lfg_ct_assert_strn_equal_impl(const char *expected, const char *actual, size
 int lfg_ct_assert_mem_equal_impl(const void *expected, const void *actual, size_t n, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (NULL == expected || NULL == actual)
     {
         if (expected != actual)
         {
-            printf("*** %s: %u: FAILURE in %s(): %s (%p) should equal %p (NULL mismatch)\r\n", filename, line_no,
-                    function, actual_expr_str, actual, expected);
+            _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p (NULL mismatch)", actual_expr_str,
+                    actual, expected);
             RECORD_FAILURE();
             return -1;
         }
     }
     else if (memcmp(expected, actual, n) != 0)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s memory (%zu bytes) does not match expected\r\n", filename, line_no,
-                function, actual_expr_str, n);
+        /* the pass path is a single memcmp; locating the difference is left to the failure */
+        _lfg_ct_fail_mem(expected, actual, n, _lfg_ct_mem_mismatch(expected, actual, 0, n), filename, line_no,
+                function, actual_expr_str);
         RECORD_FAILURE();
         return -1;
     }
@@ -650,12 +1318,11 @@ int lfg_ct_assert_mem_equal_impl(const void *expected, const void *actual, size_
 int lfg_ct_assert_mem_not_equal_impl(const void *expected, const void *actual, size_t n, char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if ((NULL == expected && NULL == actual) ||
             (expected != NULL && actual != NULL && memcmp(expected, actual, n) == 0))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s memory (%zu bytes) should not match\r\n", filename, line_no, function,
-                actual_expr_str, n);
+        _lfg_ct_fail(filename, line_no, function, "%s memory (%zu bytes) should not match", actual_expr_str, n);
         RECORD_FAILURE();
         return -1;
     }
@@ -666,11 +1333,10 @@ int lfg_ct_assert_mem_not_equal_impl(const void *expected, const void *actual, s
 int lfg_ct_assert_greater_than_impl(
         int a, int b, char *filename, int line_no, const char *function, const char *a_expr_str, const char *b_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(a > b))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%d) should be > %s (%d)\r\n", filename, line_no, function, a_expr_str,
-                a, b_expr_str, b);
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be > %s (%d)", a_expr_str, a, b_expr_str, b);
         RECORD_FAILURE();
         return -1;
     }
@@ -681,11 +1347,10 @@ int lfg_ct_assert_greater_than_impl(
 int lfg_ct_assert_less_than_impl(
         int a, int b, char *filename, int line_no, const char *function, const char *a_expr_str, const char *b_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(a < b))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%d) should be < %s (%d)\r\n", filename, line_no, function, a_expr_str,
-                a, b_expr_str, b);
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be < %s (%d)", a_expr_str, a, b_expr_str, b);
         RECORD_FAILURE();
         return -1;
     }
@@ -696,11 +1361,10 @@ int lfg_ct_assert_less_than_impl(
 int lfg_ct_assert_greater_or_equal_impl(
         int a, int b, char *filename, int line_no, const char *function, const char *a_expr_str, const char *b_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(a >= b))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%d) should be >= %s (%d)\r\n", filename, line_no, function, a_expr_str,
-                a, b_expr_str, b);
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be >= %s (%d)", a_expr_str, a, b_expr_str, b);
         RECORD_FAILURE();
         return -1;
     }
@@ -711,11 +1375,10 @@ int lfg_ct_assert_greater_or_equal_impl(
 int lfg_ct_assert_less_or_equal_impl(
         int a, int b, char *filename, int line_no, const char *function, const char *a_expr_str, const char *b_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(a <= b))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%d) should be <= %s (%d)\r\n", filename, line_no, function, a_expr_str,
-                a, b_expr_str, b);
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be <= %s (%d)", a_expr_str, a, b_expr_str, b);
         RECORD_FAILURE();
         return -1;
     }
@@ -726,11 +1389,10 @@ int lfg_ct_assert_less_or_equal_impl(
 int lfg_ct_assert_in_range_impl(
         int val, int min, int max, char *filename, int line_no, const char *function, const char *val_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(val >= min && val <= max))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%d) should be in range [%d, %d]\r\n", filename, line_no, function,
-                val_expr_str, val, min, max);
+        _lfg_ct_fail(filename, line_no, function, "%s (%d) should be in range [%d, %d]", val_expr_str, val, min, max);
         RECORD_FAILURE();
         return -1;
     }
@@ -741,11 +1403,10 @@ int lfg_ct_assert_in_range_impl(
 int lfg_ct_assert_bit_set_impl(unsigned val, unsigned bit, char *filename, int line_no, const char *function,
         const char *val_expr_str, unsigned bit_num)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(val & (1u << bit)))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (0x%08X) should have bit %u set\r\n", filename, line_no, function,
-                val_expr_str, val, bit_num);
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should have bit %u set", val_expr_str, val, bit_num);
         RECORD_FAILURE();
         return -1;
     }
@@ -756,11 +1417,10 @@ int lfg_ct_assert_bit_set_impl(unsigned val, unsigned bit, char *filename, int l
 int lfg_ct_assert_bit_clear_impl(unsigned val, unsigned bit, char *filename, int line_no, const char *function,
         const char *val_expr_str, unsigned bit_num)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (val & (1u << bit))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (0x%08X) should have bit %u clear\r\n", filename, line_no, function,
-                val_expr_str, val, bit_num);
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should have bit %u clear", val_expr_str, val, bit_num);
         RECORD_FAILURE();
         return -1;
     }
@@ -771,11 +1431,11 @@ int lfg_ct_assert_bit_clear_impl(unsigned val, unsigned bit, char *filename, int
 int lfg_ct_assert_bits_set_impl(unsigned val, unsigned mask, char *filename, int line_no, const char *function,
         const char *val_expr_str, unsigned mask_val)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if ((val & mask) != mask)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (0x%08X) should have bits 0x%08X set\r\n", filename, line_no, function,
-                val_expr_str, val, mask_val);
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should have bits 0x%08X set", val_expr_str, val,
+                mask_val);
         RECORD_FAILURE();
         return -1;
     }
@@ -786,11 +1446,11 @@ int lfg_ct_assert_bits_set_impl(unsigned val, unsigned mask, char *filename, int
 int lfg_ct_assert_bits_clear_impl(unsigned val, unsigned mask, char *filename, int line_no, const char *function,
         const char *val_expr_str, unsigned mask_val)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (val & mask)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (0x%08X) should have bits 0x%08X clear\r\n", filename, line_no,
-                function, val_expr_str, val, mask_val);
+        _lfg_ct_fail(filename, line_no, function, "%s (0x%08X) should have bits 0x%08X clear", val_expr_str, val,
+                mask_val);
         RECORD_FAILURE();
         return -1;
     }
@@ -800,45 +1460,170 @@ int lfg_ct_assert_bits_clear_impl(unsigned val, unsigned mask, char *filename, i
 
 int lfg_ct_assert_fail_impl(char *filename, int line_no, const char *function, const char *message)
 {
-    _assertions_executed++;
-    printf("*** %s: %u: FAILURE in %s(): %s\r\n", filename, line_no, function, message ? message : "Explicit failure");
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    _lfg_ct_fail(filename, line_no, function, "%s", message ? message : "Explicit failure");
     RECORD_FAILURE();
     return -1;
 }
 
 /*============================================================================
- *  32-bit Float Assertions (optional)
+ *  Array Assertions
+ *
+ *  Each array assertion counts once. The pass path is a single memcmp for
+ *  integers and a branch-free loop the compiler can vectorize for floating
+ *  point; listing the first LFG_CT_ARRAY_DIFF_MAX mismatches only happens on
+ *  failure.
  *==========================================================================*/
 
-#ifdef LFG_CTEST_HAS_FLOAT
-
-int lfg_ct_assert_float_equal_impl(float expected, float actual, float epsilon, const char *filename, int line_no,
-        const char *function, const char *actual_expr_str)
-{
-    _assertions_executed++;
-    float diff = fabsf(expected - actual);
-    if (diff > epsilon)
-    {
-        printf("*** %s: %u: FAILURE in %s(): %s (%.6g) should equal %.6g "
-               "(diff=%.6g, eps=%.6g)\r\n",
-                filename, line_no, function, actual_expr_str, actual, expected, diff, epsilon);
-        RECORD_FAILURE();
-        return -1;
+#define _LFG_CT_INT_ARRAY_EQUAL_DEF(_name, _type, _fmt, _cast)                                                         \
+    int lfg_ct_assert_##_name##_array_equal_impl(const _type *expected, const _type *actual, size_t n,                 \
+            char *filename, int line_no, const char *function, const char *actual_expr_str)                            \
+    {                                                                                                                  \
+        char message[_LFG_CT_ARRAY_MESSAGE_MAX];                                                                       \
+        size_t bad = 0;                                                                                                \
+        size_t shown = 0;                                                                                              \
+        size_t len;                                                                                                    \
+        size_t i;                                                                                                      \
+                                                                                                                       \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);                                                         \
+        if (_lfg_ct_array_null(expected, actual, filename, line_no, function, actual_expr_str))                        \
+        {                                                                                                              \
+            RECORD_FAILURE();                                                                                          \
+            return -1;                                                                                                 \
+        }                                                                                                              \
+        if (0 == n || NULL == expected || memcmp(expected, actual, n * sizeof(_type)) == 0)                            \
+        {                                                                                                              \
+            RECORD_PASS();                                                                                             \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        for (i = 0; i < n; i++)                                                                                        \
+        {                                                                                                              \
+            bad += (expected[i] != actual[i]);                                                                         \
+        }                                                                                                              \
+        len = _lfg_ct_appendf(message, sizeof(message), 0,                                                             \
+                "%s array (%zu elements) does not match expected: %zu differ", actual_expr_str, n, bad);               \
+        for (i = 0; i < n && shown < LFG_CT_ARRAY_DIFF_MAX; i++)                                                       \
+        {                                                                                                              \
+            if (expected[i] != actual[i])                                                                              \
+            {                                                                                                          \
+                len = _lfg_ct_appendf(message, sizeof(message), len, "\r\n    [%zu] expected " _fmt ", actual " _fmt,  \
+                        i, (_cast)expected[i], (_cast)actual[i]);                                                      \
+                shown++;                                                                                               \
+            }                                                                                                          \
+        }                                                                                                              \
+        _lfg_ct_fail_message(filename, line_no, function, message);                                                    \
+        RECORD_FAILURE();                                                                                              \
+        return -1;                                                                                                     \
     }
-    RECORD_PASS();
-    return 0;
-}
 
-int lfg_ct_assert_float_not_equal_impl(float expected, float actual, float epsilon, const char *filename, int line_no,
-        const char *function, const char *actual_expr_str)
-{
-    _assertions_executed++;
-    float diff = fabsf(expected - actual);
-    if (diff <= epsilon)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(int8, int8_t, "%lld", long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(int16, int16_t, "%lld", long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(int32, int32_t, "%lld", long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(int64, int64_t, "%lld", long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(uint8, uint8_t, "0x%02llX", unsigned long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(uint16, uint16_t, "0x%04llX", unsigned long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(uint32, uint32_t, "0x%08llX", unsigned long long)
+_LFG_CT_INT_ARRAY_EQUAL_DEF(uint64, uint64_t, "0x%016llX", unsigned long long)
+
+/* Floating-point arrays: _near(e, a, tol) decides one element without branching, so the counting loop vectorizes */
+#define _LFG_CT_FP_ARRAY_DEF(_impl, _type, _tol_type, _near, _fmt, _tol_fmt, _tol_cast)                                \
+    int lfg_ct_assert_##_impl(const _type *expected, const _type *actual, size_t n, _tol_type tolerance,               \
+            const char *filename, int line_no, const char *function, const char *actual_expr_str)                      \
+    {                                                                                                                  \
+        char message[_LFG_CT_ARRAY_MESSAGE_MAX];                                                                       \
+        size_t bad = 0;                                                                                                \
+        size_t shown = 0;                                                                                              \
+        size_t len;                                                                                                    \
+        size_t i;                                                                                                      \
+                                                                                                                       \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);                                                         \
+        if (_lfg_ct_array_null(expected, actual, filename, line_no, function, actual_expr_str))                        \
+        {                                                                                                              \
+            RECORD_FAILURE();                                                                                          \
+            return -1;                                                                                                 \
+        }                                                                                                              \
+        for (i = 0; i < (NULL == expected ? 0 : n); i++)                                                               \
+        {                                                                                                              \
+            bad += !_near(expected[i], actual[i], tolerance);                                                          \
+        }                                                                                                              \
+        if (0 == bad)                                                                                                  \
+        {                                                                                                              \
+            RECORD_PASS();                                                                                             \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        len = _lfg_ct_appendf(message, sizeof(message), 0,                                                             \
+                "%s array (%zu elements) does not match expected: %zu differ (" _tol_fmt ")", actual_expr_str, n, bad, \
+                (_tol_cast)tolerance);                                                                                 \
+        for (i = 0; i < n && shown < LFG_CT_ARRAY_DIFF_MAX; i++)                                                       \
+        {                                                                                                              \
+            if (!_near(expected[i], actual[i], tolerance))                                                             \
+            {                                                                                                          \
+                len = _lfg_ct_appendf(message, sizeof(message), len,                                                   \
+                        "\r\n    [%zu] expected " _fmt ", actual " _fmt " (diff=%.3g, ulps=%llu)", i, expected[i],     \
+                        actual[i], (double)(actual[i] - expected[i]),                                                  \
+                        (unsigned long long)_lfg_ct_##_type##_ulps(expected[i], actual[i]));                           \
+                shown++;                                                                                               \
+            }                                                                                                          \
+        }                                                                                                              \
+        _lfg_ct_fail_message(filename, line_no, function, message);                                                    \
+        RECORD_FAILURE();                                                                                              \
+        return -1;                                                                                                     \
+    }
+
+/* equal values (including matching infinities) or within the tolerance; NaN never matches */
+#define _LFG_CT_NEAR_EPS(_fabs, _e, _a, _eps) (((_e) == (_a)) | (_fabs((_e) - (_a)) <= (_eps)))
+#define _LFG_CT_NEAR_ULP(_ulps_fn, _e, _a, _ulps)                                                                      \
+    (((_e) == (_a)) | (((_e) == (_e)) & ((_a) == (_a)) & (_ulps_fn((_e), (_a)) <= (_ulps))))
+
+#ifdef LFG_CTEST_HAS_FLOAT
+#define _LFG_CT_FLOAT_NEAR_EPS(_e, _a, _eps) _LFG_CT_NEAR_EPS(fabsf, _e, _a, _eps)
+#define _LFG_CT_FLOAT_NEAR_ULP(_e, _a, _ulps) _LFG_CT_NEAR_ULP(_lfg_ct_float_ulps, _e, _a, _ulps)
+
+_LFG_CT_FP_ARRAY_DEF(float_array_equal_impl, float, float, _LFG_CT_FLOAT_NEAR_EPS, "%.9g", "eps=%g", double)
+_LFG_CT_FP_ARRAY_DEF(float_array_equal_ulp_impl, float, uint64_t, _LFG_CT_FLOAT_NEAR_ULP, "%.9g", "ulps=%llu",
+        unsigned long long)
+#endif /* LFG_CTEST_HAS_FLOAT */
+
+#ifdef LFG_CTEST_HAS_DOUBLE
+#define _LFG_CT_DOUBLE_NEAR_EPS(_e, _a, _eps) _LFG_CT_NEAR_EPS(fabs, _e, _a, _eps)
+#define _LFG_CT_DOUBLE_NEAR_ULP(_e, _a, _ulps) _LFG_CT_NEAR_ULP(_lfg_ct_double_ulps, _e, _a, _ulps)
+
+_LFG_CT_FP_ARRAY_DEF(double_array_equal_impl, double, double, _LFG_CT_DOUBLE_NEAR_EPS, "%.17g", "eps=%g", double)
+_LFG_CT_FP_ARRAY_DEF(double_array_equal_ulp_impl, double, uint64_t, _LFG_CT_DOUBLE_NEAR_ULP, "%.17g", "ulps=%llu",
+        unsigned long long)
+#endif /* LFG_CTEST_HAS_DOUBLE */
+
+/*============================================================================
+ *  32-bit Float Assertions (optional)
+ *==========================================================================*/
+
+#ifdef LFG_CTEST_HAS_FLOAT
+
+int lfg_ct_assert_float_equal_impl(float expected, float actual, float epsilon, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    float diff = fabsf(expected - actual);
+    if (diff > epsilon)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%.6g) should not equal %.6g "
-               "(diff=%.6g, eps=%.6g)\r\n",
-                filename, line_no, function, actual_expr_str, actual, expected, diff, epsilon);
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should equal %.6g (diff=%.6g, eps=%.6g)", actual_expr_str,
+                actual, expected, diff, epsilon);
+        RECORD_FAILURE();
+        return -1;
+    }
+    RECORD_PASS();
+    return 0;
+}
+
+int lfg_ct_assert_float_not_equal_impl(float expected, float actual, float epsilon, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
+    float diff = fabsf(expected - actual);
+    if (diff <= epsilon)
+    {
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should not equal %.6g (diff=%.6g, eps=%.6g)",
+                actual_expr_str, actual, expected, diff, epsilon);
         RECORD_FAILURE();
         return -1;
     }
@@ -849,11 +1634,10 @@ int lfg_ct_assert_float_not_equal_impl(float expected, float actual, float epsil
 int lfg_ct_assert_float_greater_impl(float a, float b, const char *filename, int line_no, const char *function,
         const char *a_expr_str, const char *b_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(a > b))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%.6g) should be > %s (%.6g)\r\n", filename, line_no, function,
-                a_expr_str, a, b_expr_str, b);
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be > %s (%.6g)", a_expr_str, a, b_expr_str, b);
         RECORD_FAILURE();
         return -1;
     }
@@ -864,11 +1648,10 @@ int lfg_ct_assert_float_greater_impl(float a, float b, const char *filename, int
 int lfg_ct_assert_float_less_impl(float a, float b, const char *filename, int line_no, const char *function,
         const char *a_expr_str, const char *b_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(a < b))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%.6g) should be < %s (%.6g)\r\n", filename, line_no, function,
-                a_expr_str, a, b_expr_str, b);
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be < %s (%.6g)", a_expr_str, a, b_expr_str, b);
         RECORD_FAILURE();
         return -1;
     }
@@ -879,11 +1662,10 @@ int lfg_ct_assert_float_less_impl(float a, float b, const char *filename, int li
 int lfg_ct_assert_float_ge_impl(float a, float b, const char *filename, int line_no, const char *function,
         const char *a_expr_str, const char *b_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(a >= b))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%.6g) should be >= %s (%.6g)\r\n", filename, line_no, function,
-                a_expr_str, a, b_expr_str, b);
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be >= %s (%.6g)", a_expr_str, a, b_expr_str, b);
         RECORD_FAILURE();
         return -1;
     }
@@ -894,11 +1676,10 @@ int lfg_ct_assert_float_ge_impl(float a, float b, const char *filename, int line
 int lfg_ct_assert_float_le_impl(float a, float b, const char *filename, int line_no, const char *function,
         const char *a_expr_str, const char *b_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(a <= b))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%.6g) should be <= %s (%.6g)\r\n", filename, line_no, function,
-                a_expr_str, a, b_expr_str, b);
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be <= %s (%.6g)", a_expr_str, a, b_expr_str, b);
         RECORD_FAILURE();
         return -1;
     }
@@ -909,12 +1690,11 @@ int lfg_ct_assert_float_le_impl(float a, float b, const char *filename, int line
 int lfg_ct_assert_float_in_range_impl(float val, float min, float max, const char *filename, int line_no,
         const char *function, const char *val_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     if (!(val >= min && val <= max))
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%.6g) should be in range "
-               "[%.6g, %.6g]\r\n",
-                filename, line_no, function, val_expr_str, val, min, max);
+        _lfg_ct_fail(filename, line_no, function, "%s (%.6g) should be in range [%.6g, %.6g]", val_expr_str, val, min,
+                max);
         RECORD_FAILURE();
         return -1;
     }
@@ -933,13 +1713,12 @@ int lfg_ct_assert_float_in_range_impl(float val, float min, float max, const cha
 int lfg_ct_assert_double_equal_impl(double expected, double actual, double epsilon, const char *filename, int line_no,
         const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     double diff = fabs(expected - actual);
     if (diff > epsilon)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%.10g) should equal %.10g "
-               "(diff=%.10g, eps=%.10g)\r\n",
-                filename, line_no, function, actual_expr_str, actual, expected, diff, epsilon);
+        _lfg_ct_fail(filename, line_no, function, "%s (%.10g) should equal %.10g (diff=%.10g, eps=%.10g)",
+                actual_expr_str, actual, expected, diff, epsilon);
         RECORD_FAILURE();
         return -1;
     }
@@ -950,13 +1729,12 @@ int lfg_ct_assert_double_equal_impl(double expected, double actual, double epsil
 int lfg_ct_assert_double_not_equal_impl(double expected, double actual, double epsilon, const char *filename,
         int line_no, const char *function, const char *actual_expr_str)
 {
-    _assertions_executed++;
+    _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);
     double diff = fabs(expected - actual);
     if (diff <= epsilon)
     {
-        printf("*** %s: %u: FAILURE in %s(): %s (%.10g) should not equal %.10g "
-               "(diff=%.10g, eps=%.10g)\r\n",
-                filename, line_no, function, actual_expr_str, actual, expected, diff, epsilon);
+        _lfg_ct_fail(filename, line_no, function, "%s (%.10g) should not equal %.10g (diff=%.10g, eps=%.10g)",
+                actual_expr_str, actual, expected, diff, epsilon);
         RECORD_FAILURE();
         return -1;
     }
@@ -969,3 +1747,1271 @@ int lfg_ct_assert_double_not_equal_impl(double expected, double actual, double e
 /*============================================================================
  *  Private Functions
  *==========================================================================*/
+
+/* Run one test in this process, timing it. A test run from inside another
+ * test keeps the outer test's failure count intact. */
+static void _lfg_ct_run(void (*fn)(void), const char *name, unsigned timeout_ms)
+{
+    int outer_failures = _current_test_failures;
+    const char *outer_name = _running_name;
+    uint64_t outer_start_ns = _running_start_ns;
+    struct _lfg_ct_watch saved;
+    uint64_t wall0 = _lfg_ct_wall_ns();
+    uint64_t cpu0 = _lfg_ct_cpu_ns();
+
+    _tests_executed++;
+    _current_test_failures = 0;
+    _running_name = name;
+    _running_start_ns = wall0;
+    _test_depth++;
+    _lfg_ct_watch_begin("test", name, timeout_ms, &saved);
+    fn();
+    _lfg_ct_watch_end(&saved);
+    _test_depth--;
+    _running_name = outer_name;
+    _running_start_ns = outer_start_ns;
+    _lfg_ct_test_finished(
+            name, _current_test_failures, _lfg_ct_wall_ns() - wall0, _lfg_ct_cpu_ns() - cpu0, NULL);
+    _current_test_failures = outer_failures;
+}
+
+/* Run a test that has already passed shard selection. */
+static void _lfg_ct_dispatch(void (*fn)(void), const char *name, unsigned timeout_ms)
+{
+#ifdef LFG_CTEST_HAS_FORK
+    if (_jobs > 1)
+    {
+        _lfg_ct_spawn(fn, name, timeout_ms);
+        return;
+    }
+    if (_isolate)
+    {
+        /* one worker at a time, so output and order match an in-process run */
+        _lfg_ct_spawn(fn, name, timeout_ms);
+        _lfg_ct_drain();
+        return;
+    }
+#endif
+    _lfg_ct_run(fn, name, timeout_ms);
+}
+
+/* Budget for the test or suite about to start: a pending
+ * lfg_ct_timeout_next() value, else @p fallback. */
+static unsigned _lfg_ct_take_timeout(unsigned fallback)
+{
+    if (_timeout_next_set)
+    {
+        _timeout_next_set = false;
+        return _timeout_next_ms;
+    }
+    return fallback;
+}
+
+/* Enter a test or suite with an @p ms budget (0 = none). The tighter of it
+ * and any enclosing budget is armed; @p saved restores the enclosing one. */
+static void _lfg_ct_watch_begin(const char *what, const char *name, unsigned ms, struct _lfg_ct_watch *saved)
+{
+    *saved = _watch;
+    if (ms > 0)
+    {
+        uint64_t deadline_ns = _lfg_ct_wall_ns() + (uint64_t)ms * 1000000u;
+        if (0 == _watch.deadline_ns || deadline_ns < _watch.deadline_ns)
+        {
+            _watch.what = what;
+            _watch.name = name;
+            _watch.ms = ms;
+            _watch.deadline_ns = deadline_ns;
+        }
+    }
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    if (_watch.deadline_ns != 0)
+    {
+        _lfg_ct_watch_arm(); /* also re-arms an inherited budget in a fresh worker */
+    }
+#endif
+}
+
+static void _lfg_ct_watch_end(const struct _lfg_ct_watch *saved)
+{
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    bool changed = saved->deadline_ns != _watch.deadline_ns;
+#endif
+
+    _watch = *saved;
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    if (changed)
+    {
+        _lfg_ct_watch_arm();
+    }
+#endif
+}
+
+#ifdef LFG_CTEST_HAS_WATCHDOG
+
+/* Point ITIMER_REAL at the current deadline, or disarm it and put back the
+ * SIGALRM action that was in place before the first budget. */
+static void _lfg_ct_watch_arm(void)
+{
+    struct itimerval it;
+
+    memset(&it, 0, sizeof(it));
+    if (_watch.deadline_ns != 0)
+    {
+        uint64_t now_ns = _lfg_ct_wall_ns();
+        uint64_t left_ns = _watch.deadline_ns > now_ns ? _watch.deadline_ns - now_ns : 1000u;
+
+        if (!_watchdog_installed)
+        {
+            struct sigaction sa;
+#ifdef LFG_CTEST_HAS_BACKTRACE
+            void *frame;
+
+            backtrace(&frame, 1); /* loads the unwinder now, not inside the handler */
+#endif
+            memset(&sa, 0, sizeof(sa));
+            sa.sa_handler = _lfg_ct_watchdog;
+            sigemptyset(&sa.sa_mask);
+            sigaction(SIGALRM, &sa, &_watchdog_saved);
+            _watchdog_installed = true;
+        }
+        it.it_value.tv_sec = (time_t)(left_ns / 1000000000u);
+        it.it_value.tv_usec = (suseconds_t)(left_ns / 1000u % 1000000u);
+        if (0 == it.it_value.tv_sec && 0 == it.it_value.tv_usec)
+        {
+            it.it_value.tv_usec = 1;
+        }
+    }
+    else if (!_watchdog_installed)
+    {
+        return; /* never armed, nothing to cancel */
+    }
+    setitimer(ITIMER_REAL, &it, NULL);
+    if (0 == _watch.deadline_ns)
+    {
+        sigaction(SIGALRM, &_watchdog_saved, NULL);
+        _watchdog_installed = false;
+    }
+}
+
+/* SIGALRM: the innermost budget ran out and whatever is running is stuck.
+ * Only async-signal-safe calls here: write(), the stack of the stuck code,
+ * kill() and _exit(). A worker's parent sees the exit status and reports the
+ * timeout. In-process nobody else can, so the handler writes the pending
+ * console batch, the timeout, the failed test and the summary line itself,
+ * in the console reporter's format, and ends the run with status 1. Other
+ * reporters and the result file get nothing; lfg_ct_isolate() keeps them. */
+static void _lfg_ct_watchdog(int sig)
+{
+    static const char message[] = "\r\n*** TIME BUDGET EXCEEDED, stopping\r\n";
+    char line[512];
+    size_t len = 0;
+    unsigned long failures = (unsigned long)_tests_failed;
+    ssize_t n;
+#ifdef LFG_CTEST_HAS_BACKTRACE
+    void *frames[LFG_CT_BACKTRACE_MAX];
+    int frames_count;
+#endif
+#ifdef LFG_CTEST_HAS_FORK
+    unsigned i;
+#endif
+
+    (void)sig;
+#ifdef LFG_CTEST_HAS_FORK
+    if (_in_worker)
+    {
+        n = write(STDOUT_FILENO, message, sizeof(message) - 1);
+        (void)n;
+#ifdef LFG_CTEST_HAS_BACKTRACE
+        frames_count = backtrace(frames, LFG_CT_BACKTRACE_MAX);
+        backtrace_symbols_fd(frames, frames_count, STDOUT_FILENO);
+#endif
+        _exit(_LFG_CT_TIMEOUT_STATUS);
+    }
+    for (i = 0; i < _workers_active; i++)
+    {
+        kill(_workers[i].pid, SIGKILL);
+    }
+#else
+    (void)message;
+#endif
+
+    n = write(STDOUT_FILENO, _report_buf, _report_len);
+    _lfg_ct_sig_append(line, sizeof(line), &len, "*** ");
+    _lfg_ct_sig_append(line, sizeof(line), &len, _watch.what);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " ");
+    _lfg_ct_sig_append(line, sizeof(line), &len, _watch.name);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " TIMED OUT after ");
+    _lfg_ct_sig_append_uint(line, sizeof(line), &len, _watch.ms);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " ms\r\n");
+    n = write(STDOUT_FILENO, line, len);
+#ifdef LFG_CTEST_HAS_BACKTRACE
+    frames_count = backtrace(frames, LFG_CT_BACKTRACE_MAX);
+    backtrace_symbols_fd(frames, frames_count, STDOUT_FILENO);
+#endif
+
+    len = 0;
+    if (_running_name)
+    {
+        _lfg_ct_sig_append(line, sizeof(line), &len, "*** test FAILURE: ");
+        _lfg_ct_sig_append(line, sizeof(line), &len, _running_name);
+        _lfg_ct_sig_append(line, sizeof(line), &len, " (timed out)\r\n");
+        failures++;
+    }
+    _lfg_ct_sig_append(line, sizeof(line), &len, "*** Executed ");
+    _lfg_ct_sig_append_uint(line, sizeof(line), &len, (unsigned long)lfg_ct_counters.assertions_executed);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " assertions in ");
+    _lfg_ct_sig_append_uint(line, sizeof(line), &len, (unsigned long)_tests_executed);
+    _lfg_ct_sig_append(line, sizeof(line), &len, " tests. Failures: ");
+    _lfg_ct_sig_append_uint(line, sizeof(line), &len, failures);
+    _lfg_ct_sig_append(line, sizeof(line), &len, "\r\n*** Testing complete. Result: FAIL\r\n");
+    n = write(STDOUT_FILENO, line, len);
+    (void)n;
+    _exit(1);
+}
+
+/* Append @p s to @p line, truncating at @p size; async-signal-safe. */
+static void _lfg_ct_sig_append(char *line, size_t size, size_t *len, const char *s)
+{
+    while (*s && *len < size)
+    {
+        line[(*len)++] = *s++;
+    }
+}
+
+/* Append @p v in decimal to @p line; async-signal-safe. */
+static void _lfg_ct_sig_append_uint(char *line, size_t size, size_t *len, unsigned long v)
+{
+    char digits[24];
+    size_t i = sizeof(digits) - 1;
+
+    digits[i] = '\0';
+    do
+    {
+        digits[--i] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v > 0);
+    _lfg_ct_sig_append(line, size, len, digits + i);
+}
+
+#ifdef LFG_CTEST_HAS_FORK
+
+/* Stop this process's own timer while it waits on workers, so an enclosing
+ * budget that runs out meanwhile is reported by _lfg_ct_watch_resume() instead
+ * of ending the run from the signal handler. */
+static void _lfg_ct_watch_pause(void)
+{
+    struct itimerval it;
+
+    if (_watchdog_installed)
+    {
+        memset(&it, 0, sizeof(it));
+        setitimer(ITIMER_REAL, &it, NULL);
+    }
+}
+
+/* Done waiting on a worker: re-arm, or if the budget ran out meanwhile report
+ * it, stop the other workers, print the summary and end the run. */
+static void _lfg_ct_watch_resume(void)
+{
+    lfg_ct_event_t ev;
+    unsigned i;
+
+    if (0 == _watch.deadline_ns || _lfg_ct_wall_ns() < _watch.deadline_ns)
+    {
+        _lfg_ct_watch_arm();
+        return;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_TIMEOUT;
+    ev.name = _watch.name;
+    ev.message = _watch.what;
+    ev.wall_ns = (uint64_t)_watch.ms * 1000000u;
+    _lfg_ct_emit(&ev);
+
+    memset(&_watch, 0, sizeof(_watch)); /* the drain below must not come back here */
+    _lfg_ct_watch_arm();
+    for (i = 0; i < _workers_active; i++)
+    {
+        kill(_workers[i].pid, SIGKILL);
+    }
+    _lfg_ct_drain();
+    if (_running_name)
+    {
+        _lfg_ct_test_finished(_running_name, 1, _lfg_ct_wall_ns() - _running_start_ns, 0, "timed out");
+    }
+    lfg_ct_print_summary();
+    lfg_ct_end();
+    exit(1);
+}
+
+#endif /* LFG_CTEST_HAS_FORK */
+
+#endif /* LFG_CTEST_HAS_WATCHDOG */
+
+/* Advance the shard ordinal; true if the test belongs to another shard.
+ * Round-robin on the ordinal splits tests evenly and deterministically as
+ * long as every shard runs the same binary with the same selection. */
+static bool _lfg_ct_shard_skip(void)
+{
+    unsigned ordinal;
+
+    _lfg_ct_shard_from_env();
+    ordinal = _shard_ordinal++;
+    if (ordinal % _shard_count != _shard_index)
+    {
+        _tests_skipped++;
+        return true;
+    }
+    return false;
+}
+
+/* Pick up LFG_CT_SHARD_INDEX / LFG_CT_SHARD_COUNT / LFG_CT_RESULT_FILE once.
+ * Invalid values are reported and ignored, so the binary runs every test
+ * rather than silently dropping some. */
+static void _lfg_ct_shard_from_env(void)
+{
+    const char *index;
+    const char *count;
+    const char *file;
+
+    if (_shard_env_read)
+    {
+        return;
+    }
+    _shard_env_read = true;
+
+    file = getenv("LFG_CT_RESULT_FILE");
+    if (file && *file && NULL == _result_file)
+    {
+        _result_file = file;
+    }
+    index = getenv("LFG_CT_SHARD_INDEX");
+    count = getenv("LFG_CT_SHARD_COUNT");
+    if (index && count)
+    {
+        unsigned i = (unsigned)strtoul(index, NULL, 10);
+        unsigned n = (unsigned)strtoul(count, NULL, 10);
+        if (0 == n || i >= n)
+        {
+            fprintf(stderr, "lfg-ctest: ignoring invalid shard %s/%s\n", index, count);
+            return;
+        }
+        _shard_index = i;
+        _shard_count = n;
+    }
+}
+
+/* Write the run totals as key=value lines for a CI merge step. */
+static void _lfg_ct_write_result_file(void)
+{
+    FILE *f;
+    unsigned i;
+
+    if (NULL == _result_file)
+    {
+        return;
+    }
+    f = fopen(_result_file, "w");
+    if (NULL == f)
+    {
+        fprintf(stderr, "lfg-ctest: cannot write result file %s\n", _result_file);
+        return;
+    }
+    fprintf(f,
+            "shard_index=%u\nshard_count=%u\ntests_executed=%d\ntests_passed=%d\ntests_failed=%d\n"
+            "tests_skipped=%d\nassertions_executed=%d\nassertions_failed=%d\nwall_ns=%llu\ncpu_ns=%llu\n"
+            "result=%s\n",
+            _shard_index, _shard_count, _tests_executed, _tests_passed, _tests_failed, _tests_skipped,
+            lfg_ct_counters.assertions_executed, _assertions_failed, (unsigned long long)_tests_wall_ns,
+            (unsigned long long)_tests_cpu_ns, _tests_failed ? "FAIL" : "PASS");
+    for (i = 0; i < _failed_names_count; i++)
+    {
+        fprintf(f, "failed_test=%s\n", _failed_names[i]);
+    }
+    fclose(f);
+}
+
+/* Fold one finished test into the test/suite counters and timing tables.
+ * @p reason describes a test that failed without an assertion (worker crash). */
+static void _lfg_ct_test_finished(
+        const char *name, int failures, uint64_t wall_ns, uint64_t cpu_ns, const char *reason)
+{
+    lfg_ct_event_t ev;
+
+    _tests_wall_ns += wall_ns;
+    _tests_cpu_ns += cpu_ns;
+    _lfg_ct_slowest_insert(_slowest_tests, &_slowest_tests_count, name, wall_ns, cpu_ns);
+    if (failures > 0)
+    {
+#ifdef LFG_CTEST_SELF_TEST
+        /* a whole test failing (e.g. a crashed worker) counts like a failed
+         * assertion while the parent is in expect-failures mode */
+        if (_expect_failures_mode)
+        {
+            _expected_failures_count++;
+            failures = 0;
+        }
+        else
+#endif
+        {
+            _current_suite_failures++;
+            _tests_failed++;
+            if (_failed_names_count < LFG_CT_FAILED_NAMES_MAX)
+            {
+                _failed_names[_failed_names_count++] = name;
+            }
+        }
+    }
+    if (0 == failures)
+    {
+        _tests_passed++;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_TEST_END;
+    ev.name = name;
+    ev.message = reason;
+    ev.failures = failures;
+    ev.wall_ns = wall_ns;
+    ev.cpu_ns = cpu_ns;
+    _lfg_ct_emit(&ev);
+}
+
+/* Format an assertion failure and hand it to every reporter. */
+static void _lfg_ct_fail(const char *filename, int line_no, const char *function, const char *fmt, ...)
+{
+    char message[LFG_CT_MESSAGE_MAX];
+    char *text = message;
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(message, sizeof(message), fmt, ap);
+    va_end(ap);
+
+    /* long strings in STR/STRN failures must not be cut short: format those on the heap */
+    if (n >= (int)sizeof(message) && NULL != (text = malloc((size_t)n + 1)))
+    {
+        va_start(ap, fmt);
+        vsnprintf(text, (size_t)n + 1, fmt, ap);
+        va_end(ap);
+    }
+    else
+    {
+        text = message;
+    }
+
+    _lfg_ct_fail_message(filename, line_no, function, text);
+    if (text != message)
+    {
+        free(text);
+    }
+}
+
+static void _lfg_ct_fail_message(const char *filename, int line_no, const char *function, const char *message)
+{
+    lfg_ct_event_t ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = LFG_CT_EVENT_FAILURE;
+    ev.file = filename;
+    ev.line = line_no;
+    ev.function = function;
+    ev.message = message;
+    _lfg_ct_emit(&ev);
+}
+
+/* vsnprintf onto @p buf at @p len, returning the new length clamped to the buffer */
+static size_t _lfg_ct_appendf(char *buf, size_t size, size_t len, const char *fmt, ...)
+{
+    va_list ap;
+    int w;
+
+    if (len + 1 >= size)
+    {
+        return len;
+    }
+    va_start(ap, fmt);
+    w = vsnprintf(buf + len, size - len, fmt, ap);
+    va_end(ap);
+    if (w < 0)
+    {
+        return len;
+    }
+    return ((size_t)w < size - len) ? len + (size_t)w : size - 1;
+}
+
+/* Report an array assertion given exactly one NULL array. Two NULLs compare equal. */
+static bool _lfg_ct_array_null(const void *expected, const void *actual, const char *filename, int line_no,
+        const char *function, const char *actual_expr_str)
+{
+    if ((NULL == expected) == (NULL == actual))
+    {
+        return false;
+    }
+    _lfg_ct_fail(filename, line_no, function, "%s (%p) should equal %p (NULL mismatch)", actual_expr_str, actual,
+            expected);
+    return true;
+}
+
+#ifdef LFG_CTEST_HAS_FLOAT
+/* Distance in representable floats: map the bits onto a monotonic unsigned scale and subtract */
+static uint64_t _lfg_ct_float_ulps(float a, float b)
+{
+    uint32_t ua, ub;
+
+    memcpy(&ua, &a, sizeof(ua));
+    memcpy(&ub, &b, sizeof(ub));
+    ua ^= (0u - (ua >> 31)) | 0x80000000u; /* negative: flip all bits; positive: set the sign */
+    ub ^= (0u - (ub >> 31)) | 0x80000000u;
+    return (ua > ub) ? ua - ub : ub - ua;
+}
+#endif
+
+#ifdef LFG_CTEST_HAS_DOUBLE
+static uint64_t _lfg_ct_double_ulps(double a, double b)
+{
+    const uint64_t sign = (uint64_t)1 << 63;
+    uint64_t ua, ub;
+
+    memcpy(&ua, &a, sizeof(ua));
+    memcpy(&ub, &b, sizeof(ub));
+    ua ^= (0u - (ua >> 63)) | sign;
+    ub ^= (0u - (ub >> 63)) | sign;
+    return (ua > ub) ? ua - ub : ub - ua;
+}
+#endif
+
+/* First offset in [from, n) where @p a and @p b differ, or n. Equal blocks are
+ * skipped with memcmp, which libc already vectorizes, and only the block that
+ * differs is narrowed down, a word and then a byte at a time. */
+static size_t _lfg_ct_mem_mismatch(const unsigned char *a, const unsigned char *b, size_t from, size_t n)
+{
+    while (from < n)
+    {
+        size_t block = (n - from < _LFG_CT_DIFF_BLOCK) ? n - from : _LFG_CT_DIFF_BLOCK;
+        if (memcmp(a + from, b + from, block) != 0)
+        {
+            break;
+        }
+        from += block;
+    }
+    while (n - from >= sizeof(uint64_t))
+    {
+        uint64_t wa, wb;
+        memcpy(&wa, a + from, sizeof(wa));
+        memcpy(&wb, b + from, sizeof(wb));
+        if (wa != wb)
+        {
+            break;
+        }
+        from += sizeof(uint64_t);
+    }
+    while (from < n && a[from] == b[from])
+    {
+        from++;
+    }
+    return from;
+}
+
+/* Index of the first differing char within the first @p n, stopping at a shared terminator */
+static size_t _lfg_ct_str_mismatch(const char *a, const char *b, size_t n)
+{
+    size_t i = 0;
+
+    while (i < n && a[i] == b[i] && a[i] != '\0')
+    {
+        i++;
+    }
+    return i;
+}
+
+/* Format the row of @p n bytes starting at @p row as expected, actual and a ^^ line under the
+ * bytes that differ. Returns the length written, or 0 if it did not fit in @p room. */
+static size_t _lfg_ct_hexdump_row(char *out, size_t room, const unsigned char *expected, const unsigned char *actual,
+        size_t row, size_t n)
+{
+    size_t end = (n - row < _LFG_CT_HEXDUMP_ROW) ? n : row + _LFG_CT_HEXDUMP_ROW;
+    size_t last = row;
+    size_t len;
+    size_t i;
+    int w;
+
+    w = snprintf(out, room, "\r\n    0x%08zx exp:", row);
+    len = (w > 0) ? (size_t)w : 0;
+    for (i = row; i < end && len < room; i++)
+    {
+        len += (size_t)snprintf(out + len, room - len, " %02x", expected[i]);
+    }
+    if (len < room)
+    {
+        len += (size_t)snprintf(out + len, room - len, "\r\n               act:");
+    }
+    for (i = row; i < end && len < room; i++)
+    {
+        len += (size_t)snprintf(out + len, room - len, " %02x", actual[i]);
+        if (expected[i] != actual[i])
+        {
+            last = i;
+        }
+    }
+    if (len < room)
+    {
+        len += (size_t)snprintf(out + len, room - len, "\r\n                   ");
+    }
+    for (i = row; i <= last && len < room; i++)
+    {
+        len += (size_t)snprintf(out + len, room - len, "%s", (expected[i] != actual[i]) ? " ^^" : "   ");
+    }
+    return (len < room) ? len : 0;
+}
+
+/* Report a failed ASSERT_MEM_EQUAL whose first difference is at @p first: count every
+ * differing byte and run, then hexdump the rows of the first LFG_CT_MEM_DIFF_WINDOWS runs. */
+static void _lfg_ct_fail_mem(const unsigned char *expected, const unsigned char *actual, size_t n, size_t first,
+        char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    char message[LFG_CT_MESSAGE_MAX + LFG_CT_MEM_DIFF_WINDOWS * _LFG_CT_HEXDUMP_ROW_MAX];
+    size_t rows[LFG_CT_MEM_DIFF_WINDOWS];
+    unsigned nrows = 0;
+    size_t bytes = 0;
+    size_t runs = 0;
+    size_t off = first;
+    size_t len;
+    unsigned i;
+    int w;
+
+    while (off < n)
+    {
+        size_t row = off - off % _LFG_CT_HEXDUMP_ROW;
+        if (nrows < LFG_CT_MEM_DIFF_WINDOWS && (0 == nrows || rows[nrows - 1] != row))
+        {
+            rows[nrows++] = row;
+        }
+        runs++;
+        while (off < n && expected[off] != actual[off])
+        {
+            bytes++;
+            off++;
+        }
+        off = _lfg_ct_mem_mismatch(expected, actual, off, n);
+    }
+
+    w = snprintf(message, LFG_CT_MESSAGE_MAX,
+            "%s memory (%zu bytes) does not match expected: %zu bytes differ in %zu runs, first at offset %zu (0x%zx)",
+            actual_expr_str, n, bytes, runs, first, first);
+    len = (w < 0) ? 0 : ((size_t)w < LFG_CT_MESSAGE_MAX) ? (size_t)w : LFG_CT_MESSAGE_MAX - 1;
+    for (i = 0; i < nrows; i++)
+    {
+        len += _lfg_ct_hexdump_row(message + len, sizeof(message) - len, expected, actual, rows[i], n);
+    }
+    message[len] = '\0';
+    _lfg_ct_fail_message(filename, line_no, function, message);
+}
+
+static void _lfg_ct_emit(const lfg_ct_event_t *event)
+{
+    unsigned i;
+
+    _LFG_CT_REPORT_LOCK();
+    if (_console_enabled)
+    {
+        _lfg_ct_console(event);
+    }
+    for (i = 0; i < _reporters_count; i++)
+    {
+        _reporters[i].fn(event, _reporters[i].ctx);
+    }
+    _LFG_CT_REPORT_UNLOCK();
+}
+
+/* Write out the console batch. Callers hold the report lock. */
+static void _lfg_ct_report_write(void)
+{
+    if (_report_len > 0)
+    {
+        fwrite(_report_buf, 1, _report_len, stdout);
+        _report_len = 0;
+    }
+    fflush(stdout);
+}
+
+/* Built-in console reporter. Lines are collected in _report_buf and written
+ * in one go at the end of each test, suite and run (or when the buffer fills),
+ * instead of one stdio call per failure. */
+static void _lfg_ct_console(const lfg_ct_event_t *event)
+{
+    switch (event->type)
+    {
+    case LFG_CT_EVENT_START:
+        _lfg_ct_console_printf("*** begin unit test\r\n*** random seed is %u\r\n", event->seed);
+        if (event->shard_count > 1)
+        {
+            _lfg_ct_console_printf("*** shard %u of %u\r\n", event->shard_index, event->shard_count);
+        }
+        _lfg_ct_report_write();
+        break;
+
+    case LFG_CT_EVENT_FAILURE:
+        _lfg_ct_console_printf("*** %s: %u: FAILURE in %s(): %s\r\n", event->file, event->line, event->function,
+                event->message);
+#ifdef LFG_CTEST_HAS_FORK
+        if (_in_worker || _isolate)
+        {
+            _lfg_ct_report_write(); /* a crash is expected to be survivable here; it would lose the batch */
+        }
+#endif
+        break;
+
+    case LFG_CT_EVENT_TEST_END:
+        if (event->failures > 0)
+        {
+            if (event->message)
+            {
+                _lfg_ct_console_printf("*** test FAILURE: %s (%s)\r\n", event->name, event->message);
+            }
+            else
+            {
+                _lfg_ct_console_printf("*** test FAILURE: %s\r\n", event->name);
+            }
+        }
+        else if (event->message)
+        {
+            _lfg_ct_console_printf("*** test %s: %s\r\n", event->name, event->message);
+        }
+        _lfg_ct_report_write();
+        break;
+
+    case LFG_CT_EVENT_SUITE_END:
+        if (event->failures > 0)
+        {
+            _lfg_ct_console_printf("*** suite FAILURE: %s\r\n", event->name);
+        }
+        _lfg_ct_report_write();
+        break;
+
+    case LFG_CT_EVENT_TIMEOUT:
+        _lfg_ct_console_printf("*** %s %s TIMED OUT after %lu ms\r\n", event->message, event->name,
+                (unsigned long)(event->wall_ns / 1000000u));
+        _lfg_ct_report_write(); /* ahead of the backtrace, which goes straight to stdout */
+        break;
+
+    case LFG_CT_EVENT_SUMMARY:
+        _lfg_ct_console_printf("*** Executed %d assertions in %d tests. Failures: %d\r\n", event->assertions_executed,
+                event->tests_executed, event->failures);
+        _lfg_ct_console_printf("*** Time: %lu.%03lu ms elapsed, tests %lu.%03lu ms wall, %lu.%03lu ms cpu\r\n",
+                (unsigned long)(event->elapsed_ns / 1000000u), (unsigned long)(event->elapsed_ns / 1000u % 1000u),
+                (unsigned long)(event->wall_ns / 1000000u), (unsigned long)(event->wall_ns / 1000u % 1000u),
+                (unsigned long)(event->cpu_ns / 1000000u), (unsigned long)(event->cpu_ns / 1000u % 1000u));
+        _lfg_ct_console_slowest("tests", event->slowest_tests, event->slowest_tests_count);
+        _lfg_ct_console_slowest("suites", event->slowest_suites, event->slowest_suites_count);
+        _lfg_ct_console_bench(event->bench, event->bench_count);
+        if (event->shard_count > 1)
+        {
+            /* one self-contained line a CI merge step can grep for */
+            _lfg_ct_console_printf("LFG_CT_RESULT shard=%u/%u tests=%d failed=%d skipped=%d assertions=%d "
+                                   "wall_ns=%llu result=%s\r\n",
+                    event->shard_index, event->shard_count, event->tests_executed, event->failures,
+                    event->tests_skipped, event->assertions_executed, (unsigned long long)event->wall_ns,
+                    event->failures ? "FAIL" : "PASS");
+        }
+        _lfg_ct_console_printf("*** Testing complete. Result: %s\r\n", event->failures ? "FAIL" : "PASS");
+        _lfg_ct_report_write();
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* Append one formatted line to the console batch, flushing first if it does
+ * not fit. Lines longer than the whole buffer are written straight through. */
+static void _lfg_ct_console_printf(const char *fmt, ...)
+{
+    size_t room = sizeof(_report_buf) - _report_len;
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(_report_buf + _report_len, room, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+    {
+        return;
+    }
+    if ((size_t)n < room)
+    {
+        _report_len += (size_t)n;
+        return;
+    }
+
+    _lfg_ct_report_write();
+    va_start(ap, fmt);
+    if ((size_t)n < sizeof(_report_buf))
+    {
+        vsnprintf(_report_buf, sizeof(_report_buf), fmt, ap);
+        _report_len = (size_t)n;
+    }
+    else
+    {
+        vprintf(fmt, ap);
+    }
+    va_end(ap);
+}
+
+/* Convert clock() ticks to nanoseconds without overflowing the intermediate. */
+static uint64_t _lfg_ct_ticks_to_ns(clock_t ticks)
+{
+    uint64_t t = (uint64_t)ticks;
+    return t / CLOCKS_PER_SEC * 1000000000u + t % CLOCKS_PER_SEC * 1000000000u / CLOCKS_PER_SEC;
+}
+
+/* Monotonic wall time. Falls back to clock() where clock_gettime() is missing
+ * (that measures CPU time on most hosted platforms, but is the only tick many
+ * embedded C libraries provide). */
+static uint64_t _lfg_ct_wall_ns(void)
+{
+#if defined(LFG_CTEST_HAS_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    if (0 == clock_gettime(CLOCK_MONOTONIC, &ts))
+    {
+        return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    }
+#endif
+    return _lfg_ct_ticks_to_ns(clock());
+}
+
+/* CPU time consumed by this process. */
+static uint64_t _lfg_ct_cpu_ns(void)
+{
+#if defined(LFG_CTEST_HAS_CLOCK_GETTIME) && defined(CLOCK_PROCESS_CPUTIME_ID)
+    struct timespec ts;
+    if (0 == clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts))
+    {
+        return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    }
+#endif
+    return _lfg_ct_ticks_to_ns(clock());
+}
+
+/* Insert into a table sorted by descending wall time, dropping the fastest
+ * entry once full. Tables hold LFG_CT_SLOWEST_MAX entries regardless of the
+ * report size so lfg_ct_set_report_slowest() may be called at any time. */
+static void _lfg_ct_slowest_insert(
+        lfg_ct_timing_t *table, unsigned *count, const char *name, uint64_t wall_ns, uint64_t cpu_ns)
+{
+    unsigned i = *count;
+
+    if (i == LFG_CT_SLOWEST_MAX)
+    {
+        if (wall_ns <= table[i - 1].wall_ns)
+        {
+            return;
+        }
+        i--;
+    }
+    else
+    {
+        (*count)++;
+    }
+    while (i > 0 && table[i - 1].wall_ns < wall_ns)
+    {
+        table[i] = table[i - 1];
+        i--;
+    }
+    table[i].name = name;
+    table[i].wall_ns = wall_ns;
+    table[i].cpu_ns = cpu_ns;
+}
+
+static void _lfg_ct_console_slowest(const char *what, const lfg_ct_timing_t *table, unsigned count)
+{
+    unsigned i;
+
+    if (0 == count)
+    {
+        return;
+    }
+    _lfg_ct_console_printf("*** Slowest %u %s:\r\n", count, what);
+    for (i = 0; i < count; i++)
+    {
+        _lfg_ct_console_printf("***   %lu.%03lu ms wall, %lu.%03lu ms cpu  %s\r\n",
+                (unsigned long)(table[i].wall_ns / 1000000u), (unsigned long)(table[i].wall_ns / 1000u % 1000u),
+                (unsigned long)(table[i].cpu_ns / 1000000u), (unsigned long)(table[i].cpu_ns / 1000u % 1000u),
+                table[i].name);
+    }
+}
+
+static void _lfg_ct_console_bench(const lfg_ct_bench_result_t *table, unsigned count)
+{
+    unsigned i;
+
+    if (0 == count)
+    {
+        return;
+    }
+    _lfg_ct_console_printf("*** Benchmarks (ns/op: min / median / mean / p99):\r\n");
+    for (i = 0; i < count; i++)
+    {
+        const lfg_ct_bench_result_t *b = &table[i];
+
+        _lfg_ct_console_printf("***   %lu.%03lu / %lu.%03lu / %lu.%03lu / %lu.%03lu",
+                (unsigned long)(b->min_ps / 1000u), (unsigned long)(b->min_ps % 1000u),
+                (unsigned long)(b->median_ps / 1000u), (unsigned long)(b->median_ps % 1000u),
+                (unsigned long)(b->mean_ps / 1000u), (unsigned long)(b->mean_ps % 1000u),
+                (unsigned long)(b->p99_ps / 1000u), (unsigned long)(b->p99_ps % 1000u));
+        if (b->median_mcycles > 0)
+        {
+            _lfg_ct_console_printf(", %lu.%03lu cycles", (unsigned long)(b->median_mcycles / 1000u),
+                    (unsigned long)(b->median_mcycles % 1000u));
+        }
+        _lfg_ct_console_printf("  %s (%u x %lu)\r\n", b->name, b->samples, b->iterations);
+    }
+}
+
+/* Match @p str against a glob supporting '*' (any run) and '?' (any char). */
+static bool _lfg_ct_glob(const char *pattern, const char *str)
+{
+    const char *star = NULL;
+    const char *resume = NULL;
+
+    while (*str)
+    {
+        if ('*' == *pattern)
+        {
+            star = pattern++;
+            resume = str;
+        }
+        else if ('?' == *pattern || *pattern == *str)
+        {
+            pattern++;
+            str++;
+        }
+        else if (star)
+        {
+            /* backtrack: let the last '*' swallow one more character */
+            pattern = star + 1;
+            str = ++resume;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while ('*' == *pattern)
+    {
+        pattern++;
+    }
+    return '\0' == *pattern;
+}
+
+static int _lfg_ct_node_name_cmp(const void *a, const void *b)
+{
+    const lfg_ct_test_node_t *na = *(const lfg_ct_test_node_t *const *)a;
+    const lfg_ct_test_node_t *nb = *(const lfg_ct_test_node_t *const *)b;
+    return strcmp(na->name, nb->name);
+}
+
+/* Match argv[*i] against "--name=value", "--name value" or "-s value". Returns
+ * the value (advancing *i past a separate value argument) or NULL. */
+static const char *_lfg_ct_option(int argc, char *argv[], int *i, const char *long_name, const char *short_name)
+{
+    const char *arg = argv[*i];
+    size_t n = strlen(long_name);
+
+    if (0 == strncmp(arg, long_name, n) && '=' == arg[n])
+    {
+        return arg + n + 1;
+    }
+    if ((0 == strcmp(arg, long_name) || (short_name && 0 == strcmp(arg, short_name))) && *i + 1 < argc)
+    {
+        return argv[++*i];
+    }
+    return NULL;
+}
+
+/* Time stamp counter where one is available, 0 elsewhere. */
+static uint64_t _lfg_ct_cycles(void)
+{
+#ifdef LFG_CT_HAS_CYCLES
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* Run @p fn @p iterations times; return elapsed wall ns and store elapsed cycles. */
+static uint64_t _lfg_ct_bench_sample(void (*fn)(void), unsigned long iterations, uint64_t *cycles)
+{
+    unsigned long i;
+    uint64_t c0 = _lfg_ct_cycles();
+    uint64_t t0 = _lfg_ct_wall_ns();
+
+    for (i = 0; i < iterations; i++)
+    {
+        fn();
+    }
+    *cycles = _lfg_ct_cycles() - c0;
+    return _lfg_ct_wall_ns() - t0;
+}
+
+/* Wait for every outstanding worker so the counters are complete. */
+static void _lfg_ct_drain(void)
+{
+#ifdef LFG_CTEST_HAS_FORK
+    while (_workers_active > 0)
+    {
+        _lfg_ct_reap_one();
+    }
+#endif
+}
+
+#ifdef LFG_CTEST_HAS_FORK
+
+/* Run one test in a forked worker. Blocks while all job slots are busy. If a
+ * pipe or process cannot be created the test runs in-process instead. */
+static void _lfg_ct_spawn(void (*fn)(void), const char *name, unsigned timeout_ms)
+{
+    int fds[2];
+    uint64_t start_ns;
+    pid_t pid;
+
+    while (_workers_active > 0 && _workers_active >= _jobs)
+    {
+        _lfg_ct_reap_one();
+    }
+
+    /* anything still buffered would otherwise be printed again by the child */
+    lfg_ct_report_flush();
+    fflush(stderr);
+
+    if (pipe(fds) != 0)
+    {
+        _lfg_ct_run(fn, name, timeout_ms);
+        return;
+    }
+
+    start_ns = _lfg_ct_wall_ns();
+    pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        _lfg_ct_run(fn, name, timeout_ms);
+        return;
+    }
+
+    if (0 == pid)
+    {
+        /* Child: start from zero so the parent can add the result as-is */
+        struct _lfg_ct_result r;
+        struct _lfg_ct_watch saved;
+        const char *p = (const char *)&r;
+        size_t left = sizeof(r);
+        uint64_t cpu0 = _lfg_ct_cpu_ns();
+
+        close(fds[0]);
+        _jobs = 0; /* nested lfg_ctest() calls run in this process */
+        _isolate = false;
+        _in_worker = true;
+        _workers_active = 0;
+        lfg_ct_counters.assertions_executed = 0;
+        _assertions_failed = 0;
+        lfg_ct_counters.assertions_passed = 0;
+        _current_test_failures = 0;
+        _tests_executed = 0;
+        _tests_failed = 0;
+        _tests_passed = 0;
+        _test_depth = 1;
+#ifdef LFG_CTEST_SELF_TEST
+        _expected_failures_count = 0;
+#endif
+        _running_name = name;
+        _running_start_ns = start_ns;
+
+        _lfg_ct_watch_begin("test", name, timeout_ms, &saved);
+        fn();
+        _lfg_ct_watch_end(&saved);
+
+        memset(&r, 0, sizeof(r));
+#ifdef LFG_CTEST_SELF_TEST
+        r.expected_failures = _expected_failures_count;
+#endif
+        r.assertions_executed = lfg_ct_counters.assertions_executed;
+        r.assertions_failed = _assertions_failed;
+        r.assertions_passed = lfg_ct_counters.assertions_passed;
+        r.test_failures = _current_test_failures;
+        r.nested_executed = _tests_executed;
+        r.nested_failed = _tests_failed;
+        r.nested_passed = _tests_passed;
+        r.wall_ns = _lfg_ct_wall_ns() - start_ns;
+        r.cpu_ns = _lfg_ct_cpu_ns() - cpu0;
+        lfg_ct_report_flush();
+        fflush(stderr);
+        while (left > 0)
+        {
+            ssize_t n = write(fds[1], p, left);
+            if (n < 0 && EINTR == errno)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                _exit(1);
+            }
+            p += n;
+            left -= (size_t)n;
+        }
+        _exit(0);
+    }
+
+    close(fds[1]);
+    _workers[_workers_active].pid = pid;
+    _workers[_workers_active].fd = fds[0];
+    _workers[_workers_active].name = name;
+    _workers[_workers_active].start_ns = start_ns;
+    _workers[_workers_active].timeout_ms = timeout_ms;
+    _workers_active++;
+}
+
+/* Block until some worker finishes, then merge its result. A worker whose
+ * result is missing (crash, abort, _exit) counts as a failed test. */
+static void _lfg_ct_reap_one(void)
+{
+    struct pollfd pfds[LFG_CT_JOBS_MAX];
+    struct _lfg_ct_worker w;
+    struct _lfg_ct_result r;
+    char reason[64];
+    char *p = (char *)&r;
+    size_t got = 0;
+    unsigned i;
+    int status = 0;
+
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    _lfg_ct_watch_pause();
+#endif
+    for (i = 0; i < _workers_active; i++)
+    {
+        pfds[i].fd = _workers[i].fd;
+        pfds[i].events = POLLIN;
+        pfds[i].revents = 0;
+    }
+    while (poll(pfds, _workers_active, -1) < 0 && EINTR == errno)
+    {
+    }
+    for (i = 0; i < _workers_active && 0 == pfds[i].revents; i++)
+    {
+    }
+    if (i == _workers_active)
+    {
+        i = 0; /* poll failed outright: block on the oldest worker */
+    }
+
+    w = _workers[i];
+    _workers[i] = _workers[--_workers_active];
+
+    while (got < sizeof(r))
+    {
+        ssize_t n = read(w.fd, p + got, sizeof(r) - got);
+        if (n < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        got += (size_t)n;
+    }
+    close(w.fd);
+    while (waitpid(w.pid, &status, 0) < 0 && EINTR == errno)
+    {
+    }
+
+    _tests_executed++;
+    if (got == sizeof(r) && WIFEXITED(status) && 0 == WEXITSTATUS(status))
+    {
+        lfg_ct_counters.assertions_executed += r.assertions_executed;
+        _assertions_failed += r.assertions_failed;
+        lfg_ct_counters.assertions_passed += r.assertions_passed;
+        _tests_executed += r.nested_executed;
+        _tests_failed += r.nested_failed;
+        _tests_passed += r.nested_passed;
+        _current_suite_failures += r.nested_failed;
+#ifdef LFG_CTEST_SELF_TEST
+        _expected_failures_count += r.expected_failures;
+#endif
+        _lfg_ct_test_finished(w.name, r.test_failures, r.wall_ns, r.cpu_ns, NULL);
+#ifdef LFG_CTEST_HAS_WATCHDOG
+        _lfg_ct_watch_resume();
+#endif
+        return;
+    }
+
+    if (WIFSIGNALED(status))
+    {
+        snprintf(reason, sizeof(reason), "killed by %s", _lfg_ct_signal_name(WTERMSIG(status)));
+    }
+    else if (WIFEXITED(status) && _LFG_CT_TIMEOUT_STATUS == WEXITSTATUS(status))
+    {
+        snprintf(reason, sizeof(reason), "timed out");
+        if (w.timeout_ms > 0 && (0 == _watch.deadline_ns || _lfg_ct_wall_ns() < _watch.deadline_ns))
+        {
+            /* the test's own budget; an enclosing one is reported by _lfg_ct_watch_resume() */
+            lfg_ct_event_t ev;
+
+            memset(&ev, 0, sizeof(ev));
+            ev.type = LFG_CT_EVENT_TIMEOUT;
+            ev.name = w.name;
+            ev.message = "test";
+            ev.wall_ns = (uint64_t)w.timeout_ms * 1000000u;
+            _lfg_ct_emit(&ev);
+        }
+    }
+    else
+    {
+        snprintf(reason, sizeof(reason), "worker exited abnormally (status %d)",
+                WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+    }
+    _lfg_ct_test_finished(w.name, 1, _lfg_ct_wall_ns() - w.start_ns, 0, reason);
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    _lfg_ct_watch_resume();
+#endif
+}
+
+/* Name of a signal that ended a worker, e.g. "SIGSEGV (segmentation fault)". */
+static const char *_lfg_ct_signal_name(int sig)
+{
+    static const struct
+    {
+        int sig;
+        const char *name;
+    } names[] = {
+        {SIGSEGV, "SIGSEGV (segmentation fault)"},
+        {SIGABRT, "SIGABRT (abort, e.g. a failed assert())"},
+        {SIGBUS, "SIGBUS (bus error)"},
+        {SIGFPE, "SIGFPE (arithmetic exception)"},
+        {SIGILL, "SIGILL (illegal instruction)"},
+        {SIGTRAP, "SIGTRAP (trace/breakpoint trap)"},
+        {SIGPIPE, "SIGPIPE (broken pipe)"},
+        {SIGALRM, "SIGALRM (alarm clock)"},
+        {SIGTERM, "SIGTERM (terminated)"},
+        {SIGKILL, "SIGKILL (killed)"},
+        {SIGINT, "SIGINT (interrupted)"},
+    };
+    static char unknown[32];
+    unsigned i;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if (names[i].sig == sig)
+        {
+            return names[i].name;
+        }
+    }
+    snprintf(unknown, sizeof(unknown), "signal %d", sig);
+    return unknown;
+}
+
+#endif /* LFG_CTEST_HAS_FORK */
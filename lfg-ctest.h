@@ -53,81 +53,91 @@
 #define LFG_CT_FUNCTION "(unknown)"
 #endif
 
+/** Selects the assertion entry point. With LFG_CTEST_INLINE_ASSERTS the scalar
+ *  assertions go through the header-inline lfg_ct_fast_* helpers below, which
+ *  only call the out-of-line implementation when the check fails.
+ */
+#ifdef LFG_CTEST_INLINE_ASSERTS
+#define _LFG_CT_ASSERT(_name) lfg_ct_fast_##_name
+#else
+#define _LFG_CT_ASSERT(_name) lfg_ct_assert_##_name
+#endif
+
 /** Execute a test or suite of tests.
  */
-#define ASSERT_FALSE(_cond) lfg_ct_assert_false_impl((_cond), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_cond))
+#define ASSERT_FALSE(_cond) _LFG_CT_ASSERT(false_impl)((_cond), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_cond))
 
-#define ASSERT_TRUE(_cond) lfg_ct_assert_true_impl((_cond), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_cond))
+#define ASSERT_TRUE(_cond) _LFG_CT_ASSERT(true_impl)((_cond), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_cond))
 
 #define ASSERT_INT_EQUAL(_e, _a)                                                                                       \
-    lfg_ct_assert_int_equal_impl((int)(_e), (int)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int_equal_impl)((int)(_e), (int)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_INT_NOT_EQUAL(_e, _a)                                                                                   \
-    lfg_ct_assert_int_not_equal_impl((int)(_e), (int)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int_not_equal_impl)((int)(_e), (int)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT_EQUAL(_e, _a)                                                                                      \
-    lfg_ct_assert_uint_equal_impl((unsigned)(_e), (unsigned)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint_equal_impl)((unsigned)(_e), (unsigned)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT_NOT_EQUAL(_e, _a)                                                                                  \
-    lfg_ct_assert_uint_not_equal_impl((unsigned)(_e), (unsigned)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint_not_equal_impl)((unsigned)(_e), (unsigned)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT8_EQUAL(_e, _a)                                                                                     \
-    lfg_ct_assert_uint8_equal_impl((uint8_t)(_e), (uint8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint8_equal_impl)((uint8_t)(_e), (uint8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT8_NOT_EQUAL(_e, _a)                                                                                 \
-    lfg_ct_assert_uint8_not_equal_impl((uint8_t)(_e), (uint8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint8_not_equal_impl)((uint8_t)(_e), (uint8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT16_EQUAL(_e, _a)                                                                                    \
-    lfg_ct_assert_uint16_equal_impl((uint16_t)(_e), (uint16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint16_equal_impl)((uint16_t)(_e), (uint16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT16_NOT_EQUAL(_e, _a)                                                                                \
-    lfg_ct_assert_uint16_not_equal_impl((uint16_t)(_e), (uint16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint16_not_equal_impl)((uint16_t)(_e), (uint16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT32_EQUAL(_e, _a)                                                                                    \
-    lfg_ct_assert_uint32_equal_impl((uint32_t)(_e), (uint32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint32_equal_impl)((uint32_t)(_e), (uint32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT32_NOT_EQUAL(_e, _a)                                                                                \
-    lfg_ct_assert_uint32_not_equal_impl((uint32_t)(_e), (uint32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint32_not_equal_impl)((uint32_t)(_e), (uint32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_PTR_EQUAL(_e, _a)                                                                                       \
-    lfg_ct_assert_ptr_equal_impl((void *)(_e), (void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(ptr_equal_impl)((void *)(_e), (void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_PTR_NOT_EQUAL(_e, _a)                                                                                   \
-    lfg_ct_assert_ptr_not_equal_impl((void *)(_e), (void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(ptr_not_equal_impl)((void *)(_e), (void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
-#define ASSERT_PTR_NOT_NULL(_a) lfg_ct_assert_ptr_not_null((void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+#define ASSERT_PTR_NOT_NULL(_a) _LFG_CT_ASSERT(ptr_not_null)((void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
-#define ASSERT_PTR_NULL(_a) lfg_ct_assert_ptr_null((void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+#define ASSERT_PTR_NULL(_a) _LFG_CT_ASSERT(ptr_null)((void *)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_INT8_EQUAL(_e, _a)                                                                                      \
-    lfg_ct_assert_int8_equal_impl((int8_t)(_e), (int8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int8_equal_impl)((int8_t)(_e), (int8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_INT8_NOT_EQUAL(_e, _a)                                                                                  \
-    lfg_ct_assert_int8_not_equal_impl((int8_t)(_e), (int8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int8_not_equal_impl)((int8_t)(_e), (int8_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_INT16_EQUAL(_e, _a)                                                                                     \
-    lfg_ct_assert_int16_equal_impl((int16_t)(_e), (int16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int16_equal_impl)((int16_t)(_e), (int16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_INT16_NOT_EQUAL(_e, _a)                                                                                 \
-    lfg_ct_assert_int16_not_equal_impl((int16_t)(_e), (int16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int16_not_equal_impl)((int16_t)(_e), (int16_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_INT32_EQUAL(_e, _a)                                                                                     \
-    lfg_ct_assert_int32_equal_impl((int32_t)(_e), (int32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int32_equal_impl)((int32_t)(_e), (int32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_INT32_NOT_EQUAL(_e, _a)                                                                                 \
-    lfg_ct_assert_int32_not_equal_impl((int32_t)(_e), (int32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int32_not_equal_impl)((int32_t)(_e), (int32_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_INT64_EQUAL(_e, _a)                                                                                     \
-    lfg_ct_assert_int64_equal_impl((int64_t)(_e), (int64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int64_equal_impl)((int64_t)(_e), (int64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_INT64_NOT_EQUAL(_e, _a)                                                                                 \
-    lfg_ct_assert_int64_not_equal_impl((int64_t)(_e), (int64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(int64_not_equal_impl)((int64_t)(_e), (int64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT64_EQUAL(_e, _a)                                                                                    \
-    lfg_ct_assert_uint64_equal_impl((uint64_t)(_e), (uint64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint64_equal_impl)((uint64_t)(_e), (uint64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_UINT64_NOT_EQUAL(_e, _a)                                                                                \
-    lfg_ct_assert_uint64_not_equal_impl((uint64_t)(_e), (uint64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+    _LFG_CT_ASSERT(uint64_not_equal_impl)((uint64_t)(_e), (uint64_t)(_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
 #define ASSERT_STR_EQUAL(_e, _a) lfg_ct_assert_str_equal_impl((_e), (_a), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
@@ -143,32 +153,58 @@
 #define ASSERT_MEM_NOT_EQUAL(_e, _a, _n)                                                                               \
     lfg_ct_assert_mem_not_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
+/** Assert @p _n elements of two fixed-width integer arrays are equal. Counts as one assertion;
+ *  a failure lists the first LFG_CT_ARRAY_DIFF_MAX mismatching indices. */
+#define ASSERT_INT8_ARRAY_EQUAL(_e, _a, _n)                                                                            \
+    lfg_ct_assert_int8_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT16_ARRAY_EQUAL(_e, _a, _n)                                                                           \
+    lfg_ct_assert_int16_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT32_ARRAY_EQUAL(_e, _a, _n)                                                                           \
+    lfg_ct_assert_int32_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_INT64_ARRAY_EQUAL(_e, _a, _n)                                                                           \
+    lfg_ct_assert_int64_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT8_ARRAY_EQUAL(_e, _a, _n)                                                                           \
+    lfg_ct_assert_uint8_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT16_ARRAY_EQUAL(_e, _a, _n)                                                                          \
+    lfg_ct_assert_uint16_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT32_ARRAY_EQUAL(_e, _a, _n)                                                                          \
+    lfg_ct_assert_uint32_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+#define ASSERT_UINT64_ARRAY_EQUAL(_e, _a, _n)                                                                          \
+    lfg_ct_assert_uint64_array_equal_impl((_e), (_a), (_n), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
 #define ASSERT_GREATER_THAN(_a, _b)                                                                                    \
-    lfg_ct_assert_greater_than_impl((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+    _LFG_CT_ASSERT(greater_than_impl)((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
 
 #define ASSERT_LESS_THAN(_a, _b)                                                                                       \
-    lfg_ct_assert_less_than_impl((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+    _LFG_CT_ASSERT(less_than_impl)((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
 
 #define ASSERT_GREATER_OR_EQUAL(_a, _b)                                                                                \
-    lfg_ct_assert_greater_or_equal_impl((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+    _LFG_CT_ASSERT(greater_or_equal_impl)((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
 
 #define ASSERT_LESS_OR_EQUAL(_a, _b)                                                                                   \
-    lfg_ct_assert_less_or_equal_impl((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
+    _LFG_CT_ASSERT(less_or_equal_impl)((int)(_a), (int)(_b), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a), STR(_b))
 
 #define ASSERT_IN_RANGE(_val, _min, _max)                                                                              \
-    lfg_ct_assert_in_range_impl((int)(_val), (int)(_min), (int)(_max), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val))
+    _LFG_CT_ASSERT(in_range_impl)((int)(_val), (int)(_min), (int)(_max), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val))
 
 #define ASSERT_BIT_SET(_val, _bit)                                                                                     \
-    lfg_ct_assert_bit_set_impl((unsigned)(_val), (_bit), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_bit))
+    _LFG_CT_ASSERT(bit_set_impl)((unsigned)(_val), (_bit), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_bit))
 
 #define ASSERT_BIT_CLEAR(_val, _bit)                                                                                   \
-    lfg_ct_assert_bit_clear_impl((unsigned)(_val), (_bit), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_bit))
+    _LFG_CT_ASSERT(bit_clear_impl)((unsigned)(_val), (_bit), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_bit))
 
 #define ASSERT_BITS_SET(_val, _mask)                                                                                   \
-    lfg_ct_assert_bits_set_impl((unsigned)(_val), (_mask), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_mask))
+    _LFG_CT_ASSERT(bits_set_impl)((unsigned)(_val), (_mask), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_mask))
 
 #define ASSERT_BITS_CLEAR(_val, _mask)                                                                                 \
-    lfg_ct_assert_bits_clear_impl((unsigned)(_val), (_mask), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_mask))
+    _LFG_CT_ASSERT(bits_clear_impl)((unsigned)(_val), (_mask), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val), (_mask))
 
 #define ASSERT_FAIL(_msg) lfg_ct_assert_fail_impl(__FILE__, __LINE__, LFG_CT_FUNCTION, (_msg))
 
@@ -213,6 +249,15 @@
     lfg_ct_assert_float_in_range_impl(                                                                                 \
             (float)(_val), (float)(_min), (float)(_max), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_val))
 
+/** Assert @p _n float elements are each equal within absolute epsilon (one assertion) */
+#define ASSERT_FLOAT_ARRAY_EQUAL(_e, _a, _n, _eps)                                                                     \
+    lfg_ct_assert_float_array_equal_impl((_e), (_a), (_n), (float)(_eps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/** Assert @p _n float elements are each at most @p _ulps representable values apart (one assertion) */
+#define ASSERT_FLOAT_ARRAY_EQUAL_ULP(_e, _a, _n, _ulps)                                                                \
+    lfg_ct_assert_float_array_equal_ulp_impl(                                                                          \
+            (_e), (_a), (_n), (uint64_t)(_ulps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
 /* Shorthand aliases for float assertions */
 #define ASSERT_FLT_EQ(_e, _a, _eps) ASSERT_FLOAT_EQUAL(_e, _a, _eps)
 #define ASSERT_FLT_NE(_e, _a, _eps) ASSERT_FLOAT_NOT_EQUAL(_e, _a, _eps)
@@ -244,6 +289,16 @@
     lfg_ct_assert_double_not_equal_impl(                                                                               \
             (double)(_e), (double)(_a), (double)(_eps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
 
+/** Assert @p _n double elements are each equal within absolute epsilon (one assertion) */
+#define ASSERT_DOUBLE_ARRAY_EQUAL(_e, _a, _n, _eps)                                                                    \
+    lfg_ct_assert_double_array_equal_impl(                                                                             \
+            (_e), (_a), (_n), (double)(_eps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
+/** Assert @p _n double elements are each at most @p _ulps representable values apart (one assertion) */
+#define ASSERT_DOUBLE_ARRAY_EQUAL_ULP(_e, _a, _n, _ulps)                                                               \
+    lfg_ct_assert_double_array_equal_ulp_impl(                                                                         \
+            (_e), (_a), (_n), (uint64_t)(_ulps), __FILE__, __LINE__, LFG_CT_FUNCTION, STR(_a))
+
 /* Shorthand aliases for double assertions */
 #define ASSERT_DBL_EQ(_e, _a, _eps) ASSERT_DOUBLE_EQUAL(_e, _a, _eps)
 #define ASSERT_DBL_NE(_e, _a, _eps) ASSERT_DOUBLE_NOT_EQUAL(_e, _a, _eps)
@@ -264,6 +319,160 @@
 
 #define lfg_ctest(_test) lfg_ct_impl(_test, #_test)
 
+#define lfg_ct_bench(_fn) lfg_ct_bench_impl(_fn, #_fn)
+
+/* Run a test or suite with its own time budget in milliseconds */
+#define lfg_ctest_timeout(_test, _ms)                                                                                  \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        lfg_ct_timeout_next(_ms);                                                                                      \
+        lfg_ct_impl(_test, #_test);                                                                                    \
+    } while (0)
+
+#define lfg_ct_suite_timeout(_suite, _ms)                                                                              \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        lfg_ct_timeout_next(_ms);                                                                                      \
+        lfg_ct_suite_impl(_suite, #_suite);                                                                            \
+    } while (0)
+
+/*============================================================================
+ *  Test Registration
+ *
+ *  LFG_CT_TEST(name) defines a test function and adds it to a static registry
+ *  before main() runs, so lfg_ct_main() can list, filter and order tests
+ *  without hand-written suites:
+ *
+ *      LFG_CT_TEST(test_parse_empty)
+ *      {
+ *          ASSERT_INT_EQUAL(0, parse(""));
+ *      }
+ *
+ *      int main(int argc, char *argv[])
+ *      {
+ *          return lfg_ct_main(argc, argv);
+ *      }
+ *
+ *  GCC/Clang use a constructor function and MSVC a .CRT$XCU initializer; both
+ *  define LFG_CT_HAS_AUTO_REGISTER. Other compilers must list each test with
+ *  LFG_CT_REGISTER(name) before calling lfg_ct_main(). LFG_CT_REGISTER is
+ *  harmless where registration is automatic.
+ *==========================================================================*/
+
+/** Registry entry created by LFG_CT_TEST(). */
+typedef struct lfg_ct_test_node
+{
+    const char *name;
+    void (*fn)(void);
+    const char *file;
+    int line;
+    struct lfg_ct_test_node *next;
+    bool registered;
+} lfg_ct_test_node_t;
+
+#define _LFG_CT_TEST_NODE(_name)                                                                                       \
+    static void _name(void);                                                                                           \
+    static lfg_ct_test_node_t _name##__lfg_ct_node = {#_name, _name, __FILE__, __LINE__, NULL, false}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LFG_CT_HAS_AUTO_REGISTER 1
+#define LFG_CT_TEST(_name)                                                                                             \
+    _LFG_CT_TEST_NODE(_name);                                                                                          \
+    __attribute__((constructor)) static void _name##__lfg_ct_register(void)                                            \
+    {                                                                                                                  \
+        lfg_ct_register(&_name##__lfg_ct_node);                                                                        \
+    }                                                                                                                  \
+    static void _name(void)
+#elif defined(_MSC_VER)
+#define LFG_CT_HAS_AUTO_REGISTER 1
+#define LFG_CT_TEST(_name)                                                                                             \
+    _LFG_CT_TEST_NODE(_name);                                                                                          \
+    static void __cdecl _name##__lfg_ct_register(void)                                                                 \
+    {                                                                                                                  \
+        lfg_ct_register(&_name##__lfg_ct_node);                                                                        \
+    }                                                                                                                  \
+    __pragma(section(".CRT$XCU", read)) __declspec(allocate(".CRT$XCU")) void(__cdecl * _name##__lfg_ct_ctor)(void) =  \
+            _name##__lfg_ct_register;                                                                                  \
+    static void _name(void)
+#else
+#define LFG_CT_TEST(_name)                                                                                             \
+    _LFG_CT_TEST_NODE(_name);                                                                                          \
+    static void _name(void)
+#endif
+
+#define LFG_CT_REGISTER(_name) lfg_ct_register(&_name##__lfg_ct_node)
+
+/*============================================================================
+ *  Reporter Types
+ *==========================================================================*/
+
+/** Kinds of event delivered to reporters. */
+typedef enum
+{
+    LFG_CT_EVENT_START,     /* lfg_ct_start(); seed is valid */
+    LFG_CT_EVENT_FAILURE,   /* an assertion failed; file/line/function/message are valid */
+    LFG_CT_EVENT_TEST_END,  /* a test finished; name/failures/wall_ns/cpu_ns, message on crash */
+    LFG_CT_EVENT_SUITE_END, /* a suite finished; name/failures (failed tests)/wall_ns/cpu_ns */
+    LFG_CT_EVENT_SUMMARY,   /* lfg_ct_print_summary(); run totals, slowest and benchmark tables */
+    LFG_CT_EVENT_BENCH,     /* a benchmark finished; name/bench are valid */
+    LFG_CT_EVENT_TIMEOUT,   /* a time budget ran out; name, message ("test" or "suite"), wall_ns = budget */
+} lfg_ct_event_type_t;
+
+/** One entry of a slowest-tests or slowest-suites table. */
+typedef struct
+{
+    const char *name;
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+} lfg_ct_timing_t;
+
+/** Result of one lfg_ct_bench() run. Per-op figures are in picoseconds
+ *  (divide by 1000 for ns) so operations faster than 1 ns keep precision.
+ */
+typedef struct
+{
+    const char *name;
+    unsigned long iterations; /* calls per sample, found by calibration */
+    unsigned samples;         /* timed samples taken */
+    uint64_t min_ps;
+    uint64_t median_ps;
+    uint64_t mean_ps;
+    uint64_t p99_ps;
+    uint64_t median_mcycles; /* median CPU cycles per op x1000; 0 without a cycle counter */
+} lfg_ct_bench_result_t;
+
+/** Event passed to reporters. Fields not listed for an event type are zero.
+ *  Strings are only valid for the duration of the callback.
+ */
+typedef struct
+{
+    lfg_ct_event_type_t type;
+    const char *name;        /* test or suite name */
+    const char *file;        /* failing assertion's source file */
+    int line;                /* failing assertion's source line */
+    const char *function;    /* function containing the failing assertion */
+    const char *message;     /* failure text, or why a test failed without one */
+    int failures;            /* failed assertions (test), failed tests (suite, summary) */
+    unsigned seed;           /* random seed */
+    int assertions_executed; /* summary only */
+    int tests_executed;      /* summary only */
+    uint64_t wall_ns;        /* test/suite wall time; summed test wall time for the summary */
+    uint64_t cpu_ns;         /* test/suite CPU time; summed test CPU time for the summary */
+    uint64_t elapsed_ns;     /* summary only: wall time since lfg_ct_start() */
+    const lfg_ct_timing_t *slowest_tests;
+    unsigned slowest_tests_count;
+    const lfg_ct_timing_t *slowest_suites;
+    unsigned slowest_suites_count;
+    const lfg_ct_bench_result_t *bench; /* the finished benchmark, or the results table (summary) */
+    unsigned bench_count;               /* summary only: entries in bench */
+    int tests_skipped;                  /* summary only: tests left to other shards */
+    unsigned shard_index;               /* start and summary */
+    unsigned shard_count;               /* start and summary; 1 when not sharded */
+} lfg_ct_event_t;
+
+/** Reporter callback. @p ctx is the pointer given to lfg_ct_reporter_add(). */
+typedef void (*lfg_ct_reporter_fn)(const lfg_ct_event_t *event, void *ctx);
+
 /*============================================================================
  *  Public API
  *==========================================================================*/
@@ -282,10 +491,91 @@ void lfg_ct_start(void);
  */
 void lfg_ct_end(void);
 
+/** Run subsequent tests in up to @p jobs forked worker processes.
+ *  Each lfg_ctest() call becomes one worker; its assertion counters are sent
+ *  back to the parent over a pipe and a worker that crashes counts as a failed
+ *  test. Output from concurrent workers may interleave. Outstanding workers
+ *  are always drained at the end of each suite, and before printing the
+ *  summary or returning. A value of 0 or 1 restores in-process execution.
+ *  No-op unless built with LFG_CTEST_HAS_FORK.
+ *  @param jobs Maximum number of concurrent workers (clamped to LFG_CT_JOBS_MAX).
+ */
+void lfg_ct_parallel(unsigned jobs);
+
+/** Run each subsequent test in its own forked child, one at a time, so a
+ *  crash, abort or _exit() in one test is reported as that test's failure
+ *  (naming the signal) and the run carries on. Counters come back to the
+ *  parent the same way as with lfg_ct_parallel(), which takes precedence
+ *  when it asks for more than one job. No-op unless built with
+ *  LFG_CTEST_HAS_FORK.
+ *  @param enable true to isolate tests, false to run them in-process again.
+ */
+void lfg_ct_isolate(bool enable);
+
+/** Set the default time budgets. When a test or suite runs past its budget
+ *  the runner reports it as timed out and prints a backtrace of where it is
+ *  stuck (with LFG_CTEST_HAS_BACKTRACE). A test isolated in a worker (see
+ *  lfg_ct_isolate() and lfg_ct_parallel()) fails and the run continues.
+ *  Otherwise the running test fails, a summary line is printed and the
+ *  process exits with status 1. A test's budget is measured inside its
+ *  suite's, and whichever ends first fires. The previous SIGALRM action is
+ *  restored once no budget is active.
+ *  No-op unless built with LFG_CTEST_HAS_WATCHDOG.
+ *  @param test_ms  Budget for each test in milliseconds, 0 for none (default).
+ *  @param suite_ms Budget for each suite in milliseconds, 0 for none (default).
+ */
+void lfg_ct_set_timeout_ms(unsigned test_ms, unsigned suite_ms);
+
+/** Override the budget of the next test or suite started (used by
+ *  lfg_ctest_timeout() and lfg_ct_suite_timeout()).
+ *  @param ms Budget in milliseconds, 0 for none.
+ */
+void lfg_ct_timeout_next(unsigned ms);
+
+/** Set how many of the slowest tests and suites lfg_ct_print_summary() lists.
+ *  Every test and suite is timed (monotonic wall time and process CPU time);
+ *  this only controls the report. Defaults to 5; 0 disables the listing.
+ *  @param n Number of entries to print (clamped to LFG_CT_SLOWEST_MAX).
+ */
+void lfg_ct_set_report_slowest(unsigned n);
+
+/** Register a reporter that receives every event after the console reporter.
+ *  Registering the same fn/ctx pair twice has no effect. Reporters registered
+ *  before lfg_ct_parallel() workers are forked are also called inside them.
+ *  @param fn  Callback.
+ *  @param ctx Passed through to @p fn.
+ *  @return 0 on success, -1 if @p fn is NULL or LFG_CT_REPORTERS_MAX is reached.
+ */
+int lfg_ct_reporter_add(lfg_ct_reporter_fn fn, void *ctx);
+
+/** Unregister a reporter added with lfg_ct_reporter_add().
+ */
+void lfg_ct_reporter_remove(lfg_ct_reporter_fn fn, void *ctx);
+
+/** Enable or disable the built-in console reporter (enabled by default).
+ */
+void lfg_ct_reporter_console(bool enable);
+
+/** Write out any console output still held in the batch buffer. The buffer is
+ *  flushed automatically at the end of every test and suite and by the summary.
+ */
+void lfg_ct_report_flush(void);
+
 /** Execute a suite of tests.
  */
 void lfg_ct_suite_impl(void (*fn)(void), const char *name);
 
+/** Benchmark a function. Calibrates the number of calls per sample until one
+ *  sample takes about LFG_CT_BENCH_SAMPLE_NS, runs a warmup sample, then takes
+ *  LFG_CT_BENCH_SAMPLES timed samples with CLOCK_MONOTONIC (and the CPU cycle
+ *  counter on x86). min/median/mean/p99 ns per call are listed by
+ *  lfg_ct_print_summary(). Always runs in-process, after draining any
+ *  lfg_ct_parallel() workers.
+ *  @param fn   Function performing one operation.
+ *  @param name Name shown in the report.
+ */
+void lfg_ct_bench_impl(void (*fn)(void), const char *name);
+
 /** Execute a single unit test.
  */
 void lfg_ct_impl(void (*fn)(void), const char *name);
@@ -303,6 +593,45 @@ void lfg_ct_print_summary(void);
  */
 int lfg_ct_return(void);
 
+/** Run only every @p count-th top-level test, starting at @p index. Tests are
+ *  assigned round-robin in the order lfg_ctest() is called (declaration order
+ *  under lfg_ct_main()), so shards of the same binary never overlap and
+ *  together cover every test. Overrides the LFG_CT_SHARD_INDEX and
+ *  LFG_CT_SHARD_COUNT environment variables, which lfg_ct_start() reads.
+ *  @return 0, or -1 if @p count is 0 or @p index >= @p count.
+ */
+int lfg_ct_set_shard(unsigned index, unsigned count);
+
+/** Write the run totals as key=value lines to @p path when the summary is
+ *  printed (NULL disables). Defaults to the LFG_CT_RESULT_FILE environment
+ *  variable. @p path must stay valid until then.
+ */
+void lfg_ct_set_result_file(const char *path);
+
+/** Add a test to the registry. Called by LFG_CT_TEST() / LFG_CT_REGISTER();
+ *  a node that is already registered is ignored. Tests keep registration
+ *  order, which is the default run order.
+ */
+void lfg_ct_register(lfg_ct_test_node_t *node);
+
+/** Run the registered tests, driven by command-line options:
+ *      --list              print the selected test names and exit
+ *      --filter=GLOB       run only tests whose name matches GLOB ('*' and
+ *                          '?' wildcards); may be repeated, matches are OR'ed
+ *      --order=ORDER       declaration (default), name, or random (seeded by
+ *                          lfg_ct_start())
+ *      -j N, --jobs=N      run tests in N worker processes (lfg_ct_parallel)
+ *      --isolate           run each test in its own child process (lfg_ct_isolate)
+ *      --shard-index=I     with --shard-count=N, run only shard I of N
+ *      --shard-count=N     (see lfg_ct_set_shard; overrides the environment)
+ *      --result-file=PATH  see lfg_ct_set_result_file
+ *      --timeout=MS        per-test budget (see lfg_ct_set_timeout_ms)
+ *  Calls lfg_ct_start(), runs the tests, prints the summary and calls
+ *  lfg_ct_end().
+ *  @return lfg_ct_return(), or -1 on a usage error.
+ */
+int lfg_ct_main(int argc, char *argv[]);
+
 int lfg_ct_assert_false_impl(
         bool condition, char *filename, int line_no, const char *function, const char *condition_str);
 
@@ -396,6 +725,30 @@ int lfg_ct_assert_mem_equal_impl(const void *expected, const void *actual, size_
 int lfg_ct_assert_mem_not_equal_impl(const void *expected, const void *actual, size_t n, char *filename, int line_no,
         const char *function, const char *actual_expr_str);
 
+int lfg_ct_assert_int8_array_equal_impl(const int8_t *expected, const int8_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int16_array_equal_impl(const int16_t *expected, const int16_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int32_array_equal_impl(const int32_t *expected, const int32_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_int64_array_equal_impl(const int64_t *expected, const int64_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint8_array_equal_impl(const uint8_t *expected, const uint8_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint16_array_equal_impl(const uint16_t *expected, const uint16_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint32_array_equal_impl(const uint32_t *expected, const uint32_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_uint64_array_equal_impl(const uint64_t *expected, const uint64_t *actual, size_t n, char *filename,
+        int line_no, const char *function, const char *actual_expr_str);
+
 int lfg_ct_assert_greater_than_impl(int a, int b, char *filename, int line_no, const char *function,
         const char *a_expr_str, const char *b_expr_str);
 
@@ -452,6 +805,12 @@ int lfg_ct_assert_float_le_impl(float a, float b, const char *filename, int line
 int lfg_ct_assert_float_in_range_impl(float val, float min, float max, const char *filename, int line_no,
         const char *function, const char *val_expr_str);
 
+int lfg_ct_assert_float_array_equal_impl(const float *expected, const float *actual, size_t n, float tolerance,
+        const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_float_array_equal_ulp_impl(const float *expected, const float *actual, size_t n, uint64_t tolerance,
+        const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
 #endif /* LFG_CTEST_HAS_FLOAT */
 
 /*============================================================================
@@ -466,8 +825,194 @@ int lfg_ct_assert_double_equal_impl(double expected, double actual, double epsil
 int lfg_ct_assert_double_not_equal_impl(double expected, double actual, double epsilon, const char *filename,
         int line_no, const char *function, const char *actual_expr_str);
 
+int lfg_ct_assert_double_array_equal_impl(const double *expected, const double *actual, size_t n, double tolerance,
+        const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
+int lfg_ct_assert_double_array_equal_ulp_impl(const double *expected, const double *actual, size_t n,
+        uint64_t tolerance, const char *filename, int line_no, const char *function, const char *actual_expr_str);
+
 #endif /* LFG_CTEST_HAS_DOUBLE */
 
+/*============================================================================
+ *  Inline Assertion Fast Path
+ *
+ *  Define LFG_CTEST_INLINE_ASSERTS before including this header to evaluate
+ *  the scalar assertions (bool, integer, pointer, comparison, range and bit)
+ *  inline. A passing check only bumps lfg_ct_counters; a failing one calls
+ *  the regular lfg_ct_assert_*_impl function, which counts the assertion and
+ *  reports it exactly as the out-of-line path does. String, memory and
+ *  floating-point assertions always take the out-of-line path.
+ *==========================================================================*/
+
+/** Assertion counters shared between lfg-ctest.c and the inline fast path.
+ *  Read them through the summary or a reporter, not directly.
+ */
+typedef struct
+{
+    int assertions_executed;
+    int assertions_passed;
+    int pass_weight; /* 0 while expect-failures mode is active, else 1 */
+} lfg_ct_counters_t;
+
+extern lfg_ct_counters_t lfg_ct_counters;
+
+/** Add to a framework counter. With LFG_CTEST_THREAD_SAFE this is a relaxed
+ *  atomic add, so assertions made from threads spawned by the code under test
+ *  are all counted. Those threads must be joined before the test returns.
+ */
+#ifdef LFG_CTEST_THREAD_SAFE
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "LFG_CTEST_THREAD_SAFE needs the GCC/Clang __atomic builtins"
+#endif
+#define _LFG_CT_COUNT(_var, _n) ((void)__atomic_fetch_add(&(_var), (_n), __ATOMIC_RELAXED))
+#else
+#define _LFG_CT_COUNT(_var, _n) ((void)((_var) += (_n)))
+#endif
+
+#ifdef LFG_CTEST_INLINE_ASSERTS
+
+#if defined(__GNUC__) || defined(__clang__)
+#define _LFG_CT_LIKELY(_x) __builtin_expect(!!(_x), 1)
+#else
+#define _LFG_CT_LIKELY(_x) (_x)
+#endif
+
+#define _LFG_CT_FAST_PASSED()                                                                                          \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_executed, 1);                                                         \
+        _LFG_CT_COUNT(lfg_ct_counters.assertions_passed, lfg_ct_counters.pass_weight);                                 \
+    } while (0)
+
+/* Scalar assertion taking (expected, actual) and the actual expression string. */
+#define _LFG_CT_FAST_PAIR(_name, _type, _pass)                                                                         \
+    static inline int lfg_ct_fast_##_name(_type expected, _type actual, const char *filename, int line_no,             \
+            const char *function, const char *actual_expr_str)                                                         \
+    {                                                                                                                  \
+        if (_LFG_CT_LIKELY(_pass))                                                                                     \
+        {                                                                                                              \
+            _LFG_CT_FAST_PASSED();                                                                                     \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        return lfg_ct_assert_##_name(expected, actual, (char *)filename, line_no, function, actual_expr_str);          \
+    }
+
+/* Ordering assertion taking (a, b) and both expression strings. */
+#define _LFG_CT_FAST_CMP(_name, _pass)                                                                                 \
+    static inline int lfg_ct_fast_##_name(int a, int b, const char *filename, int line_no, const char *function,       \
+            const char *a_str, const char *b_str)                                                                      \
+    {                                                                                                                  \
+        if (_LFG_CT_LIKELY(_pass))                                                                                     \
+        {                                                                                                              \
+            _LFG_CT_FAST_PASSED();                                                                                     \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        return lfg_ct_assert_##_name(a, b, (char *)filename, line_no, function, a_str, b_str);                         \
+    }
+
+/* Bit assertion taking (val, bit-or-mask) plus the literal echoed in the message. */
+#define _LFG_CT_FAST_BITS(_name, _pass)                                                                                \
+    static inline int lfg_ct_fast_##_name(unsigned val, unsigned bits, const char *filename, int line_no,              \
+            const char *function, const char *val_expr_str, unsigned bits_val)                                         \
+    {                                                                                                                  \
+        if (_LFG_CT_LIKELY(_pass))                                                                                     \
+        {                                                                                                              \
+            _LFG_CT_FAST_PASSED();                                                                                     \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+        return lfg_ct_assert_##_name(val, bits, (char *)filename, line_no, function, val_expr_str, bits_val);          \
+    }
+
+static inline int lfg_ct_fast_false_impl(
+        bool condition, const char *filename, int line_no, const char *function, const char *condition_str)
+{
+    if (_LFG_CT_LIKELY(!condition))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_false_impl(condition, (char *)filename, line_no, function, condition_str);
+}
+
+static inline int lfg_ct_fast_true_impl(
+        bool condition, const char *filename, int line_no, const char *function, const char *condition_str)
+{
+    if (_LFG_CT_LIKELY(condition))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_true_impl(condition, (char *)filename, line_no, function, condition_str);
+}
+
+static inline int lfg_ct_fast_ptr_not_null(
+        void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    if (_LFG_CT_LIKELY(actual != NULL))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_ptr_not_null(actual, filename, line_no, function, actual_expr_str);
+}
+
+static inline int lfg_ct_fast_ptr_null(
+        void *actual, const char *filename, int line_no, const char *function, const char *actual_expr_str)
+{
+    if (_LFG_CT_LIKELY(actual == NULL))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_ptr_null(actual, filename, line_no, function, actual_expr_str);
+}
+
+static inline int lfg_ct_fast_in_range_impl(
+        int val, int min, int max, const char *filename, int line_no, const char *function, const char *val_expr_str)
+{
+    if (_LFG_CT_LIKELY(val >= min && val <= max))
+    {
+        _LFG_CT_FAST_PASSED();
+        return 0;
+    }
+    return lfg_ct_assert_in_range_impl(val, min, max, (char *)filename, line_no, function, val_expr_str);
+}
+
+_LFG_CT_FAST_PAIR(int_equal_impl, int, expected == actual)
+_LFG_CT_FAST_PAIR(int_not_equal_impl, int, expected != actual)
+_LFG_CT_FAST_PAIR(uint_equal_impl, unsigned, expected == actual)
+_LFG_CT_FAST_PAIR(uint_not_equal_impl, unsigned, expected != actual)
+_LFG_CT_FAST_PAIR(int8_equal_impl, int8_t, expected == actual)
+_LFG_CT_FAST_PAIR(int8_not_equal_impl, int8_t, expected != actual)
+_LFG_CT_FAST_PAIR(int16_equal_impl, int16_t, expected == actual)
+_LFG_CT_FAST_PAIR(int16_not_equal_impl, int16_t, expected != actual)
+_LFG_CT_FAST_PAIR(int32_equal_impl, int32_t, expected == actual)
+_LFG_CT_FAST_PAIR(int32_not_equal_impl, int32_t, expected != actual)
+_LFG_CT_FAST_PAIR(int64_equal_impl, int64_t, expected == actual)
+_LFG_CT_FAST_PAIR(int64_not_equal_impl, int64_t, expected != actual)
+_LFG_CT_FAST_PAIR(uint8_equal_impl, uint8_t, expected == actual)
+_LFG_CT_FAST_PAIR(uint8_not_equal_impl, uint8_t, expected != actual)
+_LFG_CT_FAST_PAIR(uint16_equal_impl, uint16_t, expected == actual)
+_LFG_CT_FAST_PAIR(uint16_not_equal_impl, uint16_t, expected != actual)
+_LFG_CT_FAST_PAIR(uint32_equal_impl, uint32_t, expected == actual)
+_LFG_CT_FAST_PAIR(uint32_not_equal_impl, uint32_t, expected != actual)
+_LFG_CT_FAST_PAIR(uint64_equal_impl, uint64_t, expected == actual)
+_LFG_CT_FAST_PAIR(uint64_not_equal_impl, uint64_t, expected != actual)
+_LFG_CT_FAST_PAIR(ptr_equal_impl, void *, expected == actual)
+_LFG_CT_FAST_PAIR(ptr_not_equal_impl, void *, expected != actual)
+
+_LFG_CT_FAST_CMP(greater_than_impl, a > b)
+_LFG_CT_FAST_CMP(less_than_impl, a < b)
+_LFG_CT_FAST_CMP(greater_or_equal_impl, a >= b)
+_LFG_CT_FAST_CMP(less_or_equal_impl, a <= b)
+
+_LFG_CT_FAST_BITS(bit_set_impl, val & (1u << bits))
+_LFG_CT_FAST_BITS(bit_clear_impl, !(val & (1u << bits)))
+_LFG_CT_FAST_BITS(bits_set_impl, (val & bits) == bits)
+_LFG_CT_FAST_BITS(bits_clear_impl, !(val & bits))
+
+#endif /* LFG_CTEST_INLINE_ASSERTS */
+
 /*============================================================================
  *  Self-Test API (internal only - requires LFG_CTEST_SELF_TEST)
  *
@@ -489,6 +1034,25 @@ void lfg_ct_expect_failures_begin(void);
  */
 int lfg_ct_expect_failures_end(void);
 
+/** Snapshot of the framework counters. */
+typedef struct
+{
+    int tests_executed;
+    int tests_failed;
+    int tests_passed;
+    int assertions_executed;
+    int assertions_failed;
+    int assertions_passed;
+    uint64_t tests_wall_ns; /* sum of per-test wall time */
+    uint64_t tests_cpu_ns;  /* sum of per-test CPU time */
+} lfg_ct_counts_t;
+
+/** Copy the current counters into @p counts, waiting for any parallel
+ *  workers first.
+ *  @param counts Destination for the counters.
+ */
+void lfg_ct_self_test_counts(lfg_ct_counts_t *counts);
+
 #endif /* LFG_CTEST_SELF_TEST */
 
 #endif /* LFG_CTEST_H_ */
@@ -0,0 +1,50 @@
+/*
+ * Registration Test Suite for lfg-ctest
+ *
+ * Tests here are defined with LFG_CT_TEST() and run by lfg_ct_main() with no
+ * hand-written suites. CTest also runs this binary with --list, --filter and
+ * --order to check selection and ordering from the command line.
+ */
+
+#include "lfg-ctest.h"
+
+/* ============================================================================
+ * REGISTERED TESTS - Declared out of name order on purpose
+ * ============================================================================ */
+
+LFG_CT_TEST(a_first)
+{
+    ASSERT_TRUE(1);
+}
+
+LFG_CT_TEST(c_second)
+{
+    ASSERT_INT_EQUAL(4, 2 + 2);
+}
+
+LFG_CT_TEST(b_third)
+{
+    ASSERT_STR_EQUAL("lfg", "lfg");
+}
+
+LFG_CT_TEST(d_register_is_idempotent)
+{
+    /* already registered by its constructor (or by main); must not relink */
+    LFG_CT_REGISTER(a_first);
+    ASSERT_PTR_NULL(d_register_is_idempotent__lfg_ct_node.next);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char *argv[])
+{
+#ifndef LFG_CT_HAS_AUTO_REGISTER
+    LFG_CT_REGISTER(a_first);
+    LFG_CT_REGISTER(c_second);
+    LFG_CT_REGISTER(b_third);
+    LFG_CT_REGISTER(d_register_is_idempotent);
+#endif
+    return lfg_ct_main(argc, argv);
+}
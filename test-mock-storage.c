@@ -0,0 +1,565 @@
+/**
+ * @file
+ * @brief       Test suite for the optional mock call storage modes.
+ *
+ * Built once per storage mode (see CMakeLists.txt); the mode is selected by
+ * defining it before lfg-ctest-mock.h is included.
+ */
+
+#include "lfg-ctest.h"
+#include "lfg-ctest-mock.h"
+#include <stdint.h>
+#include <string.h>
+#ifdef MOCK_THREAD_SAFE
+#include <pthread.h>
+#endif
+
+/*============================================================================
+ *  Mock Declarations
+ *==========================================================================*/
+
+typedef struct
+{
+    int x;
+    int y;
+} point_t;
+
+DECLARE_MOCK_V_1(storage_sink, int);
+DECLARE_MOCK_R_V(storage_next, int);
+DECLARE_MOCK_R_2(storage_add, int, int, int);
+DECLARE_MOCK_R_1_S(storage_norm, int, point_t);
+
+/*============================================================================
+ *  Mock Definitions
+ *==========================================================================*/
+
+DEFINE_MOCK_V_1(storage_sink, int)
+DEFINE_MOCK_R_V(storage_next, int)
+DEFINE_MOCK_R_2(storage_add, int, int, int)
+DEFINE_MOCK_R_1_S(storage_norm, int, point_t)
+
+#ifdef MOCK_CALL_STORAGE_DYNAMIC
+
+/*============================================================================
+ *  Test: Dynamic storage
+ *==========================================================================*/
+
+/* Well past any fixed MOCK_CALL_STORAGE_MAX */
+#define STORAGE_CALLS 100000
+
+static void test_dynamic_history_grows(void)
+{
+    size_t i;
+
+    for (i = 0; i < STORAGE_CALLS; i++)
+    {
+        storage_sink__mock((int)i);
+    }
+
+    ASSERT_INT_EQUAL(STORAGE_CALLS, storage_sink__call_count);
+    ASSERT_TRUE(storage_sink__param_history_cap >= STORAGE_CALLS);
+    ASSERT_INT_EQUAL(0, storage_sink__param_history[0].p0);
+    ASSERT_INT_EQUAL(STORAGE_CALLS / 2, storage_sink__param_history[STORAGE_CALLS / 2].p0);
+    ASSERT_INT_EQUAL(STORAGE_CALLS - 1, MOCK_PARAM_HISTORY(storage_sink, STORAGE_CALLS - 1).p0);
+
+    storage_sink__mock_reset();
+}
+
+static void test_dynamic_return_queue_primed(void)
+{
+    size_t i;
+
+    for (i = 0; i < STORAGE_CALLS; i += 1000)
+    {
+        MOCK_RETURN_QUEUE(storage_add, i) = (int)(i / 1000) + 1;
+    }
+
+    for (i = 0; i < STORAGE_CALLS; i++)
+    {
+        int ret = storage_add__mock(1, 2);
+        if (i % 1000 == 0)
+        {
+            ASSERT_INT_EQUAL((int)(i / 1000) + 1, ret);
+        }
+    }
+
+    ASSERT_INT_EQUAL(STORAGE_CALLS, storage_add__call_count);
+    ASSERT_INT_EQUAL(2, storage_add__param_history[STORAGE_CALLS - 1].p1);
+
+    storage_add__mock_reset();
+}
+
+static void test_dynamic_unprimed_returns_zero(void)
+{
+    MOCK_RETURN_QUEUE(storage_next, 1) = 7;
+
+    ASSERT_INT_EQUAL(0, storage_next__mock());
+    ASSERT_INT_EQUAL(7, storage_next__mock());
+
+    /* Calls past the primed slots do not grow the queue */
+    while (storage_next__call_count < 5000)
+    {
+        ASSERT_INT_EQUAL(0, storage_next__mock());
+    }
+    ASSERT_TRUE(storage_next__return_queue_cap < 5000);
+
+    storage_next__mock_reset();
+}
+
+static void test_dynamic_struct_safe(void)
+{
+    point_t pt;
+    size_t i;
+
+    MOCK_RETURN_QUEUE(storage_norm, 99) = 42;
+
+    for (i = 0; i < 100; i++)
+    {
+        pt.x = (int)i;
+        pt.y = -(int)i;
+        (void)storage_norm__mock(pt);
+    }
+
+    ASSERT_INT_EQUAL(100, storage_norm__call_count);
+    ASSERT_INT_EQUAL(99, storage_norm__param_history[99].p0.x);
+    ASSERT_INT_EQUAL(-99, storage_norm__param_history[99].p0.y);
+
+    storage_norm__mock_reset();
+}
+
+static void test_dynamic_reset_clears_and_keeps_capacity(void)
+{
+    size_t cap;
+    size_t i;
+
+    for (i = 0; i < 100; i++)
+    {
+        storage_sink__mock(1);
+    }
+    MOCK_RETURN_QUEUE(storage_add, 50) = 9;
+    cap = storage_sink__param_history_cap;
+
+    mock_reset_all();
+
+    ASSERT_INT_EQUAL(0, storage_sink__call_count);
+    ASSERT_INT_EQUAL(cap, storage_sink__param_history_cap);
+    ASSERT_INT_EQUAL(0, storage_sink__param_history[99].p0);
+
+    storage_add__mock_reset();
+    ASSERT_INT_EQUAL(0, MOCK_RETURN_QUEUE(storage_add, 50));
+}
+
+static void suite_dynamic_storage(void)
+{
+    lfg_ctest(test_dynamic_history_grows);
+    lfg_ctest(test_dynamic_return_queue_primed);
+    lfg_ctest(test_dynamic_unprimed_returns_zero);
+    lfg_ctest(test_dynamic_struct_safe);
+    lfg_ctest(test_dynamic_reset_clears_and_keeps_capacity);
+}
+
+#endif /* MOCK_CALL_STORAGE_DYNAMIC */
+
+#ifdef MOCK_CALL_STORAGE_RING
+
+/*============================================================================
+ *  Test: Ring storage
+ *==========================================================================*/
+
+/* Many laps of the ring */
+#define STORAGE_CALLS 100000
+
+static size_t ring_last_callback_index;
+
+static void ring_callback(size_t i, int *ret, int a, int b)
+{
+    (void)ret;
+    (void)a;
+    (void)b;
+    ring_last_callback_index = i;
+}
+
+static void test_ring_keeps_last_calls(void)
+{
+    size_t i;
+
+    for (i = 0; i < STORAGE_CALLS; i++)
+    {
+        storage_sink__mock((int)i);
+    }
+
+    ASSERT_INT_EQUAL(STORAGE_CALLS, storage_sink__call_count);
+    for (i = STORAGE_CALLS - MOCK_CALL_STORAGE_MAX; i < STORAGE_CALLS; i++)
+    {
+        ASSERT_INT_EQUAL(i, MOCK_PARAM_HISTORY(storage_sink, i).p0);
+    }
+
+    storage_sink__mock_reset();
+}
+
+static void test_ring_return_queue_wraps(void)
+{
+    size_t i;
+
+    for (i = 0; i < MOCK_CALL_STORAGE_MAX; i++)
+    {
+        MOCK_RETURN_QUEUE(storage_add, i) = (int)i + 1;
+    }
+
+    for (i = 0; i < 3 * MOCK_CALL_STORAGE_MAX; i++)
+    {
+        ASSERT_INT_EQUAL((int)(i % MOCK_CALL_STORAGE_MAX) + 1, storage_add__mock((int)i, 0));
+    }
+
+    ASSERT_INT_EQUAL(3 * MOCK_CALL_STORAGE_MAX, storage_add__call_count);
+    ASSERT_INT_EQUAL(3 * MOCK_CALL_STORAGE_MAX - 1, MOCK_PARAM_HISTORY(storage_add, 3 * MOCK_CALL_STORAGE_MAX - 1).p0);
+
+    storage_add__mock_reset();
+}
+
+static void test_ring_callback_sees_logical_index(void)
+{
+    size_t i;
+
+    storage_add__callback = ring_callback;
+    for (i = 0; i < 2 * MOCK_CALL_STORAGE_MAX + 3; i++)
+    {
+        (void)storage_add__mock(0, 0);
+    }
+
+    ASSERT_INT_EQUAL(2 * MOCK_CALL_STORAGE_MAX + 2, ring_last_callback_index);
+
+    storage_add__mock_reset();
+}
+
+static void test_ring_struct_safe(void)
+{
+    point_t pt;
+    size_t i;
+
+    for (i = 0; i < 5 * MOCK_CALL_STORAGE_MAX; i++)
+    {
+        pt.x = (int)i;
+        pt.y = 0;
+        (void)storage_norm__mock(pt);
+    }
+
+    i = 5 * MOCK_CALL_STORAGE_MAX - 1;
+    ASSERT_INT_EQUAL(i, MOCK_PARAM_HISTORY(storage_norm, i).p0.x);
+
+    storage_norm__mock_reset();
+}
+
+static void test_ring_reset_clears(void)
+{
+    size_t i;
+
+    MOCK_RETURN_QUEUE(storage_next, 0) = 5;
+    for (i = 0; i < MOCK_CALL_STORAGE_MAX + 1; i++)
+    {
+        (void)storage_next__mock();
+    }
+
+    mock_reset_all();
+
+    ASSERT_INT_EQUAL(0, storage_next__call_count);
+    ASSERT_INT_EQUAL(0, storage_next__mock());
+
+    storage_next__mock_reset();
+}
+
+static void test_ring_return_program_soak(void)
+{
+    size_t i;
+
+    /* constant setup for any number of calls */
+    MOCK_RETURNS_REPEAT(storage_add, 1, STORAGE_CALLS / 2);
+    MOCK_RETURNS_DEFAULT(storage_add, 2);
+
+    for (i = 0; i < STORAGE_CALLS; i++)
+    {
+        if (storage_add__mock(0, 0) != (i < STORAGE_CALLS / 2 ? 1 : 2))
+        {
+            break;
+        }
+    }
+
+    ASSERT_INT_EQUAL(STORAGE_CALLS, i);
+
+    storage_add__mock_reset();
+}
+
+static void test_ring_stats_report_wrapping(void)
+{
+    char line[256];
+    mock_stats_t stats;
+    FILE *fp = tmpfile();
+    bool listed = false;
+    size_t i;
+
+    ASSERT_NOT_NULL(fp);
+    for (i = 0; i < 2 * MOCK_CALL_STORAGE_MAX; i++)
+    {
+        storage_next__mock();
+    }
+    ASSERT_TRUE(mock_stats_get("storage_next", &stats));
+    ASSERT_TRUE(stats.storage_wraps);
+
+    /* a peak over the ring size is not a percentage of anything */
+    mock_stats_print(fp, 8);
+    rewind(fp);
+    while (fgets(line, sizeof(line), fp))
+    {
+        if (strstr(line, "storage_next"))
+        {
+            listed = true;
+            ASSERT_NOT_NULL(strstr(line, "wrapping"));
+            ASSERT_NULL(strstr(line, "%"));
+        }
+    }
+    ASSERT_TRUE(listed);
+    fclose(fp);
+
+    storage_next__mock_reset();
+}
+
+static void suite_ring_storage(void)
+{
+    lfg_ctest(test_ring_keeps_last_calls);
+    lfg_ctest(test_ring_return_queue_wraps);
+    lfg_ctest(test_ring_callback_sees_logical_index);
+    lfg_ctest(test_ring_struct_safe);
+    lfg_ctest(test_ring_reset_clears);
+    lfg_ctest(test_ring_return_program_soak);
+    lfg_ctest(test_ring_stats_report_wrapping);
+}
+
+#endif /* MOCK_CALL_STORAGE_RING */
+
+#ifdef MOCK_THREAD_SAFE
+
+/*============================================================================
+ *  Test: Thread-safe mocks
+ *==========================================================================*/
+
+#define TS_THREADS 4
+#define TS_CALLS_PER_THREAD (MOCK_CALL_STORAGE_MAX / TS_THREADS)
+
+static size_t ts_index_sum;
+
+static void ts_callback(size_t i, int *ret, int a, int b)
+{
+    (void)a;
+    (void)b;
+    *ret = (int)i;
+    __atomic_fetch_add(&ts_index_sum, i, __ATOMIC_RELAXED);
+}
+
+static void *ts_worker(void *arg)
+{
+    int base = (int)(size_t)arg * TS_CALLS_PER_THREAD;
+    int k;
+
+    for (k = 0; k < TS_CALLS_PER_THREAD; k++)
+    {
+        storage_sink__mock(base + k);
+        (void)storage_add__mock(base + k, 0);
+    }
+    return NULL;
+}
+
+static void test_thread_safe_calls_not_lost(void)
+{
+    pthread_t threads[TS_THREADS];
+    static unsigned char seen[MOCK_CALL_STORAGE_MAX];
+    size_t i;
+
+    memset(seen, 0, sizeof(seen));
+    ts_index_sum = 0;
+    storage_add__callback = ts_callback;
+
+    for (i = 0; i < TS_THREADS; i++)
+    {
+        pthread_create(&threads[i], NULL, ts_worker, (void *)i);
+    }
+    for (i = 0; i < TS_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    ASSERT_INT_EQUAL(MOCK_CALL_STORAGE_MAX, storage_sink__call_count);
+    ASSERT_INT_EQUAL(MOCK_CALL_STORAGE_MAX, storage_add__call_count);
+
+    /* every claimed slot holds exactly one call's arguments */
+    for (i = 0; i < MOCK_CALL_STORAGE_MAX; i++)
+    {
+        seen[storage_sink__param_history[i].p0]++;
+    }
+    for (i = 0; i < MOCK_CALL_STORAGE_MAX; i++)
+    {
+        ASSERT_INT_EQUAL(1, seen[i]);
+    }
+
+    /* callbacks saw each index 0..N-1 once */
+    ASSERT_INT_EQUAL((size_t)MOCK_CALL_STORAGE_MAX * (MOCK_CALL_STORAGE_MAX - 1) / 2, ts_index_sum);
+
+    mock_reset_all();
+    ASSERT_INT_EQUAL(0, storage_sink__param_history[MOCK_CALL_STORAGE_MAX - 1].p0);
+}
+
+/* A matcher that calls another mock with expectations */
+static bool ts_matcher_calls_sink(const void *params, void *ctx)
+{
+    (void)ctx;
+    storage_sink__mock(((const storage_add_params *)params)->p0);
+    return true;
+}
+
+static void test_thread_safe_matcher_may_call_mocks(void)
+{
+    mock_reset_all();
+    MOCK_EXPECT(storage_sink, 2, 2);
+    mock_expect_match(MOCK_EXPECT(storage_add, 2, 2), ts_matcher_calls_sink, NULL);
+
+    (void)storage_add__mock(1, 0);
+    (void)storage_add__mock(2, 0);
+
+    ASSERT_INT_EQUAL(0, mock_expect_verify());
+    ASSERT_INT_EQUAL(2, storage_sink__call_count);
+    ASSERT_INT_EQUAL(2, storage_sink__param_history[1].p0);
+    mock_reset_all();
+}
+
+#ifdef LFG_CTEST_HAS_MMAP
+
+#define TS_STREAM_PATH "test-mock-threads-stream.bin"
+
+static void *ts_stream_worker(void *arg)
+{
+    int base = (int)(size_t)arg * TS_CALLS_PER_THREAD;
+    int k;
+
+    for (k = 0; k < TS_CALLS_PER_THREAD; k++)
+    {
+        storage_sink__mock(base + k);
+    }
+    return NULL;
+}
+
+static void test_thread_safe_stream_grows(void)
+{
+    pthread_t threads[TS_THREADS];
+    static unsigned char seen[MOCK_CALL_STORAGE_MAX];
+    mock_param_reader_t reader;
+    uint64_t n;
+    size_t i;
+
+    memset(seen, 0, sizeof(seen));
+    mock_reset_all();
+
+    /* the smallest mapping, so it grows while the threads write */
+    ASSERT_TRUE(MOCK_PARAM_STREAM_OPEN(storage_sink, TS_STREAM_PATH, 0));
+    for (i = 0; i < TS_THREADS; i++)
+    {
+        pthread_create(&threads[i], NULL, ts_stream_worker, (void *)i);
+    }
+    for (i = 0; i < TS_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    MOCK_PARAM_STREAM_CLOSE(storage_sink);
+
+    ASSERT_TRUE(mock_param_reader_open(&reader, TS_STREAM_PATH));
+    ASSERT_INT_EQUAL(MOCK_CALL_STORAGE_MAX, reader.count);
+    for (n = 0; n < reader.count; n++)
+    {
+        int v = MOCK_PARAM_STREAM_AT(storage_sink, &reader, n)->p0;
+        if (v >= 0 && v < MOCK_CALL_STORAGE_MAX)
+        {
+            seen[v]++;
+        }
+    }
+    mock_param_reader_close(&reader);
+    for (i = 0; i < MOCK_CALL_STORAGE_MAX; i++)
+    {
+        ASSERT_INT_EQUAL(1, seen[i]);
+    }
+
+    mock_reset_all();
+    remove(TS_STREAM_PATH);
+}
+
+#endif /* LFG_CTEST_HAS_MMAP */
+
+static void suite_thread_safe_mocks(void)
+{
+    lfg_ctest(test_thread_safe_calls_not_lost);
+    lfg_ctest(test_thread_safe_matcher_may_call_mocks);
+#ifdef LFG_CTEST_HAS_MMAP
+    lfg_ctest(test_thread_safe_stream_grows);
+#endif
+}
+
+#endif /* MOCK_THREAD_SAFE */
+
+#ifdef MOCK_RETURN_QUEUE_TRACKED
+
+/*============================================================================
+ *  Test: Tracked return queue priming
+ *==========================================================================*/
+
+static void test_tracked_reset_clears_primed(void)
+{
+    size_t i;
+
+    MOCK_RETURN_QUEUE(storage_next, 3) = 7;
+    MOCK_RETURN_QUEUE(storage_next, 1) = 5;
+    storage_next__mock_reset();
+
+    for (i = 0; i < 4; i++)
+    {
+        ASSERT_INT_EQUAL(0, storage_next__mock());
+    }
+    MOCK_RETURN_QUEUE(storage_next, 4) = 9;
+    ASSERT_INT_EQUAL(9, storage_next__mock());
+
+    storage_next__mock_reset();
+}
+
+static void suite_tracked_return_queue(void)
+{
+    lfg_ctest(test_tracked_reset_clears_primed);
+}
+
+#endif /* MOCK_RETURN_QUEUE_TRACKED */
+
+/*============================================================================
+ *  Main
+ *==========================================================================*/
+
+int main(void)
+{
+    lfg_ct_start();
+
+#ifdef MOCK_CALL_STORAGE_DYNAMIC
+    printf("\n--- Dynamic Mock Storage ---\n");
+    lfg_ct_suite(suite_dynamic_storage);
+#endif
+#ifdef MOCK_CALL_STORAGE_RING
+    printf("\n--- Ring Mock Storage ---\n");
+    lfg_ct_suite(suite_ring_storage);
+#endif
+#ifdef MOCK_THREAD_SAFE
+    printf("\n--- Thread-Safe Mocks ---\n");
+    lfg_ct_suite(suite_thread_safe_mocks);
+#endif
+#ifdef MOCK_RETURN_QUEUE_TRACKED
+    printf("\n--- Tracked Return Queue ---\n");
+    lfg_ct_suite(suite_tracked_return_queue);
+#endif
+
+    printf("\n");
+    lfg_ct_print_summary();
+
+    return lfg_ct_return();
+}
@@ -780,6 +780,182 @@ static void test_mock_param_action_multi_call(void)
     copy_data__mock_reset();
 }
 
+/*============================================================================
+ *  Test: Param actions appended out of call order
+ *==========================================================================*/
+
+static void test_mock_param_action_out_of_order(void)
+{
+    uint8_t captured0[4] = {0};
+    uint8_t captured2[4] = {0};
+    uint8_t inject[] = {0x01, 0x02, 0x03, 0x04};
+    uint8_t buf[3][4] = {{0xA0, 0xA1, 0xA2, 0xA3}, {0xB0, 0xB1, 0xB2, 0xB3}, {0xC0, 0xC1, 0xC2, 0xC3}};
+    uint8_t untouched[] = {0xB0, 0xB1, 0xB2, 0xB3};
+    mock_param_action_t action;
+
+    copy_data__mock_reset();
+
+    /* Call 2 first: write then read the same param, so order within a call is visible */
+    action = mock_param_mem_write(NULL, 2, 0, inject, 4);
+    action = mock_param_mem_read(action, 0, 0, captured0, 4);
+    action = mock_param_mem_read(action, 2, 0, captured2, 4);
+    copy_data__param_actions = action;
+
+    copy_data__mock(buf[0], 4);
+    copy_data__mock(buf[1], 4);
+    copy_data__mock(buf[2], 4);
+
+    ASSERT_UINT8_EQUAL(0xA0, captured0[0]);
+    ASSERT_MEM_EQUAL(untouched, buf[1], 4);
+    ASSERT_MEM_EQUAL(inject, buf[2], 4);
+    ASSERT_MEM_EQUAL(inject, captured2, 4);
+
+    copy_data__mock_reset();
+}
+
+/*============================================================================
+ *  Test: Param actions appended between calls still apply
+ *==========================================================================*/
+
+static void test_mock_param_action_append_after_calls(void)
+{
+    uint8_t captured[MOCK_CALL_STORAGE_MAX] = {0};
+    uint8_t data[MOCK_CALL_STORAGE_MAX];
+    mock_param_action_t action = NULL;
+    size_t i;
+
+    copy_data__mock_reset();
+
+    for (i = 0; i < MOCK_CALL_STORAGE_MAX; i++)
+    {
+        data[i] = (uint8_t)(i + 1);
+        /* script the next call only once the previous one has run */
+        action = mock_param_mem_read(action, (unsigned)i, 0, &captured[i], 1);
+        copy_data__param_actions = action;
+        copy_data__mock(&data[i], 1);
+    }
+
+    ASSERT_MEM_EQUAL(data, captured, MOCK_CALL_STORAGE_MAX);
+
+    copy_data__mock_reset();
+}
+
+/* Actions appended after a call for earlier and already scripted calls are
+ * merged into the index in place */
+static void test_mock_param_action_merge_after_calls(void)
+{
+    uint8_t captured[5] = {0};
+    uint8_t data[4] = {0x10, 0x11, 0x12, 0x13};
+    mock_param_action_t action;
+
+    copy_data__mock_reset();
+
+    action = mock_param_mem_read(NULL, 0, 0, &captured[0], 1);
+    action = mock_param_mem_read(action, 3, 0, &captured[3], 1);
+    copy_data__param_actions = action;
+    copy_data__mock(&data[0], 1);
+
+    action = mock_param_mem_read(action, 2, 0, &captured[2], 1);
+    action = mock_param_mem_read(action, 3, 0, &captured[4], 1);
+    action = mock_param_mem_read(action, 1, 0, &captured[1], 1);
+    copy_data__mock(&data[1], 1);
+    copy_data__mock(&data[2], 1);
+    copy_data__mock(&data[3], 1);
+
+    ASSERT_MEM_EQUAL(data, captured, 4);
+    ASSERT_UINT8_EQUAL(0x13, captured[4]);
+
+    copy_data__mock_reset();
+}
+
+/*============================================================================
+ *  Test: Chains longer than one pooled slab, rebuilt from the pool
+ *==========================================================================*/
+
+#define SLAB_TEST_ACTIONS (2 * MOCK_PARAM_SLAB_NODES + 1)
+
+static void test_mock_param_action_spans_slabs(void)
+{
+    uint8_t captured[SLAB_TEST_ACTIONS];
+    uint8_t data[MOCK_CALL_STORAGE_MAX];
+    mock_param_action_t action;
+    int round;
+    size_t i;
+
+    for (round = 0; round < 2; round++)
+    {
+        copy_data__mock_reset();
+        memset(captured, 0, sizeof(captured));
+
+        action = NULL;
+        for (i = 0; i < SLAB_TEST_ACTIONS; i++)
+        {
+            action = mock_param_mem_read(action, (unsigned)(i % MOCK_CALL_STORAGE_MAX), 0, &captured[i], 1);
+        }
+        copy_data__param_actions = action;
+
+        for (i = 0; i < MOCK_CALL_STORAGE_MAX; i++)
+        {
+            data[i] = (uint8_t)(0x80 + i + round);
+            copy_data__mock(&data[i], 1);
+        }
+
+        for (i = 0; i < SLAB_TEST_ACTIONS; i++)
+        {
+            ASSERT_UINT8_EQUAL(data[i % MOCK_CALL_STORAGE_MAX], captured[i]);
+        }
+    }
+
+    copy_data__mock_reset();
+    mock_reset_all();
+}
+
+/*============================================================================
+ *  Test: Digest-only capture of large buffers
+ *==========================================================================*/
+
+#define DIGEST_TEST_FRAME (64 * 1024)
+
+static void test_mock_param_action_digest(void)
+{
+    static uint8_t frame[DIGEST_TEST_FRAME];
+    static const char phrase[] = "Nobody inspects the spammish repetition";
+    uint64_t digest0 = 0;
+    uint64_t digest1 = 0;
+    mock_param_action_t action;
+    size_t i;
+
+    /* reference XXH64 vectors: empty, short tail-only, and one full stripe */
+    ASSERT_UINT64_EQUAL(0xEF46DB3751D8E999ull, mock_digest(NULL, 0));
+    ASSERT_UINT64_EQUAL(0x44BC2CF5AD770999ull, mock_digest("abc", 3));
+    ASSERT_UINT64_EQUAL(0xFBCEA83C8A378BF1ull, mock_digest(phrase, sizeof(phrase) - 1));
+
+    copy_data__mock_reset();
+
+    action = mock_param_mem_digest(NULL, 0, 0, &digest0, sizeof(frame));
+    action = mock_param_mem_digest(action, 1, 0, &digest1, sizeof(frame));
+    copy_data__param_actions = action;
+
+    for (i = 0; i < sizeof(frame); i++)
+    {
+        frame[i] = (uint8_t)(i * 31);
+    }
+    copy_data__mock(frame, sizeof(frame));
+    ASSERT_MEM_DIGEST(frame, sizeof(frame), digest0);
+
+    /* a single flipped bit gives a different digest */
+    frame[DIGEST_TEST_FRAME / 2] ^= 0x01;
+    copy_data__mock(frame, sizeof(frame));
+    ASSERT_MEM_DIGEST(frame, sizeof(frame), digest1);
+    ASSERT_UINT64_NOT_EQUAL(digest0, digest1);
+
+    lfg_ct_expect_failures_begin();
+    ASSERT_MEM_DIGEST(frame, sizeof(frame), digest0);
+    ASSERT_INT_EQUAL(1, lfg_ct_expect_failures_end());
+
+    copy_data__mock_reset();
+}
+
 /*============================================================================
  *  Test: R_3 with output parameter simulation
  *==========================================================================*/
@@ -1826,6 +2002,11 @@ static void suite_mock_param_actions(void)
     lfg_ctest(test_mock_param_action_read);
     lfg_ctest(test_mock_param_action_write);
     lfg_ctest(test_mock_param_action_multi_call);
+    lfg_ctest(test_mock_param_action_out_of_order);
+    lfg_ctest(test_mock_param_action_append_after_calls);
+    lfg_ctest(test_mock_param_action_merge_after_calls);
+    lfg_ctest(test_mock_param_action_spans_slabs);
+    lfg_ctest(test_mock_param_action_digest);
     lfg_ctest(test_mock_r_3_output_param);
     lfg_ctest(test_mock_pointer_vs_memory);
     lfg_ctest(test_mock_reset_clears_all);
@@ -1855,6 +2036,181 @@ static void suite_mock_callback(void)
     lfg_ctest(test_mock_callback_r_2_modify_queue);
 }
 
+/*============================================================================
+ *  Test: Return programs
+ *==========================================================================*/
+
+static int ramp(size_t k)
+{
+    return 100 + 10 * (int)k;
+}
+
+static void test_mock_returns_repeat_then_queue(void)
+{
+    size_t i;
+
+    get_value__mock_reset();
+
+    /* a step longer than the queue, then fall back to the primed queue */
+    MOCK_RETURNS_REPEAT(get_value, 7, 3);
+    get_value__return_queue[3] = 99;
+
+    for (i = 0; i < 3; i++)
+    {
+        ASSERT_INT_EQUAL(7, get_value__mock());
+    }
+    ASSERT_INT_EQUAL(99, get_value__mock());
+    ASSERT_INT_EQUAL(0, get_value__mock());
+
+    get_value__mock_reset();
+}
+
+static void test_mock_returns_steps_in_sequence(void)
+{
+    static const int cycle[] = {1, 2, 3};
+    int expected[] = {5, 5, 1, 2, 3, 1, 100, 110, 120, -1, -1, -1};
+    size_t i;
+
+    add_numbers__mock_reset();
+
+    MOCK_RETURNS_REPEAT(add_numbers, 5, 2);
+    MOCK_RETURNS_CYCLE(add_numbers, cycle, 3, 4);
+    MOCK_RETURNS_FN(add_numbers, ramp, 3);
+    MOCK_RETURNS_DEFAULT(add_numbers, -1);
+
+    for (i = 0; i < sizeof(expected) / sizeof(expected[0]); i++)
+    {
+        ASSERT_INT_EQUAL(expected[i], add_numbers__mock(0, 0));
+    }
+
+    add_numbers__mock_reset();
+}
+
+static void test_mock_returns_start_at_current_call(void)
+{
+    add_numbers__mock_reset();
+    add_numbers__return_queue[0] = 4;
+
+    ASSERT_INT_EQUAL(4, add_numbers__mock(0, 0));
+
+    /* the program covers calls from here on, not from call 0 */
+    MOCK_RETURNS_REPEAT(add_numbers, 8, 1);
+    ASSERT_INT_EQUAL(8, add_numbers__mock(0, 0));
+    ASSERT_INT_EQUAL(0, add_numbers__mock(0, 0));
+
+    add_numbers__mock_reset();
+}
+
+static void test_mock_returns_step_after_gap_starts_now(void)
+{
+    size_t i;
+
+    get_value__mock_reset();
+
+    MOCK_RETURNS_REPEAT(get_value, 1, 3);
+    for (i = 0; i < 10; i++)
+    {
+        get_value__mock();
+    }
+
+    /* the first step ended at call 3; the new one covers calls 10..14 */
+    MOCK_RETURNS_REPEAT(get_value, 2, 5);
+    for (i = 0; i < 5; i++)
+    {
+        ASSERT_INT_EQUAL(2, get_value__mock());
+    }
+    ASSERT_INT_EQUAL(0, get_value__mock());
+
+    get_value__mock_reset();
+}
+
+#ifdef LFG_CTEST_HAS_FORK
+static void helper_returns_empty_cycle(void)
+{
+    static const int cycle[] = {1};
+
+    add_numbers__mock_reset();
+    MOCK_RETURNS_CYCLE(add_numbers, cycle, 0, 4); /* asserts unless NDEBUG */
+    ASSERT_INT_EQUAL(0, add_numbers__return_program.nsteps);
+    ASSERT_INT_EQUAL(0, add_numbers__mock(0, 0));
+}
+
+static void test_mock_returns_empty_cycle_rejected(void)
+{
+#ifdef NDEBUG
+    int expected_failures = 0;
+#else
+    int expected_failures = 1; /* the worker dies on the assert */
+#endif
+
+    lfg_ct_expect_failures_begin();
+    lfg_ct_isolate(true);
+    lfg_ctest(helper_returns_empty_cycle);
+    lfg_ct_isolate(false);
+    ASSERT_INT_EQUAL(expected_failures, lfg_ct_expect_failures_end());
+}
+#endif
+
+static void test_mock_returns_callback_still_overrides(void)
+{
+    add_numbers__mock_reset();
+
+    MOCK_RETURNS_DEFAULT(add_numbers, 3);
+    add_numbers__callback = on_add_numbers_argdriven;
+
+    /* the callback sees the program's value in *ret and may replace it */
+    ASSERT_INT_EQUAL(30, add_numbers__mock(10, 20));
+
+    add_numbers__mock_reset();
+}
+
+static void test_mock_returns_struct(void)
+{
+    struct point a = {1, 2};
+    struct point zero = {0, 0};
+    struct point got;
+
+    transform_point__mock_reset();
+
+    MOCK_RETURNS_REPEAT(transform_point, a, 2);
+
+    got = transform_point__mock(zero);
+    ASSERT_INT_EQUAL(1, got.x);
+    got = transform_point__mock(zero);
+    ASSERT_INT_EQUAL(2, got.y);
+    got = transform_point__mock(zero);
+    ASSERT_INT_EQUAL(0, got.x);
+
+    transform_point__mock_reset();
+}
+
+static void test_mock_returns_reset_clears_program(void)
+{
+    MOCK_RETURNS_DEFAULT(get_value, 42);
+    ASSERT_INT_EQUAL(42, get_value__mock());
+
+    mock_reset_all();
+
+    ASSERT_INT_EQUAL(0, get_value__return_program.nsteps);
+    ASSERT_INT_EQUAL(0, get_value__mock());
+
+    get_value__mock_reset();
+}
+
+static void suite_mock_returns(void)
+{
+    lfg_ctest(test_mock_returns_repeat_then_queue);
+    lfg_ctest(test_mock_returns_steps_in_sequence);
+    lfg_ctest(test_mock_returns_start_at_current_call);
+    lfg_ctest(test_mock_returns_step_after_gap_starts_now);
+#ifdef LFG_CTEST_HAS_FORK
+    lfg_ctest(test_mock_returns_empty_cycle_rejected);
+#endif
+    lfg_ctest(test_mock_returns_callback_still_overrides);
+    lfg_ctest(test_mock_returns_struct);
+    lfg_ctest(test_mock_returns_reset_clears_program);
+}
+
 /*============================================================================
  *  Test: mock_reset_all - resets all invoked mocks
  *==========================================================================*/
@@ -1982,6 +2338,66 @@ static void test_mock_reset_all_struct_safe(void)
     ASSERT_INT_EQUAL(0, draw_point__param_history[0].p0.x);
 }
 
+static void test_mock_reset_clears_written_history(void)
+{
+    size_t i;
+
+    set_value__mock_reset();
+
+    for (i = 0; i < MOCK_CALL_STORAGE_MAX; i++)
+    {
+        set_value__mock((int)i + 1);
+    }
+    set_value__mock_reset();
+
+    /* a shorter second run must not see the first run's tail */
+    set_value__mock(100);
+    set_value__mock(200);
+    set_value__mock_reset();
+
+    for (i = 0; i < MOCK_CALL_STORAGE_MAX; i++)
+    {
+        ASSERT_INT_EQUAL(0, set_value__param_history[i].p0);
+    }
+}
+
+/* The registry has no fixed capacity: register far more nodes than the old 64-entry table held */
+#define REGISTRY_TEST_NODES 1000
+
+static size_t registry_resets;
+
+static void count_registry_reset(void)
+{
+    registry_resets++;
+}
+
+static void test_mock_reset_all_unbounded_registry(void)
+{
+    static struct _mock_registration regs[REGISTRY_TEST_NODES];
+    size_t i;
+
+    mock_reset_all();
+    registry_resets = 0;
+
+    for (i = 0; i < REGISTRY_TEST_NODES; i++)
+    {
+        regs[i].reset_fn = count_registry_reset;
+        _mock_register(&regs[i]);
+        _mock_register(&regs[i]); /* duplicate registration is a no-op */
+    }
+    simple_void_func__mock();
+
+    mock_reset_all();
+
+    ASSERT_INT_EQUAL(REGISTRY_TEST_NODES, registry_resets);
+    ASSERT_INT_EQUAL(0, simple_void_func__call_count);
+    ASSERT_FALSE(regs[REGISTRY_TEST_NODES - 1].registered);
+
+    /* nothing stays registered after the reset */
+    mock_reset_all();
+    ASSERT_INT_EQUAL(REGISTRY_TEST_NODES, registry_resets);
+}
+
 static void suite_mock_reset_all(void)
 {
     lfg_ctest(test_mock_reset_all_clears_invoked);
@@ -1993,6 +2409,452 @@ static void suite_mock_reset_all(void)
     lfg_ctest(test_mock_reset_all_re_register_after_reset);
     lfg_ctest(test_mock_reset_all_noop_when_empty);
     lfg_ctest(test_mock_reset_all_struct_safe);
+    lfg_ctest(test_mock_reset_all_unbounded_registry);
+    lfg_ctest(test_mock_reset_clears_written_history);
+}
+
+/*============================================================================
+ *  Test: Call trace
+ *==========================================================================*/
+
+static void test_mock_trace_order(void)
+{
+    const mock_trace_record_t *rec;
+
+    mock_reset_all();
+    ASSERT_TRUE(mock_trace_start(64, false));
+
+    set_value__mock(1);
+    add_numbers__mock(2, 3);
+    set_value__mock(4);
+
+    mock_trace_stop();
+    simple_void_func__mock(); /* not traced */
+
+    ASSERT_INT_EQUAL(3, mock_trace_count());
+    ASSERT_TRUE(MOCK_TRACE_BEFORE(set_value, add_numbers));
+    ASSERT_FALSE(mock_trace_called_before("add_numbers", "set_value"));
+    ASSERT_TRUE(MOCK_TRACE_NONE == mock_trace_find("simple_void_func", 0));
+
+    ASSERT_INT_EQUAL(2, mock_trace_find("set_value", 1));
+    rec = mock_trace_at(2);
+    ASSERT_NOT_NULL(rec);
+    ASSERT_INT_EQUAL(1, rec->call_index);
+    ASSERT_INT_EQUAL(0, rec->timestamp_ns);
+    ASSERT_STR_EQUAL("set_value", mock_trace_name(rec->mock_id));
+    ASSERT_NULL(mock_trace_at(3));
+
+    mock_trace_clear();
+    ASSERT_INT_EQUAL(0, mock_trace_count());
+}
+
+static void test_mock_trace_ring_wraps(void)
+{
+    size_t i;
+
+    mock_reset_all();
+    ASSERT_TRUE(mock_trace_start(16, true));
+
+    for (i = 0; i < 30; i++)
+    {
+        set_value__mock((int)i);
+    }
+    mock_trace_stop();
+
+    /* only the newest 16 records survive */
+    ASSERT_INT_EQUAL(16, mock_trace_count());
+    ASSERT_INT_EQUAL(14, mock_trace_at(0)->seq);
+    ASSERT_INT_EQUAL(14, mock_trace_at(0)->call_index);
+    ASSERT_INT_EQUAL(29, mock_trace_at(15)->call_index);
+    ASSERT_TRUE(mock_trace_at(15)->timestamp_ns >= mock_trace_at(0)->timestamp_ns);
+}
+
+static void test_mock_trace_write(void)
+{
+    char magic[8];
+    uint64_t count;
+    FILE *fp = tmpfile();
+
+    ASSERT_NOT_NULL(fp);
+    mock_reset_all();
+    ASSERT_TRUE(mock_trace_start(16, false));
+    set_value__mock(1);
+    add_numbers__mock(1, 2);
+    mock_trace_stop();
+
+    ASSERT_INT_EQUAL(0, mock_trace_write(fp));
+
+    rewind(fp);
+    ASSERT_INT_EQUAL(8, fread(magic, 1, sizeof(magic), fp));
+    ASSERT_MEM_EQUAL("LFGMTRC1", magic, sizeof(magic));
+    fseek(fp, 16, SEEK_SET);
+    ASSERT_INT_EQUAL(1, fread(&count, sizeof(count), 1, fp));
+    ASSERT_INT_EQUAL(2, count);
+    fclose(fp);
+}
+
+static void suite_mock_trace(void)
+{
+    lfg_ctest(test_mock_trace_order);
+    lfg_ctest(test_mock_trace_ring_wraps);
+    lfg_ctest(test_mock_trace_write);
+}
+
+/*============================================================================
+ *  Test: Statistics
+ *==========================================================================*/
+
+static void slow_set_value(size_t call_index, int value)
+{
+    uint64_t until = _mock_now_ns() + 1000000u;
+
+    (void)call_index;
+    (void)value;
+    while (_mock_now_ns() < until)
+    {
+    }
+}
+
+static void test_mock_stats_across_resets(void)
+{
+    mock_stats_t before;
+    mock_stats_t after;
+    size_t i;
+
+    set_value__mock(0);
+    ASSERT_TRUE(mock_stats_get("set_value", &before));
+    set_value__mock_reset();
+
+    for (i = 0; i < 20; i++)
+    {
+        set_value__mock((int)i);
+    }
+    set_value__mock_reset();
+    for (i = 0; i < 3; i++)
+    {
+        set_value__mock((int)i);
+    }
+
+    ASSERT_TRUE(mock_stats_get("set_value", &after));
+    ASSERT_STR_EQUAL("set_value", after.name);
+    ASSERT_INT_EQUAL(before.total_calls + 23, after.total_calls);
+    ASSERT_TRUE(after.peak_calls >= 20);
+    ASSERT_INT_EQUAL(MOCK_CALL_STORAGE_MAX, after.storage_max);
+    ASSERT_FALSE(after.storage_wraps);
+    ASSERT_FALSE(mock_stats_get("never_called_mock", &after));
+    set_value__mock_reset();
+}
+
+static void test_mock_stats_callback_time(void)
+{
+    mock_stats_t before;
+    mock_stats_t after;
+
+    set_value__mock_reset();
+    set_value__mock(0);
+    ASSERT_TRUE(mock_stats_get("set_value", &before));
+
+    set_value__callback = slow_set_value;
+    set_value__mock(1); /* not timed: the report is off */
+    mock_stats_set_report(1);
+    set_value__mock(2);
+    set_value__mock(3);
+    mock_stats_set_report(0);
+
+    ASSERT_TRUE(mock_stats_get("set_value", &after));
+    ASSERT_INT_EQUAL(before.callback_calls + 2, after.callback_calls);
+    ASSERT_TRUE(after.callback_ns - before.callback_ns >= 2000000u);
+    set_value__mock_reset();
+}
+
+static void test_mock_stats_print(void)
+{
+    char line[256];
+    FILE *fp = tmpfile();
+
+    ASSERT_NOT_NULL(fp);
+    set_value__mock(1);
+    mock_stats_print(fp, 1);
+    set_value__mock_reset();
+
+    rewind(fp);
+    ASSERT_NOT_NULL(fgets(line, sizeof(line), fp));
+    ASSERT_MEM_EQUAL("*** Busiest 1 mocks", line, 19);
+    fclose(fp);
+}
+
+static void suite_mock_stats(void)
+{
+    lfg_ctest(test_mock_stats_across_resets);
+    lfg_ctest(test_mock_stats_callback_time);
+    lfg_ctest(test_mock_stats_print);
+}
+
+/*============================================================================
+ *  Test: Param streams
+ *==========================================================================*/
+
+#define STREAM_TEST_PATH "test-mock-stream.bin"
+
+#ifdef LFG_CTEST_HAS_MMAP
+
+static void test_mock_param_stream_across_resets(void)
+{
+    mock_param_reader_t reader;
+    size_t i;
+
+    add_numbers__mock_reset();
+    ASSERT_TRUE(MOCK_PARAM_STREAM_OPEN(add_numbers, STREAM_TEST_PATH, 0));
+
+    /* past the first mapping and across a reset */
+    for (i = 0; i < 3000; i++)
+    {
+        add_numbers__mock((int)i, -(int)i);
+        if (i % 20 == 19)
+        {
+            add_numbers__mock_reset();
+        }
+    }
+    MOCK_PARAM_STREAM_CLOSE(add_numbers);
+    MOCK_PARAM_STREAM_CLOSE(add_numbers); /* closing twice is a no-op */
+    add_numbers__mock(1, 1);              /* no longer streamed */
+    add_numbers__mock_reset();
+
+    ASSERT_TRUE(mock_param_reader_open(&reader, STREAM_TEST_PATH));
+    ASSERT_STR_EQUAL("add_numbers", reader.name);
+    ASSERT_INT_EQUAL(sizeof(add_numbers_params), reader.record_size);
+    ASSERT_INT_EQUAL(3000, reader.count);
+    ASSERT_INT_EQUAL(0, MOCK_PARAM_STREAM_AT(add_numbers, &reader, 0)->p0);
+    ASSERT_INT_EQUAL(2999, MOCK_PARAM_STREAM_AT(add_numbers, &reader, 2999)->p0);
+    ASSERT_INT_EQUAL(-1234, MOCK_PARAM_STREAM_AT(add_numbers, &reader, 1234)->p1);
+    ASSERT_NULL(MOCK_PARAM_STREAM_AT(add_numbers, &reader, 3000));
+    mock_param_reader_close(&reader);
+
+    remove(STREAM_TEST_PATH);
+}
+
+static void test_mock_param_stream_unclosed(void)
+{
+    mock_param_reader_t reader;
+
+    set_value__mock_reset();
+    ASSERT_TRUE(MOCK_PARAM_STREAM_OPEN(set_value, STREAM_TEST_PATH, 0));
+    set_value__mock(7);
+    set_value__mock(8);
+
+    /* readable while the writer still holds the full-size mapping */
+    ASSERT_TRUE(mock_param_reader_open(&reader, STREAM_TEST_PATH));
+    ASSERT_INT_EQUAL(2, reader.count);
+    ASSERT_INT_EQUAL(8, MOCK_PARAM_STREAM_AT(set_value, &reader, 1)->p0);
+    mock_param_reader_close(&reader);
+
+    MOCK_PARAM_STREAM_CLOSE(set_value);
+    set_value__mock_reset();
+    remove(STREAM_TEST_PATH);
+}
+
+#endif /* LFG_CTEST_HAS_MMAP */
+
+static void test_mock_param_reader_rejects_other_files(void)
+{
+    mock_param_reader_t reader;
+    FILE *fp = fopen(STREAM_TEST_PATH, "wb");
+
+    ASSERT_NOT_NULL(fp);
+    fprintf(fp, "%64s", "not a param stream");
+    fclose(fp);
+
+    ASSERT_FALSE(mock_param_reader_open(&reader, STREAM_TEST_PATH));
+    ASSERT_FALSE(mock_param_reader_open(&reader, "no-such-dir/stream.bin"));
+    remove(STREAM_TEST_PATH);
+}
+
+static void suite_mock_param_stream(void)
+{
+#ifdef LFG_CTEST_HAS_MMAP
+    lfg_ctest(test_mock_param_stream_across_resets);
+    lfg_ctest(test_mock_param_stream_unclosed);
+#endif
+    lfg_ctest(test_mock_param_reader_rejects_other_files);
+}
+
+/*============================================================================
+ *  Test: Expectations
+ *==========================================================================*/
+
+static bool sum_is_ten(const void *params, void *ctx)
+{
+    const add_numbers_params *p = params;
+
+    (void)ctx;
+    return p->p0 + p->p1 == 10;
+}
+
+static void test_mock_expect_args_in_order(void)
+{
+    mock_expect_t e;
+
+    mock_reset_all();
+    e = MOCK_EXPECT_ONCE(add_numbers);
+    MOCK_EXPECT_ARG(e, add_numbers, 0, 1);
+    MOCK_EXPECT_ARG(e, add_numbers, 1, 2);
+    e = MOCK_EXPECT(set_value, 2, 2);
+    MOCK_EXPECT_ARG(e, set_value, 0, 5);
+    MOCK_EXPECT(set_value, 0, MOCK_FOREVER); /* anything after that */
+
+    add_numbers__mock(1, 2);
+    set_value__mock(5);
+    set_value__mock(5);
+    set_value__mock(6);
+    set_value__mock(7);
+
+    ASSERT_INT_EQUAL(0, mock_expect_verify());
+    mock_reset_all();
+}
+
+static void test_mock_expect_fails_at_the_call(void)
+{
+    mock_expect_t e;
+    int at_call;
+
+    mock_reset_all();
+    e = MOCK_EXPECT_ONCE(set_value);
+    MOCK_EXPECT_ARG(e, set_value, 0, 1);
+
+    lfg_ct_expect_failures_begin();
+    set_value__mock(2);
+    at_call = lfg_ct_expect_failures_end();
+    ASSERT_INT_EQUAL(1, at_call);
+
+    /* the expectation is still waiting for its call */
+    set_value__mock(1);
+    lfg_ct_expect_failures_begin();
+    set_value__mock(1); /* used up */
+    ASSERT_INT_EQUAL(1, lfg_ct_expect_failures_end());
+
+    ASSERT_INT_EQUAL(0, mock_expect_verify());
+    mock_reset_all();
+}
+
+static char expect_failure_message[256];
+
+static void capture_failure_reporter(const lfg_ct_event_t *event, void *ctx)
+{
+    (void)ctx;
+    if (LFG_CT_EVENT_FAILURE == event->type)
+    {
+        snprintf(expect_failure_message, sizeof(expect_failure_message), "%s", event->message);
+    }
+}
+
+static void test_mock_expect_optional_mismatch_reason(void)
+{
+    mock_expect_t e;
+
+    mock_reset_all();
+    e = MOCK_EXPECT(set_value, 0, 1);
+    MOCK_EXPECT_ARG(e, set_value, 0, 5);
+
+    expect_failure_message[0] = '\0';
+    lfg_ct_reporter_add(capture_failure_reporter, NULL);
+    lfg_ct_expect_failures_begin();
+    set_value__mock(6); /* skips the optional expectation, which rejects it */
+    ASSERT_INT_EQUAL(1, lfg_ct_expect_failures_end());
+    lfg_ct_reporter_remove(capture_failure_reporter, NULL);
+
+    ASSERT_STR_EQUAL("set_value call 0: parameter p0 does not match the expectation", expect_failure_message);
+    ASSERT_INT_EQUAL(0, mock_expect_verify());
+    mock_reset_all();
+}
+
+static void test_mock_expect_cardinality(void)
+{
+    mock_reset_all();
+    MOCK_EXPECT(set_value, 2, 3);
+    MOCK_EXPECT(simple_void_func, 0, 0);
+    set_value__mock(1);
+
+    lfg_ct_expect_failures_begin();
+    simple_void_func__mock();
+    ASSERT_INT_EQUAL(1, mock_expect_verify());
+    ASSERT_INT_EQUAL(2, lfg_ct_expect_failures_end());
+    mock_reset_all();
+}
+
+static void test_mock_expect_matcher(void)
+{
+    mock_reset_all();
+    mock_expect_match(MOCK_EXPECT(add_numbers, 1, MOCK_FOREVER), sum_is_ten, NULL);
+
+    add_numbers__mock(3, 7);
+    add_numbers__mock(10, 0);
+    lfg_ct_expect_failures_begin();
+    add_numbers__mock(1, 1);
+    ASSERT_INT_EQUAL(1, lfg_ct_expect_failures_end());
+
+    ASSERT_INT_EQUAL(0, mock_expect_verify());
+    mock_reset_all();
+}
+
+static void test_mock_expect_sequence(void)
+{
+    mock_reset_all();
+    mock_expect_sequence_begin();
+    MOCK_EXPECT_ONCE(simple_void_func);
+    MOCK_EXPECT(set_value, 1, 2);
+    MOCK_EXPECT_ONCE(get_value);
+    mock_expect_sequence_end();
+
+    lfg_ct_expect_failures_begin();
+    get_value__mock(); /* simple_void_func must come first */
+    ASSERT_INT_EQUAL(1, lfg_ct_expect_failures_end());
+
+    simple_void_func__mock();
+    set_value__mock(1);
+    get_value__mock();
+
+    lfg_ct_expect_failures_begin();
+    set_value__mock(2); /* retired once get_value matched */
+    ASSERT_INT_EQUAL(1, lfg_ct_expect_failures_end());
+
+    ASSERT_INT_EQUAL(0, mock_expect_verify());
+    mock_reset_all();
+}
+
+#define EXPECT_TEST_CALLS 100000
+
+static void test_mock_expect_many_calls(void)
+{
+    size_t i;
+
+    mock_reset_all();
+    for (i = 0; i < EXPECT_TEST_CALLS; i++)
+    {
+        mock_expect_t e = MOCK_EXPECT_ONCE(set_value);
+        MOCK_EXPECT_ARG(e, set_value, 0, (int)i);
+    }
+    for (i = 0; i < EXPECT_TEST_CALLS; i++)
+    {
+        if (i % MOCK_CALL_STORAGE_MAX == 0)
+        {
+            set_value__mock_reset(); /* keeps the expectations */
+        }
+        set_value__mock((int)i);
+    }
+
+    ASSERT_INT_EQUAL(0, mock_expect_verify());
+    mock_reset_all();
+}
+
+static void suite_mock_expect(void)
+{
+    lfg_ctest(test_mock_expect_args_in_order);
+    lfg_ctest(test_mock_expect_fails_at_the_call);
+    lfg_ctest(test_mock_expect_optional_mismatch_reason);
+    lfg_ctest(test_mock_expect_cardinality);
+    lfg_ctest(test_mock_expect_matcher);
+    lfg_ctest(test_mock_expect_sequence);
+    lfg_ctest(test_mock_expect_many_calls);
 }
 
 /*============================================================================
@@ -2026,6 +2888,21 @@ int main(void)
     printf("\n--- SUITE 6: Reset All ---\n");
     lfg_ct_suite(suite_mock_reset_all);
 
+    printf("\n--- SUITE 7: Return Programs ---\n");
+    lfg_ct_suite(suite_mock_returns);
+
+    printf("\n--- SUITE 8: Call Trace ---\n");
+    lfg_ct_suite(suite_mock_trace);
+
+    printf("\n--- SUITE 9: Statistics ---\n");
+    lfg_ct_suite(suite_mock_stats);
+
+    printf("\n--- SUITE 10: Param Streams ---\n");
+    lfg_ct_suite(suite_mock_param_stream);
+
+    printf("\n--- SUITE 11: Expectations ---\n");
+    lfg_ct_suite(suite_mock_expect);
+
     printf("\n");
     lfg_ct_print_summary();
 
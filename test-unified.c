@@ -12,8 +12,20 @@
  */
 
 #include "lfg-ctest.h"
+#include <float.h>
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
+#ifdef LFG_CTEST_TEST_PTHREADS
+#include <pthread.h>
+#endif
+#ifdef LFG_CTEST_HAS_WATCHDOG
+#include <signal.h>
+#ifdef LFG_CTEST_HAS_FORK
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#endif
 
 /* ============================================================================
  * PASSING TESTS - All assertions should succeed
@@ -97,6 +109,44 @@ static void test_memory_assertions_pass(void)
     ASSERT_MEM_NOT_EQUAL(buf1, buf3, 4);
 }
 
+static void test_array_assertions_pass(void)
+{
+    static int32_t big_expected[64 * 1024];
+    static int32_t big_actual[64 * 1024];
+    int8_t i8[] = {-128, 0, 127};
+    int16_t i16[] = {-32768, 0, 32767};
+    int64_t i64[] = {INT64_MIN, 0, INT64_MAX};
+    uint8_t u8[] = {0, 0x80, 0xFF};
+    uint16_t u16[] = {0, 0x8000, 0xFFFF};
+    uint32_t u32[] = {0, 0x80000000u, 0xFFFFFFFFu};
+    uint64_t u64[] = {0, 1, UINT64_MAX};
+    lfg_ct_counts_t before;
+    lfg_ct_counts_t after;
+    size_t i;
+
+    ASSERT_INT8_ARRAY_EQUAL(i8, i8, 3);
+    ASSERT_INT16_ARRAY_EQUAL(i16, i16, 3);
+    ASSERT_INT64_ARRAY_EQUAL(i64, i64, 3);
+    ASSERT_UINT8_ARRAY_EQUAL(u8, u8, 3);
+    ASSERT_UINT16_ARRAY_EQUAL(u16, u16, 3);
+    ASSERT_UINT32_ARRAY_EQUAL(u32, u32, 3);
+    ASSERT_UINT64_ARRAY_EQUAL(u64, u64, 3);
+    ASSERT_INT32_ARRAY_EQUAL((const int32_t *)NULL, (const int32_t *)NULL, 3);
+    ASSERT_INT32_ARRAY_EQUAL(big_expected, big_actual, 0);
+
+    for (i = 0; i < 64 * 1024; i++)
+    {
+        big_expected[i] = (int32_t)(i * 2654435761u);
+        big_actual[i] = big_expected[i];
+    }
+
+    /* 64K elements are one assertion */
+    lfg_ct_self_test_counts(&before);
+    ASSERT_INT32_ARRAY_EQUAL(big_expected, big_actual, 64 * 1024);
+    lfg_ct_self_test_counts(&after);
+    ASSERT_INT_EQUAL(1, after.assertions_executed - before.assertions_executed);
+}
+
 static void test_comparison_assertions_pass(void)
 {
     ASSERT_GREATER_THAN(10, 5);
@@ -324,6 +374,173 @@ static void test_memory_failure_detection(void)
     ASSERT_INT_EQUAL(expected_failures, actual_failures);
 }
 
+static void capture_failure_reporter(const lfg_ct_event_t *event, void *ctx)
+{
+    if (LFG_CT_EVENT_FAILURE == event->type)
+    {
+        snprintf(ctx, 1024, "%s", event->message);
+    }
+}
+
+static void test_memory_failure_locates_difference(void)
+{
+    static uint8_t expected[64 * 1024];
+    static uint8_t actual[64 * 1024];
+    char message[1024] = "";
+    int actual_failures;
+
+    memset(expected, 0x5A, sizeof(expected));
+    memcpy(actual, expected, sizeof(actual));
+    actual[40000] = 0x00;
+    actual[40001] = 0x01;
+    actual[50000] = 0x02;
+
+    lfg_ct_reporter_add(capture_failure_reporter, message);
+    lfg_ct_expect_failures_begin();
+    ASSERT_MEM_EQUAL(expected, actual, sizeof(actual)); /* FAIL: two runs differ */
+    actual_failures = lfg_ct_expect_failures_end();
+
+    ASSERT_INT_EQUAL(1, actual_failures);
+    ASSERT_PTR_NOT_NULL(strstr(message, "3 bytes differ in 2 runs, first at offset 40000 (0x9c40)"));
+    ASSERT_PTR_NOT_NULL(strstr(message, "0x00009c40 exp: 5a 5a 5a"));
+    ASSERT_PTR_NOT_NULL(strstr(message, "act: 00 01 5a"));
+    ASSERT_PTR_NOT_NULL(strstr(message, "0x0000c350 exp:"));
+
+    lfg_ct_expect_failures_begin();
+    ASSERT_STR_EQUAL("hello", "help!"); /* FAIL: differs at index 3 */
+    actual_failures = lfg_ct_expect_failures_end();
+    lfg_ct_reporter_remove(capture_failure_reporter, message);
+
+    ASSERT_INT_EQUAL(1, actual_failures);
+    ASSERT_PTR_NOT_NULL(strstr(message, "differs at index 3"));
+}
+
+static void capture_failure_length(const lfg_ct_event_t *event, void *ctx)
+{
+    if (LFG_CT_EVENT_FAILURE == event->type)
+    {
+        *(size_t *)ctx = strlen(event->message);
+    }
+}
+
+static void test_long_string_failure_not_truncated(void)
+{
+    static char expected[2001];
+    static char actual[2001];
+    size_t length = 0;
+    int actual_failures;
+
+    memset(expected, 'a', sizeof(expected) - 1);
+    memset(actual, 'a', sizeof(actual) - 1);
+    actual[1999] = 'b';
+
+    lfg_ct_reporter_add(capture_failure_length, &length);
+    lfg_ct_expect_failures_begin();
+    ASSERT_STR_EQUAL(expected, actual); /* FAIL: differs in the last char */
+    actual_failures = lfg_ct_expect_failures_end();
+    lfg_ct_reporter_remove(capture_failure_length, &length);
+
+    ASSERT_INT_EQUAL(1, actual_failures);
+    ASSERT_GREATER_THAN(length, 4000); /* both strings printed in full */
+}
+
+static void test_array_failure_detection(void)
+{
+    int32_t expected[20];
+    int32_t actual[20];
+    uint8_t u8_expected[] = {0x01, 0x02, 0x03};
+    uint8_t u8_actual[] = {0x01, 0xF2, 0x03};
+    char message[1024] = "";
+    int actual_failures;
+    int i;
+
+    for (i = 0; i < 20; i++)
+    {
+        expected[i] = i;
+        actual[i] = i;
+    }
+    actual[5] = -5;
+
+    lfg_ct_reporter_add(capture_failure_reporter, message);
+    lfg_ct_expect_failures_begin();
+    ASSERT_INT32_ARRAY_EQUAL(expected, actual, 20); /* FAIL: one element differs */
+    actual_failures = lfg_ct_expect_failures_end();
+    ASSERT_INT_EQUAL(1, actual_failures);
+    ASSERT_PTR_NOT_NULL(strstr(message, "(20 elements) does not match expected: 1 differ"));
+    ASSERT_PTR_NOT_NULL(strstr(message, "[5] expected 5, actual -5"));
+
+    for (i = 0; i < 20; i++)
+    {
+        actual[i] = -1 - i;
+    }
+
+    lfg_ct_expect_failures_begin();
+    ASSERT_INT32_ARRAY_EQUAL(expected, actual, 20); /* FAIL: every element differs */
+    actual_failures = lfg_ct_expect_failures_end();
+    ASSERT_INT_EQUAL(1, actual_failures);
+    ASSERT_PTR_NOT_NULL(strstr(message, "20 differ"));
+    ASSERT_PTR_NOT_NULL(strstr(message, "[0] expected 0, actual -1"));
+    ASSERT_PTR_NULL(strstr(message, "[19]")); /* only the first LFG_CT_ARRAY_DIFF_MAX are listed */
+
+    lfg_ct_expect_failures_begin();
+    ASSERT_UINT8_ARRAY_EQUAL(u8_expected, u8_actual, 3);          /* FAIL: element 1 differs */
+    ASSERT_INT32_ARRAY_EQUAL(expected, (const int32_t *)NULL, 3); /* FAIL: NULL mismatch */
+    actual_failures = lfg_ct_expect_failures_end();
+    lfg_ct_reporter_remove(capture_failure_reporter, message);
+    ASSERT_INT_EQUAL(2, actual_failures);
+    ASSERT_PTR_NOT_NULL(strstr(message, "NULL mismatch"));
+}
+
+#ifdef LFG_CTEST_HAS_FLOAT
+static void test_float_array_assertions(void)
+{
+    float expected[] = {1.0f, 0.0f, -2.5f, 1.0f / 0.0f};
+    float actual[] = {1.0f + 2 * FLT_EPSILON, -0.0f, -2.5f, 1.0f / 0.0f};
+    float off[] = {1.0f + 3 * FLT_EPSILON, 0.0f, -2.5f, 1.0f / 0.0f};
+    float nan[] = {1.0f, 0.0f, -2.5f, 0.0f / 0.0f};
+    char message[1024] = "";
+    int actual_failures;
+
+    ASSERT_FLOAT_ARRAY_EQUAL(expected, actual, 4, 1e-6f);
+    ASSERT_FLOAT_ARRAY_EQUAL_ULP(expected, actual, 4, 2);
+
+    lfg_ct_reporter_add(capture_failure_reporter, message);
+    lfg_ct_expect_failures_begin();
+    ASSERT_FLOAT_ARRAY_EQUAL_ULP(expected, off, 4, 2); /* FAIL: element 0 is 3 ulps away */
+    actual_failures = lfg_ct_expect_failures_end();
+    ASSERT_INT_EQUAL(1, actual_failures);
+    ASSERT_PTR_NOT_NULL(strstr(message, "1 differ (ulps=2)"));
+    ASSERT_PTR_NOT_NULL(strstr(message, "ulps=3)"));
+
+    lfg_ct_expect_failures_begin();
+    ASSERT_FLOAT_ARRAY_EQUAL(expected, off, 4, 1e-9f);       /* FAIL: diff > epsilon */
+    ASSERT_FLOAT_ARRAY_EQUAL(expected, nan, 4, 1e30f);       /* FAIL: NaN never matches */
+    ASSERT_FLOAT_ARRAY_EQUAL_ULP(nan, nan, 4, UINT32_MAX);   /* FAIL: NaN never matches */
+    actual_failures = lfg_ct_expect_failures_end();
+    lfg_ct_reporter_remove(capture_failure_reporter, message);
+    ASSERT_INT_EQUAL(3, actual_failures);
+}
+#endif
+
+#ifdef LFG_CTEST_HAS_DOUBLE
+static void test_double_array_assertions(void)
+{
+    double expected[] = {1.0, 0.0, -2.5e100, 1e-300};
+    double actual[] = {1.0 + DBL_EPSILON, -0.0, -2.5e100, 1e-300};
+    double off[] = {1.0 + 4 * DBL_EPSILON, 0.0, -2.5e100, -1e-300};
+    int actual_failures;
+
+    ASSERT_DOUBLE_ARRAY_EQUAL(expected, actual, 4, 1e-12);
+    ASSERT_DOUBLE_ARRAY_EQUAL_ULP(expected, actual, 4, 1);
+
+    lfg_ct_expect_failures_begin();
+    ASSERT_DOUBLE_ARRAY_EQUAL_ULP(expected, off, 4, 3); /* FAIL: 4 ulps, and opposite signs */
+    ASSERT_DOUBLE_ARRAY_EQUAL(expected, off, 4, 1e-18); /* FAIL: diff > epsilon */
+    actual_failures = lfg_ct_expect_failures_end();
+    ASSERT_INT_EQUAL(2, actual_failures);
+}
+#endif
+
 static void test_comparison_failure_detection(void)
 {
     int expected_failures = 8;
@@ -455,10 +672,390 @@ static void test_double_failure_detection(void)
 }
 #endif
 
+/* ============================================================================
+ * TIMING TESTS - Every test is timed and the totals are accumulated
+ * ============================================================================ */
+
+static void helper_busy_test(void)
+{
+    clock_t start = clock();
+
+    /* burn a few milliseconds of CPU so both clocks must advance */
+    while (clock() - start < CLOCKS_PER_SEC / 200)
+    {
+    }
+    ASSERT_TRUE(1);
+}
+
+static void test_timing_recorded(void)
+{
+    lfg_ct_counts_t before;
+    lfg_ct_counts_t after;
+
+    lfg_ct_self_test_counts(&before);
+    lfg_ctest(helper_busy_test);
+    lfg_ct_self_test_counts(&after);
+
+    ASSERT_TRUE(after.tests_wall_ns > before.tests_wall_ns);
+    ASSERT_TRUE(after.tests_cpu_ns > before.tests_cpu_ns);
+}
+
+/* ============================================================================
+ * REPORTER TESTS - Diagnostics are delivered to registered reporters
+ * ============================================================================ */
+
+struct event_tally
+{
+    int failures;
+    int test_ends;
+    int last_failure_line;
+};
+
+static void tally_reporter(const lfg_ct_event_t *event, void *ctx)
+{
+    struct event_tally *tally = ctx;
+
+    if (LFG_CT_EVENT_FAILURE == event->type)
+    {
+        tally->failures++;
+        tally->last_failure_line = event->line;
+    }
+    else if (LFG_CT_EVENT_TEST_END == event->type)
+    {
+        tally->test_ends++;
+    }
+}
+
+static void helper_two_failures(void)
+{
+    ASSERT_INT_EQUAL(1, 2); /* FAIL */
+    ASSERT_TRUE(0);         /* FAIL */
+}
+
+/* Re-enters the runner from inside event delivery: flushes on a failure, fails an ASSERT on a test end */
+static void reentrant_reporter(const lfg_ct_event_t *event, void *ctx)
+{
+    if (LFG_CT_EVENT_FAILURE == event->type)
+    {
+        lfg_ct_report_flush();
+        (*(int *)ctx)++;
+    }
+    else if (LFG_CT_EVENT_TEST_END == event->type)
+    {
+        ASSERT_FAIL("failed from a reporter");
+    }
+}
+
+static void test_reporter_may_reenter(void)
+{
+    int flushed = 0;
+    int actual_failures;
+
+    lfg_ct_reporter_add(reentrant_reporter, &flushed);
+    lfg_ct_expect_failures_begin();
+    lfg_ctest(helper_two_failures); /* FAIL x2, then one more from the reporter at test end */
+    actual_failures = lfg_ct_expect_failures_end();
+    lfg_ct_reporter_remove(reentrant_reporter, &flushed);
+
+    ASSERT_INT_EQUAL(3, actual_failures);
+    ASSERT_INT_EQUAL(3, flushed);
+}
+
+static void test_reporter_receives_events(void)
+{
+    struct event_tally tally = {0, 0, 0};
+    int expected_failures = 2;
+    int actual_failures;
+
+    ASSERT_INT_EQUAL(0, lfg_ct_reporter_add(tally_reporter, &tally));
+    ASSERT_INT_EQUAL(0, lfg_ct_reporter_add(tally_reporter, &tally)); /* duplicate is ignored */
+
+    lfg_ct_expect_failures_begin();
+    lfg_ctest(helper_two_failures);
+    actual_failures = lfg_ct_expect_failures_end();
+
+    lfg_ct_reporter_remove(tally_reporter, &tally);
+
+    ASSERT_INT_EQUAL(expected_failures, actual_failures);
+    ASSERT_INT_EQUAL(2, tally.failures);
+    ASSERT_INT_EQUAL(1, tally.test_ends);
+    ASSERT_TRUE(tally.last_failure_line > 0);
+}
+
+/* ============================================================================
+ * THREAD TESTS - Assertions from several threads are all counted
+ * ============================================================================ */
+
+#ifdef LFG_CTEST_TEST_PTHREADS
+#define THREAD_COUNT 4
+#define THREAD_ASSERTIONS 20000
+
+static void *thread_asserts(void *arg)
+{
+    int i;
+
+    (void)arg;
+    for (i = 0; i < THREAD_ASSERTIONS; i++)
+    {
+        ASSERT_INT_EQUAL(i, i);
+    }
+    ASSERT_INT_EQUAL(1, 2); /* FAIL: once per thread */
+    return NULL;
+}
+
+static void test_threaded_assertions_counted(void)
+{
+    pthread_t threads[THREAD_COUNT];
+    lfg_ct_counts_t before;
+    lfg_ct_counts_t after;
+    int expected_failures = THREAD_COUNT;
+    int actual_failures;
+    int i;
+
+    lfg_ct_self_test_counts(&before);
+    lfg_ct_expect_failures_begin();
+    for (i = 0; i < THREAD_COUNT; i++)
+    {
+        pthread_create(&threads[i], NULL, thread_asserts, NULL);
+    }
+    for (i = 0; i < THREAD_COUNT; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    actual_failures = lfg_ct_expect_failures_end();
+    lfg_ct_self_test_counts(&after);
+
+    ASSERT_INT_EQUAL(expected_failures, actual_failures);
+    ASSERT_INT_EQUAL(THREAD_COUNT * (THREAD_ASSERTIONS + 1), after.assertions_executed - before.assertions_executed);
+}
+#endif
+
+/* ============================================================================
+ * BENCHMARK TESTS - lfg_ct_bench() calibrates, samples and reports
+ * ============================================================================ */
+
+static volatile unsigned bench_counter;
+
+static void bench_increment(void)
+{
+    bench_counter++;
+}
+
+static void capture_bench_reporter(const lfg_ct_event_t *event, void *ctx)
+{
+    if (LFG_CT_EVENT_BENCH == event->type)
+    {
+        *(lfg_ct_bench_result_t *)ctx = *event->bench;
+    }
+}
+
+static void test_bench_reports_statistics(void)
+{
+    lfg_ct_bench_result_t result;
+
+    memset(&result, 0, sizeof(result));
+    lfg_ct_reporter_add(capture_bench_reporter, &result);
+    lfg_ct_bench(bench_increment);
+    lfg_ct_reporter_remove(capture_bench_reporter, &result);
+
+    ASSERT_STR_EQUAL("bench_increment", result.name);
+    ASSERT_TRUE(result.iterations > 1);
+    ASSERT_TRUE(result.samples > 0);
+    ASSERT_TRUE(result.median_ps > 0);
+    ASSERT_TRUE(result.min_ps <= result.median_ps);
+    ASSERT_TRUE(result.median_ps <= result.p99_ps);
+    ASSERT_TRUE(result.min_ps <= result.mean_ps);
+    ASSERT_TRUE(result.mean_ps <= result.p99_ps);
+}
+
 /* ============================================================================
  * TEST SUITES
  * ============================================================================ */
 
+static void suite_passing_tests(void);
+static void suite_failure_detection_tests(void);
+
+/* ============================================================================
+ * PARALLEL RUNNER TESTS - Forked workers must report the same counters
+ * ============================================================================ */
+
+#ifdef LFG_CTEST_HAS_FORK
+/* Counter deltas produced by running suites 1 and 2 in-process (set in main) */
+static lfg_ct_counts_t sequential_delta;
+
+static void test_parallel_matches_sequential(void)
+{
+    lfg_ct_counts_t before;
+    lfg_ct_counts_t after;
+
+    lfg_ct_self_test_counts(&before);
+    lfg_ct_parallel(4);
+    suite_passing_tests();
+    suite_failure_detection_tests();
+    lfg_ct_parallel(0);
+    lfg_ct_self_test_counts(&after);
+
+    ASSERT_INT_EQUAL(sequential_delta.tests_executed, after.tests_executed - before.tests_executed);
+    ASSERT_INT_EQUAL(sequential_delta.tests_failed, after.tests_failed - before.tests_failed);
+    ASSERT_INT_EQUAL(sequential_delta.tests_passed, after.tests_passed - before.tests_passed);
+    ASSERT_INT_EQUAL(sequential_delta.assertions_executed, after.assertions_executed - before.assertions_executed);
+    ASSERT_INT_EQUAL(sequential_delta.assertions_failed, after.assertions_failed - before.assertions_failed);
+    ASSERT_INT_EQUAL(sequential_delta.assertions_passed, after.assertions_passed - before.assertions_passed);
+}
+
+static void helper_worker_aborts(void)
+{
+    abort();
+}
+
+static void test_parallel_worker_crash_detection(void)
+{
+    int expected_failures = 1;
+    int actual_failures;
+
+    lfg_ct_expect_failures_begin();
+
+    lfg_ct_parallel(2);
+    lfg_ctest(helper_worker_aborts); /* FAIL: worker dies with SIGABRT */
+    lfg_ct_parallel(0);
+
+    actual_failures = lfg_ct_expect_failures_end();
+    ASSERT_INT_EQUAL(expected_failures, actual_failures);
+}
+
+static void capture_test_end_reporter(const lfg_ct_event_t *event, void *ctx)
+{
+    if (LFG_CT_EVENT_TEST_END == event->type && event->message)
+    {
+        snprintf(ctx, 128, "%s", event->message);
+    }
+}
+
+static void test_isolated_crash_names_signal(void)
+{
+    char reason[128] = "";
+    lfg_ct_counts_t before;
+    lfg_ct_counts_t after;
+    int expected_failures = 1;
+    int actual_failures;
+
+    lfg_ct_self_test_counts(&before);
+    lfg_ct_reporter_add(capture_test_end_reporter, reason);
+    lfg_ct_expect_failures_begin();
+
+    lfg_ct_isolate(true);
+    lfg_ctest(helper_worker_aborts); /* FAIL: child dies with SIGABRT */
+    lfg_ctest(test_boolean_assertions_pass);
+    lfg_ct_isolate(false);
+
+    actual_failures = lfg_ct_expect_failures_end();
+    lfg_ct_reporter_remove(capture_test_end_reporter, reason);
+    lfg_ct_self_test_counts(&after);
+
+    ASSERT_INT_EQUAL(expected_failures, actual_failures);
+    ASSERT_INT_EQUAL(2, after.tests_executed - before.tests_executed);
+    ASSERT_PTR_NOT_NULL(strstr(reason, "SIGABRT"));
+}
+
+#ifdef LFG_CTEST_HAS_WATCHDOG
+static volatile int hang_forever = 1;
+
+static void helper_hangs(void)
+{
+    while (hang_forever)
+    {
+    }
+}
+
+static void test_timeout_fails_hung_test(void)
+{
+    char reason[128] = "";
+    int expected_failures = 1;
+    int actual_failures;
+
+    lfg_ctest_timeout(test_boolean_assertions_pass, 10000); /* finishes well inside its budget */
+
+    lfg_ct_reporter_add(capture_test_end_reporter, reason);
+    lfg_ct_expect_failures_begin();
+
+    lfg_ct_isolate(true);
+    lfg_ctest_timeout(helper_hangs, 50); /* FAIL: killed by the watchdog */
+    lfg_ct_isolate(false);
+
+    actual_failures = lfg_ct_expect_failures_end();
+    lfg_ct_reporter_remove(capture_test_end_reporter, reason);
+
+    ASSERT_INT_EQUAL(expected_failures, actual_failures);
+    ASSERT_STR_EQUAL("timed out", reason);
+}
+
+/* Without lfg_ct_isolate() a hung test runs in this process, so the watchdog
+ * ends the run with the timeout, the failed test and a summary. It is run in
+ * a forked child here so that only the child's run ends. */
+static void test_timeout_in_process_ends_run(void)
+{
+    char output[4096] = "";
+    size_t got = 0;
+    ssize_t n;
+    int status = 0;
+    int fds[2];
+    pid_t pid;
+
+    ASSERT_INT_EQUAL(0, pipe(fds));
+    fflush(stdout);
+    pid = fork();
+    ASSERT_TRUE(pid >= 0);
+    if (0 == pid)
+    {
+        close(fds[0]);
+        dup2(fds[1], STDOUT_FILENO);
+        lfg_ctest_timeout(helper_hangs, 50);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    while ((n = read(fds[0], output + got, sizeof(output) - 1 - got)) > 0)
+    {
+        got += (size_t)n;
+    }
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_INT_EQUAL(1, WEXITSTATUS(status));
+    ASSERT_PTR_NOT_NULL(strstr(output, "*** test helper_hangs TIMED OUT after 50 ms"));
+    ASSERT_PTR_NOT_NULL(strstr(output, "*** test FAILURE: helper_hangs (timed out)"));
+    ASSERT_PTR_NOT_NULL(strstr(output, "*** Testing complete. Result: FAIL"));
+}
+
+static void helper_alarm_handler(int sig)
+{
+    (void)sig;
+}
+
+static void suite_quick(void)
+{
+    lfg_ctest(test_boolean_assertions_pass);
+}
+
+static void test_timeout_restores_sigalrm(void)
+{
+    struct sigaction sa;
+    struct sigaction old;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = helper_alarm_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGALRM, &sa, &old);
+
+    lfg_ct_suite_timeout(suite_quick, 10000);
+
+    sigaction(SIGALRM, &old, &sa);
+    ASSERT_TRUE(helper_alarm_handler == sa.sa_handler);
+}
+#endif
+#endif
+
 static void suite_passing_tests(void)
 {
     lfg_ctest(test_pointer_assertions_pass);
@@ -466,6 +1063,7 @@ static void suite_passing_tests(void)
     lfg_ctest(test_integer_assertions_pass);
     lfg_ctest(test_string_assertions_pass);
     lfg_ctest(test_memory_assertions_pass);
+    lfg_ctest(test_array_assertions_pass);
     lfg_ctest(test_comparison_assertions_pass);
     lfg_ctest(test_range_assertion_pass);
     lfg_ctest(test_bit_assertions_pass);
@@ -475,6 +1073,8 @@ static void suite_passing_tests(void)
 #ifdef LFG_CTEST_HAS_DOUBLE
     lfg_ctest(test_double_assertions_pass);
 #endif
+    lfg_ctest(test_timing_recorded);
+    lfg_ctest(test_bench_reports_statistics);
 }
 
 static void suite_failure_detection_tests(void)
@@ -485,6 +1085,15 @@ static void suite_failure_detection_tests(void)
     lfg_ctest(test_integer64_failure_detection);
     lfg_ctest(test_string_failure_detection);
     lfg_ctest(test_memory_failure_detection);
+    lfg_ctest(test_memory_failure_locates_difference);
+    lfg_ctest(test_long_string_failure_not_truncated);
+    lfg_ctest(test_array_failure_detection);
+#ifdef LFG_CTEST_HAS_FLOAT
+    lfg_ctest(test_float_array_assertions);
+#endif
+#ifdef LFG_CTEST_HAS_DOUBLE
+    lfg_ctest(test_double_array_assertions);
+#endif
     lfg_ctest(test_comparison_failure_detection);
     lfg_ctest(test_range_failure_detection);
     lfg_ctest(test_bit_failure_detection);
@@ -494,8 +1103,27 @@ static void suite_failure_detection_tests(void)
 #endif
 #ifdef LFG_CTEST_HAS_DOUBLE
     lfg_ctest(test_double_failure_detection);
+#endif
+    lfg_ctest(test_reporter_receives_events);
+    lfg_ctest(test_reporter_may_reenter);
+#ifdef LFG_CTEST_TEST_PTHREADS
+    lfg_ctest(test_threaded_assertions_counted);
+#endif
+}
+
+#ifdef LFG_CTEST_HAS_FORK
+static void suite_parallel_tests(void)
+{
+    lfg_ctest(test_parallel_matches_sequential);
+    lfg_ctest(test_parallel_worker_crash_detection);
+    lfg_ctest(test_isolated_crash_names_signal);
+#ifdef LFG_CTEST_HAS_WATCHDOG
+    lfg_ctest(test_timeout_fails_hung_test);
+    lfg_ctest(test_timeout_in_process_ends_run);
+    lfg_ctest(test_timeout_restores_sigalrm);
 #endif
 }
+#endif
 
 /* ============================================================================
  * MAIN
@@ -503,6 +1131,11 @@ static void suite_failure_detection_tests(void)
 
 int main(void)
 {
+#ifdef LFG_CTEST_HAS_FORK
+    lfg_ct_counts_t before;
+    lfg_ct_counts_t after;
+#endif
+
     lfg_ct_start();
 
     printf("\n");
@@ -514,6 +1147,10 @@ int main(void)
     printf("failure detection tests to verify the framework works correctly.\n");
     printf("\n");
 
+#ifdef LFG_CTEST_HAS_FORK
+    lfg_ct_self_test_counts(&before);
+#endif
+
     printf("--- SUITE 1: PASSING TESTS ---\n");
     lfg_ct_suite(suite_passing_tests);
 
@@ -521,6 +1158,20 @@ int main(void)
     printf("(Verifies the framework correctly detects assertion failures)\n");
     lfg_ct_suite(suite_failure_detection_tests);
 
+#ifdef LFG_CTEST_HAS_FORK
+    lfg_ct_self_test_counts(&after);
+    sequential_delta.tests_executed = after.tests_executed - before.tests_executed;
+    sequential_delta.tests_failed = after.tests_failed - before.tests_failed;
+    sequential_delta.tests_passed = after.tests_passed - before.tests_passed;
+    sequential_delta.assertions_executed = after.assertions_executed - before.assertions_executed;
+    sequential_delta.assertions_failed = after.assertions_failed - before.assertions_failed;
+    sequential_delta.assertions_passed = after.assertions_passed - before.assertions_passed;
+
+    printf("\n--- SUITE 3: PARALLEL RUNNER TESTS ---\n");
+    printf("(Re-runs suites 1 and 2 in forked workers and compares the counters)\n");
+    lfg_ct_suite(suite_parallel_tests);
+#endif
+
     printf("\n");
     printf("================================================================================\n");
     printf("                         FINAL TEST SUMMARY\n");
@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @brief   mocktrace.c -- print a mock call trace written by mock_trace_write().
+ *
+ * Usage: mocktrace <trace-file>
+ *
+ * Prints one line per recorded call, oldest first:
+ *
+ *     <seq> <timestamp_ns> <mock name>[<call index>]
+ *
+ * The timestamp column is "-" when the trace was started without
+ * timestamps. The log is read back in host byte order, so it must be
+ * decoded on a machine with the endianness of the one that wrote it.
+ *
+ * The tool is self-contained; it reads the layout documented at
+ * mock_trace_write() in lfg-ctest-mock.h and does not link the library.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_MAGIC "LFGMTRC1"
+#define TRACE_VERSION 1u
+
+/* mirrors mock_trace_record_t */
+typedef struct
+{
+    uint64_t seq;
+    uint64_t timestamp_ns;
+    uint64_t call_index;
+    uint32_t mock_id;
+    uint32_t reserved;
+} trace_record_t;
+
+static int
+read_exact(FILE *fp, void *buf, size_t size)
+{
+    return fread(buf, 1, size, fp) == size;
+}
+
+int
+main(int argc, char **argv)
+{
+    char magic[8];
+    uint32_t version, record_size, nnames, reserved;
+    uint64_t count, i;
+    char **names;
+    FILE *fp;
+    int ok = 1;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <trace-file>\n", argv[0]);
+        return 2;
+    }
+
+    fp = fopen(argv[1], "rb");
+    if (!fp)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (!read_exact(fp, magic, sizeof(magic)) || memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0)
+    {
+        fprintf(stderr, "%s: not a mock trace\n", argv[1]);
+        fclose(fp);
+        return 1;
+    }
+
+    if (!read_exact(fp, &version, sizeof(version)) || !read_exact(fp, &record_size, sizeof(record_size))
+            || !read_exact(fp, &count, sizeof(count)) || !read_exact(fp, &nnames, sizeof(nnames))
+            || !read_exact(fp, &reserved, sizeof(reserved)))
+    {
+        fprintf(stderr, "%s: truncated header\n", argv[1]);
+        fclose(fp);
+        return 1;
+    }
+
+    if (version != TRACE_VERSION || record_size != sizeof(trace_record_t))
+    {
+        fprintf(stderr, "%s: unsupported trace version %u (record size %u)\n", argv[1], (unsigned)version,
+                (unsigned)record_size);
+        fclose(fp);
+        return 1;
+    }
+
+    names = calloc(nnames ? nnames : 1, sizeof(*names));
+    if (!names)
+    {
+        fprintf(stderr, "out of memory\n");
+        fclose(fp);
+        return 1;
+    }
+
+    for (i = 0; ok && i < nnames; i++)
+    {
+        uint32_t len;
+        if (!read_exact(fp, &len, sizeof(len)) || !(names[i] = malloc((size_t)len + 1))
+                || !read_exact(fp, names[i], len))
+        {
+            fprintf(stderr, "%s: truncated name table\n", argv[1]);
+            ok = 0;
+            break;
+        }
+        names[i][len] = '\0';
+    }
+
+    for (i = 0; ok && i < count; i++)
+    {
+        trace_record_t rec;
+        const char *name;
+
+        if (!read_exact(fp, &rec, sizeof(rec)))
+        {
+            fprintf(stderr, "%s: truncated after %lu records\n", argv[1], (unsigned long)i);
+            ok = 0;
+            break;
+        }
+
+        name = (rec.mock_id >= 1 && rec.mock_id <= nnames) ? names[rec.mock_id - 1] : "?";
+        if (rec.timestamp_ns)
+        {
+            printf("%llu %llu %s[%llu]\n", (unsigned long long)rec.seq, (unsigned long long)rec.timestamp_ns,
+                    name, (unsigned long long)rec.call_index);
+        }
+        else
+        {
+            printf("%llu - %s[%llu]\n", (unsigned long long)rec.seq, name, (unsigned long long)rec.call_index);
+        }
+    }
+
+    for (i = 0; i < nnames; i++)
+    {
+        free(names[i]);
+    }
+    free(names);
+    fclose(fp);
+    return ok ? 0 : 1;
+}